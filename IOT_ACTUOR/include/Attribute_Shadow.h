@@ -0,0 +1,91 @@
+#ifndef Attribute_Shadow_h
+#define Attribute_Shadow_h
+
+#include <Telemetry.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Maximum amount of client attributes that can be tracked by one shadow
+constexpr size_t ATTRIBUTE_SHADOW_MAX_KEYS = 8U;
+
+/// @brief Type of a tracked client attribute value
+enum class Shadow_Type : uint8_t
+{
+	NONE,	 ///< No value known yet, always differs from any set value
+	BOOL,	 ///< Boolean value
+	INTEGER, ///< 32 bit signed integer value
+	STRING	 ///< String value, compared by its hash
+};
+
+/// @brief Value of a tracked client attribute, strings are only referenced and compared by their hash,
+/// which allows persisting the acknowledged value without copying the string
+struct Shadow_Value
+{
+	Shadow_Type type;	// Type of the value
+	int32_t		number; // Boolean, integer or FNV-1a hash of the string
+	const char* string; // Referenced string, only set for STRING values that still have to be published
+};
+
+/// @brief Shadow of the client attributes that were last published to the ThingsBoard server.
+/// Values are set every time they might have changed, but only keys whose value differs from the
+/// last published one are sent. Every change made between two calls to flush() is sent in one single message.
+/// Optionally the published values are persisted to NVS, so a reboot or reconnect with an unchanged state sends nothing
+class Attribute_Shadow
+{
+public:
+	/// @brief Sends the given client attributes in one message
+	/// @return Whether publishing was successful
+	using attributes_send = bool (*)(const Attribute* first, const Attribute* last);
+
+	/// @brief Constructs a shadow without any known value
+	/// @param keys Keys of the tracked client attributes, the index of a key is used to set its value
+	/// @param count Amount of keys, at most ATTRIBUTE_SHADOW_MAX_KEYS
+	/// @param send Method used to publish the changed attributes
+	Attribute_Shadow(const char* const* keys, size_t count, attributes_send send);
+
+	/// @brief Loads the values published before the last reboot from NVS and persists every future publish.
+	/// Values are only restored if the keys did not change since they were persisted
+	/// @param nvs_namespace NVS namespace the values are stored in
+	/// @return Whether the values were restored
+	bool begin_persistence(const char* nvs_namespace);
+
+	/// @brief Sets the current value of the attribute with the given index, publishes nothing
+	void set(size_t index, bool value);
+
+	/// @brief Sets the current value of the attribute with the given index, publishes nothing
+	void set(size_t index, int32_t value);
+
+	/// @brief Sets the current value of the attribute with the given index, publishes nothing.
+	/// The string is only referenced and has to stay valid until the next call to flush()
+	void set(size_t index, const char* value);
+
+	/// @brief Publishes every attribute whose current value differs from the last published value in one message
+	/// @return Whether nothing had to be sent or publishing was successful, failed attributes are retried with the next call
+	bool flush();
+
+	/// @brief Forgets every published value, so the next flush() sends every attribute that has a value
+	void invalidate();
+
+private:
+	/// @brief Stores the given value as current value, it is sent with the next flush() if it differs from the published value
+	void update(size_t index, const Shadow_Value& value);
+
+	/// @brief Writes the published values into NVS
+	void persist() const;
+
+	/// @brief FNV-1a hash of the given string, continued from the given hash
+	static uint32_t hash(const char* value, uint32_t seed);
+
+	/// @brief Hash of every key, detects persisted values that belong to different keys
+	uint32_t keys_hash() const;
+
+	const char* const* m_keys;								 // Keys of the tracked attributes
+	size_t			   m_count;								 // Amount of tracked attributes
+	attributes_send	   m_send;								 // Publishes the changed attributes
+	Shadow_Value	   m_current[ATTRIBUTE_SHADOW_MAX_KEYS];	 // Values set since the last publish
+	Shadow_Value	   m_published[ATTRIBUTE_SHADOW_MAX_KEYS]; // Values the server received last
+	const char*		   m_nvs_namespace;						 // NVS namespace or nullptr if not persisted
+};
+
+#endif // Attribute_Shadow_h
@@ -0,0 +1,55 @@
+#ifndef Instrumented_MQTT_Client_h
+#define Instrumented_MQTT_Client_h
+
+#include <Arduino_MQTT_Client.h>
+
+#include "Latency_Stats.h"
+#include "RPC_Dedup_Cache.h"
+
+/// @brief Arduino_MQTT_Client that reports every received and published message to the latency statistics.
+/// Sits between PubSubClient and the ThingsBoard instance, so the receive timestamp is taken
+/// before the payload is parsed and the publish timestamp right before the response is written to the socket.
+/// Additionally answers duplicated server-side RPC requests from the responses in the dedup cache,
+/// without passing them on to the ThingsBoard instance
+class Instrumented_MQTT_Client : public Arduino_MQTT_Client
+{
+public:
+	/// @brief Constructs the client
+	/// @param transport_client Client the MQTT connection is established over
+	/// @param stats Statistics every received and published topic is reported to
+	/// @param dedup Cache the responses to server-side RPC requests are kept in
+	Instrumented_MQTT_Client(Client& transport_client, Latency_Stats& stats, RPC_Dedup_Cache& dedup);
+
+	void set_data_callback(Callback<void, char*, uint8_t*, unsigned int>::function callback) override;
+
+	bool connect(const char* client_id, const char* user_name, const char* password) override;
+
+	bool publish(const char* topic, const uint8_t* payload, const size_t& length) override;
+
+	uint8_t* reserve_publish(const char* topic, const size_t& length) override;
+
+	bool commit_publish(const size_t& length) override;
+
+private:
+	/// @brief Reports the received message and answers it from the dedup cache if it is a duplicated RPC request,
+	/// otherwise passes it on to the callback of the ThingsBoard instance
+	void on_data(char* topic, uint8_t* payload, unsigned int length);
+
+#if !THINGSBOARD_ENABLE_STL
+	/// @brief Data callback passed to the underlying client, forwards to the instance that set it last
+	static void on_static_data(char* topic, uint8_t* payload, unsigned int length);
+
+	static Instrumented_MQTT_Client* m_instance; // Instance the received messages are forwarded to
+#endif
+
+	/// @brief Reports the message that is about to be sent and caches it if it is the response to an RPC request
+	void on_publish(const char* topic, const uint8_t* payload, size_t length);
+
+	Latency_Stats&								  m_stats;			  // Statistics messages are reported to
+	RPC_Dedup_Cache&							  m_dedup;			  // Responses of recently handled RPC requests
+	Callback<void, char*, uint8_t*, unsigned int> m_data_callback;	  // Callback of the ThingsBoard instance
+	const char*									  m_reserved_topic;	  // Topic of the message reserved in the send buffer, valid until committed
+	const uint8_t*								  m_reserved_payload; // Payload of the message reserved in the send buffer
+};
+
+#endif // Instrumented_MQTT_Client_h
@@ -0,0 +1,94 @@
+#ifndef Latency_Stats_h
+#define Latency_Stats_h
+
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Maximum amount of different RPC methods latencies are tracked for
+constexpr size_t MAX_LATENCY_METHODS = 12U;
+
+// Amount of histogram buckets per method, bucket i counts latencies in [2^(i+6), 2^(i+7)) microseconds,
+// the first bucket additionally counts everything below and the last one everything above (> 2 seconds)
+constexpr size_t  LATENCY_BUCKETS			 = 16U;
+constexpr uint8_t LATENCY_FIRST_BUCKET_SHIFT = 7U;
+
+// Size of the json document needed to serialize the statistics of every tracked method
+constexpr size_t LATENCY_STATS_JSON_SIZE =
+	JSON_OBJECT_SIZE(MAX_LATENCY_METHODS + 1U) + MAX_LATENCY_METHODS * JSON_OBJECT_SIZE(7U);
+
+/// @brief Aggregated latencies of a single RPC method
+struct Method_Latency
+{
+	const char* method;						// Name of the RPC method, pointer to the subscribed constant
+	uint32_t	count;						// Amount of completed requests
+	uint64_t	parse_total_us;				// Sum of MQTT receive -> callback entry (tb.loop() dispatch and json parsing)
+	uint64_t	handler_total_us;			// Sum of callback entry -> GPIO write, stays 0 for read only methods
+	uint64_t	publish_total_us;			// Sum of GPIO write (or callback entry) -> response publish
+	uint32_t	max_us;						// Highest end to end latency
+	uint32_t	histogram[LATENCY_BUCKETS]; // End to end latency (MQTT receive -> response publish) distribution
+};
+
+/// @brief Tracks the end to end latency of server-side RPC requests on the device.
+/// Each request is traced through four timestamps: MQTT receive, callback entry, GPIO write and
+/// response publish. Completed traces are aggregated per method into a static table, so tracing never allocates.
+/// Only one request is traced at a time, which matches the single threaded processing in tb.loop()
+class Latency_Stats
+{
+public:
+	/// @brief Constructs an empty statistics table
+	Latency_Stats();
+
+	/// @brief Called when an MQTT message was received, before it is parsed, starts a trace for RPC requests
+	/// @param topic Topic the message was received on
+	void on_receive(const char* topic);
+
+	/// @brief Called as the first thing in every traced RPC callback
+	/// @param method Name of the RPC method, has to be the same pointer the callback was subscribed with
+	void on_callback_entry(const char* method);
+
+	/// @brief Called directly after the relay GPIO was written
+	void on_gpio_write();
+
+	/// @brief Called when an MQTT message is published, completes the trace for RPC responses
+	/// @param topic Topic the message is published on
+	void on_publish(const char* topic);
+
+	/// @brief Called before every tb.loop(), tracks the longest time between two calls,
+	/// which is the worst case delay before a received message is even looked at
+	void on_loop();
+
+	/// @brief Whether requests completed since the last call, clears the flag
+	/// @return True if the statistics changed and should be reported again
+	bool take_changed()
+	{
+		const bool changed = m_changed;
+		m_changed		   = false;
+		return changed;
+	}
+
+	/// @brief Writes the statistics of every method as {"method":{"n":..,"avg_us":..,...},...,"loop_gap_max_us":..}
+	/// @param object Object the statistics are written into
+	void serialize(const JsonObject& object) const;
+
+private:
+	/// @brief Returns the table entry of the given method, creates it if it does not exist yet
+	/// @return Entry of the method or nullptr if the table is full
+	Method_Latency* find_or_create(const char* method);
+
+	/// @brief Upper bound in microseconds of the bucket that contains the given percentile
+	static uint32_t percentile(const Method_Latency& latency, uint8_t percent);
+
+	Method_Latency	m_methods[MAX_LATENCY_METHODS]; // Static table of tracked methods
+	size_t			m_method_count;					// Amount of used entries in m_methods
+	Method_Latency* m_current;						// Method of the ongoing trace, nullptr until the callback was entered
+	bool			m_tracing;						// Whether an RPC request was received and is not answered yet
+	uint32_t		m_receive_us;					// Timestamps of the ongoing trace
+	uint32_t		m_entry_us;
+	uint32_t		m_gpio_us;
+	uint32_t		m_last_loop_us;					// Timestamp of the last tb.loop()
+	uint32_t		m_loop_gap_max_us;				// Longest time between two tb.loop() calls
+	bool			m_changed;						// Whether requests completed since the last take_changed()
+};
+
+#endif // Latency_Stats_h
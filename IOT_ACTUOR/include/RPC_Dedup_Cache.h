@@ -0,0 +1,64 @@
+#ifndef RPC_Dedup_Cache_h
+#define RPC_Dedup_Cache_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Amount of recently handled server-side RPC requests whose response is kept
+constexpr size_t RPC_DEDUP_ENTRIES = 8U;
+
+// Biggest response that is cached, the relay methods answer with a few bytes,
+// bigger responses (get_latency_stats) are not cached and their duplicates are handled again
+constexpr size_t RPC_DEDUP_MAX_RESPONSE_SIZE = 64U;
+
+/// @brief Response sent for an already handled server-side RPC request
+struct RPC_Dedup_Entry
+{
+	uint32_t request_id;						 // Id from the v1/devices/me/rpc/request/+ topic suffix
+	uint32_t last_used;							 // Use counter value of the last store or lookup, 0 if unused
+	uint8_t	 length;							 // Length of the response payload
+	uint8_t	 response[RPC_DEDUP_MAX_RESPONSE_SIZE]; // Response payload published for the request
+};
+
+/// @brief Least recently used cache of responses to recently handled server-side RPC requests.
+/// Retried or duplicated deliveries of the same request id are answered from the cache,
+/// instead of running the callback again, which would re-write the relay and re-publish its attributes.
+/// Request ids are only unique per MQTT session, so the cache has to be cleared on every connect
+class RPC_Dedup_Cache
+{
+public:
+	/// @brief Constructs an empty cache
+	RPC_Dedup_Cache();
+
+	/// @brief Parses the request id from a server-side RPC request topic
+	/// @param topic Topic the message was received on
+	/// @param request_id Parsed request id
+	/// @return Whether the topic is an RPC request topic with a valid id
+	static bool parse_request_id(const char* topic, uint32_t& request_id);
+
+	/// @brief Parses the request id from a server-side RPC response topic
+	/// @param topic Topic the message is published on
+	/// @param request_id Parsed request id
+	/// @return Whether the topic is an RPC response topic with a valid id
+	static bool parse_response_id(const char* topic, uint32_t& request_id);
+
+	/// @brief Returns the cached response of the given request and marks it as recently used
+	/// @return Cached response or nullptr if the request was not handled yet
+	const RPC_Dedup_Entry* find(uint32_t request_id);
+
+	/// @brief Caches the response of the given request, replaces the least recently used entry if full
+	/// @return Whether the response was small enough to be cached
+	bool store(uint32_t request_id, const uint8_t* response, size_t length);
+
+	/// @brief Removes every cached response
+	void clear();
+
+private:
+	/// @brief Parses the decimal request id following the given topic prefix
+	static bool parse_id(const char* topic, const char* prefix, size_t prefix_size, uint32_t& request_id);
+
+	RPC_Dedup_Entry m_entries[RPC_DEDUP_ENTRIES]; // Static table of cached responses
+	uint32_t		m_use_counter;				  // Increased on every store or lookup hit, orders the entries
+};
+
+#endif // RPC_Dedup_Cache_h
@@ -0,0 +1,106 @@
+#ifndef Relay_Schedule_h
+#define Relay_Schedule_h
+
+#include "Timer_Wheel.h"
+
+#include <ArduinoJson.h>
+#include <time.h>
+
+// Maximum amount of schedule entries that can be received with the shared attribute,
+// additional entries are ignored
+constexpr size_t MAX_SCHEDULE_ENTRIES = 256U;
+
+// Amount of slots in the timer wheel, one tick is one second of wall time
+constexpr size_t SCHEDULE_WHEEL_SLOTS = 256U;
+
+// Any epoch time before this value means SNTP did not synchronize the clock yet
+constexpr time_t SCHEDULE_MIN_VALID_TIME = 1609459200; // 2021-01-01T00:00:00Z
+
+// Elapsed time in seconds above which the wheel is rebuilt instead of ticked,
+// happens when the SNTP client steps the clock or loop() was blocked for a long time
+constexpr uint32_t SCHEDULE_MAX_CATCH_UP = 300U;
+
+/// @brief Single entry of the relay schedule, switches a relay to the given state at the given local time.
+/// Received as a compact json array [relay, state, minute, days, every] where the last two are optional:
+/// - relay : key of the relay (LIGHT_RELAY, VMC_RELAY, HEATER_RELAY or AC_RELAY)
+/// - state : 1 to switch the relay on, 0 to switch it off
+/// - minute : local minute of the day the entry first fires at (420 = 07:00)
+/// - days : bitmask of week days the entry is active on, bit 0 is sunday, default = 127 (every day)
+/// - every : repeat the entry every given minutes after minute until midnight, default = 0 (once a day)
+struct Schedule_Entry
+{
+	uint8_t	 relay;	 // Index of the relay, as returned by the lookup passed to Relay_Schedule
+	bool	 state;	 // State the relay is switched to
+	uint8_t	 days;	 // Bitmask of active week days, bit 0 is sunday
+	uint16_t minute; // First minute of the day the entry fires at
+	uint16_t every;	 // Repeat period in minutes, 0 if the entry fires once a day
+};
+
+/// @brief Time based relay switching driven from a hashed timer wheel.
+/// The schedule is loaded from a json array (see Schedule_Entry), every entry is armed in the wheel
+/// with the amount of seconds until its next occurrence in local wall time and re-armed each time it fired.
+/// The next occurrence is always recomputed with mktime(), so daylight saving time changes are respected.
+class Relay_Schedule
+{
+public:
+	/// @brief Returns the index of the relay with the given key or a negative value if it is unknown
+	using relay_lookup = int (*)(const char* key);
+
+	/// @brief Switches the relay with the given index to the given state
+	using relay_apply = void (*)(uint8_t relay, bool state);
+
+	/// @brief Returns the current epoch time in seconds, replaced in tests with a virtual clock
+	using clock_source = time_t (*)();
+
+	/// @brief Constructs an empty schedule
+	/// @param lookup Method used to resolve the relay key of received entries
+	/// @param apply Method called whenever an entry fires
+	/// @param clock Method used to read the current epoch time, default = SNTP synchronized system time
+	Relay_Schedule(relay_lookup lookup, relay_apply apply, clock_source clock = &system_clock);
+
+	/// @brief Replaces the current schedule with the entries contained in the given json array
+	/// @param entries Array of compact schedule entries
+	/// @return Amount of entries that were accepted
+	size_t load(const JsonArrayConst& entries);
+
+	/// @brief Removes every entry and disarms all timers
+	void clear();
+
+	/// @brief Advances the timer wheel to the current wall time and fires all due entries,
+	/// has to be called regularly from the main loop. Does nothing as long as the clock is not synchronized
+	void loop();
+
+	/// @brief Amount of entries in the current schedule
+	size_t size() const
+	{
+		return m_size;
+	}
+
+private:
+	/// @brief Default clock source, current system time as set by the SNTP client
+	static time_t system_clock();
+
+	/// @brief Called by the timer wheel for every expired entry
+	static void on_expired(size_t index, void* context);
+
+	/// @brief Arms every entry with the amount of seconds until its next occurrence
+	/// @param now Current epoch time
+	void rearm_all(time_t now);
+
+	/// @brief Arms a single entry with the amount of seconds until its next occurrence after the given time
+	void arm(size_t index, time_t now);
+
+	/// @brief Computes the amount of seconds from now until the next occurrence of the given entry
+	/// @return Seconds until the next occurrence, 0 if the entry never fires
+	static uint32_t seconds_until_next(const Schedule_Entry& entry, time_t now);
+
+	relay_lookup											m_lookup;	 // Resolves relay keys of received entries
+	relay_apply												m_apply;	 // Switches a relay when an entry fires
+	clock_source											m_clock;	 // Current epoch time
+	Timer_Wheel<SCHEDULE_WHEEL_SLOTS, MAX_SCHEDULE_ENTRIES> m_wheel;	 // One timer per entry, one tick per second
+	Schedule_Entry											m_entries[MAX_SCHEDULE_ENTRIES];
+	size_t													m_size;		 // Amount of valid entries
+	time_t													m_last_tick; // Wall time the wheel was last advanced to, 0 if not armed
+};
+
+#endif // Relay_Schedule_h
@@ -0,0 +1,177 @@
+#ifndef Timer_Wheel_h
+#define Timer_Wheel_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+/// @brief Hashed timer wheel with a fixed amount of slots and a fixed amount of timers.
+/// Each timer is identified by its index in [0, Capacity) and is kept in an intrusive doubly linked
+/// list hanging off the slot it expires in, so arming, cancelling and advancing the wheel by one tick
+/// are O(1) apart from the timers that actually share the processed slot.
+/// Delays longer than one revolution are handled with a per timer rounds counter.
+/// The wheel does not know about wall or monotonic time, the owner decides what one tick is and calls
+/// advance() with the amount of ticks that elapsed, which allows driving it from a virtual clock.
+/// @tparam Slots Amount of slots in the wheel, has to be a power of two
+/// @tparam Capacity Maximum amount of timers that can be armed at the same time
+template <size_t Slots, size_t Capacity> class Timer_Wheel
+{
+	static_assert(Slots != 0U && (Slots & (Slots - 1U)) == 0U, "Slots has to be a power of two");
+	static_assert(Capacity < UINT16_MAX, "Capacity has to fit into the 16 bit node links");
+
+public:
+	/// @brief Callback called for every timer that expired while advancing the wheel
+	/// @param index Index of the expired timer, the timer is already disarmed and may be re-armed.
+	/// Other timers must not be armed or cancelled from inside the callback
+	/// @param context Opaque pointer that was passed to advance()
+	using expired_callback = void (*)(size_t index, void* context);
+
+	/// @brief Constructs an empty wheel with all timers disarmed
+	Timer_Wheel()
+	{
+		clear();
+	}
+
+	/// @brief Disarms every timer and resets the cursor to the first slot
+	void clear()
+	{
+		for (size_t i = 0U; i < Slots; i++)
+		{
+			m_heads[i] = NONE;
+		}
+		for (size_t i = 0U; i < Capacity; i++)
+		{
+			m_nodes[i] = Node{};
+		}
+		m_cursor = 0U;
+	}
+
+	/// @brief Arms the given timer so it expires after the given amount of ticks,
+	/// a timer that is already armed is moved to its new expiry instead
+	/// @param index Index of the timer in [0, Capacity)
+	/// @param delay_ticks Amount of ticks until the timer expires, 0 is treated as 1
+	/// @return Whether the index was valid and the timer has been armed
+	bool arm(size_t index, uint32_t delay_ticks)
+	{
+		if (index >= Capacity)
+		{
+			return false;
+		}
+		cancel(index);
+		if (delay_ticks == 0U)
+		{
+			delay_ticks = 1U;
+		}
+		Node& node	 = m_nodes[index];
+		node.rounds	 = (delay_ticks - 1U) / Slots;
+		node.slot	 = static_cast<uint16_t>((m_cursor + delay_ticks) & (Slots - 1U));
+		node.armed	 = true;
+		link(static_cast<uint16_t>(index));
+		return true;
+	}
+
+	/// @brief Disarms the given timer, does nothing if it is not armed
+	/// @param index Index of the timer in [0, Capacity)
+	void cancel(size_t index)
+	{
+		if (index >= Capacity || !m_nodes[index].armed)
+		{
+			return;
+		}
+		unlink(static_cast<uint16_t>(index));
+		m_nodes[index].armed = false;
+	}
+
+	/// @brief Whether the given timer is currently armed
+	/// @param index Index of the timer in [0, Capacity)
+	/// @return True if the timer will expire in a future tick
+	bool armed(size_t index) const
+	{
+		return index < Capacity && m_nodes[index].armed;
+	}
+
+	/// @brief Advances the wheel by the given amount of ticks and calls the callback for every timer that expired
+	/// @param ticks Amount of ticks that elapsed since the last call
+	/// @param callback Method called with the index of every expired timer
+	/// @param context Opaque pointer forwarded to the callback
+	void advance(uint32_t ticks, expired_callback callback, void* context)
+	{
+		while (ticks-- > 0U)
+		{
+			m_cursor = (m_cursor + 1U) & (Slots - 1U);
+			// Detach the whole slot first, so timers re-armed from the callback into this very slot
+			// (delay being a multiple of Slots) are not processed a second time in the same tick
+			uint16_t current = m_heads[m_cursor];
+			m_heads[m_cursor] = NONE;
+			while (current != NONE)
+			{
+				Node& node			= m_nodes[current];
+				const uint16_t next = node.next;
+				if (node.rounds > 0U)
+				{
+					node.rounds--;
+					link(current);
+				}
+				else
+				{
+					node.armed = false;
+					if (callback != nullptr)
+					{
+						callback(current, context);
+					}
+				}
+				current = next;
+			}
+		}
+	}
+
+private:
+	static constexpr uint16_t NONE = UINT16_MAX;
+
+	struct Node
+	{
+		uint32_t rounds = 0U;	// Full revolutions left before the timer expires in its slot
+		uint16_t slot	= 0U;	// Slot the timer is currently linked into
+		uint16_t prev	= NONE; // Previous timer in the same slot
+		uint16_t next	= NONE; // Next timer in the same slot
+		bool	 armed	= false;
+	};
+
+	/// @brief Pushes the given timer to the front of the list of its slot
+	void link(uint16_t index)
+	{
+		Node& node	= m_nodes[index];
+		node.prev	= NONE;
+		node.next	= m_heads[node.slot];
+		if (node.next != NONE)
+		{
+			m_nodes[node.next].prev = index;
+		}
+		m_heads[node.slot] = index;
+	}
+
+	/// @brief Removes the given timer from the list of its slot
+	void unlink(uint16_t index)
+	{
+		Node& node = m_nodes[index];
+		if (node.prev != NONE)
+		{
+			m_nodes[node.prev].next = node.next;
+		}
+		else if (m_heads[node.slot] == index)
+		{
+			m_heads[node.slot] = node.next;
+		}
+		if (node.next != NONE)
+		{
+			m_nodes[node.next].prev = node.prev;
+		}
+		node.prev = NONE;
+		node.next = NONE;
+	}
+
+	uint16_t m_heads[Slots];	// First timer linked into each slot
+	Node	 m_nodes[Capacity]; // Intrusive list nodes, one per timer
+	size_t	 m_cursor;			// Slot processed by the last tick
+};
+
+#endif // Timer_Wheel_h
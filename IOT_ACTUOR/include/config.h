@@ -16,6 +16,14 @@
 
 // Serial debug output
 #define SERIAL_DEBUG true
+
+// LOCAL TRANSPORT ENABLE / DISABLE
+// Receives relay commands and samples directly from the sensor nodes over UDP
+#define LOCAL_TRANSPORT_ENABLE true
+
+// ATTRIBUTE SHADOW PERSISTENCE ENABLE / DISABLE
+// Keeps the last published client attributes in NVS, so a reboot with unchanged relays sends nothing
+#define ATTRIBUTE_SHADOW_PERSIST true
 #if SERIAL_DEBUG
 #define SERIAL_PRINT_SENSOR_VALUES false
 #endif
@@ -111,4 +119,25 @@ emyPxgcYxn/eR44/KJ4EBs+lVDR3veyJm+kXQ99b21/+jh5Xos1AnX5iItreGCc=
 #define VMC_PIN 12
 #define LIGHT_PIN 13
 #define HEATER_PIN 27
-#define AC_PIN 33
\ No newline at end of file
+#define AC_PIN 33
+// SNTP server used to synchronize the wall time the relay schedule is based on
+constexpr char NTP_SERVER[] = "pool.ntp.org";
+
+// POSIX time zone the relay schedule minutes are expressed in (Europe/Paris)
+constexpr char TIME_ZONE[] = "CET-1CEST,M3.5.0,M10.5.0/3";
+
+#if LOCAL_TRANSPORT_ENABLE
+#include <Local_Frame.h>
+
+// Id of this node in the local frames, has to be unique on the network
+constexpr uint16_t LOCAL_NODE_ID = 2U;
+
+// Multicast group and port every node joins to exchange local frames
+constexpr uint8_t  LOCAL_MULTICAST_GROUP[4] = { 239U, 10U, 42U, 1U };
+constexpr uint16_t LOCAL_PORT               = 4210U;
+
+// Key the local frames are tagged with, has to be the same on every node and kept secret,
+// frames tagged with another key are discarded. Change it for every installation
+constexpr Local_Key LOCAL_KEY = { { 0x3BU, 0x91U, 0x5EU, 0xC2U, 0x07U, 0xA4U, 0x6DU, 0xF8U,
+                                    0x12U, 0xB7U, 0x4CU, 0xE9U, 0x80U, 0x2DU, 0x65U, 0x1AU } };
+#endif
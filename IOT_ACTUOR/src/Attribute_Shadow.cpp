@@ -0,0 +1,188 @@
+#include "Attribute_Shadow.h"
+
+#include <Preferences.h>
+#include <string.h>
+
+// NVS entries the published values are persisted in
+constexpr char NVS_KEYS_HASH_KEY[] = "keys";
+constexpr char NVS_VALUES_KEY[]	   = "values";
+
+// FNV-1a 32 bit parameters
+constexpr uint32_t FNV_OFFSET_BASIS = 2166136261U;
+constexpr uint32_t FNV_PRIME		= 16777619U;
+
+/// @brief Published value as stored in NVS, strings are stored as their hash
+struct Persisted_Value
+{
+	uint8_t type;	// Shadow_Type of the value
+	int32_t number; // Boolean, integer or hash of the string
+};
+
+Attribute_Shadow::Attribute_Shadow(const char* const* keys, size_t count, attributes_send send)
+	: m_keys(keys)
+	, m_count(count < ATTRIBUTE_SHADOW_MAX_KEYS ? count : ATTRIBUTE_SHADOW_MAX_KEYS)
+	, m_send(send)
+	, m_current()
+	, m_published()
+	, m_nvs_namespace(nullptr)
+{
+	// Nothing to do
+}
+
+bool Attribute_Shadow::begin_persistence(const char* nvs_namespace)
+{
+	m_nvs_namespace = nvs_namespace;
+
+	Preferences		preferences;
+	Persisted_Value values[ATTRIBUTE_SHADOW_MAX_KEYS] = {};
+	if (!preferences.begin(m_nvs_namespace, true))
+	{
+		return false;
+	}
+	const bool restored = preferences.getUInt(NVS_KEYS_HASH_KEY, 0U) == keys_hash()
+		&& preferences.getBytesLength(NVS_VALUES_KEY) == m_count * sizeof(Persisted_Value)
+		&& preferences.getBytes(NVS_VALUES_KEY, values, m_count * sizeof(Persisted_Value)) != 0U;
+	preferences.end();
+	if (!restored)
+	{
+		return false;
+	}
+
+	for (size_t i = 0U; i < m_count; i++)
+	{
+		m_published[i].type	  = static_cast<Shadow_Type>(values[i].type);
+		m_published[i].number = values[i].number;
+		m_published[i].string = nullptr;
+	}
+	return true;
+}
+
+void Attribute_Shadow::set(size_t index, bool value)
+{
+	update(index, { Shadow_Type::BOOL, value ? 1 : 0, nullptr });
+}
+
+void Attribute_Shadow::set(size_t index, int32_t value)
+{
+	update(index, { Shadow_Type::INTEGER, value, nullptr });
+}
+
+void Attribute_Shadow::set(size_t index, const char* value)
+{
+	if (value == nullptr)
+	{
+		return;
+	}
+	update(index, { Shadow_Type::STRING, static_cast<int32_t>(hash(value, FNV_OFFSET_BASIS)), value });
+}
+
+bool Attribute_Shadow::flush()
+{
+	Attribute changed[ATTRIBUTE_SHADOW_MAX_KEYS];
+	size_t	  changed_count = 0U;
+	for (size_t i = 0U; i < m_count; i++)
+	{
+		const Shadow_Value& current = m_current[i];
+		if (current.type == Shadow_Type::NONE
+			|| (current.type == m_published[i].type && current.number == m_published[i].number))
+		{
+			continue;
+		}
+		switch (current.type)
+		{
+			case Shadow_Type::BOOL:
+				changed[changed_count++] = Attribute(m_keys[i], current.number != 0);
+				break;
+			case Shadow_Type::INTEGER:
+				changed[changed_count++] = Attribute(m_keys[i], current.number);
+				break;
+			case Shadow_Type::STRING:
+				changed[changed_count++] = Attribute(m_keys[i], current.string);
+				break;
+			default:
+				break;
+		}
+	}
+	if (changed_count == 0U)
+	{
+		return true;
+	}
+	if (!m_send(changed + 0U, changed + changed_count))
+	{
+		return false;
+	}
+
+	for (size_t i = 0U; i < m_count; i++)
+	{
+		if (m_current[i].type != Shadow_Type::NONE)
+		{
+			m_published[i] = m_current[i];
+		}
+	}
+	persist();
+	return true;
+}
+
+void Attribute_Shadow::invalidate()
+{
+	for (size_t i = 0U; i < m_count; i++)
+	{
+		m_published[i] = {};
+	}
+}
+
+void Attribute_Shadow::update(size_t index, const Shadow_Value& value)
+{
+	if (index >= m_count)
+	{
+		return;
+	}
+	m_current[index] = value;
+}
+
+void Attribute_Shadow::persist() const
+{
+	if (m_nvs_namespace == nullptr)
+	{
+		return;
+	}
+	// Only written after an actual change was published, relays switch a few times a day at most,
+	// which keeps the flash wear negligible
+	Persisted_Value values[ATTRIBUTE_SHADOW_MAX_KEYS] = {};
+	for (size_t i = 0U; i < m_count; i++)
+	{
+		values[i].type	 = static_cast<uint8_t>(m_published[i].type);
+		values[i].number = m_published[i].number;
+	}
+	Preferences preferences;
+	if (!preferences.begin(m_nvs_namespace, false))
+	{
+		return;
+	}
+	preferences.putUInt(NVS_KEYS_HASH_KEY, keys_hash());
+	preferences.putBytes(NVS_VALUES_KEY, values, m_count * sizeof(Persisted_Value));
+	preferences.end();
+}
+
+uint32_t Attribute_Shadow::hash(const char* value, uint32_t seed)
+{
+	uint32_t result = seed;
+	while (*value != '\0')
+	{
+		result ^= static_cast<uint8_t>(*value++);
+		result *= FNV_PRIME;
+	}
+	return result;
+}
+
+uint32_t Attribute_Shadow::keys_hash() const
+{
+	uint32_t result = FNV_OFFSET_BASIS;
+	for (size_t i = 0U; i < m_count; i++)
+	{
+		// Separator, so moving characters from one key to the next changes the hash
+		result = hash(m_keys[i], result) ^ 0xFFU;
+		result *= FNV_PRIME;
+	}
+	return result;
+}
@@ -0,0 +1,112 @@
+#include "Instrumented_MQTT_Client.h"
+
+#include <Helper.h>
+#include <Server_Side_RPC.h>
+
+// Size of the longest RPC response topic, prefix followed by the digits of the biggest request id
+constexpr size_t RPC_RESPONSE_TOPIC_SIZE = RPC_SEND_RESPONSE_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U;
+
+#if !THINGSBOARD_ENABLE_STL
+Instrumented_MQTT_Client* Instrumented_MQTT_Client::m_instance = nullptr;
+#endif
+
+Instrumented_MQTT_Client::Instrumented_MQTT_Client(
+	Client& transport_client, Latency_Stats& stats, RPC_Dedup_Cache& dedup)
+	: Arduino_MQTT_Client(transport_client)
+	, m_stats(stats)
+	, m_dedup(dedup)
+	, m_data_callback()
+	, m_reserved_topic(nullptr)
+	, m_reserved_payload(nullptr)
+{
+	// Nothing to do
+}
+
+void Instrumented_MQTT_Client::set_data_callback(
+	Callback<void, char*, uint8_t*, unsigned int>::function callback)
+{
+	m_data_callback.Set_Callback(callback);
+#if THINGSBOARD_ENABLE_STL
+	Arduino_MQTT_Client::set_data_callback(
+		[this](char* topic, uint8_t* payload, unsigned int length) { on_data(topic, payload, length); });
+#else
+	// Without std::function the callback can not capture this instance, like the ThingsBoard instance
+	// the received messages are forwarded through a static pointer, so only one instance can be used at a time
+	m_instance = this;
+	Arduino_MQTT_Client::set_data_callback(&Instrumented_MQTT_Client::on_static_data);
+#endif
+}
+
+bool Instrumented_MQTT_Client::connect(const char* client_id, const char* user_name, const char* password)
+{
+	// Request ids restart with every session, cached responses would answer unrelated requests
+	m_dedup.clear();
+	return Arduino_MQTT_Client::connect(client_id, user_name, password);
+}
+
+bool Instrumented_MQTT_Client::publish(const char* topic, const uint8_t* payload, const size_t& length)
+{
+	on_publish(topic, payload, length);
+	return Arduino_MQTT_Client::publish(topic, payload, length);
+}
+
+uint8_t* Instrumented_MQTT_Client::reserve_publish(const char* topic, const size_t& length)
+{
+	uint8_t* const payload = Arduino_MQTT_Client::reserve_publish(topic, length);
+	m_reserved_topic	   = (payload != nullptr) ? topic : nullptr;
+	m_reserved_payload	   = payload;
+	return payload;
+}
+
+bool Instrumented_MQTT_Client::commit_publish(const size_t& length)
+{
+	// The ThingsBoard instance serializes most messages in place and sends them without calling publish()
+	if (m_reserved_topic != nullptr)
+	{
+		on_publish(m_reserved_topic, m_reserved_payload, length);
+		m_reserved_topic   = nullptr;
+		m_reserved_payload = nullptr;
+	}
+	return Arduino_MQTT_Client::commit_publish(length);
+}
+
+void Instrumented_MQTT_Client::on_data(char* topic, uint8_t* payload, unsigned int length)
+{
+	m_stats.on_receive(topic);
+	uint32_t request_id = 0U;
+	if (RPC_Dedup_Cache::parse_request_id(topic, request_id))
+	{
+		const RPC_Dedup_Entry* entry = m_dedup.find(request_id);
+		if (entry != nullptr)
+		{
+			// Already handled, answer again without running the callback
+			char response_topic[RPC_RESPONSE_TOPIC_SIZE] = {};
+			(void)Helper::buildTopic(response_topic, RPC_SEND_RESPONSE_TOPIC,
+				RPC_SEND_RESPONSE_TOPIC_LENGTH, request_id);
+			Arduino_MQTT_Client::publish(response_topic, entry->response, entry->length);
+			return;
+		}
+	}
+	m_data_callback.Call_Callback(topic, payload, length);
+}
+
+void Instrumented_MQTT_Client::on_publish(const char* topic, const uint8_t* payload, size_t length)
+{
+	m_stats.on_publish(topic);
+	uint32_t request_id = 0U;
+	if (RPC_Dedup_Cache::parse_response_id(topic, request_id))
+	{
+		m_dedup.store(request_id, payload, length);
+	}
+}
+
+#if !THINGSBOARD_ENABLE_STL
+void Instrumented_MQTT_Client::on_static_data(char* topic, uint8_t* payload, unsigned int length)
+{
+	if (m_instance == nullptr)
+	{
+		return;
+	}
+	m_instance->on_data(topic, payload, length);
+}
+#endif
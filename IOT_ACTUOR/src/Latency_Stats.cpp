@@ -0,0 +1,165 @@
+#include "Latency_Stats.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+// Topic prefixes server-side RPC requests are received on and responses are published on
+constexpr char	 RPC_REQUEST_PREFIX[]	  = "v1/devices/me/rpc/request/";
+constexpr char	 RPC_RESPONSE_PREFIX[]	  = "v1/devices/me/rpc/response/";
+constexpr size_t RPC_REQUEST_PREFIX_SIZE  = sizeof(RPC_REQUEST_PREFIX) - 1U;
+constexpr size_t RPC_RESPONSE_PREFIX_SIZE = sizeof(RPC_RESPONSE_PREFIX) - 1U;
+
+// Keys of the serialized statistics
+constexpr char COUNT_KEY[]			 = "n";
+constexpr char AVG_PARSE_KEY[]		 = "parse_us";
+constexpr char AVG_HANDLER_KEY[]	 = "handler_us";
+constexpr char AVG_PUBLISH_KEY[]	 = "publish_us";
+constexpr char P50_KEY[]			 = "p50_us";
+constexpr char P99_KEY[]			 = "p99_us";
+constexpr char MAX_KEY[]			 = "max_us";
+constexpr char LOOP_GAP_MAX_KEY[]	 = "loop_gap_max_us";
+
+Latency_Stats::Latency_Stats()
+	: m_methods()
+	, m_method_count(0U)
+	, m_current(nullptr)
+	, m_tracing(false)
+	, m_receive_us(0U)
+	, m_entry_us(0U)
+	, m_gpio_us(0U)
+	, m_last_loop_us(0U)
+	, m_loop_gap_max_us(0U)
+	, m_changed(false)
+{
+	// Nothing to do
+}
+
+void Latency_Stats::on_receive(const char* topic)
+{
+	if (topic == nullptr || strncmp(topic, RPC_REQUEST_PREFIX, RPC_REQUEST_PREFIX_SIZE) != 0)
+	{
+		return;
+	}
+	m_tracing	 = true;
+	m_current	 = nullptr;
+	m_receive_us = micros();
+	m_entry_us	 = m_receive_us;
+	m_gpio_us	 = 0U;
+}
+
+void Latency_Stats::on_callback_entry(const char* method)
+{
+	if (!m_tracing)
+	{
+		return;
+	}
+	m_entry_us = micros();
+	m_current  = find_or_create(method);
+}
+
+void Latency_Stats::on_gpio_write()
+{
+	if (!m_tracing || m_current == nullptr)
+	{
+		return;
+	}
+	m_gpio_us = micros();
+}
+
+void Latency_Stats::on_publish(const char* topic)
+{
+	if (!m_tracing || m_current == nullptr || topic == nullptr
+		|| strncmp(topic, RPC_RESPONSE_PREFIX, RPC_RESPONSE_PREFIX_SIZE) != 0)
+	{
+		return;
+	}
+	const uint32_t publish_us = micros();
+	const uint32_t handled_us = (m_gpio_us != 0U) ? m_gpio_us : m_entry_us;
+	const uint32_t total_us	  = publish_us - m_receive_us;
+
+	Method_Latency& latency = *m_current;
+	latency.count++;
+	latency.parse_total_us += m_entry_us - m_receive_us;
+	latency.handler_total_us += handled_us - m_entry_us;
+	latency.publish_total_us += publish_us - handled_us;
+	if (total_us > latency.max_us)
+	{
+		latency.max_us = total_us;
+	}
+
+	size_t bucket = 0U;
+	while (bucket + 1U < LATENCY_BUCKETS && (total_us >> (LATENCY_FIRST_BUCKET_SHIFT + bucket)) != 0U)
+	{
+		bucket++;
+	}
+	latency.histogram[bucket]++;
+
+	m_tracing = false;
+	m_current = nullptr;
+	m_changed = true;
+}
+
+void Latency_Stats::on_loop()
+{
+	const uint32_t now = micros();
+	if (m_last_loop_us != 0U && now - m_last_loop_us > m_loop_gap_max_us)
+	{
+		m_loop_gap_max_us = now - m_last_loop_us;
+	}
+	m_last_loop_us = now;
+}
+
+void Latency_Stats::serialize(const JsonObject& object) const
+{
+	for (size_t i = 0U; i < m_method_count; i++)
+	{
+		const Method_Latency& latency = m_methods[i];
+		if (latency.count == 0U)
+		{
+			continue;
+		}
+		JsonObject method = object.createNestedObject(latency.method);
+		method[COUNT_KEY]		= latency.count;
+		method[AVG_PARSE_KEY]	= static_cast<uint32_t>(latency.parse_total_us / latency.count);
+		method[AVG_HANDLER_KEY] = static_cast<uint32_t>(latency.handler_total_us / latency.count);
+		method[AVG_PUBLISH_KEY] = static_cast<uint32_t>(latency.publish_total_us / latency.count);
+		method[P50_KEY]			= percentile(latency, 50U);
+		method[P99_KEY]			= percentile(latency, 99U);
+		method[MAX_KEY]			= latency.max_us;
+	}
+	object[LOOP_GAP_MAX_KEY] = m_loop_gap_max_us;
+}
+
+Method_Latency* Latency_Stats::find_or_create(const char* method)
+{
+	for (size_t i = 0U; i < m_method_count; i++)
+	{
+		if (m_methods[i].method == method)
+		{
+			return &m_methods[i];
+		}
+	}
+	if (m_method_count >= MAX_LATENCY_METHODS)
+	{
+		return nullptr;
+	}
+	Method_Latency& latency = m_methods[m_method_count++];
+	latency.method			= method;
+	return &latency;
+}
+
+uint32_t Latency_Stats::percentile(const Method_Latency& latency, uint8_t percent)
+{
+	// Rank of the request that has the percentile latency, rounded up
+	const uint32_t rank = (static_cast<uint64_t>(latency.count) * percent + 99U) / 100U;
+	uint32_t	   seen = 0U;
+	for (size_t bucket = 0U; bucket < LATENCY_BUCKETS; bucket++)
+	{
+		seen += latency.histogram[bucket];
+		if (seen >= rank)
+		{
+			return (bucket + 1U < LATENCY_BUCKETS) ? (1UL << (LATENCY_FIRST_BUCKET_SHIFT + bucket)) : latency.max_us;
+		}
+	}
+	return latency.max_us;
+}
@@ -0,0 +1,102 @@
+#include "RPC_Dedup_Cache.h"
+
+#include <string.h>
+
+// Topic prefixes server-side RPC requests are received on and responses are published on
+constexpr char	 RPC_REQUEST_PREFIX[]	  = "v1/devices/me/rpc/request/";
+constexpr char	 RPC_RESPONSE_PREFIX[]	  = "v1/devices/me/rpc/response/";
+constexpr size_t RPC_REQUEST_PREFIX_SIZE  = sizeof(RPC_REQUEST_PREFIX) - 1U;
+constexpr size_t RPC_RESPONSE_PREFIX_SIZE = sizeof(RPC_RESPONSE_PREFIX) - 1U;
+
+RPC_Dedup_Cache::RPC_Dedup_Cache()
+	: m_entries()
+	, m_use_counter(0U)
+{
+	// Nothing to do
+}
+
+bool RPC_Dedup_Cache::parse_request_id(const char* topic, uint32_t& request_id)
+{
+	return parse_id(topic, RPC_REQUEST_PREFIX, RPC_REQUEST_PREFIX_SIZE, request_id);
+}
+
+bool RPC_Dedup_Cache::parse_response_id(const char* topic, uint32_t& request_id)
+{
+	return parse_id(topic, RPC_RESPONSE_PREFIX, RPC_RESPONSE_PREFIX_SIZE, request_id);
+}
+
+const RPC_Dedup_Entry* RPC_Dedup_Cache::find(uint32_t request_id)
+{
+	for (RPC_Dedup_Entry& entry : m_entries)
+	{
+		if (entry.last_used != 0U && entry.request_id == request_id)
+		{
+			entry.last_used = ++m_use_counter;
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+bool RPC_Dedup_Cache::store(uint32_t request_id, const uint8_t* response, size_t length)
+{
+	if (length > RPC_DEDUP_MAX_RESPONSE_SIZE)
+	{
+		return false;
+	}
+
+	// Reuse the entry of the same request, otherwise replace an unused or the least recently used one
+	RPC_Dedup_Entry* victim = &m_entries[0];
+	for (RPC_Dedup_Entry& entry : m_entries)
+	{
+		if (entry.last_used != 0U && entry.request_id == request_id)
+		{
+			victim = &entry;
+			break;
+		}
+		if (entry.last_used < victim->last_used)
+		{
+			victim = &entry;
+		}
+	}
+
+	victim->request_id = request_id;
+	victim->last_used  = ++m_use_counter;
+	victim->length	   = static_cast<uint8_t>(length);
+	memcpy(victim->response, response, length);
+	return true;
+}
+
+void RPC_Dedup_Cache::clear()
+{
+	for (RPC_Dedup_Entry& entry : m_entries)
+	{
+		entry.last_used = 0U;
+	}
+	m_use_counter = 0U;
+}
+
+bool RPC_Dedup_Cache::parse_id(const char* topic, const char* prefix, size_t prefix_size, uint32_t& request_id)
+{
+	if (topic == nullptr || strncmp(topic, prefix, prefix_size) != 0)
+	{
+		return false;
+	}
+
+	const char* digit = topic + prefix_size;
+	if (*digit == '\0')
+	{
+		return false;
+	}
+	uint32_t id = 0U;
+	for (; *digit != '\0'; digit++)
+	{
+		if (*digit < '0' || *digit > '9' || id > (UINT32_MAX - 9U) / 10U)
+		{
+			return false;
+		}
+		id = id * 10U + static_cast<uint32_t>(*digit - '0');
+	}
+	request_id = id;
+	return true;
+}
@@ -0,0 +1,171 @@
+#include "Relay_Schedule.h"
+
+// Amount of minutes in one day, entries have to fire before midnight
+constexpr uint16_t MINUTES_PER_DAY = 24U * 60U;
+
+// Bitmask with every week day set, used if an entry does not specify its days
+constexpr uint8_t ALL_DAYS = 0x7FU;
+
+Relay_Schedule::Relay_Schedule(relay_lookup lookup, relay_apply apply, clock_source clock)
+	: m_lookup(lookup)
+	, m_apply(apply)
+	, m_clock(clock)
+	, m_wheel()
+	, m_entries()
+	, m_size(0U)
+	, m_last_tick(0)
+{
+	// Nothing to do
+}
+
+size_t Relay_Schedule::load(const JsonArrayConst& entries)
+{
+	clear();
+	for (const JsonVariantConst item : entries)
+	{
+		if (m_size >= MAX_SCHEDULE_ENTRIES)
+		{
+			break;
+		}
+		const JsonArrayConst fields = item.as<JsonArrayConst>();
+		if (fields.size() < 3U)
+		{
+			continue;
+		}
+		const int relay = m_lookup(fields[0].as<const char*>());
+		if (relay < 0)
+		{
+			continue;
+		}
+		const uint16_t minute = fields[2].as<uint16_t>();
+		const uint8_t  days	  = fields[3].isNull() ? ALL_DAYS : (fields[3].as<uint8_t>() & ALL_DAYS);
+		const uint16_t every  = fields[4].as<uint16_t>();
+		if (minute >= MINUTES_PER_DAY || every >= MINUTES_PER_DAY || days == 0U)
+		{
+			continue;
+		}
+		Schedule_Entry& entry = m_entries[m_size++];
+		entry.relay			  = static_cast<uint8_t>(relay);
+		entry.state			  = fields[1].as<int>() != 0;
+		entry.days			  = days;
+		entry.minute		  = minute;
+		entry.every			  = every;
+	}
+
+	const time_t now = m_clock();
+	if (now >= SCHEDULE_MIN_VALID_TIME)
+	{
+		rearm_all(now);
+	}
+	return m_size;
+}
+
+void Relay_Schedule::clear()
+{
+	m_wheel.clear();
+	m_size		= 0U;
+	m_last_tick = 0;
+}
+
+void Relay_Schedule::loop()
+{
+	const time_t now = m_clock();
+	if (now < SCHEDULE_MIN_VALID_TIME || m_size == 0U)
+	{
+		return;
+	}
+
+	// Rebuild the wheel if it was never armed (schedule received before SNTP synchronized)
+	// or the clock jumped, instead of replaying every second in between
+	if (m_last_tick == 0 || now < m_last_tick || static_cast<uint32_t>(now - m_last_tick) > SCHEDULE_MAX_CATCH_UP)
+	{
+		rearm_all(now);
+		return;
+	}
+
+	// Tick one second at a time, so entries fired in between are re-armed relative to their own fire time
+	while (m_last_tick < now)
+	{
+		m_last_tick++;
+		m_wheel.advance(1U, &Relay_Schedule::on_expired, this);
+	}
+}
+
+time_t Relay_Schedule::system_clock()
+{
+	return time(nullptr);
+}
+
+void Relay_Schedule::on_expired(size_t index, void* context)
+{
+	Relay_Schedule* instance = static_cast<Relay_Schedule*>(context);
+	const Schedule_Entry& entry = instance->m_entries[index];
+	instance->m_apply(entry.relay, entry.state);
+	instance->arm(index, instance->m_last_tick);
+}
+
+void Relay_Schedule::rearm_all(time_t now)
+{
+	m_wheel.clear();
+	m_last_tick = now;
+	for (size_t i = 0U; i < m_size; i++)
+	{
+		arm(i, now);
+	}
+}
+
+void Relay_Schedule::arm(size_t index, time_t now)
+{
+	const uint32_t delay = seconds_until_next(m_entries[index], now);
+	if (delay == 0U)
+	{
+		return;
+	}
+	(void)m_wheel.arm(index, delay);
+}
+
+uint32_t Relay_Schedule::seconds_until_next(const Schedule_Entry& entry, time_t now)
+{
+	struct tm local;
+	(void)localtime_r(&now, &local);
+	const uint16_t now_minute = static_cast<uint16_t>(local.tm_hour * 60 + local.tm_min);
+
+	// Look at most one week ahead, the current day is checked twice
+	// because the only occurrence might already have passed today
+	for (uint8_t day = 0U; day <= 7U; day++)
+	{
+		const uint8_t week_day = static_cast<uint8_t>((local.tm_wday + day) % 7);
+		if ((entry.days & (1U << week_day)) == 0U)
+		{
+			continue;
+		}
+
+		uint16_t minute = entry.minute;
+		if (day == 0U && minute <= now_minute)
+		{
+			if (entry.every == 0U)
+			{
+				continue;
+			}
+			minute += ((now_minute - minute) / entry.every + 1U) * entry.every;
+		}
+		if (minute >= MINUTES_PER_DAY)
+		{
+			continue;
+		}
+
+		// Let mktime normalize the day overflow and resolve daylight saving time for the target day
+		struct tm target = local;
+		target.tm_mday += day;
+		target.tm_hour	= minute / 60U;
+		target.tm_min	= minute % 60U;
+		target.tm_sec	= 0;
+		target.tm_isdst = -1;
+		const time_t when = mktime(&target);
+		if (when > now)
+		{
+			return static_cast<uint32_t>(when - now);
+		}
+	}
+	return 0U;
+}
@@ -6,9 +6,22 @@
 #include <Adafruit_NeoPixel.h>
 
 #include <Arduino_MQTT_Client.h>
+#include <Attribute_Request.h>
 #include <Server_Side_RPC.h>
+#include <Shared_Attribute_Update.h>
 #include <ThingsBoard.h>
 
+#include "Attribute_Shadow.h"
+#include "Instrumented_MQTT_Client.h"
+#include "Latency_Stats.h"
+#include "RPC_Dedup_Cache.h"
+#include "Relay_Schedule.h"
+
+#if LOCAL_TRANSPORT_ENABLE
+#include <Local_Frame.h>
+#include <UDP_Local_Transport.h>
+#endif
+
 // Initialize underlying client, used to establish a connection
 #if ENCRYPTED
 WiFiClientSecure espClient;
@@ -16,8 +29,14 @@ WiFiClientSecure espClient;
 WiFiClient espClient;
 #endif
 
-// Initalize the Mqtt client instance
-Arduino_MQTT_Client mqttClient(espClient);
+// Latency of every server-side RPC, from MQTT receive to the published response
+Latency_Stats latency_stats;
+
+// Responses of recently handled server-side RPC requests, answers duplicated deliveries
+RPC_Dedup_Cache rpc_dedup;
+
+// Initalize the Mqtt client instance, reports received and published topics to the latency statistics
+Instrumented_MQTT_Client mqttClient(espClient, latency_stats, rpc_dedup);
 
 // Actuator status global variables
 bool VMC_STATUS;	 // Status VMC
@@ -38,6 +57,37 @@ bool reconnect();
 /// @param data Data containing the shared attributes that were changed and their current value
 void processSharedAttributeUpdate(const JsonObjectConst& data);
 
+/// @brief Callback called with the shared attributes requested after connecting
+/// @param data Data containing the requested shared attributes and their current value
+void processSharedAttributeRequest(const JsonObjectConst& data);
+
+/// @brief Callback called when the relay schedule shared attribute was received,
+/// either because it changed or because it was requested after connecting
+/// @param data Data containing the relay schedule shared attribute
+void processRelayScheduleUpdate(const JsonObjectConst& data);
+
+/// @brief Callback called when the shared attributes request did not receive a response in time
+void sharedAttributeRequestTimedOut();
+
+/// @brief Resolves the relay key used in the schedule entries to its relay index
+/// @return Index of the relay or -1 if the key is unknown
+int getRelayIndex(const char* key);
+
+/// @brief Switches the relay with the given index, used by the schedule and local commands
+void setRelay(uint8_t relay, bool status);
+
+/// @brief Returns the current status of the relay with the given index
+bool getRelay(uint8_t relay);
+
+/// @brief Writes the relay pin and records its status in the attribute shadow,
+/// without logging it or reporting the GPIO write to the latency statistics
+void writeRelay(uint8_t relay, bool status);
+
+#if LOCAL_TRANSPORT_ENABLE
+/// @brief Handles every frame received from the other nodes on the local network since the last call
+void processLocalFrames();
+#endif
+
 /// @brief Process Light change RPC
 void processSwitchLightChange(const JsonVariantConst& data, JsonDocument& response);
 
@@ -62,19 +112,28 @@ void getSwitchHeater(const JsonVariantConst& data, JsonDocument& response);
 /// @brief Process AC status inquiry RPC
 void getSwitchAC(const JsonVariantConst& data, JsonDocument& response);
 
-/// @brief Set light pin value and publish it to Thingsboard server
+/// @brief Process RPC latency statistics inquiry RPC
+void getLatencyStats(const JsonVariantConst& data, JsonDocument& response);
+
+/// @brief Publishes the RPC latency statistics as diagnostics attribute if they changed since the last report
+void sendLatencyStats();
+
+/// @brief Publishes the client attributes changed since the last flush of the attribute shadow in one message
+bool sendClientAttributes(const Attribute* first, const Attribute* last);
+
+/// @brief Set light pin value and record it in the attribute shadow, sent with its next flush
 /// @return Returns true if pin is HIGH, false if LOW
 bool setLight(bool status);
 
-/// @brief Set VMC pin value and publish it to Thingsboard server
+/// @brief Set VMC pin value and record it in the attribute shadow, sent with its next flush
 /// @return Returns true if pin is HIGH, false if LOW
 bool setVMC(bool status);
 
-/// @brief Set heater pin value and publish it to Thingsboard server
+/// @brief Set heater pin value and record it in the attribute shadow, sent with its next flush
 /// @return Returns true if pin is HIGH, false if LOW
 bool setHeater(bool status);
 
-/// @brief Set AC pin value and publish it to Thingsboard server
+/// @brief Set AC pin value and record it in the attribute shadow, sent with its next flush
 /// @return Returns true if pin is HIGH, false if LOW
 bool setAC(bool status);
 
@@ -84,6 +143,39 @@ constexpr const char VMC_RELAY_KEY[]	= "VMC_RELAY";
 constexpr const char HEATER_RELAY_KEY[] = "HEATER_RELAY";
 constexpr const char AC_RELAY_KEY[]		= "AC_RELAY";
 constexpr const char VERSION_KEY[]		= "VERSION";
+constexpr const char RELAY_SCHEDULE_KEY[] = "relay_schedule";
+constexpr const char DESIRED_RELAYS_KEY[] = "desired_relays";
+
+// Index of every relay, in the same order as RELAY_KEYS
+enum Relay_Index : uint8_t
+{
+	LIGHT_RELAY_INDEX,
+	VMC_RELAY_INDEX,
+	HEATER_RELAY_INDEX,
+	AC_RELAY_INDEX,
+	RELAY_COUNT
+};
+constexpr std::array<const char*, RELAY_COUNT> RELAY_KEYS = { LIGHT_RELAY_KEY, VMC_RELAY_KEY,
+	HEATER_RELAY_KEY, AC_RELAY_KEY };
+constexpr std::array<uint8_t, RELAY_COUNT> RELAY_PINS = { LIGHT_PIN, VMC_PIN, HEATER_PIN, AC_PIN };
+const std::array<bool*, RELAY_COUNT> RELAY_STATUSES = { &LIGHT_STATUS, &VMC_STATUS, &HEATER_STATUS,
+	&AC_STATUS };
+
+// Client attributes tracked by the attribute shadow, relays use their relay index
+constexpr size_t VERSION_ATTRIBUTE_INDEX = RELAY_COUNT;
+constexpr std::array<const char*, RELAY_COUNT + 1U> CLIENT_ATTRIBUTE_KEYS = { LIGHT_RELAY_KEY,
+	VMC_RELAY_KEY, HEATER_RELAY_KEY, AC_RELAY_KEY, VERSION_KEY };
+
+// NVS namespace the published client attributes are persisted in
+constexpr char ATTRIBUTE_SHADOW_NAMESPACE[] = "attr_shadow";
+
+#if LOCAL_TRANSPORT_ENABLE
+static_assert(static_cast<uint8_t>(LIGHT_RELAY_INDEX) == LOCAL_RELAY_LIGHT
+		&& static_cast<uint8_t>(VMC_RELAY_INDEX) == LOCAL_RELAY_VMC
+		&& static_cast<uint8_t>(HEATER_RELAY_INDEX) == LOCAL_RELAY_HEATER
+		&& static_cast<uint8_t>(AC_RELAY_INDEX) == LOCAL_RELAY_AC,
+	"Relay indexes have to match the ones used in local command frames");
+#endif
 
 constexpr const char RPC_JSON_METHOD[]			   = "example_json";
 constexpr const char RPC_GET_LIGHT_SWITCH_METHOD[] = "get_light_switch";
@@ -102,11 +194,17 @@ constexpr const char RPC_GET_AC_SWITCH_METHOD[] = "get_ac_switch";
 constexpr const char RPC_SET_AC_SWITCH_METHOD[] = "set_ac_switch";
 constexpr const char RPC_AC_SWITCH_KEY[]		= "AC_RELAY";
 
+constexpr const char RPC_GET_LATENCY_STATS_METHOD[] = "get_latency_stats";
+constexpr const char RPC_LATENCY_KEY[]				= "rpc_latency";
+
+// Interval the RPC latency statistics are published as diagnostics attribute in
+constexpr unsigned long LATENCY_REPORT_INTERVAL_MS = 60U * 1000U;
+
 // Maximum size packets will ever be sent or received by the underlying MQTT client,
 // if the size is to small messages might not be sent or received messages will be discarded
-constexpr uint16_t MAX_MESSAGE_SEND_SIZE		= 128U;
-constexpr uint16_t MAX_MESSAGE_RECEIVE_SIZE		= 128U;
-constexpr uint8_t  MAX_RPC_SUBSCRIPTIONS		= 8U;
+constexpr uint16_t MAX_MESSAGE_SEND_SIZE		= 1024U;
+constexpr uint16_t MAX_MESSAGE_RECEIVE_SIZE		= 4096U;
+constexpr uint8_t  MAX_RPC_SUBSCRIPTIONS		= 9U;
 constexpr uint8_t  MAX_RPC_RESPONSE				= 16U;
 constexpr uint8_t  MAX_RPC_REQUEST				= 10U;
 constexpr uint64_t REQUEST_TIMEOUT_MICROSECONDS = 5000U * 1000U;
@@ -116,19 +214,49 @@ constexpr uint64_t REQUEST_TIMEOUT_MICROSECONDS = 5000U * 1000U;
 // of variables in the passed array. If it is less not all variables will be requested or subscribed
 constexpr size_t MAX_ATTRIBUTES = 3U;
 
+// Shared attributes the relay schedule is received with
+constexpr std::array<const char*, 1U> SCHEDULE_SHARED_ATTRIBUTES = { RELAY_SCHEDULE_KEY };
+
+// Shared attribute the desired relay states are received with, as {"LIGHT_RELAY":true,...}
+constexpr std::array<const char*, 1U> DESIRED_SHARED_ATTRIBUTES = { DESIRED_RELAYS_KEY };
+
+// Shared attributes requested after every (re)connect
+constexpr std::array<const char*, 2U> REQUESTED_SHARED_ATTRIBUTES = { RELAY_SCHEDULE_KEY,
+	DESIRED_RELAYS_KEY };
+
 // Initialize used apis
-Server_Side_RPC server_rpc;
-const std::array<IAPI_Implementation*, 1U> apis = { &server_rpc };
+Server_Side_RPC			  server_rpc;
+Shared_Attribute_Update<> shared_update;
+Attribute_Request<>		  attr_request;
+const std::array<IAPI_Implementation*, 3U> apis = { &server_rpc, &shared_update, &attr_request };
 
 // Initialize ThingsBoard instance with the maximum needed buffer size
-ThingsBoard tb(
-	mqttClient, MAX_MESSAGE_RECEIVE_SIZE, MAX_MESSAGE_SEND_SIZE);
+ThingsBoard tb(mqttClient, MAX_MESSAGE_RECEIVE_SIZE, MAX_MESSAGE_SEND_SIZE, Default_Max_Stack_Size,
+	Default_Max_Response_Size, apis.cbegin(), apis.cend());
+
+// Last published client attributes, changes are only sent once per loop and only if the value differs
+Attribute_Shadow attribute_shadow(CLIENT_ATTRIBUTE_KEYS.data(), CLIENT_ATTRIBUTE_KEYS.size(),
+	&sendClientAttributes);
+
+// Relay schedule, fired from a timer wheel driven by the SNTP synchronized wall time
+Relay_Schedule relay_schedule(&getRelayIndex, &setRelay);
+
+#if LOCAL_TRANSPORT_ENABLE
+// Direct link to the sensor nodes, works independently of the ThingsBoard server
+UDP_Local_Transport local_transport(IPAddress(LOCAL_MULTICAST_GROUP[0], LOCAL_MULTICAST_GROUP[1],
+										LOCAL_MULTICAST_GROUP[2], LOCAL_MULTICAST_GROUP[3]),
+	LOCAL_PORT, true);
+
+// Frames already handled, a recorded frame that is sent again is discarded instead of being applied twice
+Local_Replay_Filter local_replay_filter;
+#endif
 
 // Statuses for subscribing to shared attributes
 bool RPC_subscribed = false;
+bool shared_subscribed = false;
 
-// Initial client attributes sent
-bool init_att_published = false;
+// Shared attributes requested since the last connection to the ThingsBoard server
+bool shared_requested = false;
 
 void setup()
 {
@@ -156,12 +284,45 @@ void setup()
 		delay(500);
 	}
 
+#if ATTRIBUTE_SHADOW_PERSIST
+	// Restores the attributes published before the reboot, unchanged values are not sent again
+	attribute_shadow.begin_persistence(ATTRIBUTE_SHADOW_NAMESPACE);
+#endif
+	attribute_shadow.set(VERSION_ATTRIBUTE_INDEX, VERSION);
+	for (uint8_t relay = 0U; relay < RELAY_COUNT; relay++)
+	{
+		attribute_shadow.set(relay, getRelay(relay));
+	}
+
 	// Init Wifi connexion
 	InitWiFi();
+
+#if LOCAL_TRANSPORT_ENABLE
+	// Modem sleep delays received datagrams until the next DTIM beacon (~100ms),
+	// keep the radio awake so local commands are applied within a few milliseconds
+	WiFi.setSleep(false);
+	if (!local_transport.begin())
+	{
+#if SERIAL_DEBUG
+		Serial.println("Failed to start local transport");
+#endif
+	}
+#endif
+
+	// Start the SNTP client, the relay schedule only fires once the wall time is synchronized
+	configTzTime(TIME_ZONE, NTP_SERVER);
 }
 
 void loop()
 {
+	// Fire due schedule entries first, so switching stays on time even without a server connection
+	relay_schedule.loop();
+
+#if LOCAL_TRANSPORT_ENABLE
+	// Local frames are handled before anything that could block on the server connection
+	processLocalFrames();
+#endif
+
 	if (!reconnect())
 	{
 		return;
@@ -182,18 +343,7 @@ void loop()
 #endif
 			return;
 		}
-	}
-
-	// Send initial values
-	if (!init_att_published)
-	{
-		Serial.println("Sending device type attribute...");
-		tb.sendAttributeData(VERSION_KEY, VERSION);
-		tb.sendAttributeData(LIGHT_RELAY_KEY, LIGHT_STATUS);
-		tb.sendAttributeData(VMC_RELAY_KEY, VMC_STATUS);
-		tb.sendAttributeData(HEATER_RELAY_KEY, HEATER_STATUS);
-		tb.sendAttributeData(AC_RELAY_KEY, AC_STATUS);
-		init_att_published = true;
+		shared_requested = false;
 	}
 
 	if (!RPC_subscribed)
@@ -208,7 +358,8 @@ void loop()
 			{ RPC_GET_LIGHT_SWITCH_METHOD, getSwitchLight },
 			{ RPC_GET_VMC_SWITCH_METHOD, getSwitchVmc },
 			{ RPC_GET_HEATER_SWITCH_METHOD, getSwitchHeater },
-			{ RPC_GET_AC_SWITCH_METHOD, getSwitchAC }
+			{ RPC_GET_AC_SWITCH_METHOD, getSwitchAC },
+			{ RPC_GET_LATENCY_STATS_METHOD, getLatencyStats, LATENCY_STATS_JSON_SIZE }
 		};
 
 		if (!server_rpc.RPC_Subscribe(callbacks + 0U, callbacks + MAX_RPC_SUBSCRIPTIONS))
@@ -221,6 +372,53 @@ void loop()
 		RPC_subscribed = true;
 	}
 
+	if (!shared_subscribed)
+	{
+#if SERIAL_DEBUG
+		Serial.println("Subscribing for shared attribute updates...");
+#endif
+		const Shared_Attribute_Callback callbacks[2U] = {
+			{ &processRelayScheduleUpdate, SCHEDULE_SHARED_ATTRIBUTES.cbegin(),
+				SCHEDULE_SHARED_ATTRIBUTES.cend() },
+			{ &processSharedAttributeUpdate, DESIRED_SHARED_ATTRIBUTES.cbegin(),
+				DESIRED_SHARED_ATTRIBUTES.cend() }
+		};
+		if (!shared_update.Shared_Attributes_Subscribe(callbacks + 0U, callbacks + 2U))
+		{
+#if SERIAL_DEBUG
+			Serial.println("Failed to subscribe for shared attribute updates");
+#endif
+			return;
+		}
+		shared_subscribed = true;
+	}
+
+	// Shared attribute updates are only received while connected, request the current schedule and
+	// desired relay states after every (re)connect to catch up with changes made while the device was offline
+	if (!shared_requested)
+	{
+#if SERIAL_DEBUG
+		Serial.println("Requesting shared attributes...");
+#endif
+		const Attribute_Request_Callback callback(&processSharedAttributeRequest,
+			REQUEST_TIMEOUT_MICROSECONDS, &sharedAttributeRequestTimedOut,
+			REQUESTED_SHARED_ATTRIBUTES.cbegin(), REQUESTED_SHARED_ATTRIBUTES.cend());
+		shared_requested = attr_request.Shared_Attributes_Request(callback);
+#if SERIAL_DEBUG
+		if (!shared_requested)
+		{
+			Serial.println("Failed to request shared attributes");
+		}
+#endif
+	}
+
+	sendLatencyStats();
+
+	// Publishes every client attribute changed since the last loop in a single message,
+	// failed publishes are retried with the next loop
+	attribute_shadow.flush();
+
+	latency_stats.on_loop();
 	tb.loop();
 }
 
@@ -268,6 +466,7 @@ bool reconnect()
 /// @brief Process VMC change RPC
 void processSwitchVmcChange(const JsonVariantConst& data, JsonDocument& response)
 {
+	latency_stats.on_callback_entry(RPC_SET_VMC_SWITCH_METHOD);
 	Serial.println(">>> processSwitchVmcChange called!");
 	bool rcvSwitchStatus;
 	const int switch_state = data["enabled"];
@@ -279,6 +478,7 @@ void processSwitchVmcChange(const JsonVariantConst& data, JsonDocument& response
 /// @brief Process light status inquiry RPC
 void getSwitchLight(const JsonVariantConst& data, JsonDocument& response)
 {
+	latency_stats.on_callback_entry(RPC_GET_LIGHT_SWITCH_METHOD);
 #if SERIAL_DEBUG
 	Serial.println("Received the json RPC method");
 #endif
@@ -300,6 +500,7 @@ void getSwitchLight(const JsonVariantConst& data, JsonDocument& response)
 /// @brief Process heater change RPC
 void processSwitchHeaterChange(const JsonVariantConst& data, JsonDocument& response)
 {
+	latency_stats.on_callback_entry(RPC_SET_HEATER_SWITCH_METHOD);
 	bool rcvSwitchStatus;
 
 #if SERIAL_DEBUG
@@ -326,7 +527,7 @@ void processSwitchHeaterChange(const JsonVariantConst& data, JsonDocument& respo
 	setHeater(rcvSwitchStatus);
 }
 
-/// @brief Set heater pin value and publish it to Thingsboard server
+/// @brief Set heater pin value and record it in the attribute shadow, sent with its next flush
 /// @return Returns true if pin is HIGH, false if LOW
 bool setHeater(bool status)
 {
@@ -334,26 +535,13 @@ bool setHeater(bool status)
 	Serial.printf("Changing heater status to : %s\n", status ? "true" : "false");
 #endif
 	digitalWrite(HEATER_PIN, status);
+	latency_stats.on_gpio_write();
 	HEATER_STATUS = status;
-	if (!tb.connected())
-	{
-// Reconnect to the ThingsBoard server,
-// if a connection was disrupted or has not yet been established
-#if SERIAL_DEBUG
-		Serial.printf(CONNECTING_MSG, THINGSBOARD_SERVER, TOKEN);
-#endif
-		if (!tb.connect(THINGSBOARD_SERVER, TOKEN, THINGSBOARD_PORT))
-		{
-#if SERIAL_DEBUG
-			Serial.println("Failed to connect");
-#endif
-		}
-	}
-	tb.sendAttributeData(HEATER_RELAY_KEY, HEATER_STATUS);
+	attribute_shadow.set(HEATER_RELAY_INDEX, HEATER_STATUS);
 	return status;
 }
 
-/// @brief Set VMC pin value and publish it to Thingsboard server
+/// @brief Set VMC pin value and record it in the attribute shadow, sent with its next flush
 /// @return Returns true if pin is HIGH, false if LOW
 bool setVMC(bool status)
 {
@@ -361,28 +549,16 @@ bool setVMC(bool status)
 	Serial.printf("Changing VMC status to : %s\n", status ? "true" : "false");
 #endif
 	digitalWrite(VMC_PIN, status);
+	latency_stats.on_gpio_write();
 	VMC_STATUS = status;
-	if (!tb.connected())
-	{
-		// Reconnect to the ThingsBoard server,
-		// if a connection was disrupted or has not yet been established
-#if SERIAL_DEBUG
-		Serial.printf(CONNECTING_MSG, THINGSBOARD_SERVER, TOKEN);
-#endif
-		if (!tb.connect(THINGSBOARD_SERVER, TOKEN, THINGSBOARD_PORT))
-		{
-#if SERIAL_DEBUG
-			Serial.println("Failed to connect");
-#endif
-		}
-	}
-	tb.sendAttributeData(VMC_RELAY_KEY, VMC_STATUS);
+	attribute_shadow.set(VMC_RELAY_INDEX, VMC_STATUS);
 	return status;
 }
 
 /// @brief Process Light change RPC
 void processSwitchLightChange(const JsonVariantConst& data, JsonDocument& response)
 {
+	latency_stats.on_callback_entry(RPC_SET_LIGHT_SWITCH_METHOD);
 	Serial.println(">>> processSwitchLightChange called!");
 	bool rcvSwitchStatus;
 	const int switch_state = data["enabled"];
@@ -391,7 +567,7 @@ void processSwitchLightChange(const JsonVariantConst& data, JsonDocument& respon
 	setLight(rcvSwitchStatus);
 }
 
-/// @brief Set light pin value and publish it to Thingsboard server
+/// @brief Set light pin value and record it in the attribute shadow, sent with its next flush
 /// @return Returns true if pin is HIGH, false if LOW
 bool setLight(bool status)
 {
@@ -399,28 +575,16 @@ bool setLight(bool status)
 	Serial.printf("Changing light status to : %s\n", status ? "true" : "false");
 #endif
 	digitalWrite(LIGHT_PIN, status);
+	latency_stats.on_gpio_write();
 	LIGHT_STATUS = status;
-	if (!tb.connected())
-	{
-		// Reconnect to the ThingsBoard server,
-		// if a connection was disrupted or has not yet been established
-#if SERIAL_DEBUG
-		Serial.printf(CONNECTING_MSG, THINGSBOARD_SERVER, TOKEN);
-#endif
-		if (!tb.connect(THINGSBOARD_SERVER, TOKEN, THINGSBOARD_PORT))
-		{
-#if SERIAL_DEBUG
-			Serial.println("Failed to connect");
-#endif
-		}
-	}
-	tb.sendAttributeData(LIGHT_RELAY_KEY, LIGHT_STATUS);
+	attribute_shadow.set(LIGHT_RELAY_INDEX, LIGHT_STATUS);
 	return status;
 }
 
 /// @brief Process AC change RPC
 void processSwitchACChange(const JsonVariantConst& data, JsonDocument& response)
 {
+	latency_stats.on_callback_entry(RPC_SET_AC_SWITCH_METHOD);
 	bool rcvSwitchStatus;
 
 #if SERIAL_DEBUG
@@ -450,6 +614,7 @@ void processSwitchACChange(const JsonVariantConst& data, JsonDocument& response)
 /// @brief Process VMC status inquiry RPC
 void getSwitchVmc(const JsonVariantConst& data, JsonDocument& response)
 {
+	latency_stats.on_callback_entry(RPC_GET_VMC_SWITCH_METHOD);
 #if SERIAL_DEBUG
 	Serial.println("Received the get VMC switch method");
 #endif
@@ -471,6 +636,7 @@ void getSwitchVmc(const JsonVariantConst& data, JsonDocument& response)
 /// @brief Process heater status inquiry RPC
 void getSwitchHeater(const JsonVariantConst& data, JsonDocument& response)
 {
+	latency_stats.on_callback_entry(RPC_GET_HEATER_SWITCH_METHOD);
 #if SERIAL_DEBUG
 	Serial.println("Received the get heater switch method");
 #endif
@@ -492,6 +658,7 @@ void getSwitchHeater(const JsonVariantConst& data, JsonDocument& response)
 /// @brief Process AC status inquiry RPC
 void getSwitchAC(const JsonVariantConst& data, JsonDocument& response)
 {
+	latency_stats.on_callback_entry(RPC_GET_AC_SWITCH_METHOD);
 #if SERIAL_DEBUG
 	Serial.println("Received the get AC switch method");
 #endif
@@ -510,7 +677,7 @@ void getSwitchAC(const JsonVariantConst& data, JsonDocument& response)
 	response[AC_RELAY_KEY] = innerDoc;
 }
 
-/// @brief Set AC pin value and publish it to Thingsboard server
+/// @brief Set AC pin value and record it in the attribute shadow, sent with its next flush
 /// @return Returns true if pin is HIGH, false if LOW
 bool setAC(bool status)
 {
@@ -518,21 +685,211 @@ bool setAC(bool status)
 	Serial.printf("Changing AC status to : %s\n", status ? "true" : "false");
 #endif
 	digitalWrite(AC_PIN, status);
+	latency_stats.on_gpio_write();
 	AC_STATUS = status;
-	if (!tb.connected())
+	attribute_shadow.set(AC_RELAY_INDEX, AC_STATUS);
+	return status;
+}
+
+/// @brief Callback called when the relay schedule shared attribute was received,
+/// either because it changed or because it was requested after connecting
+/// @param data Data containing the relay schedule shared attribute
+void processRelayScheduleUpdate(const JsonObjectConst& data)
+{
+	if (!data.containsKey(RELAY_SCHEDULE_KEY))
 	{
-		// Reconnect to the ThingsBoard server,
-		// if a connection was disrupted or has not yet been established
+		return;
+	}
+	const size_t accepted = relay_schedule.load(data[RELAY_SCHEDULE_KEY].as<JsonArrayConst>());
 #if SERIAL_DEBUG
-		Serial.printf(CONNECTING_MSG, THINGSBOARD_SERVER, TOKEN);
+	Serial.printf("Relay schedule loaded with %u entries\n", accepted);
+#else
+	(void)accepted;
 #endif
-		if (!tb.connect(THINGSBOARD_SERVER, TOKEN, THINGSBOARD_PORT))
+}
+
+/// @brief Callback called when the shared attributes request did not receive a response in time
+void sharedAttributeRequestTimedOut()
+{
+#if SERIAL_DEBUG
+	Serial.printf("Shared attributes request timed out after (%llu) microseconds\n",
+		REQUEST_TIMEOUT_MICROSECONDS);
+#endif
+	// Retry with the next loop iteration
+	shared_requested = false;
+}
+
+/// @brief Resolves the relay key used in the schedule entries to its relay index
+/// @return Index of the relay or -1 if the key is unknown
+int getRelayIndex(const char* key)
+{
+	if (key == nullptr)
+	{
+		return -1;
+	}
+	for (size_t i = 0U; i < RELAY_KEYS.size(); i++)
+	{
+		if (strcmp(key, RELAY_KEYS[i]) == 0)
 		{
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+/// @brief Switches the relay with the given index, called by the schedule when an entry fires
+void setRelay(uint8_t relay, bool status)
+{
+	switch (relay)
+	{
+		case LIGHT_RELAY_INDEX:
+			setLight(status);
+			break;
+		case VMC_RELAY_INDEX:
+			setVMC(status);
+			break;
+		case HEATER_RELAY_INDEX:
+			setHeater(status);
+			break;
+		case AC_RELAY_INDEX:
+			setAC(status);
+			break;
+		default:
+			break;
+	}
+}
+
+/// @brief Returns the current status of the relay with the given index
+bool getRelay(uint8_t relay)
+{
+	if (relay >= RELAY_COUNT)
+	{
+		return false;
+	}
+	return *RELAY_STATUSES[relay];
+}
+
+/// @brief Writes the relay pin and records its status in the attribute shadow,
+/// without logging it or reporting the GPIO write to the latency statistics
+void writeRelay(uint8_t relay, bool status)
+{
+	if (relay >= RELAY_COUNT)
+	{
+		return;
+	}
+	digitalWrite(RELAY_PINS[relay], status);
+	*RELAY_STATUSES[relay] = status;
+	attribute_shadow.set(relay, status);
+}
+
+/// @brief Update callback that will be called as soon as one of the provided shared attributes
+/// changes value, if none are provided we subscribe to any shared attribute change instead
+/// @param data Data containing the shared attributes that were changed and their current value
+void processSharedAttributeUpdate(const JsonObjectConst& data)
+{
+	if (!data.containsKey(DESIRED_RELAYS_KEY))
+	{
+		return;
+	}
+
+	// Converge every relay contained in the desired state, relays that are not mentioned keep their state
+	const JsonObjectConst desired = data[DESIRED_RELAYS_KEY].as<JsonObjectConst>();
+	for (uint8_t relay = 0U; relay < RELAY_COUNT; relay++)
+	{
+		const JsonVariantConst value = desired[RELAY_KEYS[relay]];
+		if (value.isNull() || getRelay(relay) == value.as<bool>())
+		{
+			continue;
+		}
 #if SERIAL_DEBUG
-			Serial.println("Failed to connect");
+		Serial.printf("Desired %s : %s\n", RELAY_KEYS[relay], value.as<bool>() ? "true" : "false");
 #endif
+		writeRelay(relay, value.as<bool>());
+	}
+	// The applied state of the changed relays is reported by the attribute shadow with the next flush
+}
+
+/// @brief Callback called with the shared attributes requested after connecting
+/// @param data Data containing the requested shared attributes and their current value
+void processSharedAttributeRequest(const JsonObjectConst& data)
+{
+	processRelayScheduleUpdate(data);
+	processSharedAttributeUpdate(data);
+}
+
+#if LOCAL_TRANSPORT_ENABLE
+/// @brief Handles every frame received from the other nodes on the local network since the last call
+void processLocalFrames()
+{
+	uint8_t		buffer[LOCAL_FRAME_MAX_SIZE];
+	Local_Frame frame;
+	size_t		length;
+	while ((length = local_transport.receive(buffer, sizeof(buffer))) != 0U)
+	{
+		// Multicast datagrams can be looped back to the sender, ignore our own frames. The repeated copies
+		// of a command have the same sequence number and are discarded by the replay filter
+		if (!Local_Frame_Decode(buffer, length, LOCAL_KEY, frame) || frame.source == LOCAL_NODE_ID
+			|| !local_replay_filter.accept(frame.source, frame.sequence))
+		{
+			continue;
+		}
+		switch (frame.type)
+		{
+			case LOCAL_FRAME_COMMAND:
+				// Commands are repeated by the sender, only switch and publish on an actual change
+				if (frame.command.relay < RELAY_COUNT
+					&& getRelay(frame.command.relay) != frame.command.state)
+				{
+#if SERIAL_DEBUG
+					Serial.printf("Local command from node %u: %s -> %s\n", frame.source,
+						RELAY_KEYS[frame.command.relay], frame.command.state ? "true" : "false");
+#endif
+					setRelay(frame.command.relay, frame.command.state);
+				}
+				break;
+			case LOCAL_FRAME_SAMPLE:
+#if SERIAL_DEBUG
+				Serial.printf("Local sample from node %u (#%lu): %d.%02d C, alarms 0x%02x\n",
+					frame.source, static_cast<unsigned long>(frame.sequence),
+					frame.sample.temperature_centi / 100, abs(frame.sample.temperature_centi % 100),
+					frame.sample.alarms);
+#endif
+				break;
+			default:
+				break;
 		}
 	}
-	tb.sendAttributeData(AC_RELAY_KEY, AC_STATUS);
-	return status;
-}
\ No newline at end of file
+}
+#endif
+
+/// @brief Process RPC latency statistics inquiry RPC
+void getLatencyStats(const JsonVariantConst& data, JsonDocument& response)
+{
+	latency_stats.on_callback_entry(RPC_GET_LATENCY_STATS_METHOD);
+	latency_stats.serialize(response.to<JsonObject>());
+}
+
+/// @brief Publishes the RPC latency statistics as diagnostics attribute if they changed since the last report
+void sendLatencyStats()
+{
+	static unsigned long last_report = 0U;
+	if (millis() - last_report < LATENCY_REPORT_INTERVAL_MS)
+	{
+		return;
+	}
+	last_report = millis();
+	if (!latency_stats.take_changed())
+	{
+		return;
+	}
+
+	DynamicJsonDocument doc(JSON_OBJECT_SIZE(1U) + LATENCY_STATS_JSON_SIZE);
+	latency_stats.serialize(doc.createNestedObject(RPC_LATENCY_KEY));
+	tb.sendAttributeJson(doc, measureJson(doc));
+}
+
+/// @brief Publishes the client attributes changed since the last flush of the attribute shadow in one message
+bool sendClientAttributes(const Attribute* first, const Attribute* last)
+{
+	return tb.sendAttributes(first, last);
+}
@@ -0,0 +1,23 @@
+#ifndef Arduino_h
+#define Arduino_h
+
+// Host stand-in for the Arduino core used by the native test environment,
+// only provides what the libraries under test call when they are built without a framework
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Virtual time in microseconds returned by micros(), advanced by the tests instead of waiting
+inline unsigned long native_micros = 0U;
+
+inline unsigned long micros()
+{
+	return native_micros;
+}
+
+inline unsigned long millis()
+{
+	return native_micros / 1000U;
+}
+
+#endif // Arduino_h
@@ -0,0 +1,12 @@
+#ifndef Client_h
+#define Client_h
+
+// Host stand-in for the Arduino network client interface, the PubSubClient stand-in never uses it
+
+class Client
+{
+public:
+	virtual ~Client() = default;
+};
+
+#endif // Client_h
@@ -0,0 +1,176 @@
+#ifndef Fake_MQTT_Client_h
+#define Fake_MQTT_Client_h
+
+// IMQTT_Client implementation used by the native tests in place of a broker connection.
+// Published messages are recorded instead of sent and received messages are delivered with deliver()
+
+#include <IMQTT_Client.h>
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+class Fake_MQTT_Client : public IMQTT_Client
+{
+public:
+	/// @brief Message published by the ThingsBoard instance under test
+	struct Message
+	{
+		std::string			 topic;
+		std::vector<uint8_t> payload;
+	};
+
+	/// @brief Constructs the client
+	/// @param zero_copy Whether reserve_publish() is supported, otherwise every message is sent with publish()
+	explicit Fake_MQTT_Client(bool zero_copy = true)
+		: m_zero_copy(zero_copy)
+	{
+		// Nothing to do
+	}
+
+	void set_data_callback(Callback<void, char*, uint8_t*, unsigned int>::function callback) override
+	{
+		m_data_callback.Set_Callback(callback);
+	}
+
+	void set_connect_callback(Callback<void>::function callback) override
+	{
+		m_connect_callback.Set_Callback(callback);
+	}
+
+	bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override
+	{
+		m_receive_buffer.resize(receive_buffer_size);
+		m_send_buffer.resize(send_buffer_size);
+		return true;
+	}
+
+	uint16_t get_receive_buffer_size() override
+	{
+		return static_cast<uint16_t>(m_receive_buffer.size());
+	}
+
+	uint16_t get_send_buffer_size() override
+	{
+		return static_cast<uint16_t>(m_send_buffer.size());
+	}
+
+	void set_server(const char* domain, uint16_t port) override
+	{
+		(void)domain;
+		(void)port;
+	}
+
+	bool connect(const char* client_id, const char* user_name, const char* password) override
+	{
+		(void)client_id;
+		(void)user_name;
+		(void)password;
+		m_connected = true;
+		m_connect_callback.Call_Callback();
+		return true;
+	}
+
+	void disconnect() override
+	{
+		m_connected = false;
+	}
+
+	bool loop() override
+	{
+		return m_connected;
+	}
+
+	bool publish(const char* topic, const uint8_t* payload, const size_t& length) override
+	{
+		if (!m_connected || !fits(topic, length))
+		{
+			return false;
+		}
+		if (record)
+		{
+			published.push_back(Message{ topic, std::vector<uint8_t>(payload, payload + length) });
+		}
+		return true;
+	}
+
+	uint8_t* reserve_publish(const char* topic, const size_t& length) override
+	{
+		if (!m_zero_copy || !m_connected || !fits(topic, length))
+		{
+			return nullptr;
+		}
+		m_reserved_topic = topic;
+		return m_send_buffer.data() + PUBLISH_OVERHEAD + m_reserved_topic.size();
+	}
+
+	bool commit_publish(const size_t& length) override
+	{
+		return publish(
+			m_reserved_topic.c_str(), m_send_buffer.data() + PUBLISH_OVERHEAD + m_reserved_topic.size(), length);
+	}
+
+	bool subscribe(const char* topic) override
+	{
+		subscribed.push_back(topic);
+		return m_connected;
+	}
+
+	bool unsubscribe(const char* topic) override
+	{
+		(void)topic;
+		return m_connected;
+	}
+
+	bool connected() override
+	{
+		return m_connected;
+	}
+
+	/// @brief Delivers a message from the broker, like the receive loop of a real client.
+	/// Messages that do not fit into the receive buffer are dropped, like PubSubClient does
+	/// @param topic Topic the message is received on
+	/// @param payload Payload of the message
+	/// @param length Length of the payload
+	void deliver(const char* topic, const uint8_t* payload, size_t length)
+	{
+		if (length > m_receive_buffer.size())
+		{
+			return;
+		}
+		// The callback receives mutable copies, like the receive buffer of the real client
+		std::string topic_copy(topic);
+		memcpy(m_receive_buffer.data(), payload, length);
+		m_data_callback.Call_Callback(&topic_copy[0], m_receive_buffer.data(), static_cast<unsigned int>(length));
+	}
+
+	/// @brief Delivers a message with a null terminated payload from the broker
+	void deliver(const char* topic, const char* payload)
+	{
+		deliver(topic, reinterpret_cast<const uint8_t*>(payload), strlen(payload));
+	}
+
+	std::vector<Message>	 published;	 // Every message published since the client was constructed
+	std::vector<std::string> subscribed; // Every topic subscribed since the client was constructed
+	bool					 record = true; // Whether published messages are recorded, benchmarks disable it to only time the sender
+
+private:
+	// Bytes of the send buffer used by the fixed header, with the remaining length, and the length of the topic, like PubSubClient
+	static constexpr size_t PUBLISH_OVERHEAD = 7U;
+
+	/// @brief Whether a message with the given topic and payload length fits into the send buffer, together with the header
+	bool fits(const char* topic, size_t length) const
+	{
+		return PUBLISH_OVERHEAD + strlen(topic) + length <= m_send_buffer.size();
+	}
+
+	Callback<void, char*, uint8_t*, unsigned int> m_data_callback;
+	Callback<void>								  m_connect_callback;
+	bool										  m_zero_copy;
+	bool										  m_connected = false;
+	std::vector<uint8_t>						  m_receive_buffer;
+	std::vector<uint8_t>						  m_send_buffer;
+	std::string									  m_reserved_topic;
+};
+
+#endif // Fake_MQTT_Client_h
@@ -0,0 +1,170 @@
+#ifndef PubSubClient_h
+#define PubSubClient_h
+
+// Host stand-in for the PubSubClient used by Arduino_MQTT_Client, acts as the broker of the native tests.
+// Published messages are recorded instead of sent and received messages are delivered with deliver()
+
+#include "Client.h"
+
+#include <functional>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+// Bytes reserved for the fixed header of a packet, the length of the topic takes another 2 bytes
+#define MQTT_MAX_HEADER_SIZE 5
+
+class PubSubClient;
+
+// Last constructed instance, allows the tests to reach the instance kept private by Arduino_MQTT_Client
+inline PubSubClient* native_pubsub_client = nullptr;
+
+class PubSubClient
+{
+public:
+	/// @brief Message published by the client under test
+	struct Message
+	{
+		std::string			 topic;
+		std::vector<uint8_t> payload;
+	};
+
+	PubSubClient()
+	{
+		native_pubsub_client = this;
+	}
+
+	explicit PubSubClient(Client& client)
+	{
+		(void)client;
+		native_pubsub_client = this;
+	}
+
+	void setClient(Client& client)
+	{
+		(void)client;
+	}
+
+	void setCallback(std::function<void(char*, uint8_t*, unsigned int)> callback)
+	{
+		m_callback = callback;
+	}
+
+	bool setBufferSize(uint16_t receive_buffer_size, uint16_t send_buffer_size)
+	{
+		m_receive_buffer_size = receive_buffer_size;
+		m_send_buffer.resize(send_buffer_size);
+		return true;
+	}
+
+	uint16_t getReceiveBufferSize()
+	{
+		return m_receive_buffer_size;
+	}
+
+	uint16_t getSendBufferSize()
+	{
+		return static_cast<uint16_t>(m_send_buffer.size());
+	}
+
+	void setServer(const char* domain, uint16_t port)
+	{
+		(void)domain;
+		(void)port;
+	}
+
+	bool connect(const char* client_id, const char* user_name, const char* password)
+	{
+		(void)client_id;
+		(void)user_name;
+		(void)password;
+		m_connected = true;
+		return true;
+	}
+
+	void disconnect()
+	{
+		m_connected = false;
+	}
+
+	bool loop()
+	{
+		return m_connected;
+	}
+
+	bool publish(const char* topic, const uint8_t* payload, size_t length, bool retained)
+	{
+		(void)retained;
+		if (!m_connected || !fits(topic, length))
+		{
+			return false;
+		}
+		published.push_back(Message{ topic, std::vector<uint8_t>(payload, payload + length) });
+		return true;
+	}
+
+	uint8_t* reservePublish(const char* topic, size_t length)
+	{
+		if (!m_connected || !fits(topic, length))
+		{
+			return nullptr;
+		}
+		m_reserved_topic = topic;
+		return m_send_buffer.data() + MQTT_MAX_HEADER_SIZE + 2U + m_reserved_topic.size();
+	}
+
+	bool commitPublish(size_t length, bool retained)
+	{
+		return publish(m_reserved_topic.c_str(), m_send_buffer.data() + MQTT_MAX_HEADER_SIZE + 2U + m_reserved_topic.size(),
+			length, retained);
+	}
+
+	bool subscribe(const char* topic)
+	{
+		(void)topic;
+		return m_connected;
+	}
+
+	bool unsubscribe(const char* topic)
+	{
+		(void)topic;
+		return m_connected;
+	}
+
+	bool connected()
+	{
+		return m_connected;
+	}
+
+	/// @brief Delivers a message from the broker to the client under test, like loop() does for received packets
+	/// @param topic Topic the message is received on
+	/// @param payload Null terminated payload of the message
+	void deliver(const char* topic, const char* payload)
+	{
+		// The callback receives mutable copies, like the receive buffer of the real client
+		std::string			 topic_copy(topic);
+		std::vector<uint8_t> payload_copy(payload, payload + strlen(payload));
+		if (m_callback)
+		{
+			m_callback(&topic_copy[0], payload_copy.data(), static_cast<unsigned int>(payload_copy.size()));
+		}
+	}
+
+	std::vector<Message> published; // Every message published since the test started
+
+private:
+	/// @brief Whether a message with the given topic and payload length fits into the send buffer, together with the header, like the real client checks
+	bool fits(const char* topic, size_t length) const
+	{
+		return MQTT_MAX_HEADER_SIZE + 2U + strlen(topic) + length <= m_send_buffer.size();
+	}
+
+	std::function<void(char*, uint8_t*, unsigned int)> m_callback;
+	bool											   m_connected			 = false;
+	uint16_t										   m_receive_buffer_size = 0U;
+	std::vector<uint8_t>							   m_send_buffer;
+	std::string										   m_reserved_topic;
+};
+
+#endif // PubSubClient_h
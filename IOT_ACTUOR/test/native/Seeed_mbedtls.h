@@ -0,0 +1,107 @@
+#ifndef Seeed_mbedtls_h
+#define Seeed_mbedtls_h
+
+// Host stand-in for the mbedtls message digest API used by the HashGenerator of the ThingsBoard library.
+// The digest is an order sensitive 64 bit FNV-1a hash, which is enough to verify in tests that firmware data
+// was hashed completely and in order, it is not a cryptographic hash
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define MBEDTLS_MD_MAX_SIZE 64
+
+enum mbedtls_md_type_t
+{
+	MBEDTLS_MD_NONE,
+	MBEDTLS_MD_MD2,
+	MBEDTLS_MD_MD4,
+	MBEDTLS_MD_MD5,
+	MBEDTLS_MD_SHA1,
+	MBEDTLS_MD_SHA224,
+	MBEDTLS_MD_SHA256,
+	MBEDTLS_MD_SHA384,
+	MBEDTLS_MD_SHA512,
+	MBEDTLS_MD_RIPEMD160
+};
+
+struct mbedtls_md_info_t
+{
+	uint8_t size; // Size of the digest in bytes
+};
+
+struct mbedtls_md_context_t
+{
+	const mbedtls_md_info_t* md_info;
+	void*					 md_ctx;
+	void*					 hmac_ctx;
+	uint64_t				 state; // Running FNV-1a hash of the data passed to mbedtls_md_update()
+};
+
+inline const mbedtls_md_info_t* mbedtls_md_info_from_type(mbedtls_md_type_t type)
+{
+	static const mbedtls_md_info_t info_md5	   = { 16U };
+	static const mbedtls_md_info_t info_sha256 = { 32U };
+	static const mbedtls_md_info_t info_sha384 = { 48U };
+	static const mbedtls_md_info_t info_sha512 = { 64U };
+	switch (type)
+	{
+		case MBEDTLS_MD_MD5:
+			return &info_md5;
+		case MBEDTLS_MD_SHA256:
+			return &info_sha256;
+		case MBEDTLS_MD_SHA384:
+			return &info_sha384;
+		case MBEDTLS_MD_SHA512:
+			return &info_sha512;
+		default:
+			return nullptr;
+	}
+}
+
+inline void mbedtls_md_init(mbedtls_md_context_t* ctx)
+{
+	memset(ctx, 0, sizeof(*ctx));
+}
+
+inline void mbedtls_md_free(mbedtls_md_context_t* ctx)
+{
+	memset(ctx, 0, sizeof(*ctx));
+}
+
+inline int mbedtls_md_setup(mbedtls_md_context_t* ctx, const mbedtls_md_info_t* info, int)
+{
+	ctx->md_info = info;
+	return info != nullptr ? 0 : -1;
+}
+
+inline int mbedtls_md_starts(mbedtls_md_context_t* ctx)
+{
+	ctx->state = 14695981039346656037ULL;
+	return 0;
+}
+
+inline int mbedtls_md_update(mbedtls_md_context_t* ctx, const unsigned char* input, size_t length)
+{
+	for (size_t i = 0U; i < length; i++)
+	{
+		ctx->state = (ctx->state ^ input[i]) * 1099511628211ULL;
+	}
+	return 0;
+}
+
+inline int mbedtls_md_finish(mbedtls_md_context_t* ctx, unsigned char* output)
+{
+	if (ctx->md_info == nullptr)
+	{
+		return -1;
+	}
+	memset(output, 0, ctx->md_info->size);
+	for (size_t i = 0U; i < sizeof(ctx->state); i++)
+	{
+		output[i] = static_cast<unsigned char>(ctx->state >> (8U * i));
+	}
+	return 0;
+}
+
+#endif // Seeed_mbedtls_h
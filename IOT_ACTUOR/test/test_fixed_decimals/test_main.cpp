@@ -0,0 +1,175 @@
+#include <ThingsBoard.h>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <unity.h>
+
+// Amount of serializations timed per benchmark round, the fastest of the rounds is reported
+constexpr size_t BENCHMARK_ITERATIONS = 20000U;
+constexpr size_t BENCHMARK_ROUNDS	  = 5U;
+
+// Amount of random values compared per decimal places
+constexpr size_t RANDOM_VALUES = 2000U;
+
+// Measurements of a cycle of the sensor, with the precision policy of their keys
+constexpr auto	TEMPERATURE_KEY = Make_Json_Key("temperature", 2U);
+constexpr auto	HUMIDITY_KEY	= Make_Json_Key("humidity", 1U);
+constexpr auto	LUX_KEY			= Make_Json_Key("lux", 1U);
+constexpr auto	BATTERY_KEY		= Make_Json_Key("battery", 3U);
+constexpr float TEMPERATURE		= 23.4712f;
+constexpr float HUMIDITY		= 41.318f;
+constexpr float LUX				= 356.83f;
+constexpr float BATTERY			= 3.9117f;
+
+/// @brief Serializes the given batch into a string
+template <size_t MaxKeyValuePairAmount>
+static std::string serialize(const Telemetry_Batch<MaxKeyValuePairAmount>& batch)
+{
+	std::string json(batch.Measure_Json() + 1U, '\0');
+	json.resize(batch.Serialize_Json(&json[0], json.size()));
+	return json;
+}
+
+/// @brief Number written for the given value rounded to the given decimal places, without the surrounding object
+template <typename T>
+static std::string format(T value, uint8_t decimals)
+{
+	Telemetry_Batch<1U> batch;
+	TEST_ASSERT_TRUE(batch.Add("v", value, decimals));
+	const std::string json = serialize(batch);
+	// Strips {"v": and }
+	return json.substr(5U, json.size() - 6U);
+}
+
+/// @brief Checks the written number is the shortest form of the value rounded to the given decimal places
+template <typename T>
+static void check_number(T value, uint8_t decimals)
+{
+	const std::string number = format(value, decimals);
+	char			  message[96];
+	snprintf(message, sizeof(message), "%.9g with %u decimals written as %s", static_cast<double>(value),
+		static_cast<unsigned>(decimals), number.c_str());
+
+	const size_t point = number.find('.');
+	if (point != std::string::npos)
+	{
+		TEST_ASSERT_TRUE_MESSAGE(number.size() - point - 1U <= decimals, message);
+		TEST_ASSERT_TRUE_MESSAGE(number.back() != '0', message);
+	}
+	TEST_ASSERT_TRUE_MESSAGE(number != "-0", message);
+
+	// Rounding is done on the scaled value in the type of the value, which can be off by the precision of that type
+	const double unit	   = std::pow(10.0, -decimals);
+	const double tolerance = unit / 2.0 + std::fabs(static_cast<double>(value)) * 4.0 * std::numeric_limits<T>::epsilon();
+	TEST_ASSERT_TRUE_MESSAGE(std::fabs(std::strtod(number.c_str(), nullptr) - value) <= tolerance, message);
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_known_values()
+{
+	TEST_ASSERT_EQUAL_STRING("23.47", format(23.4712f, 2U).c_str());
+	TEST_ASSERT_EQUAL_STRING("41.3", format(41.3f, 1U).c_str());
+	TEST_ASSERT_EQUAL_STRING("3.912", format(3.9117f, 3U).c_str());
+	TEST_ASSERT_EQUAL_STRING("20", format(19.996, 2U).c_str());
+	TEST_ASSERT_EQUAL_STRING("-0.5", format(-0.4999, 3U).c_str());
+	TEST_ASSERT_EQUAL_STRING("0", format(-0.004, 2U).c_str());
+	TEST_ASSERT_EQUAL_STRING("-12", format(-12.4, 0U).c_str());
+	TEST_ASSERT_EQUAL_STRING("0.000000001", format(0.000000001, MAX_DECIMALS).c_str());
+	// Values that do not fit into 32 bits once scaled take the 64 bit path
+	TEST_ASSERT_EQUAL_STRING("123456789.12", format(123456789.123, 2U).c_str());
+	TEST_ASSERT_EQUAL_STRING("-123456789.12", format(-123456789.123, 2U).c_str());
+}
+
+static void test_fallback_to_default_formatting()
+{
+	// Not finite or too big to be scaled into 64 bits, written like without decimal places
+	TEST_ASSERT_EQUAL_STRING(format(1e30, 2U).c_str(), format(1e30, DEFAULT_DECIMALS).c_str());
+	TEST_ASSERT_EQUAL_STRING("null", format(std::numeric_limits<double>::quiet_NaN(), 2U).c_str());
+	TEST_ASSERT_EQUAL_STRING(format(1.5, MAX_DECIMALS + 1U).c_str(), format(1.5, DEFAULT_DECIMALS).c_str());
+}
+
+static void test_random_values()
+{
+	std::mt19937							  random(42U);
+	std::uniform_real_distribution<double>	  sensor_range(-50.0, 1000.0);
+	std::uniform_real_distribution<double>	  exponent(-6.0, 12.0);
+	for (uint8_t decimals = 0U; decimals <= 6U; decimals++)
+	{
+		for (size_t i = 0U; i < RANDOM_VALUES; i++)
+		{
+			check_number(static_cast<float>(sensor_range(random)), decimals);
+			const double magnitude = std::pow(10.0, exponent(random));
+			check_number((i % 2U) == 0U ? magnitude : -magnitude, decimals);
+		}
+	}
+}
+
+/// @brief Fastest time in nanoseconds measuring and serializing the given batch takes, like sendTelemetry() does
+template <size_t MaxKeyValuePairAmount>
+static double time_serialize(const Telemetry_Batch<MaxKeyValuePairAmount>& batch)
+{
+	char   json[256];
+	double fastest_ns = 0.0;
+	for (size_t round = 0U; round < BENCHMARK_ROUNDS; round++)
+	{
+		size_t	   total = 0U;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0U; i < BENCHMARK_ITERATIONS; i++)
+		{
+			total += batch.Measure_Json();
+			total += batch.Serialize_Json(json, sizeof(json));
+			// Keeps the compiler from hoisting the serialization out of the loop
+			asm volatile("" : "+r"(total) : : "memory");
+		}
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		TEST_ASSERT_TRUE(total != 0U);
+		const double serialize_ns = elapsed.count() / BENCHMARK_ITERATIONS;
+		fastest_ns				  = (round == 0U || serialize_ns < fastest_ns) ? serialize_ns : fastest_ns;
+	}
+	return fastest_ns;
+}
+
+static void test_benchmark_against_float_formatting()
+{
+	Telemetry_Batch<4U> formatted;
+	(void)formatted.Add("temperature", TEMPERATURE);
+	(void)formatted.Add("humidity", HUMIDITY);
+	(void)formatted.Add("lux", LUX);
+	(void)formatted.Add("battery", BATTERY);
+	Telemetry_Batch<4U> rounded;
+	(void)rounded.Add(TEMPERATURE_KEY, TEMPERATURE);
+	(void)rounded.Add(HUMIDITY_KEY, HUMIDITY);
+	(void)rounded.Add(LUX_KEY, LUX);
+	(void)rounded.Add(BATTERY_KEY, BATTERY);
+	TEST_ASSERT_EQUAL_STRING("{\"temperature\":23.47,\"humidity\":41.3,\"lux\":356.8,\"battery\":3.912}",
+		serialize(rounded).c_str());
+
+	const std::string formatted_json = serialize(formatted);
+	const std::string rounded_json	 = serialize(rounded);
+	char			  message[128];
+	snprintf(message, sizeof(message), "float formatting %3u bytes %5.0f ns, decimal places %3u bytes %5.0f ns",
+		static_cast<unsigned>(formatted_json.size()), time_serialize(formatted),
+		static_cast<unsigned>(rounded_json.size()), time_serialize(rounded));
+	TEST_MESSAGE(message);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_known_values);
+	RUN_TEST(test_fallback_to_default_formatting);
+	RUN_TEST(test_random_values);
+	RUN_TEST(test_benchmark_against_float_formatting);
+	return UNITY_END();
+}
@@ -0,0 +1,157 @@
+#include "Fake_MQTT_Client.h"
+
+#include <Gateway.h>
+#include <ThingsBoard.h>
+#include <array>
+#include <unity.h>
+
+// Topic gateway RPC requests are received and responded on
+constexpr char GATEWAY_RPC_TOPIC_NAME[] = "v1/gateway/rpc";
+
+// Amount of devices connected through the gateway in the test, every one subscribes the same two methods
+constexpr size_t DEVICE_COUNT = 16U;
+
+static char		   device_names[DEVICE_COUNT][12U];
+static std::string last_call;
+
+static void record_call(const char* method, const JsonVariantConst& data, JsonDocument& response)
+{
+	last_call = std::string(method) + ":" + data["device"].as<std::string>();
+	response["method"] = method;
+}
+
+static void read(const JsonVariantConst& data, JsonDocument& response)
+{
+	record_call("read", data, response);
+}
+
+static void write(const JsonVariantConst& data, JsonDocument& response)
+{
+	record_call("write", data, response);
+}
+
+static void dump(const JsonVariantConst& data, JsonDocument& response)
+{
+	(void)data;
+	last_call = "dump";
+	for (size_t i = 0U; i < 8U; i++)
+	{
+		response[device_names[i]] = i;
+	}
+}
+
+/// @brief ThingsBoard instance with a gateway, which subscribed read and write for every device and dump for the first one
+class Test_Gateway
+{
+public:
+	Test_Gateway()
+		: m_apis{ &m_gateway }
+		, m_tb(m_client, 512U, 512U, Default_Max_Stack_Size, Default_Max_Response_Size, m_apis.cbegin(),
+			  m_apis.cend())
+	{
+		TEST_ASSERT_TRUE(m_tb.connect("localhost", "token"));
+		for (size_t i = 0U; i < DEVICE_COUNT; i++)
+		{
+			const Gateway_RPC_Callback callbacks[2U] = { { device_names[i], "read", read, JSON_OBJECT_SIZE(1U) },
+				{ device_names[i], "write", write, JSON_OBJECT_SIZE(1U) } };
+			TEST_ASSERT_TRUE(m_gateway.Gateway_RPC_Subscribe(callbacks + 0U, callbacks + 2U));
+		}
+		TEST_ASSERT_TRUE(m_gateway.Gateway_RPC_Subscribe(
+			Gateway_RPC_Callback(device_names[0U], "dump", dump, JSON_OBJECT_SIZE(1U))));
+	}
+
+	/// @brief Delivers the given request and returns the response published for it, fails if not exactly one was published
+	std::string request(const char* payload)
+	{
+		last_call.clear();
+		m_client.published.clear();
+		m_client.deliver(GATEWAY_RPC_TOPIC_NAME, payload);
+		(void)m_tb.loop();
+		TEST_ASSERT_EQUAL_UINT32(1U, m_client.published.size());
+		TEST_ASSERT_EQUAL_STRING(GATEWAY_RPC_TOPIC_NAME, m_client.published[0U].topic.c_str());
+		return std::string(m_client.published[0U].payload.begin(), m_client.published[0U].payload.end());
+	}
+
+	Gateway<>& gateway()
+	{
+		return m_gateway;
+	}
+
+private:
+	Fake_MQTT_Client					 m_client;
+	Gateway<>							 m_gateway;
+	std::array<IAPI_Implementation*, 1U> m_apis;
+	ThingsBoard							 m_tb;
+};
+
+void setUp()
+{
+	for (size_t i = 0U; i < DEVICE_COUNT; i++)
+	{
+		snprintf(device_names[i], sizeof(device_names[i]), "Device %u", static_cast<unsigned>(i));
+	}
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_request_routed_by_device_and_method()
+{
+	Test_Gateway gateway;
+	TEST_ASSERT_EQUAL_STRING("{\"device\":\"Device 7\",\"id\":3,\"data\":{\"method\":\"write\"}}",
+		gateway
+			.request("{\"device\":\"Device 7\",\"data\":{\"id\":3,\"method\":\"write\",\"params\":{\"device\":\"7\"}}}")
+			.c_str());
+	TEST_ASSERT_EQUAL_STRING("write:7", last_call.c_str());
+
+	for (size_t i = 0U; i < DEVICE_COUNT; i++)
+	{
+		char payload[128];
+		snprintf(payload, sizeof(payload), "{\"device\":\"%s\",\"data\":{\"id\":%u,\"method\":\"read\",\"params\":{\"device\":\"%u\"}}}",
+			device_names[i], static_cast<unsigned>(i), static_cast<unsigned>(i));
+		(void)gateway.request(payload);
+		TEST_ASSERT_EQUAL_STRING(("read:" + std::to_string(i)).c_str(), last_call.c_str());
+	}
+}
+
+static void test_unknown_request_answered_with_error()
+{
+	Test_Gateway gateway;
+
+	// Method only subscribed for another device
+	TEST_ASSERT_EQUAL_STRING("{\"device\":\"Device 1\",\"id\":4,\"data\":{\"error\":\"Method not found\"}}",
+		gateway.request("{\"device\":\"Device 1\",\"data\":{\"id\":4,\"method\":\"dump\"}}").c_str());
+	// Device that never subscribed anything and request without method
+	TEST_ASSERT_EQUAL_STRING("{\"device\":\"Other\",\"id\":5,\"data\":{\"error\":\"Method not found\"}}",
+		gateway.request("{\"device\":\"Other\",\"data\":{\"id\":5,\"method\":\"read\"}}").c_str());
+	TEST_ASSERT_EQUAL_STRING("{\"device\":\"Device 1\",\"id\":6,\"data\":{\"error\":\"Method not found\"}}",
+		gateway.request("{\"device\":\"Device 1\",\"data\":{\"id\":6}}").c_str());
+	// Same characters split differently between device name and method name
+	TEST_ASSERT_EQUAL_STRING("{\"device\":\"Device 1r\",\"id\":7,\"data\":{\"error\":\"Method not found\"}}",
+		gateway.request("{\"device\":\"Device 1r\",\"data\":{\"id\":7,\"method\":\"ead\"}}").c_str());
+	TEST_ASSERT_TRUE(last_call.empty());
+
+	// Once unsubscribed every request is unknown
+	TEST_ASSERT_TRUE(gateway.gateway().Gateway_RPC_Unsubscribe());
+	TEST_ASSERT_EQUAL_STRING("{\"device\":\"Device 0\",\"id\":8,\"data\":{\"error\":\"Method not found\"}}",
+		gateway.request("{\"device\":\"Device 0\",\"data\":{\"id\":8,\"method\":\"read\"}}").c_str());
+}
+
+static void test_overflowed_response_answered_with_error()
+{
+	Test_Gateway gateway;
+	TEST_ASSERT_EQUAL_STRING("{\"device\":\"Device 0\",\"id\":9,\"data\":{\"error\":\"Response overflowed\"}}",
+		gateway.request("{\"device\":\"Device 0\",\"data\":{\"id\":9,\"method\":\"dump\"}}").c_str());
+	TEST_ASSERT_EQUAL_STRING("dump", last_call.c_str());
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_request_routed_by_device_and_method);
+	RUN_TEST(test_unknown_request_answered_with_error);
+	RUN_TEST(test_overflowed_response_answered_with_error);
+	return UNITY_END();
+}
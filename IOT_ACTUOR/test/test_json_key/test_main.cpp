@@ -0,0 +1,155 @@
+#include <ThingsBoard.h>
+#include <chrono>
+#include <string>
+#include <unity.h>
+
+// Amount of serializations timed per benchmark round, the fastest of the rounds is reported
+constexpr size_t BENCHMARK_ITERATIONS = 20000U;
+constexpr size_t BENCHMARK_ROUNDS	  = 5U;
+
+// Keys that need every escape ArduinoJson writes
+constexpr auto QUOTE_KEY	 = Make_Json_Key("say \"hi\"");
+constexpr auto BACKSLASH_KEY = Make_Json_Key("C:\\dir");
+constexpr auto CONTROL_KEY	 = Make_Json_Key("a\bb\fc\nd\re\tf");
+constexpr auto UTF8_KEY		 = Make_Json_Key("température");
+
+static_assert(QUOTE_KEY.Length() == sizeof("\"say \\\"hi\\\"\":") - 1U, "Fragment is built at compile time");
+
+// Keys of the benchmark, short ones like the sensor uses and long ones where copying them matters more
+constexpr auto VOC_KEY				 = Make_Json_Key("voc");
+constexpr auto LUX_KEY				 = Make_Json_Key("lux");
+constexpr auto HUMIDITY_KEY			 = Make_Json_Key("humidity");
+constexpr auto TEMPERATURE_KEY		 = Make_Json_Key("temperature");
+constexpr auto HIGH_THRESHOLD_KEY	 = Make_Json_Key("temperature_alarm_high_threshold");
+constexpr auto LOW_THRESHOLD_KEY	 = Make_Json_Key("temperature_alarm_low_threshold");
+constexpr auto HYSTERESIS_KEY		 = Make_Json_Key("temperature_alarm_hysteresis");
+constexpr auto CALIBRATION_KEY		 = Make_Json_Key("temperature_sensor_calibration");
+
+/// @brief Serializes the given batch into a string
+template <size_t MaxKeyValuePairAmount>
+static std::string serialize(const Telemetry_Batch<MaxKeyValuePairAmount>& batch)
+{
+	std::string json(batch.Measure_Json() + 1U, '\0');
+	json.resize(batch.Serialize_Json(&json[0], json.size()));
+	return json;
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_fragment_matches_arduinojson_escaping()
+{
+	Telemetry_Batch<4U> escaped;
+	TEST_ASSERT_TRUE(escaped.Add(QUOTE_KEY, 1));
+	TEST_ASSERT_TRUE(escaped.Add(BACKSLASH_KEY, 2));
+	TEST_ASSERT_TRUE(escaped.Add(CONTROL_KEY, 3));
+	TEST_ASSERT_TRUE(escaped.Add(UTF8_KEY, 4));
+
+	StaticJsonDocument<256U> document;
+	document["say \"hi\""]			  = 1;
+	document["C:\\dir"]				  = 2;
+	document["a\bb\fc\nd\re\tf"]	  = 3;
+	document["température"]			  = 4;
+	std::string expected;
+	serializeJson(document, expected);
+
+	TEST_ASSERT_EQUAL_STRING(expected.c_str(), serialize(escaped).c_str());
+	TEST_ASSERT_EQUAL_STRING("\"say \\\"hi\\\"\":", QUOTE_KEY.Fragment());
+	TEST_ASSERT_EQUAL_STRING("\"a\\bb\\fc\\nd\\re\\tf\":", CONTROL_KEY.Fragment());
+}
+
+static void test_plain_and_escaped_keys_are_identical()
+{
+	Telemetry_Batch<3U> plain;
+	TEST_ASSERT_TRUE(plain.Add("temperature", 23.5f));
+	TEST_ASSERT_TRUE(plain.Add("C:\\dir", true));
+	TEST_ASSERT_TRUE(plain.Add("voc", "high"));
+	Telemetry_Batch<3U> escaped;
+	TEST_ASSERT_TRUE(escaped.Add(TEMPERATURE_KEY, 23.5f));
+	TEST_ASSERT_TRUE(escaped.Add(BACKSLASH_KEY, true));
+	TEST_ASSERT_TRUE(escaped.Add(VOC_KEY, "high"));
+	TEST_ASSERT_EQUAL_STRING(serialize(plain).c_str(), serialize(escaped).c_str());
+}
+
+/// @brief Fastest time in nanoseconds measuring and serializing the given batch takes, like sendTelemetry() does
+template <size_t MaxKeyValuePairAmount>
+static double time_serialize(const Telemetry_Batch<MaxKeyValuePairAmount>& batch)
+{
+	char   json[512];
+	double fastest_ns = 0.0;
+	for (size_t round = 0U; round < BENCHMARK_ROUNDS; round++)
+	{
+		size_t	   total = 0U;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0U; i < BENCHMARK_ITERATIONS; i++)
+		{
+			total += batch.Measure_Json();
+			total += batch.Serialize_Json(json, sizeof(json));
+			// Keeps the compiler from hoisting the serialization out of the loop
+			asm volatile("" : "+r"(total) : : "memory");
+		}
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		TEST_ASSERT_TRUE(total != 0U);
+		const double serialize_ns = elapsed.count() / BENCHMARK_ITERATIONS;
+		fastest_ns				  = (round == 0U || serialize_ns < fastest_ns) ? serialize_ns : fastest_ns;
+	}
+	return fastest_ns;
+}
+
+/// @brief Times the given batches with plain and pre-escaped keys, which have to serialize identically, and reports the time per key
+template <size_t MaxKeyValuePairAmount>
+static void compare(const char* name, const Telemetry_Batch<MaxKeyValuePairAmount>& plain,
+	const Telemetry_Batch<MaxKeyValuePairAmount>& escaped)
+{
+	TEST_ASSERT_EQUAL_STRING(serialize(plain).c_str(), serialize(escaped).c_str());
+	const double plain_ns	= time_serialize(plain) / plain.Size();
+	const double escaped_ns = time_serialize(escaped) / escaped.Size();
+	char		 message[128];
+	snprintf(message, sizeof(message), "%-11s plain key %5.1f ns per key, Json_Key %5.1f ns per key", name, plain_ns,
+		escaped_ns);
+	TEST_MESSAGE(message);
+}
+
+static void test_benchmark_against_plain_keys()
+{
+	// Integer values, so the time of the keys is not hidden behind float formatting
+	Telemetry_Batch<4U> short_plain;
+	(void)short_plain.Add("voc", 112);
+	(void)short_plain.Add("lux", 356);
+	(void)short_plain.Add("humidity", 41);
+	(void)short_plain.Add("temperature", 23);
+	Telemetry_Batch<4U> short_escaped;
+	(void)short_escaped.Add(VOC_KEY, 112);
+	(void)short_escaped.Add(LUX_KEY, 356);
+	(void)short_escaped.Add(HUMIDITY_KEY, 41);
+	(void)short_escaped.Add(TEMPERATURE_KEY, 23);
+	compare("short keys", short_plain, short_escaped);
+
+	Telemetry_Batch<4U> long_plain;
+	(void)long_plain.Add("temperature_alarm_high_threshold", 30);
+	(void)long_plain.Add("temperature_alarm_low_threshold", 15);
+	(void)long_plain.Add("temperature_alarm_hysteresis", 1);
+	(void)long_plain.Add("temperature_sensor_calibration", 0);
+	Telemetry_Batch<4U> long_escaped;
+	(void)long_escaped.Add(HIGH_THRESHOLD_KEY, 30);
+	(void)long_escaped.Add(LOW_THRESHOLD_KEY, 15);
+	(void)long_escaped.Add(HYSTERESIS_KEY, 1);
+	(void)long_escaped.Add(CALIBRATION_KEY, 0);
+	compare("long keys", long_plain, long_escaped);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_fragment_matches_arduinojson_escaping);
+	RUN_TEST(test_plain_and_escaped_keys_are_identical);
+	RUN_TEST(test_benchmark_against_plain_keys);
+	return UNITY_END();
+}
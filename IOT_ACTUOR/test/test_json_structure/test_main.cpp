@@ -0,0 +1,227 @@
+#include "Fake_MQTT_Client.h"
+
+#include <Helper.h>
+#include <Shared_Attribute_Update.h>
+#include <ThingsBoard.h>
+#include <array>
+#include <chrono>
+#include <random>
+#include <unity.h>
+
+// Nesting limit of the tests, the one onMQTTMessage() passes
+constexpr size_t MAX_NESTING = ARDUINOJSON_DEFAULT_NESTING_LIMIT;
+
+// Amount of random payloads compared with the reference per alignment
+constexpr size_t RANDOM_PAYLOADS = 20000U;
+
+// Amount of bytes counted per benchmark run
+constexpr size_t BENCHMARK_BYTES = 64U * 1024U * 1024U;
+
+/// @brief Result of counting the structure of a payload
+struct Structure
+{
+	bool   within_limit;
+	size_t element_count;
+};
+
+/// @brief Byte by byte reference of Helper::countJsonElements(), brackets inside of strings are not nesting
+static Structure reference_count(const uint8_t* bytes, size_t length, size_t max_nesting)
+{
+	size_t count	 = 0U;
+	size_t depth	 = 0U;
+	bool   in_string = false;
+	bool   escaped	 = false;
+	for (size_t i = 0U; i < length; i++)
+	{
+		const uint8_t symbol = bytes[i];
+		if (symbol == ',' || symbol == '{' || symbol == '[')
+		{
+			count++;
+		}
+		if (escaped)
+		{
+			escaped = false;
+		}
+		else if (in_string)
+		{
+			escaped	  = symbol == '\\';
+			in_string = symbol != '"';
+		}
+		else if (symbol == '"')
+		{
+			in_string = true;
+		}
+		else if (symbol == '{' || symbol == '[')
+		{
+			if (++depth > max_nesting)
+			{
+				return Structure{ false, 0U };
+			}
+		}
+		else if ((symbol == '}' || symbol == ']') && depth != 0U)
+		{
+			depth--;
+		}
+	}
+	return Structure{ true, count };
+}
+
+static Structure count(const uint8_t* bytes, size_t length, size_t max_nesting)
+{
+	Structure structure = { false, 0U };
+	structure.within_limit =
+		Helper::countJsonElements(bytes, static_cast<unsigned int>(length), max_nesting, structure.element_count);
+	return structure;
+}
+
+static Structure count(const std::string& payload)
+{
+	return count(reinterpret_cast<const uint8_t*>(payload.data()), payload.size(), MAX_NESTING);
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_brackets_inside_strings_are_not_nesting()
+{
+	const std::string deep = "{\"k\":" + std::string(MAX_NESTING, '[') + std::string(MAX_NESTING, ']') + "}";
+	TEST_ASSERT_FALSE(count(deep).within_limit);
+
+	// Long enough to be scanned a word at a time
+	const std::string brackets(4U * MAX_NESTING, '[');
+	TEST_ASSERT_TRUE(count("{\"k\":\"" + brackets + "\"}").within_limit);
+	TEST_ASSERT_TRUE(count("{\"" + brackets + "\":1,\"v\":\"{{{{{{{{{{{{{{{{{{{{\"}").within_limit);
+
+	// Escaped quotes and backslashes do not end the string
+	TEST_ASSERT_TRUE(count("{\"k\":\"\\\"" + brackets + "\\\\\\\"" + brackets + "\"}").within_limit);
+	TEST_ASSERT_FALSE(count("{\"k\":\"\\\\\"," + std::string(MAX_NESTING, '[') + "}").within_limit);
+
+	// Symbols inside of strings are still counted, which only overestimates the size
+	TEST_ASSERT_EQUAL_UINT32(1U + brackets.size(), count("{\"k\":\"" + brackets + "\"}").element_count);
+}
+
+static void test_matches_reference_at_every_alignment()
+{
+	// Mostly symbols the scan looks at, so that strings, escapes and brackets cross word boundaries often
+	static const char ALPHABET[] = "{}[],\"\\\\\"aaaa";
+	std::mt19937	  random(41U);
+	uint8_t			  buffer[256U + sizeof(size_t)];
+	for (size_t alignment = 0U; alignment < sizeof(size_t); alignment++)
+	{
+		for (size_t i = 0U; i < RANDOM_PAYLOADS; i++)
+		{
+			const size_t length = random() % 256U;
+			for (size_t j = 0U; j < length; j++)
+			{
+				buffer[alignment + j] = ALPHABET[random() % (sizeof(ALPHABET) - 1U)];
+			}
+			const size_t	max_nesting = random() % 12U;
+			const Structure expected	= reference_count(buffer + alignment, length, max_nesting);
+			const Structure actual		= count(buffer + alignment, length, max_nesting);
+			TEST_ASSERT_EQUAL(expected.within_limit, actual.within_limit);
+			if (expected.within_limit)
+			{
+				TEST_ASSERT_EQUAL_UINT32(expected.element_count, actual.element_count);
+			}
+		}
+	}
+}
+
+static size_t updates = 0U;
+
+static void on_update(const JsonObjectConst& data)
+{
+	(void)data;
+	updates++;
+}
+
+static void test_valid_payload_with_brackets_is_processed()
+{
+	Fake_MQTT_Client						   client;
+	Shared_Attribute_Update<>				   shared_update;
+	const std::array<IAPI_Implementation*, 1U> apis = { &shared_update };
+	ThingsBoard tb(client, 512U, 512U, Default_Max_Stack_Size, Default_Max_Response_Size, apis.cbegin(), apis.cend());
+	TEST_ASSERT_TRUE(tb.connect("localhost", "token"));
+	const Shared_Attribute_Callback callback(on_update);
+	TEST_ASSERT_TRUE(shared_update.Shared_Attributes_Subscribe(callback));
+
+	updates = 0U;
+	client.deliver("v1/devices/me/attributes", "{\"schedule\":\"[[[[[[[[[[[[[[[[[[[[[[[[\"}");
+	TEST_ASSERT_EQUAL_UINT32(1U, updates);
+	client.deliver("v1/devices/me/attributes", ("{\"k\":" + std::string(2U * MAX_NESTING, '[') + "}").c_str());
+	TEST_ASSERT_EQUAL_UINT32(1U, updates);
+}
+
+/// @brief Attribute update of atmost the given size, with a string value every few numbers
+static std::string benchmark_payload(size_t size)
+{
+	std::string payload = "{";
+	for (size_t i = 0U;; i++)
+	{
+		const std::string pair = (i == 0U ? "\"key" : ",\"key") + std::to_string(i) +
+								 ((i % 4U) == 0U ? "\":\"text\"" : "\":1234");
+		if (payload.size() + pair.size() + 1U > size)
+		{
+			return payload + "}";
+		}
+		payload += pair;
+	}
+}
+
+/// @brief Average time in nanoseconds the given counting takes for the given payload
+template <typename Counter>
+static double time_count(const std::string& payload, Counter counter)
+{
+	const uint8_t* bytes	  = reinterpret_cast<const uint8_t*>(payload.data());
+	const size_t   iterations = BENCHMARK_BYTES / payload.size();
+	size_t		   total	  = 0U;
+	const auto	   start	  = std::chrono::steady_clock::now();
+	for (size_t i = 0U; i < iterations; i++)
+	{
+		total += counter(bytes, static_cast<unsigned int>(payload.size()));
+		// Keeps the compiler from hoisting the count out of the loop
+		asm volatile("" : "+r"(total) : : "memory");
+	}
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	TEST_ASSERT_TRUE(total != 0U);
+	return elapsed.count() / iterations;
+}
+
+static void test_benchmark_against_getOccurences()
+{
+	for (const size_t size : { 32U, 256U, 2048U, 16384U })
+	{
+		const std::string payload = benchmark_payload(size);
+		const double	  occurences_ns = time_count(payload, [](const uint8_t* bytes, unsigned int length) {
+			 return Helper::getOccurences(bytes, ',', length) + Helper::getOccurences(bytes, '{', length) +
+					Helper::getOccurences(bytes, '[', length);
+		 });
+		const double	  scan_ns		= time_count(payload, [](const uint8_t* bytes, unsigned int length) {
+			 size_t element_count = 0U;
+			 (void)Helper::countJsonElements(bytes, length, MAX_NESTING, element_count);
+			 return element_count;
+		 });
+
+		char message[96];
+		snprintf(message, sizeof(message), "%5u bytes: getOccurences x3 %.0f ns, countJsonElements %.0f ns",
+			static_cast<unsigned>(payload.size()), occurences_ns, scan_ns);
+		TEST_MESSAGE(message);
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_brackets_inside_strings_are_not_nesting);
+	RUN_TEST(test_matches_reference_at_every_alignment);
+	RUN_TEST(test_valid_payload_with_brackets_is_processed);
+	RUN_TEST(test_benchmark_against_getOccurences);
+	return UNITY_END();
+}
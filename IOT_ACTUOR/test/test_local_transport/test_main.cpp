@@ -0,0 +1,227 @@
+#include "Local_Frame.h"
+#include "Loopback_Local_Transport.h"
+
+#include <chrono>
+#include <unity.h>
+
+// Key shared by the nodes of the test, the other key stands for a node of another installation
+constexpr Local_Key TEST_KEY	 = { { 0x00U, 0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U, 0x07U, 0x08U,
+	0x09U, 0x0AU, 0x0BU, 0x0CU, 0x0DU, 0x0EU, 0x0FU } };
+constexpr Local_Key OTHER_KEY = { { 0x00U, 0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U, 0x07U, 0x08U,
+	0x09U, 0x0AU, 0x0BU, 0x0CU, 0x0DU, 0x0EU, 0x8FU } };
+
+// Node ids of the sensor and actuator (LOCAL_NODE_ID in their config.h)
+constexpr uint16_t SENSOR_NODE_ID	= 1U;
+constexpr uint16_t ACTUATOR_NODE_ID = 2U;
+
+// Budget of the local control path, from encoding the command on the sensor to the relay index on the actuator
+constexpr std::chrono::microseconds CONTROL_PATH_BUDGET(10000);
+
+static Loopback_Local_Transport sensor;
+static Loopback_Local_Transport actuator;
+
+void setUp()
+{
+	sensor	 = Loopback_Local_Transport();
+	actuator = Loopback_Local_Transport();
+	sensor.connect(actuator);
+	TEST_ASSERT_TRUE(sensor.begin());
+	TEST_ASSERT_TRUE(actuator.begin());
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+/// @brief Sends a command frame from the sensor
+static void send_command(uint8_t relay, bool state, uint32_t sequence)
+{
+	uint8_t		 buffer[LOCAL_FRAME_MAX_SIZE];
+	const size_t length = Local_Frame_Encode_Command(Local_Command{ relay, state }, sequence,
+		SENSOR_NODE_ID, TEST_KEY, buffer, sizeof(buffer));
+	TEST_ASSERT_EQUAL_UINT32(LOCAL_COMMAND_FRAME_SIZE, length);
+	TEST_ASSERT_TRUE(sensor.send(buffer, length));
+}
+
+static void test_sample_round_trip()
+{
+	Local_Sample sample;
+	sample.temperature_centi = -1234;
+	sample.humidity_centi	 = 5678U;
+	sample.voc				 = 321U;
+	sample.lux_centi		 = 4000000U;
+	sample.battery_millivolt = 3712U;
+	sample.alarms			 = LOCAL_ALARM_TEMP_LOW | LOCAL_ALARM_BATTERY;
+
+	uint8_t		 buffer[LOCAL_FRAME_MAX_SIZE];
+	const size_t length = Local_Frame_Encode_Sample(sample, 0x01020304U, SENSOR_NODE_ID, TEST_KEY,
+		buffer, sizeof(buffer));
+	TEST_ASSERT_EQUAL_UINT32(LOCAL_SAMPLE_FRAME_SIZE, length);
+	TEST_ASSERT_TRUE(sensor.send(buffer, length));
+
+	Local_Frame frame;
+	TEST_ASSERT_EQUAL_UINT32(length, actuator.receive(buffer, sizeof(buffer)));
+	TEST_ASSERT_TRUE(Local_Frame_Decode(buffer, length, TEST_KEY, frame));
+	TEST_ASSERT_EQUAL(LOCAL_FRAME_SAMPLE, frame.type);
+	TEST_ASSERT_EQUAL_UINT32(0x01020304U, frame.sequence);
+	TEST_ASSERT_EQUAL_UINT16(SENSOR_NODE_ID, frame.source);
+	TEST_ASSERT_EQUAL_INT16(-1234, frame.sample.temperature_centi);
+	TEST_ASSERT_EQUAL_UINT16(5678U, frame.sample.humidity_centi);
+	TEST_ASSERT_EQUAL_UINT16(321U, frame.sample.voc);
+	TEST_ASSERT_EQUAL_UINT32(4000000U, frame.sample.lux_centi);
+	TEST_ASSERT_EQUAL_UINT16(3712U, frame.sample.battery_millivolt);
+	TEST_ASSERT_EQUAL_UINT8(LOCAL_ALARM_TEMP_LOW | LOCAL_ALARM_BATTERY, frame.sample.alarms);
+	TEST_ASSERT_EQUAL_UINT32(0U, actuator.receive(buffer, sizeof(buffer)));
+}
+
+static void test_command_round_trip()
+{
+	send_command(LOCAL_RELAY_HEATER, true, 7U);
+
+	uint8_t		buffer[LOCAL_FRAME_MAX_SIZE];
+	Local_Frame frame;
+	const size_t length = actuator.receive(buffer, sizeof(buffer));
+	TEST_ASSERT_TRUE(Local_Frame_Decode(buffer, length, TEST_KEY, frame));
+	TEST_ASSERT_EQUAL(LOCAL_FRAME_COMMAND, frame.type);
+	TEST_ASSERT_EQUAL_UINT32(7U, frame.sequence);
+	TEST_ASSERT_EQUAL_UINT8(LOCAL_RELAY_HEATER, frame.command.relay);
+	TEST_ASSERT_TRUE(frame.command.state);
+}
+
+static void test_tampered_frames_rejected()
+{
+	uint8_t		 frame_bytes[LOCAL_FRAME_MAX_SIZE];
+	const size_t length = Local_Frame_Encode_Command(Local_Command{ LOCAL_RELAY_AC, true }, 42U,
+		SENSOR_NODE_ID, TEST_KEY, frame_bytes, sizeof(frame_bytes));
+
+	// Flipping any bit of the header, the payload or the tag invalidates the frame
+	Local_Frame frame;
+	for (size_t i = 0U; i < length; i++)
+	{
+		for (uint8_t bit = 0U; bit < 8U; bit++)
+		{
+			uint8_t tampered[LOCAL_FRAME_MAX_SIZE];
+			memcpy(tampered, frame_bytes, length);
+			tampered[i] ^= static_cast<uint8_t>(1U << bit);
+			TEST_ASSERT_FALSE(Local_Frame_Decode(tampered, length, TEST_KEY, frame));
+		}
+	}
+
+	// Frames tagged with another key, truncated or extended frames are rejected as well
+	TEST_ASSERT_FALSE(Local_Frame_Decode(frame_bytes, length, OTHER_KEY, frame));
+	TEST_ASSERT_FALSE(Local_Frame_Decode(frame_bytes, length - 1U, TEST_KEY, frame));
+	TEST_ASSERT_FALSE(Local_Frame_Decode(frame_bytes, length + 1U, TEST_KEY, frame));
+	TEST_ASSERT_FALSE(Local_Frame_Decode(nullptr, length, TEST_KEY, frame));
+	TEST_ASSERT_TRUE(Local_Frame_Decode(frame_bytes, length, TEST_KEY, frame));
+}
+
+static void test_replayed_frames_rejected()
+{
+	Local_Replay_Filter filter;
+
+	// Repeated copies of the same frame are only accepted once
+	TEST_ASSERT_TRUE(filter.accept(SENSOR_NODE_ID, 100U));
+	TEST_ASSERT_FALSE(filter.accept(SENSOR_NODE_ID, 100U));
+	TEST_ASSERT_FALSE(filter.accept(SENSOR_NODE_ID, 100U));
+
+	// Reordered frames within the window are accepted once, older ones are rejected
+	TEST_ASSERT_TRUE(filter.accept(SENSOR_NODE_ID, 105U));
+	TEST_ASSERT_TRUE(filter.accept(SENSOR_NODE_ID, 103U));
+	TEST_ASSERT_FALSE(filter.accept(SENSOR_NODE_ID, 103U));
+	TEST_ASSERT_TRUE(filter.accept(SENSOR_NODE_ID, 101U));
+	TEST_ASSERT_FALSE(filter.accept(SENSOR_NODE_ID, 100U));
+	TEST_ASSERT_FALSE(filter.accept(SENSOR_NODE_ID, 105U - LOCAL_REPLAY_WINDOW - 1U));
+
+	// Jumping exactly one window keeps the previous newest frame marked, a bigger jump forgets every older frame
+	TEST_ASSERT_TRUE(filter.accept(SENSOR_NODE_ID, 105U + LOCAL_REPLAY_WINDOW));
+	TEST_ASSERT_FALSE(filter.accept(SENSOR_NODE_ID, 105U));
+	TEST_ASSERT_TRUE(filter.accept(SENSOR_NODE_ID, 1000U));
+	TEST_ASSERT_TRUE(filter.accept(SENSOR_NODE_ID, 999U));
+	TEST_ASSERT_FALSE(filter.accept(SENSOR_NODE_ID, 1000U - LOCAL_REPLAY_WINDOW - 1U));
+
+	// Every source is tracked on its own, sources past LOCAL_REPLAY_SOURCES are rejected
+	for (uint16_t source = 0U; source < LOCAL_REPLAY_SOURCES; source++)
+	{
+		if (source != SENSOR_NODE_ID)
+		{
+			TEST_ASSERT_TRUE(filter.accept(source, 100U));
+		}
+	}
+	TEST_ASSERT_FALSE(filter.accept(LOCAL_REPLAY_SOURCES, 100U));
+}
+
+static void test_command_applied_once_within_budget()
+{
+	// Sensor side of the control path, the command is repeated because datagrams are not acknowledged
+	constexpr uint8_t COMMAND_REPEAT = 3U;
+	bool			  relays[4U]	 = {};
+	size_t			  switches		 = 0U;
+	Local_Replay_Filter filter;
+
+	const auto start = std::chrono::steady_clock::now();
+	uint8_t	   buffer[LOCAL_FRAME_MAX_SIZE];
+	const size_t length = Local_Frame_Encode_Command(Local_Command{ LOCAL_RELAY_VMC, true }, 1U,
+		SENSOR_NODE_ID, TEST_KEY, buffer, sizeof(buffer));
+	for (uint8_t i = 0U; i < COMMAND_REPEAT; i++)
+	{
+		TEST_ASSERT_TRUE(sensor.send(buffer, length));
+	}
+
+	// Actuator side, mirrors processLocalFrames()
+	Local_Frame frame;
+	size_t		received;
+	while ((received = actuator.receive(buffer, sizeof(buffer))) != 0U)
+	{
+		if (!Local_Frame_Decode(buffer, received, TEST_KEY, frame) || frame.source == ACTUATOR_NODE_ID
+			|| !filter.accept(frame.source, frame.sequence))
+		{
+			continue;
+		}
+		if (frame.type == LOCAL_FRAME_COMMAND && frame.command.relay < 4U
+			&& relays[frame.command.relay] != frame.command.state)
+		{
+			relays[frame.command.relay] = frame.command.state;
+			switches++;
+		}
+	}
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	TEST_ASSERT_TRUE(relays[LOCAL_RELAY_VMC]);
+	TEST_ASSERT_EQUAL_UINT32(1U, switches);
+	TEST_ASSERT_TRUE(elapsed < CONTROL_PATH_BUDGET);
+}
+
+static void test_full_queue_drops_frames()
+{
+	uint8_t buffer[LOCAL_FRAME_MAX_SIZE];
+	for (uint32_t i = 0U; i < LOOPBACK_QUEUE_SIZE; i++)
+	{
+		send_command(LOCAL_RELAY_LIGHT, true, i);
+	}
+	const size_t length = Local_Frame_Encode_Command(Local_Command{ LOCAL_RELAY_LIGHT, false },
+		LOOPBACK_QUEUE_SIZE, SENSOR_NODE_ID, TEST_KEY, buffer, sizeof(buffer));
+	TEST_ASSERT_FALSE(sensor.send(buffer, length));
+
+	// The queued frames are received in the order they were sent
+	Local_Frame frame;
+	for (uint32_t i = 0U; i < LOOPBACK_QUEUE_SIZE; i++)
+	{
+		const size_t received = actuator.receive(buffer, sizeof(buffer));
+		TEST_ASSERT_TRUE(Local_Frame_Decode(buffer, received, TEST_KEY, frame));
+		TEST_ASSERT_EQUAL_UINT32(i, frame.sequence);
+	}
+	TEST_ASSERT_EQUAL_UINT32(0U, actuator.receive(buffer, sizeof(buffer)));
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_sample_round_trip);
+	RUN_TEST(test_command_round_trip);
+	RUN_TEST(test_tampered_frames_rejected);
+	RUN_TEST(test_replayed_frames_rejected);
+	RUN_TEST(test_command_applied_once_within_budget);
+	RUN_TEST(test_full_queue_drops_frames);
+	return UNITY_END();
+}
@@ -0,0 +1,429 @@
+#include <HashGenerator.h>
+#include <OTA_Handler.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <random>
+#include <unity.h>
+#include <vector>
+
+// Size of the firmware and the chunks of the deterministic tests, the last chunk is only partially filled
+constexpr size_t SMALL_FIRMWARE_SIZE = 10U * 64U + 17U;
+constexpr size_t SMALL_CHUNK_SIZE	 = 64U;
+constexpr size_t SMALL_CHUNK_COUNT	 = SMALL_FIRMWARE_SIZE / SMALL_CHUNK_SIZE + 1U;
+
+// Timeout of a single chunk request
+constexpr uint64_t CHUNK_TIMEOUT = 1000U * 1000U;
+
+// Size of the firmware and the chunks of the simulated downloads
+constexpr size_t SIM_FIRMWARE_SIZE = 1000000U;
+constexpr size_t SIM_CHUNK_SIZE	   = 4096U;
+
+// Time a chunk takes to be sent over the simulated 1 Mbit/s downlink
+constexpr unsigned long SIM_TRANSMIT_TIME = SIM_CHUNK_SIZE * 8U;
+
+/// @brief Logger that discards every message, the tests deliver unexpected chunks on purpose
+struct Quiet_Logger
+{
+	template <typename... Args>
+	static int printfln(const char* format, Args...)
+	{
+		(void)format;
+		return 0;
+	}
+};
+
+/// @brief Byte of the firmware image at the given offset
+static uint8_t firmware_byte(size_t offset)
+{
+	return static_cast<uint8_t>((offset * 2654435761U) >> 13U);
+}
+
+/// @brief Updater that checks every written byte against the firmware image instead of flashing it
+class Checking_Updater : public IUpdater
+{
+public:
+	bool begin(const size_t& firmware_size) override
+	{
+		(void)firmware_size;
+		written = 0U;
+		valid	= true;
+		return true;
+	}
+
+	size_t write(uint8_t* payload, const size_t& total_bytes) override
+	{
+		for (size_t i = 0U; i < total_bytes; i++)
+		{
+			valid &= payload[i] == firmware_byte(written + i);
+		}
+		written += total_bytes;
+		return total_bytes;
+	}
+
+	void reset() override
+	{
+		written = 0U;
+	}
+
+	bool end() override
+	{
+		return valid;
+	}
+
+	size_t written = 0U; // Amount of bytes written since the update was started
+	bool   valid   = true; // Whether every written byte matched the firmware image
+};
+
+/// @brief Over the air update of the firmware image, with the requested chunks recorded and delivered by the test
+class Ota_Session
+{
+public:
+	Ota_Session(size_t firmware_size, size_t chunk_size, uint8_t window)
+		: m_firmware_size(firmware_size)
+		, m_chunk_size(chunk_size)
+		, m_callback("title", "version", &m_updater, std::bind(&Ota_Session::finished, this, std::placeholders::_1),
+			  nullptr, nullptr, 12U, static_cast<uint16_t>(chunk_size), CHUNK_TIMEOUT, window)
+		, m_handler(std::bind(&Ota_Session::request, this, std::placeholders::_1, std::placeholders::_2),
+			  [](const char* const, const char* const) { return true; }, []() { return true; })
+		, m_chunk(chunk_size)
+	{
+		// Nothing to do
+	}
+
+	/// @brief Starts the update with the checksum of the firmware image
+	void start()
+	{
+		HashGenerator hash;
+		(void)hash.start(MBEDTLS_MD_SHA256);
+		for (size_t offset = 0U; offset < m_firmware_size; offset++)
+		{
+			const uint8_t value = firmware_byte(offset);
+			(void)hash.update(&value, 1U);
+		}
+		char checksum[FIRMWARE_HASH_SIZE] = {};
+		(void)hash.finish(checksum);
+		m_handler.Start_Firmware_Update(m_callback, m_firmware_size, checksum, MBEDTLS_MD_SHA256);
+	}
+
+	/// @brief Delivers the response to the request of the given chunk
+	void deliver(size_t chunk)
+	{
+		const size_t offset = chunk * m_chunk_size;
+		const size_t size	= std::min(m_chunk_size, m_firmware_size - offset);
+		for (size_t i = 0U; i < size; i++)
+		{
+			m_chunk[i] = firmware_byte(offset + i);
+		}
+		m_handler.Process_Firmware_Packet(chunk, m_chunk.data(), size);
+	}
+
+	/// @brief Advances the virtual clock and handles every timeout that expired
+	static void advance(unsigned long microseconds)
+	{
+		native_micros += microseconds;
+		Timeout_Wheel::Get_Instance().tick();
+	}
+
+	/// @brief Whether the update finished and every byte of the image was written in order and verified by the checksum
+	bool succeeded() const
+	{
+		return done && success && m_updater.valid && m_updater.written == m_firmware_size;
+	}
+
+	/// @brief Written bytes, received chunks that were not written in order yet are not included
+	size_t written() const
+	{
+		return m_updater.written;
+	}
+
+	std::vector<size_t>						   requests;		   // Every requested chunk in request order
+	std::function<void(size_t, unsigned long)> on_request = nullptr; // Network model called with every requested chunk and the time of the request
+	bool									   done		  = false;
+	bool									   success	  = false;
+
+private:
+	bool request(const size_t& request_id, const size_t& chunk)
+	{
+		(void)request_id;
+		requests.push_back(chunk);
+		if (on_request)
+		{
+			on_request(chunk, native_micros);
+		}
+		return true;
+	}
+
+	void finished(const bool& result)
+	{
+		done	= true;
+		success = result;
+	}
+
+	size_t						 m_firmware_size;
+	size_t						 m_chunk_size;
+	Checking_Updater			 m_updater;
+	OTA_Update_Callback			 m_callback;
+	OTA_Handler<Quiet_Logger>	 m_handler;
+	std::vector<uint8_t>		 m_chunk;
+};
+
+/// @brief Amount of requests for the given chunk
+static size_t request_count(const Ota_Session& session, size_t chunk)
+{
+	return static_cast<size_t>(std::count(session.requests.begin(), session.requests.end(), chunk));
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_window_requested_at_once()
+{
+	Ota_Session session(SMALL_FIRMWARE_SIZE, SMALL_CHUNK_SIZE, 4U);
+	session.start();
+	TEST_ASSERT_EQUAL_UINT32(4U, session.requests.size());
+	for (size_t chunk = 0U; chunk < 4U; chunk++)
+	{
+		TEST_ASSERT_EQUAL_UINT32(chunk, session.requests[chunk]);
+	}
+
+	// Every written chunk frees a place in the window for the next one
+	session.deliver(0U);
+	TEST_ASSERT_EQUAL_UINT32(5U, session.requests.size());
+	TEST_ASSERT_EQUAL_UINT32(4U, session.requests.back());
+	for (size_t chunk = 1U; chunk < SMALL_CHUNK_COUNT; chunk++)
+	{
+		session.deliver(chunk);
+	}
+	TEST_ASSERT_TRUE(session.succeeded());
+	TEST_ASSERT_EQUAL_UINT32(SMALL_CHUNK_COUNT, session.requests.size());
+}
+
+static void test_reordered_chunks()
+{
+	Ota_Session session(SMALL_FIRMWARE_SIZE, SMALL_CHUNK_SIZE, 4U);
+	session.start();
+
+	// Chunks ahead of the next one in order are buffered and only written once the gap is filled
+	session.deliver(3U);
+	session.deliver(1U);
+	session.deliver(2U);
+	TEST_ASSERT_EQUAL_UINT32(0U, session.written());
+	TEST_ASSERT_EQUAL_UINT32(4U, session.requests.size());
+	session.deliver(0U);
+	TEST_ASSERT_EQUAL_UINT32(4U * SMALL_CHUNK_SIZE, session.written());
+	TEST_ASSERT_EQUAL_UINT32(8U, session.requests.size());
+
+	// Completely reversed window, including the partially filled last chunk
+	for (size_t chunk = 7U; chunk >= 4U; chunk--)
+	{
+		session.deliver(chunk);
+	}
+	for (size_t chunk = SMALL_CHUNK_COUNT - 1U; chunk >= 8U; chunk--)
+	{
+		session.deliver(chunk);
+	}
+	TEST_ASSERT_TRUE(session.succeeded());
+}
+
+static void test_duplicate_chunks()
+{
+	Ota_Session session(SMALL_FIRMWARE_SIZE, SMALL_CHUNK_SIZE, 4U);
+	session.start();
+
+	// Duplicates of a buffered chunk are discarded and do not take a second buffer
+	session.deliver(2U);
+	session.deliver(2U);
+	session.deliver(3U);
+	session.deliver(1U);
+	session.deliver(1U);
+	TEST_ASSERT_EQUAL_UINT32(0U, session.written());
+
+	// Duplicates of written chunks are discarded as well
+	session.deliver(0U);
+	session.deliver(0U);
+	session.deliver(3U);
+	TEST_ASSERT_EQUAL_UINT32(4U * SMALL_CHUNK_SIZE, session.written());
+	for (size_t chunk = 4U; chunk < SMALL_CHUNK_COUNT; chunk++)
+	{
+		session.deliver(chunk);
+		session.deliver(chunk);
+	}
+	TEST_ASSERT_TRUE(session.succeeded());
+}
+
+static void test_stale_and_unrequested_chunks()
+{
+	Ota_Session session(SMALL_FIRMWARE_SIZE, SMALL_CHUNK_SIZE, 4U);
+	session.start();
+
+	// Chunks behind the window were already written and chunks past the window were not requested yet
+	session.deliver(4U);
+	session.deliver(SMALL_CHUNK_COUNT + 3U);
+	TEST_ASSERT_EQUAL_UINT32(0U, session.written());
+	session.deliver(0U);
+	session.deliver(1U);
+	session.deliver(0U);
+	TEST_ASSERT_EQUAL_UINT32(2U * SMALL_CHUNK_SIZE, session.written());
+
+	// The discarded chunks are requested and written like every other chunk, once they are part of the window
+	for (size_t chunk = 2U; chunk < SMALL_CHUNK_COUNT; chunk++)
+	{
+		session.deliver(chunk);
+	}
+	TEST_ASSERT_TRUE(session.succeeded());
+
+	// Responses that arrive after the update finished are discarded
+	session.deliver(SMALL_CHUNK_COUNT - 1U);
+	TEST_ASSERT_TRUE(session.succeeded());
+}
+
+static void test_only_missing_chunks_requested_again()
+{
+	Ota_Session session(SMALL_FIRMWARE_SIZE, SMALL_CHUNK_SIZE, 4U);
+	session.start();
+	session.deliver(0U);
+	session.deliver(2U);
+	session.deliver(4U);
+	TEST_ASSERT_EQUAL_UINT32(5U, session.requests.size());
+
+	// Chunk 1 and 3 timed out, the received chunks 2 and 4 are not requested again
+	Ota_Session::advance(CHUNK_TIMEOUT / 2U);
+	TEST_ASSERT_EQUAL_UINT32(5U, session.requests.size());
+	Ota_Session::advance(CHUNK_TIMEOUT / 2U + (1U << TIMEOUT_WHEEL_TICK_BITS));
+	TEST_ASSERT_EQUAL_UINT32(7U, session.requests.size());
+	TEST_ASSERT_EQUAL_UINT32(2U, request_count(session, 1U));
+	TEST_ASSERT_EQUAL_UINT32(2U, request_count(session, 3U));
+	TEST_ASSERT_EQUAL_UINT32(1U, request_count(session, 2U));
+	TEST_ASSERT_EQUAL_UINT32(1U, request_count(session, 4U));
+
+	// The late response to the first request is used, the response to the second request is then a duplicate
+	session.deliver(1U);
+	session.deliver(3U);
+	TEST_ASSERT_EQUAL_UINT32(5U * SMALL_CHUNK_SIZE, session.written());
+	session.deliver(1U);
+	session.deliver(3U);
+	for (size_t chunk = 5U; chunk < SMALL_CHUNK_COUNT; chunk++)
+	{
+		session.deliver(chunk);
+	}
+	TEST_ASSERT_TRUE(session.succeeded());
+}
+
+/// @brief Result of a simulated download
+struct Download
+{
+	double seconds;	 // Time from the start of the update until it finished
+	size_t requests; // Amount of chunk requests, including requests of chunks that timed out
+	bool   success;	 // Whether the image was written completely and the checksum matched
+};
+
+/// @brief Downloads the firmware over a simulated network with the given round trip time, jitter and loss of requests or responses.
+/// Responses share a 1 Mbit/s downlink, so they queue behind each other once the window is big enough to fill the link
+static Download simulate(uint8_t window, double loss, unsigned long rtt, unsigned long jitter, unsigned seed)
+{
+	struct Response
+	{
+		unsigned long arrival;
+		size_t		  chunk;
+
+		bool operator>(const Response& other) const
+		{
+			return arrival > other.arrival;
+		}
+	};
+
+	std::mt19937														   random(seed);
+	std::uniform_real_distribution<double>								   uniform(0.0, 1.0);
+	std::priority_queue<Response, std::vector<Response>, std::greater<Response>> network;
+	unsigned long														   link_busy = 0U;
+
+	Ota_Session session(SIM_FIRMWARE_SIZE, SIM_CHUNK_SIZE, window);
+	session.on_request = [&](size_t chunk, unsigned long now) {
+		if (uniform(random) < loss)
+		{
+			return;
+		}
+		const unsigned long sent = std::max(link_busy, now + rtt / 2U);
+		link_busy				 = sent + SIM_TRANSMIT_TIME;
+		network.push(Response{ link_busy + rtt / 2U + static_cast<unsigned long>(uniform(random) * jitter), chunk });
+	};
+
+	const unsigned long begin = native_micros;
+	session.start();
+	while (!session.done)
+	{
+		Ota_Session::advance(1000U);
+		while (!session.done && !network.empty() && network.top().arrival <= native_micros)
+		{
+			const size_t chunk = network.top().chunk;
+			network.pop();
+			session.deliver(chunk);
+		}
+	}
+	return Download{ (native_micros - begin) / 1e6, session.requests.size(), session.succeeded() };
+}
+
+static void test_simulated_download()
+{
+	char message[128];
+	TEST_MESSAGE("1 MB firmware, 4 KiB chunks, 1 Mbit/s downlink, 1 s chunk timeout");
+	for (const unsigned long rtt : { 50000UL, 200000UL })
+	{
+		for (const double loss : { 0.0, 0.02, 0.05 })
+		{
+			int length = snprintf(message, sizeof(message), "rtt %3lu ms loss %2.0f%%:", rtt / 1000U, loss * 100.0);
+			double window_1_seconds = 0.0;
+			for (const uint8_t window : { 1U, 2U, 4U, 8U, 16U })
+			{
+				const Download download = simulate(window, loss, rtt, rtt / 2U, 7U);
+				TEST_ASSERT_TRUE(download.success);
+				length += snprintf(message + length, sizeof(message) - length, "  w%-2u %6.1fs", window, download.seconds);
+				if (window == 1U)
+				{
+					window_1_seconds = download.seconds;
+				}
+				else
+				{
+					TEST_ASSERT_TRUE(download.seconds < window_1_seconds);
+				}
+			}
+			TEST_MESSAGE(message);
+		}
+	}
+}
+
+static void test_simulated_late_responses()
+{
+	// Responses slower than the timeout result in duplicates of the chunks that were requested again
+	char message[128];
+	for (const uint8_t window : { 1U, 4U, 16U })
+	{
+		const Download download = simulate(window, 0.05, 200000U, 1500000U, 3U);
+		TEST_ASSERT_TRUE(download.success);
+		TEST_ASSERT_TRUE(download.requests > SIM_FIRMWARE_SIZE / SIM_CHUNK_SIZE + 1U);
+		snprintf(message, sizeof(message), "late responses w%-2u %6.1fs %u requests", window, download.seconds,
+			static_cast<unsigned>(download.requests));
+		TEST_MESSAGE(message);
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_window_requested_at_once);
+	RUN_TEST(test_reordered_chunks);
+	RUN_TEST(test_duplicate_chunks);
+	RUN_TEST(test_stale_and_unrequested_chunks);
+	RUN_TEST(test_only_missing_chunks_requested_again);
+	RUN_TEST(test_simulated_download);
+	RUN_TEST(test_simulated_late_responses);
+	return UNITY_END();
+}
@@ -0,0 +1,189 @@
+#include <Pending_Request_Map.h>
+#include <random>
+#include <unity.h>
+#include <unordered_map>
+
+// Amount of requests waiting on a response at the same time in the stress test
+constexpr size_t IN_FLIGHT = 5000U;
+
+// Timeouts of the test, the first four get a timeout list each and the fifth one shares the first list
+constexpr uint64_t TIMEOUTS[] = { 1000000U, 2000000U, 3000000U, 4000000U, 2500000U };
+
+// Amount of microseconds the virtual clock is advanced by between checking for timed out requests
+constexpr unsigned long CLOCK_STEP = 10000U;
+
+// Request ids are parsed as signed 32-bit integers by the server
+constexpr size_t MAX_REQUEST_ID = 0x7FFFFFFFU;
+
+struct Test_Request
+{
+	uint32_t	  value = 0U;
+	unsigned long inserted = 0U;
+	uint64_t	  timeout = 0U;
+};
+
+using Test_Map = Pending_Request_Map<Test_Request>;
+
+void setUp()
+{
+	native_micros = 0U;
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static size_t insert(Test_Map& map, uint32_t value, uint64_t timeout)
+{
+	Test_Request request;
+	request.value	 = value;
+	request.inserted = native_micros;
+	request.timeout	 = timeout;
+	size_t request_id = 0U;
+	TEST_ASSERT_NOT_NULL(map.Insert(request, timeout, request_id));
+	TEST_ASSERT_TRUE(request_id != 0U && request_id <= MAX_REQUEST_ID);
+	return request_id;
+}
+
+static void test_thousands_in_flight()
+{
+	Test_Map map;
+	map.reserve(IN_FLIGHT);
+	std::unordered_map<size_t, uint32_t> expected;
+	std::vector<size_t>					 erased;
+	std::mt19937						 random(47U);
+
+	const size_t		first_id	  = insert(map, 0U, 0U);
+	const Test_Request* first_request = map.Find(first_id);
+	expected[first_id]				  = 0U;
+	for (uint32_t value = 1U; value < IN_FLIGHT; value++)
+	{
+		const size_t request_id = insert(map, value, value % 2U == 0U ? 0U : TIMEOUTS[value % 5U]);
+		TEST_ASSERT_TRUE(expected.emplace(request_id, value).second);
+	}
+	// The slots were allocated up front, inserting did not move them
+	TEST_ASSERT_EQUAL_PTR(first_request, map.Find(first_id));
+	TEST_ASSERT_EQUAL_UINT32(IN_FLIGHT, map.size());
+
+	// Responses arrive in random order, while new requests take over the freed slots
+	for (uint32_t value = IN_FLIGHT; value < 20U * IN_FLIGHT; value++)
+	{
+		auto responded = expected.begin();
+		std::advance(responded, random() % expected.size());
+		TEST_ASSERT_EQUAL_UINT32(responded->second, map.Find(responded->first)->value);
+		TEST_ASSERT_TRUE(map.Erase(responded->first));
+		erased.push_back(responded->first);
+		expected.erase(responded);
+
+		const size_t request_id = insert(map, value, value % 2U == 0U ? 0U : TIMEOUTS[value % 5U]);
+		TEST_ASSERT_TRUE(expected.emplace(request_id, value).second);
+	}
+	TEST_ASSERT_EQUAL_UINT32(IN_FLIGHT, map.size());
+
+	// Late and duplicate responses are rejected, even though their slots are in use again
+	for (const size_t request_id : erased)
+	{
+		TEST_ASSERT_NULL(map.Find(request_id));
+		TEST_ASSERT_FALSE(map.Erase(request_id));
+	}
+	for (const auto& request : expected)
+	{
+		TEST_ASSERT_EQUAL_UINT32(request.second, map.Find(request.first)->value);
+	}
+
+	map.clear();
+	TEST_ASSERT_TRUE(map.empty());
+	for (const auto& request : expected)
+	{
+		TEST_ASSERT_NULL(map.Find(request.first));
+	}
+}
+
+static void test_generation_wrap()
+{
+	Test_Map map;
+
+	// Every request reuses the same slot, its generation wraps around after 2^15 - 1 requests and skips 0
+	constexpr size_t GENERATIONS = (static_cast<size_t>(1U) << PENDING_REQUEST_GENERATION_BITS) - 1U;
+	const size_t	 first_id	 = insert(map, 0U, 0U);
+	TEST_ASSERT_TRUE(map.Erase(first_id));
+	size_t previous_id = first_id;
+	for (size_t generation = 1U; generation < GENERATIONS; generation++)
+	{
+		const size_t request_id = insert(map, generation, 0U);
+		TEST_ASSERT_TRUE(request_id != previous_id && request_id != first_id);
+		TEST_ASSERT_NULL(map.Find(previous_id));
+		TEST_ASSERT_TRUE(map.Erase(request_id));
+		previous_id = request_id;
+	}
+	TEST_ASSERT_EQUAL_UINT32(first_id, insert(map, 0U, 0U));
+
+	// Ids with bits above the generation are never found
+	TEST_ASSERT_NULL(map.Find(first_id | (MAX_REQUEST_ID + 1U)));
+}
+
+static void test_timeout_lanes()
+{
+	Test_Map map;
+	map.reserve(IN_FLIGHT);
+
+	// The virtual clock wraps around while the requests are waiting
+	native_micros = ~0UL - 3000000UL;
+	std::unordered_map<size_t, Test_Request> waiting;
+	std::mt19937							 random(4U);
+	for (uint32_t value = 0U; value < IN_FLIGHT; value++)
+	{
+		const uint64_t timeout	  = value % 7U == 0U ? 0U : TIMEOUTS[random() % 5U];
+		const size_t   request_id = insert(map, value, timeout);
+		waiting[request_id]		  = *map.Find(request_id);
+		if (value % 50U == 0U)
+		{
+			native_micros += CLOCK_STEP / 4U;
+		}
+	}
+
+	// Answered requests never time out
+	size_t answered = 0U;
+	for (auto it = waiting.begin(); it != waiting.end() && answered < IN_FLIGHT / 10U; answered++)
+	{
+		TEST_ASSERT_TRUE(map.Erase(it->first));
+		it = waiting.erase(it);
+	}
+
+	size_t timed_out = 0U;
+	for (size_t step = 0U; step < 1000U; step++)
+	{
+		native_micros += CLOCK_STEP;
+		size_t request_id = 0U;
+		while (map.Next_Timed_Out(request_id))
+		{
+			// Expired on the first check after its deadline, neither earlier nor later
+			const Test_Request* request = map.Find(request_id);
+			TEST_ASSERT_NOT_NULL(request);
+			TEST_ASSERT_TRUE(request->timeout != 0U);
+			const unsigned long elapsed = native_micros - request->inserted;
+			TEST_ASSERT_TRUE(elapsed >= request->timeout && elapsed < request->timeout + CLOCK_STEP);
+			TEST_ASSERT_TRUE(map.Erase(request_id));
+			TEST_ASSERT_EQUAL_UINT32(1U, waiting.erase(request_id));
+			timed_out++;
+		}
+	}
+
+	// Only the requests without timeout are left
+	for (const auto& request : waiting)
+	{
+		TEST_ASSERT_EQUAL_UINT64(0U, request.second.timeout);
+	}
+	TEST_ASSERT_EQUAL_UINT32(waiting.size(), map.size());
+	TEST_ASSERT_TRUE(timed_out > IN_FLIGHT / 2U);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_thousands_in_flight);
+	RUN_TEST(test_generation_wrap);
+	RUN_TEST(test_timeout_lanes);
+	return UNITY_END();
+}
@@ -0,0 +1,225 @@
+// Protobuf is disabled by default, only this test enables it
+#define THINGSBOARD_ENABLE_PROTOBUF 1
+
+#include "Fake_MQTT_Client.h"
+
+#include <ThingsBoard.h>
+#include <array>
+#include <unity.h>
+
+// Keys and schema of the sensor, see IOT_SENSORT/src/main.cpp
+constexpr auto TEMPERATURE_KEY	   = Make_Json_Key("temperature", 2U);
+constexpr auto HUMIDITY_KEY		   = Make_Json_Key("humidity", 1U);
+constexpr auto VOC_KEY			   = Make_Json_Key("voc");
+constexpr auto LUX_KEY			   = Make_Json_Key("lux", 1U);
+constexpr auto BATTERY_KEY		   = Make_Json_Key("battery", 3U);
+constexpr auto TEMP_ALARM_HIGH_KEY = Make_Json_Key("temp_alarm_high");
+constexpr auto TEMP_ALARM_LOW_KEY  = Make_Json_Key("temp_alarm_low");
+constexpr auto VOC_ALARM_KEY	   = Make_Json_Key("voc_alarm");
+constexpr auto BATTERY_ALARM_KEY   = Make_Json_Key("battery_alarm");
+
+constexpr Proto_Field SENSOR_SCHEMA[] = { { "temperature", 1U, Proto_Type::PROTO_FLOAT },
+	{ "humidity", 2U, Proto_Type::PROTO_FLOAT }, { "voc", 3U, Proto_Type::PROTO_UINT32 },
+	{ "lux", 4U, Proto_Type::PROTO_FLOAT }, { "battery", 5U, Proto_Type::PROTO_FLOAT },
+	{ "temp_alarm_high", 6U, Proto_Type::PROTO_BOOL }, { "temp_alarm_low", 7U, Proto_Type::PROTO_BOOL },
+	{ "voc_alarm", 8U, Proto_Type::PROTO_BOOL }, { "battery_alarm", 9U, Proto_Type::PROTO_BOOL } };
+
+// Schema with every other scalar type, message Scalars of the .proto below
+constexpr Proto_Field SCALAR_SCHEMA[] = { { "real", 1U, Proto_Type::PROTO_DOUBLE },
+	{ "offset", 2U, Proto_Type::PROTO_INT32 }, { "delta", 3U, Proto_Type::PROTO_SINT32 },
+	{ "uptime", 4U, Proto_Type::PROTO_INT64 }, { "label", 5U, Proto_Type::PROTO_STRING },
+	{ "on", 6U, Proto_Type::PROTO_BOOL }, { "counter", 20U, Proto_Type::PROTO_UINT64 } };
+
+// Expected messages were encoded with the reference implementation, protoc 3.21.12, from the text format given above each of them:
+//   printf '<text format>' | protoc --encode=telemetry.<message> sensor.proto | od -An -tx1
+// and decode back to the same values with protoc --decode=telemetry.<message> sensor.proto. sensor.proto is the schema of the sensor,
+// with package telemetry and message SensorDataReading, followed by:
+//   message Scalars {
+//     optional double real = 1;
+//     optional int32 offset = 2;
+//     optional sint32 delta = 3;
+//     optional int64 uptime = 4;
+//     optional uint64 counter = 20;
+//     optional string label = 5;
+//     optional bool on = 6;
+//   }
+
+// temperature: 23.47 humidity: 41.3 voc: 112 lux: 356.8 battery: 3.912
+constexpr uint8_t MEASUREMENTS_MESSAGE[] = { 0x0d, 0x8f, 0xc2, 0xbb, 0x41, 0x15, 0x33, 0x33, 0x25, 0x42, 0x18, 0x70,
+	0x25, 0x66, 0x66, 0xb2, 0x43, 0x2d, 0x35, 0x5e, 0x7a, 0x40 };
+
+// temperature: 31.06 humidity: 58.9 voc: 312 lux: 12.5 battery: 3.285
+// temp_alarm_high: true temp_alarm_low: false voc_alarm: true battery_alarm: true
+constexpr uint8_t ALARMS_MESSAGE[] = { 0x0d, 0xe1, 0x7a, 0xf8, 0x41, 0x15, 0x9a, 0x99, 0x6b, 0x42, 0x18, 0xb8, 0x02,
+	0x25, 0x00, 0x00, 0x48, 0x41, 0x2d, 0x71, 0x3d, 0x52, 0x40, 0x30, 0x01, 0x38, 0x00, 0x40, 0x01, 0x48, 0x01 };
+
+// real: -1234.5678 offset: -5 delta: -5 uptime: 8589934592 counter: 4294967296000 label: "salon" on: true
+constexpr uint8_t SCALARS_MESSAGE[] = { 0x09, 0xad, 0xfa, 0x5c, 0x6d, 0x45, 0x4a, 0x93, 0xc0, 0x10, 0xfb, 0xff, 0xff,
+	0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01, 0x18, 0x09, 0x20, 0x80, 0x80, 0x80, 0x80, 0x20, 0x2a, 0x05, 0x73, 0x61,
+	0x6c, 0x6f, 0x6e, 0x30, 0x01, 0xa0, 0x01, 0x80, 0x80, 0x80, 0x80, 0x80, 0x7d };
+
+/// @brief Measurements of a cycle of the sensor without alarm changes
+static void add_measurements(Telemetry_Batch<9U>& batch)
+{
+	TEST_ASSERT_TRUE(batch.Add(TEMPERATURE_KEY, 23.4712f));
+	TEST_ASSERT_TRUE(batch.Add(HUMIDITY_KEY, 41.3f));
+	TEST_ASSERT_TRUE(batch.Add(VOC_KEY, static_cast<uint16_t>(112U)));
+	TEST_ASSERT_TRUE(batch.Add(LUX_KEY, 356.83f));
+	TEST_ASSERT_TRUE(batch.Add(BATTERY_KEY, 3.9117f));
+}
+
+/// @brief Measurements of a cycle of the sensor where every alarm changed
+static void add_alarms(Telemetry_Batch<9U>& batch)
+{
+	TEST_ASSERT_TRUE(batch.Add(TEMPERATURE_KEY, 31.06f));
+	TEST_ASSERT_TRUE(batch.Add(HUMIDITY_KEY, 58.9f));
+	TEST_ASSERT_TRUE(batch.Add(VOC_KEY, static_cast<uint16_t>(312U)));
+	TEST_ASSERT_TRUE(batch.Add(LUX_KEY, 12.5f));
+	TEST_ASSERT_TRUE(batch.Add(BATTERY_KEY, 3.285f));
+	TEST_ASSERT_TRUE(batch.Add(TEMP_ALARM_HIGH_KEY, true));
+	TEST_ASSERT_TRUE(batch.Add(TEMP_ALARM_LOW_KEY, false));
+	TEST_ASSERT_TRUE(batch.Add(VOC_ALARM_KEY, true));
+	TEST_ASSERT_TRUE(batch.Add(BATTERY_ALARM_KEY, true));
+}
+
+/// @brief Sends the given batch as telemetry and returns the published payload
+/// @param first Pointer to the first field of the schema, nullptr to send the batch as json
+/// @param last Pointer to the end of the schema (last field + 1)
+template <size_t MaxKeyValuePairAmount>
+static std::vector<uint8_t> send(
+	const Telemetry_Batch<MaxKeyValuePairAmount>& batch, const Proto_Field* first, const Proto_Field* last)
+{
+	Fake_MQTT_Client						 client;
+	const std::array<IAPI_Implementation*, 0U> apis = {};
+	ThingsBoard tb(client, 256U, 256U, Default_Max_Stack_Size, Default_Max_Response_Size, apis.cbegin(), apis.cend());
+	TEST_ASSERT_TRUE(tb.connect("localhost", "token"));
+	if (first != nullptr)
+	{
+		tb.Set_Telemetry_Schema(first, last);
+	}
+	TEST_ASSERT_TRUE(tb.sendTelemetry(batch));
+	TEST_ASSERT_EQUAL_UINT32(1U, client.published.size());
+	TEST_ASSERT_EQUAL_STRING(TELEMETRY_TOPIC, client.published.front().topic.c_str());
+	return client.published.front().payload;
+}
+
+/// @brief Compares the published payload with the message encoded by protoc
+static void assert_message(const uint8_t* expected, size_t expected_size, const std::vector<uint8_t>& payload)
+{
+	TEST_ASSERT_EQUAL_UINT32(expected_size, payload.size());
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, payload.data(), expected_size);
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_measurements_match_reference_encoding()
+{
+	Telemetry_Batch<9U> batch;
+	add_measurements(batch);
+	assert_message(MEASUREMENTS_MESSAGE, sizeof(MEASUREMENTS_MESSAGE),
+		send(batch, SENSOR_SCHEMA, SENSOR_SCHEMA + sizeof(SENSOR_SCHEMA) / sizeof(SENSOR_SCHEMA[0])));
+}
+
+static void test_alarms_match_reference_encoding()
+{
+	Telemetry_Batch<9U> batch;
+	add_alarms(batch);
+	assert_message(ALARMS_MESSAGE, sizeof(ALARMS_MESSAGE),
+		send(batch, SENSOR_SCHEMA, SENSOR_SCHEMA + sizeof(SENSOR_SCHEMA) / sizeof(SENSOR_SCHEMA[0])));
+}
+
+static void test_scalars_match_reference_encoding()
+{
+	// Fields are added in the order protoc writes them, which is the order of the field numbers
+	Telemetry_Batch<7U> batch;
+	TEST_ASSERT_TRUE(batch.Add("real", -1234.5678));
+	TEST_ASSERT_TRUE(batch.Add("offset", -5));
+	TEST_ASSERT_TRUE(batch.Add("delta", -5));
+	TEST_ASSERT_TRUE(batch.Add("uptime", 8589934592LL));
+	TEST_ASSERT_TRUE(batch.Add("label", "salon"));
+	TEST_ASSERT_TRUE(batch.Add("on", true));
+	TEST_ASSERT_TRUE(batch.Add("counter", 4294967296000LL));
+	assert_message(SCALARS_MESSAGE, sizeof(SCALARS_MESSAGE),
+		send(batch, SCALAR_SCHEMA, SCALAR_SCHEMA + sizeof(SCALAR_SCHEMA) / sizeof(SCALAR_SCHEMA[0])));
+}
+
+static void test_telemetry_instances_match_reference_encoding()
+{
+	Fake_MQTT_Client						   client;
+	const std::array<IAPI_Implementation*, 0U> apis = {};
+	ThingsBoard tb(client, 256U, 256U, Default_Max_Stack_Size, Default_Max_Response_Size, apis.cbegin(), apis.cend());
+	TEST_ASSERT_TRUE(tb.connect("localhost", "token"));
+	tb.Set_Telemetry_Schema(SCALAR_SCHEMA, SCALAR_SCHEMA + sizeof(SCALAR_SCHEMA) / sizeof(SCALAR_SCHEMA[0]));
+	tb.Set_Attribute_Schema(SCALAR_SCHEMA, SCALAR_SCHEMA + sizeof(SCALAR_SCHEMA) / sizeof(SCALAR_SCHEMA[0]));
+
+	// Each instance is encoded on its own, the concatenated fields are the same message the batch is encoded as
+	const std::array<Telemetry, 7U> scalars = { Telemetry("real", -1234.5678), Telemetry("offset", -5),
+		Telemetry("delta", -5), Telemetry("uptime", 8589934592LL), Telemetry("label", "salon"), Telemetry("on", true),
+		Telemetry("counter", 4294967296000LL) };
+	TEST_ASSERT_TRUE(tb.sendTelemetry(scalars.cbegin(), scalars.cend()));
+	TEST_ASSERT_TRUE(tb.sendAttributes(scalars.cbegin(), scalars.cend()));
+	// label: "salon", the only field of the message with a single key-value pair
+	TEST_ASSERT_TRUE(tb.sendTelemetryData("label", "salon"));
+	TEST_ASSERT_TRUE(tb.sendAttributeData("label", "salon"));
+	TEST_ASSERT_EQUAL_UINT32(4U, client.published.size());
+
+	TEST_ASSERT_EQUAL_STRING(TELEMETRY_TOPIC, client.published[0U].topic.c_str());
+	assert_message(SCALARS_MESSAGE, sizeof(SCALARS_MESSAGE), client.published[0U].payload);
+	TEST_ASSERT_EQUAL_STRING(ATTRIBUTE_TOPIC, client.published[1U].topic.c_str());
+	assert_message(SCALARS_MESSAGE, sizeof(SCALARS_MESSAGE), client.published[1U].payload);
+	constexpr uint8_t label_message[] = { 0x2a, 0x05, 0x73, 0x61, 0x6c, 0x6f, 0x6e };
+	TEST_ASSERT_EQUAL_STRING(TELEMETRY_TOPIC, client.published[2U].topic.c_str());
+	assert_message(label_message, sizeof(label_message), client.published[2U].payload);
+	TEST_ASSERT_EQUAL_STRING(ATTRIBUTE_TOPIC, client.published[3U].topic.c_str());
+	assert_message(label_message, sizeof(label_message), client.published[3U].payload);
+
+	// Keys without a field in the schema are never sent as json instead
+	const std::array<Telemetry, 2U> unknown = { Telemetry("real", 1.5), Telemetry("unknown", 1) };
+	TEST_ASSERT_FALSE(tb.sendTelemetry(unknown.cbegin(), unknown.cend()));
+	TEST_ASSERT_FALSE(tb.sendTelemetryData("unknown", 1));
+	TEST_ASSERT_FALSE(tb.sendTelemetryData("on", "text"));
+	TEST_ASSERT_EQUAL_UINT32(4U, client.published.size());
+}
+
+static void test_size_compared_to_json()
+{
+	char message[96];
+	Telemetry_Batch<9U> measurements;
+	add_measurements(measurements);
+	Telemetry_Batch<9U> alarms;
+	add_alarms(alarms);
+	const Telemetry_Batch<9U>* const batches[2U] = { &measurements, &alarms };
+	const char* const				 names[2U]	 = { "measurements", "alarms" };
+
+	for (size_t i = 0U; i < 2U; i++)
+	{
+		const size_t json_size = send(*batches[i], nullptr, nullptr).size();
+		const size_t protobuf_size =
+			send(*batches[i], SENSOR_SCHEMA, SENSOR_SCHEMA + sizeof(SENSOR_SCHEMA) / sizeof(SENSOR_SCHEMA[0])).size();
+		snprintf(message, sizeof(message), "%-12s json %3u bytes, protobuf %2u bytes, %.1fx smaller", names[i],
+			static_cast<unsigned>(json_size), static_cast<unsigned>(protobuf_size),
+			static_cast<double>(json_size) / protobuf_size);
+		TEST_MESSAGE(message);
+		// Keeps the ratio stated in IOT_SENSORT/include/config.h honest
+		TEST_ASSERT_TRUE(json_size >= 3U * protobuf_size);
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_measurements_match_reference_encoding);
+	RUN_TEST(test_alarms_match_reference_encoding);
+	RUN_TEST(test_scalars_match_reference_encoding);
+	RUN_TEST(test_telemetry_instances_match_reference_encoding);
+	RUN_TEST(test_size_compared_to_json);
+	return UNITY_END();
+}
@@ -0,0 +1,202 @@
+#include "Fake_MQTT_Client.h"
+
+#include <Queued_MQTT_Client.h>
+#include <ThingsBoard.h>
+#include <atomic>
+#include <thread>
+#include <unity.h>
+
+// Topics of the two priorities, telemetry is queued with normal priority and everything else with high priority
+constexpr char TELEMETRY[] = "v1/devices/me/telemetry";
+constexpr char ATTRIBUTES[] = "v1/devices/me/attributes";
+
+// Amount of tasks publishing at once and messages each of them publishes
+constexpr size_t PRODUCER_COUNT = 4U;
+constexpr uint32_t MESSAGES_PER_PRODUCER = 20000U;
+
+// Small queue, so that it is full most of the time and both drop policies have to discard messages
+constexpr size_t QUEUE_CAPACITY = 8U;
+constexpr size_t MAX_MESSAGE_SIZE = 64U;
+
+// Send buffer of the client underneath the queue, fits the biggest queued message together with the MQTT header
+constexpr uint16_t SEND_BUFFER_SIZE = MAX_MESSAGE_SIZE + MQTT_PUBLISH_OVERHEAD;
+
+// Header of every payload, the producer, its sequence number and the payload length, followed by a pattern derived from them
+constexpr size_t HEADER_SIZE = 6U;
+constexpr size_t MAX_PAYLOAD_SIZE = MAX_MESSAGE_SIZE - sizeof(TELEMETRY);
+
+using Test_Queue_Client = Queued_MQTT_Client<QUEUE_CAPACITY, MAX_MESSAGE_SIZE>;
+
+static uint8_t pattern(uint8_t producer, uint32_t sequence, size_t index)
+{
+	return static_cast<uint8_t>(producer * 31U + sequence * 7U + index);
+}
+
+/// @brief Writes the payload of the given message, its length varies with the sequence number
+static size_t write_payload(uint8_t producer, uint32_t sequence, uint8_t* payload)
+{
+	const size_t length = HEADER_SIZE + sequence % (MAX_PAYLOAD_SIZE - HEADER_SIZE + 1U);
+	payload[0U]			= producer;
+	memcpy(payload + 1U, &sequence, sizeof(sequence));
+	payload[5U] = static_cast<uint8_t>(length);
+	for (size_t i = HEADER_SIZE; i < length; i++)
+	{
+		payload[i] = pattern(producer, sequence, i);
+	}
+	return length;
+}
+
+/// @brief Every fourth message is published with high priority
+static const char* topic_of(uint32_t sequence)
+{
+	return (sequence % 4U) == 0U ? ATTRIBUTES : TELEMETRY;
+}
+
+/// @brief Publishes from multiple threads while one thread sends the queued messages, like tb.loop() would,
+/// then checks that every sent message is complete and was sent once, in the order its producer queued it with the same priority
+static void stress(Drop_Policy policy)
+{
+	Fake_MQTT_Client  broker;
+	Test_Queue_Client client(broker, 0U, policy);
+	TEST_ASSERT_TRUE(client.set_buffer_size(MAX_MESSAGE_SIZE, SEND_BUFFER_SIZE));
+	TEST_ASSERT_TRUE(client.connect("client", "token", nullptr));
+
+	// Every thread waits until all of them have been started, so that they actually run at the same time
+	std::atomic<size_t>	  started(0U);
+	std::atomic<size_t>	  producers_done(0U);
+	std::atomic<uint32_t> rejected(0U);
+	std::thread			  consumer([&]() {
+		  started.fetch_add(1U);
+		  while (started.load() != PRODUCER_COUNT + 1U)
+		  {
+			  // Nothing to do
+		  }
+		  while (producers_done.load() != PRODUCER_COUNT)
+		  {
+			  (void)client.loop();
+		  }
+		  (void)client.loop();
+	  });
+	std::thread			  producers[PRODUCER_COUNT];
+	for (size_t p = 0U; p < PRODUCER_COUNT; p++)
+	{
+		producers[p] = std::thread([&, p]() {
+			started.fetch_add(1U);
+			while (started.load() != PRODUCER_COUNT + 1U)
+			{
+				// Nothing to do
+			}
+			uint8_t payload[MAX_PAYLOAD_SIZE];
+			for (uint32_t sequence = 0U; sequence < MESSAGES_PER_PRODUCER; sequence++)
+			{
+				const size_t length = write_payload(static_cast<uint8_t>(p), sequence, payload);
+				if (!client.publish(topic_of(sequence), payload, length))
+				{
+					rejected.fetch_add(1U);
+				}
+				// Gives the consumer a chance to keep up, otherwise nearly every message would be discarded
+				std::this_thread::yield();
+			}
+			producers_done.fetch_add(1U);
+		});
+	}
+	for (std::thread& producer : producers)
+	{
+		producer.join();
+	}
+	consumer.join();
+
+	// Sequence number of the last message sent per producer and priority, messages of one producer and priority keep their order
+	int64_t				 last_sequence[PRODUCER_COUNT][2U];
+	std::vector<uint8_t> seen(PRODUCER_COUNT * MESSAGES_PER_PRODUCER, 0U);
+	for (auto& sequences : last_sequence)
+	{
+		sequences[0U] = -1;
+		sequences[1U] = -1;
+	}
+	for (const Fake_MQTT_Client::Message& message : broker.published)
+	{
+		TEST_ASSERT_TRUE(message.payload.size() >= HEADER_SIZE);
+		const uint8_t producer = message.payload[0U];
+		uint32_t	  sequence = 0U;
+		memcpy(&sequence, message.payload.data() + 1U, sizeof(sequence));
+		TEST_ASSERT_TRUE(producer < PRODUCER_COUNT && sequence < MESSAGES_PER_PRODUCER);
+
+		// Not torn, the topic, length and every byte belong to the same message
+		TEST_ASSERT_EQUAL_STRING(topic_of(sequence), message.topic.c_str());
+		uint8_t expected[MAX_PAYLOAD_SIZE];
+		const size_t length = write_payload(producer, sequence, expected);
+		TEST_ASSERT_EQUAL_UINT32(length, message.payload.size());
+		TEST_ASSERT_EQUAL_MEMORY(expected, message.payload.data(), length);
+
+		// Not duplicated and not reordered
+		uint8_t& sent = seen[producer * MESSAGES_PER_PRODUCER + sequence];
+		TEST_ASSERT_EQUAL_UINT8(0U, sent);
+		sent = 1U;
+		int64_t& last = last_sequence[producer][topic_of(sequence) == TELEMETRY ? 1U : 0U];
+		TEST_ASSERT_TRUE(static_cast<int64_t>(sequence) > last);
+		last = sequence;
+	}
+
+	// Every message was either sent or discarded and counted once, only the newest messages are rejected when publishing
+	TEST_ASSERT_EQUAL_UINT32(PRODUCER_COUNT * MESSAGES_PER_PRODUCER, broker.published.size() + client.dropped());
+	if (policy == Drop_Policy::DROP_NEWEST)
+	{
+		TEST_ASSERT_EQUAL_UINT32(client.dropped(), rejected.load());
+	}
+
+	char message[96];
+	snprintf(message, sizeof(message), "%u sent, %u dropped", static_cast<unsigned>(broker.published.size()),
+		static_cast<unsigned>(client.dropped()));
+	TEST_MESSAGE(message);
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_stress_drop_oldest()
+{
+	stress(Drop_Policy::DROP_OLDEST);
+}
+
+static void test_stress_drop_newest()
+{
+	stress(Drop_Policy::DROP_NEWEST);
+}
+
+static void test_high_priority_sent_first()
+{
+	Fake_MQTT_Client  broker;
+	Test_Queue_Client client(broker, 0U, Drop_Policy::DROP_OLDEST);
+	TEST_ASSERT_TRUE(client.set_buffer_size(MAX_MESSAGE_SIZE, SEND_BUFFER_SIZE));
+	TEST_ASSERT_TRUE(client.connect("client", "token", nullptr));
+
+	uint8_t payload[MAX_PAYLOAD_SIZE];
+	for (uint32_t sequence = 1U; sequence <= 3U; sequence++)
+	{
+		TEST_ASSERT_TRUE(client.publish(topic_of(sequence), payload, write_payload(0U, sequence, payload)));
+	}
+	TEST_ASSERT_TRUE(client.publish(topic_of(4U), payload, write_payload(0U, 4U, payload)));
+	TEST_ASSERT_EQUAL_UINT32(0U, broker.published.size());
+
+	(void)client.loop();
+	TEST_ASSERT_EQUAL_UINT32(4U, broker.published.size());
+	TEST_ASSERT_EQUAL_STRING(ATTRIBUTES, broker.published[0U].topic.c_str());
+	TEST_ASSERT_EQUAL_UINT8(1U, broker.published[1U].payload[1U]);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_high_priority_sent_first);
+	RUN_TEST(test_stress_drop_oldest);
+	RUN_TEST(test_stress_drop_newest);
+	return UNITY_END();
+}
@@ -0,0 +1,293 @@
+#include "Relay_Schedule.h"
+
+#include <stdlib.h>
+#include <time.h>
+#include <unity.h>
+
+// Time zone of the actuator (TIME_ZONE in config.h), daylight saving time starts on the
+// last sunday of march at 02:00 and ends on the last sunday of october at 03:00
+constexpr char TEST_TIME_ZONE[] = "CET-1CEST,M3.5.0,M10.5.0/3";
+
+// Amount of seconds in one day and one week of wall time without a daylight saving time change
+constexpr time_t SECONDS_PER_DAY  = 24 * 60 * 60;
+constexpr time_t SECONDS_PER_WEEK = 7 * SECONDS_PER_DAY;
+
+// Maximum amount of fired entries recorded by a single test
+constexpr size_t MAX_FIRES = 64U;
+
+/// @brief Entry fired by the schedule, recorded together with the virtual time it fired at
+struct Fire
+{
+	time_t	when;
+	uint8_t relay;
+	bool	state;
+};
+
+static time_t virtual_now = 0;
+static Fire	  fires[MAX_FIRES];
+static size_t fire_count = 0U;
+
+static time_t virtual_clock()
+{
+	return virtual_now;
+}
+
+static int lookup(const char* key)
+{
+	if (key == nullptr)
+	{
+		return -1;
+	}
+	if (strcmp(key, "LIGHT_RELAY") == 0)
+	{
+		return 0;
+	}
+	if (strcmp(key, "VMC_RELAY") == 0)
+	{
+		return 1;
+	}
+	return -1;
+}
+
+static void apply(uint8_t relay, bool state)
+{
+	if (fire_count < MAX_FIRES)
+	{
+		fires[fire_count] = Fire{ virtual_now, relay, state };
+	}
+	fire_count++;
+}
+
+/// @brief Converts the given local wall time into epoch time
+static time_t local_time(int year, int month, int day, int hour, int minute, int second = 0)
+{
+	struct tm local = {};
+	local.tm_year	= year - 1900;
+	local.tm_mon	= month - 1;
+	local.tm_mday	= day;
+	local.tm_hour	= hour;
+	local.tm_min	= minute;
+	local.tm_sec	= second;
+	local.tm_isdst	= -1;
+	return mktime(&local);
+}
+
+/// @brief Reads the local wall time of the given epoch time
+static struct tm to_local(time_t when)
+{
+	struct tm local;
+	(void)localtime_r(&when, &local);
+	return local;
+}
+
+/// @brief Fast forwards the virtual clock one second at a time and calls loop() after every second,
+/// like the main loop does on the device
+static void run_for(Relay_Schedule& schedule, time_t seconds)
+{
+	for (time_t i = 0; i < seconds; i++)
+	{
+		virtual_now++;
+		schedule.loop();
+	}
+}
+
+/// @brief Loads the given compact json schedule
+static size_t load(Relay_Schedule& schedule, const char* json)
+{
+	StaticJsonDocument<1024> document;
+	TEST_ASSERT_FALSE(deserializeJson(document, json));
+	return schedule.load(document.as<JsonArrayConst>());
+}
+
+void setUp()
+{
+	setenv("TZ", TEST_TIME_ZONE, 1);
+	tzset();
+	fire_count = 0U;
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+void test_daily_entry_fires_once_per_day_for_a_week()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = local_time(2024, 5, 6, 0, 0); // Monday
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["LIGHT_RELAY", 1, 420]])"));
+
+	run_for(schedule, SECONDS_PER_WEEK);
+
+	TEST_ASSERT_EQUAL_size_t(7U, fire_count);
+	for (size_t i = 0U; i < fire_count; i++)
+	{
+		const struct tm local = to_local(fires[i].when);
+		TEST_ASSERT_EQUAL_INT(7, local.tm_hour);
+		TEST_ASSERT_EQUAL_INT(0, local.tm_min);
+		TEST_ASSERT_EQUAL_INT(0, local.tm_sec);
+		TEST_ASSERT_EQUAL_INT(6 + static_cast<int>(i), local.tm_mday);
+		TEST_ASSERT_EQUAL_UINT8(0U, fires[i].relay);
+		TEST_ASSERT_TRUE(fires[i].state);
+	}
+}
+
+void test_week_days_and_repeat_period()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = local_time(2024, 5, 6, 0, 0); // Monday
+	// Monday (bit 1) and saturday (bit 6), every 2 hours from 20:00 until midnight
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["VMC_RELAY", 0, 1200, 66, 120]])"));
+
+	run_for(schedule, SECONDS_PER_WEEK);
+
+	TEST_ASSERT_EQUAL_size_t(4U, fire_count);
+	const int expected_day[]  = { 6, 6, 11, 11 };
+	const int expected_hour[] = { 20, 22, 20, 22 };
+	for (size_t i = 0U; i < fire_count; i++)
+	{
+		const struct tm local = to_local(fires[i].when);
+		TEST_ASSERT_EQUAL_INT(expected_day[i], local.tm_mday);
+		TEST_ASSERT_EQUAL_INT(expected_hour[i], local.tm_hour);
+		TEST_ASSERT_EQUAL_INT(0, local.tm_min);
+		TEST_ASSERT_FALSE(fires[i].state);
+	}
+}
+
+void test_daylight_saving_time_start()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = local_time(2024, 3, 28, 12, 0); // Thursday before the last sunday of march
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["LIGHT_RELAY", 1, 420]])"));
+
+	run_for(schedule, SECONDS_PER_WEEK);
+
+	TEST_ASSERT_EQUAL_size_t(7U, fire_count);
+	for (size_t i = 0U; i < fire_count; i++)
+	{
+		const struct tm local = to_local(fires[i].when);
+		TEST_ASSERT_EQUAL_INT(7, local.tm_hour);
+		TEST_ASSERT_EQUAL_INT(0, local.tm_min);
+	}
+	// The night from saturday to sunday is one hour shorter
+	TEST_ASSERT_EQUAL_INT64(SECONDS_PER_DAY - 3600, fires[2].when - fires[1].when);
+	TEST_ASSERT_EQUAL_INT64(SECONDS_PER_DAY, fires[3].when - fires[2].when);
+}
+
+void test_daylight_saving_time_end()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = local_time(2024, 10, 24, 12, 0); // Thursday before the last sunday of october
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["LIGHT_RELAY", 1, 420]])"));
+
+	run_for(schedule, SECONDS_PER_WEEK + 3600);
+
+	TEST_ASSERT_EQUAL_size_t(7U, fire_count);
+	for (size_t i = 0U; i < fire_count; i++)
+	{
+		const struct tm local = to_local(fires[i].when);
+		TEST_ASSERT_EQUAL_INT(7, local.tm_hour);
+		TEST_ASSERT_EQUAL_INT(0, local.tm_min);
+	}
+	// The night from saturday to sunday is one hour longer
+	TEST_ASSERT_EQUAL_INT64(SECONDS_PER_DAY + 3600, fires[2].when - fires[1].when);
+}
+
+void test_entry_in_skipped_hour_fires_once()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = local_time(2024, 3, 30, 12, 0); // Saturday before daylight saving time starts
+	// 02:30 does not exist on sunday, mktime() moves it to the first valid time after the gap
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["LIGHT_RELAY", 1, 150]])"));
+
+	run_for(schedule, 2 * SECONDS_PER_DAY);
+
+	TEST_ASSERT_EQUAL_size_t(2U, fire_count);
+	TEST_ASSERT_EQUAL_INT(31, to_local(fires[0].when).tm_mday);
+	TEST_ASSERT_EQUAL_INT(1, to_local(fires[1].when).tm_mday);
+	TEST_ASSERT_EQUAL_INT(2, to_local(fires[1].when).tm_hour);
+	TEST_ASSERT_EQUAL_INT(30, to_local(fires[1].when).tm_min);
+}
+
+void test_blocked_loop_is_caught_up_within_limit()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = local_time(2024, 5, 6, 6, 58);
+	// Fires at 07:00 and every minute after it
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["LIGHT_RELAY", 1, 420, 127, 1]])"));
+
+	// loop() blocked for exactly the maximum catch up time, every occurrence in between is fired once
+	virtual_now += SCHEDULE_MAX_CATCH_UP;
+	schedule.loop();
+	TEST_ASSERT_EQUAL_size_t(4U, fire_count);
+
+	// Entries were re-armed relative to the time they were due at and not to the time loop() caught up,
+	// the next occurrence therefore still fires on the minute
+	run_for(schedule, 60);
+	TEST_ASSERT_EQUAL_size_t(5U, fire_count);
+	TEST_ASSERT_EQUAL_INT64(local_time(2024, 5, 6, 7, 4), fires[4].when);
+}
+
+void test_clock_jump_beyond_limit_rebuilds_wheel()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = local_time(2024, 5, 6, 6, 58);
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["LIGHT_RELAY", 1, 420, 127, 1]])"));
+
+	// One second more than the catch up limit, the missed entries are skipped instead of replayed
+	virtual_now += SCHEDULE_MAX_CATCH_UP + 1;
+	schedule.loop();
+	TEST_ASSERT_EQUAL_size_t(0U, fire_count);
+
+	// The next occurrence after the jump still fires on time
+	run_for(schedule, 60);
+	TEST_ASSERT_EQUAL_size_t(1U, fire_count);
+	TEST_ASSERT_EQUAL_INT64(local_time(2024, 5, 6, 7, 4), fires[0].when);
+
+	// Stepping the clock backwards rebuilds the wheel as well, the entries fire again for the repeated minutes
+	virtual_now -= 120;
+	schedule.loop();
+	run_for(schedule, 120);
+	TEST_ASSERT_EQUAL_size_t(3U, fire_count);
+	TEST_ASSERT_EQUAL_INT64(local_time(2024, 5, 6, 7, 3), fires[1].when);
+	TEST_ASSERT_EQUAL_INT64(local_time(2024, 5, 6, 7, 4), fires[2].when);
+}
+
+void test_schedule_waits_for_synchronized_clock()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = 1000;
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["LIGHT_RELAY", 1, 420]])"));
+	run_for(schedule, SECONDS_PER_DAY);
+	TEST_ASSERT_EQUAL_size_t(0U, fire_count);
+
+	// SNTP synchronized, the wheel is armed with the first loop() afterwards
+	virtual_now = local_time(2024, 5, 6, 6, 0);
+	schedule.loop();
+	run_for(schedule, 3600);
+	TEST_ASSERT_EQUAL_size_t(1U, fire_count);
+	TEST_ASSERT_EQUAL_INT64(local_time(2024, 5, 6, 7, 0), fires[0].when);
+}
+
+void test_invalid_entries_are_ignored()
+{
+	Relay_Schedule schedule(&lookup, &apply, &virtual_clock);
+	virtual_now = local_time(2024, 5, 6, 0, 0);
+	TEST_ASSERT_EQUAL_size_t(1U, load(schedule, R"([["UNKNOWN", 1, 420], ["LIGHT_RELAY", 1, 1440],
+		["LIGHT_RELAY", 1, 420, 0], ["LIGHT_RELAY", 1], ["VMC_RELAY", 1, 0]])"));
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_daily_entry_fires_once_per_day_for_a_week);
+	RUN_TEST(test_week_days_and_repeat_period);
+	RUN_TEST(test_daylight_saving_time_start);
+	RUN_TEST(test_daylight_saving_time_end);
+	RUN_TEST(test_entry_in_skipped_hour_fires_once);
+	RUN_TEST(test_blocked_loop_is_caught_up_within_limit);
+	RUN_TEST(test_clock_jump_beyond_limit_rebuilds_wheel);
+	RUN_TEST(test_schedule_waits_for_synchronized_clock);
+	RUN_TEST(test_invalid_entries_are_ignored);
+	return UNITY_END();
+}
@@ -0,0 +1,195 @@
+#include <Server_Side_RPC.h>
+#include <ThingsBoard.h>
+#include <array>
+#include <unity.h>
+
+// Arduino_MQTT_Client is only compiled for Arduino, build it and the instrumented client into this test,
+// on top of the PubSubClient stand-in from test/native that records every published message.
+// ArduinoJson is already included above, so it keeps its configuration without the Arduino core
+#define ARDUINO 10800
+#include <Arduino_MQTT_Client.cpp>
+#include "../../src/Instrumented_MQTT_Client.cpp"
+#undef ARDUINO
+
+// Method of the test, answers with the current state of a relay that is toggled on every call
+constexpr char TOGGLE_METHOD[] = "toggle";
+
+// Method of the test, answers with a response too big for the dedup cache
+constexpr char DUMP_METHOD[] = "dump";
+
+static size_t toggle_calls = 0U;
+static size_t dump_calls   = 0U;
+
+static void toggle(const JsonVariantConst& data, JsonDocument& response)
+{
+	(void)data;
+	toggle_calls++;
+	response["state"] = (toggle_calls % 2U) != 0U;
+}
+
+static void dump(const JsonVariantConst& data, JsonDocument& response)
+{
+	(void)data;
+	dump_calls++;
+	response["dump"] = "0123456789012345678901234567890123456789012345678901234567890123456789";
+}
+
+class Test_Client
+{
+public:
+	Test_Client()
+		: m_client(m_transport, m_stats, m_dedup)
+		, m_rpc()
+		, m_apis{ &m_rpc }
+		, m_tb(m_client, 256U, 256U, Default_Max_Stack_Size, Default_Max_Response_Size, m_apis.cbegin(),
+			  m_apis.cend())
+	{
+		// Nothing to do
+	}
+
+	/// @brief Connects to the broker stand-in and subscribes the test methods
+	void begin()
+	{
+		TEST_ASSERT_TRUE(m_tb.connect("localhost", "token"));
+		const RPC_Callback callbacks[2U] = { { TOGGLE_METHOD, toggle, JSON_OBJECT_SIZE(1U) },
+			{ DUMP_METHOD, dump, JSON_OBJECT_SIZE(1U) } };
+		TEST_ASSERT_TRUE(m_rpc.RPC_Subscribe(callbacks + 0U, callbacks + 2U));
+	}
+
+	/// @brief Delivers a request for the given method with the given id and handles it
+	void request(uint32_t request_id, const char* method)
+	{
+		char topic[64];
+		char payload[64];
+		snprintf(topic, sizeof(topic), "v1/devices/me/rpc/request/%u", static_cast<unsigned>(request_id));
+		snprintf(payload, sizeof(payload), "{\"method\":\"%s\",\"params\":null}", method);
+		broker().deliver(topic, payload);
+		(void)m_tb.loop();
+	}
+
+	/// @brief Response payload published for the given request, fails if there are not exactly the given amount of them
+	std::string response(uint32_t request_id, size_t expected_count)
+	{
+		char topic[64];
+		snprintf(topic, sizeof(topic), "v1/devices/me/rpc/response/%u", static_cast<unsigned>(request_id));
+		std::string payload;
+		size_t		count = 0U;
+		for (const PubSubClient::Message& message : broker().published)
+		{
+			if (message.topic == topic)
+			{
+				const std::string current(message.payload.begin(), message.payload.end());
+				TEST_ASSERT_TRUE(count == 0U || current == payload);
+				payload = current;
+				count++;
+			}
+		}
+		TEST_ASSERT_EQUAL_UINT32(expected_count, count);
+		return payload;
+	}
+
+	ThingsBoard& tb()
+	{
+		return m_tb;
+	}
+
+private:
+	/// @brief Broker stand-in underneath the Arduino_MQTT_Client
+	PubSubClient& broker()
+	{
+		return *native_pubsub_client;
+	}
+
+	Client									   m_transport;
+	Latency_Stats							   m_stats;
+	RPC_Dedup_Cache							   m_dedup;
+	Instrumented_MQTT_Client				   m_client;
+	Server_Side_RPC<>						   m_rpc;
+	std::array<IAPI_Implementation*, 1U>	   m_apis;
+	ThingsBoard								   m_tb;
+};
+
+void setUp()
+{
+	toggle_calls = 0U;
+	dump_calls	 = 0U;
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_duplicate_request_answered_from_cache()
+{
+	Test_Client client;
+	client.begin();
+
+	client.request(5U, TOGGLE_METHOD);
+	client.request(5U, TOGGLE_METHOD);
+	client.request(5U, TOGGLE_METHOD);
+
+	// The relay is only toggled once, every delivery is answered with the same response
+	TEST_ASSERT_EQUAL_UINT32(1U, toggle_calls);
+	TEST_ASSERT_EQUAL_STRING("{\"state\":true}", client.response(5U, 3U).c_str());
+
+	client.request(6U, TOGGLE_METHOD);
+	TEST_ASSERT_EQUAL_UINT32(2U, toggle_calls);
+	TEST_ASSERT_EQUAL_STRING("{\"state\":false}", client.response(6U, 1U).c_str());
+}
+
+static void test_duplicate_after_other_requests()
+{
+	Test_Client client;
+	client.begin();
+
+	// Duplicates delivered late, after other requests, are still answered as long as they are cached
+	for (uint32_t request_id = 1U; request_id <= RPC_DEDUP_ENTRIES; request_id++)
+	{
+		client.request(request_id, TOGGLE_METHOD);
+	}
+	client.request(1U, TOGGLE_METHOD);
+	TEST_ASSERT_EQUAL_UINT32(RPC_DEDUP_ENTRIES, toggle_calls);
+	TEST_ASSERT_EQUAL_STRING("{\"state\":true}", client.response(1U, 2U).c_str());
+
+	// The least recently used response is replaced once the cache is full, its duplicate is handled again
+	client.request(RPC_DEDUP_ENTRIES + 1U, TOGGLE_METHOD);
+	client.request(2U, TOGGLE_METHOD);
+	TEST_ASSERT_EQUAL_UINT32(RPC_DEDUP_ENTRIES + 2U, toggle_calls);
+}
+
+static void test_big_response_not_cached()
+{
+	Test_Client client;
+	client.begin();
+
+	client.request(7U, DUMP_METHOD);
+	client.request(7U, DUMP_METHOD);
+	TEST_ASSERT_EQUAL_UINT32(2U, dump_calls);
+	TEST_ASSERT_TRUE(client.response(7U, 2U).size() > RPC_DEDUP_MAX_RESPONSE_SIZE);
+}
+
+static void test_reconnect_clears_cache()
+{
+	Test_Client client;
+	client.begin();
+
+	client.request(1U, TOGGLE_METHOD);
+	TEST_ASSERT_EQUAL_UINT32(1U, toggle_calls);
+
+	// Request ids restart with the new session, the same id is a new request
+	client.tb().disconnect();
+	TEST_ASSERT_TRUE(client.tb().connect("localhost", "token"));
+	client.request(1U, TOGGLE_METHOD);
+	TEST_ASSERT_EQUAL_UINT32(2U, toggle_calls);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_duplicate_request_answered_from_cache);
+	RUN_TEST(test_duplicate_after_other_requests);
+	RUN_TEST(test_big_response_not_cached);
+	RUN_TEST(test_reconnect_clears_cache);
+	return UNITY_END();
+}
@@ -0,0 +1,193 @@
+#include "Fake_MQTT_Client.h"
+
+#include <Server_Side_RPC.h>
+#include <ThingsBoard.h>
+#include <array>
+#include <chrono>
+#include <unity.h>
+
+// Topic server side RPC requests are received on
+constexpr char RPC_REQUEST_TOPIC_ID[] = "v1/devices/me/rpc/request/1";
+
+// Methods of the test, both sum the values of the params array
+constexpr char SUM_METHOD[] = "sum";
+constexpr char TOGGLE_METHOD[] = "toggle";
+
+// Receive buffer size, big enough for the longest request of the tests
+constexpr uint16_t BUFFER_SIZE = 16384U;
+
+// Amount of requests timed per benchmark run
+constexpr size_t BENCHMARK_ITERATIONS = 2000U;
+
+static size_t  calls = 0U;
+static int64_t sum	 = 0;
+
+static void sum_dom(const JsonVariantConst& data, JsonDocument& response)
+{
+	(void)response;
+	calls++;
+	sum = 0;
+	for (const JsonVariantConst value : data.as<JsonArrayConst>())
+	{
+		sum += value.as<int64_t>();
+	}
+}
+
+static void sum_events(Json_Pull_Parser& params, JsonDocument& response)
+{
+	(void)response;
+	calls++;
+	sum = 0;
+	if (params.Next() != Json_Event::ARRAY_BEGIN)
+	{
+		return;
+	}
+	while (params.Next() == Json_Event::NUMBER)
+	{
+		sum += params.Get_Integer();
+	}
+}
+
+/// @brief ThingsBoard instance with the sum and toggle methods subscribed, processing requests as json events or deserialized
+class Test_Client
+{
+public:
+	explicit Test_Client(bool json_events)
+		: m_rpc(json_events)
+		, m_apis{ &m_rpc }
+		, m_tb(m_client, BUFFER_SIZE, 512U, Default_Max_Stack_Size, 65536U, m_apis.cbegin(), m_apis.cend())
+	{
+		TEST_ASSERT_TRUE(m_tb.connect("localhost", "token"));
+		if (json_events)
+		{
+			const RPC_Callback callbacks[2U] = { { SUM_METHOD, sum_events }, { TOGGLE_METHOD, sum_events } };
+			TEST_ASSERT_TRUE(m_rpc.RPC_Subscribe(callbacks + 0U, callbacks + 2U));
+		}
+		else
+		{
+			const RPC_Callback callbacks[2U] = { { SUM_METHOD, sum_dom, JSON_OBJECT_SIZE(1U) },
+				{ TOGGLE_METHOD, sum_dom, JSON_OBJECT_SIZE(1U) } };
+			TEST_ASSERT_TRUE(m_rpc.RPC_Subscribe(callbacks + 0U, callbacks + 2U));
+		}
+	}
+
+	/// @brief Delivers the given request and handles it
+	void request(const std::string& payload)
+	{
+		m_client.deliver(RPC_REQUEST_TOPIC_ID, payload.c_str());
+		(void)m_tb.loop();
+	}
+
+private:
+	Fake_MQTT_Client					 m_client;
+	Server_Side_RPC<>					 m_rpc;
+	std::array<IAPI_Implementation*, 1U> m_apis;
+	ThingsBoard							 m_tb;
+};
+
+/// @brief Request of the sum method with the values 1 to the given count as parameters
+static std::string sum_request(size_t count)
+{
+	std::string payload = "{\"method\":\"sum\",\"params\":[";
+	for (size_t i = 1U; i <= count; i++)
+	{
+		payload += (i == 1U ? "" : ",") + std::to_string(i);
+	}
+	return payload + "]}";
+}
+
+void setUp()
+{
+	calls = 0U;
+	sum	  = 0;
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_method_name_compared_in_place()
+{
+	Test_Client client(true);
+
+	// Escaped characters are unescaped before the method name is compared
+	client.request("{\"params\":[1,2],\"method\":\"to\\u0067gle\"}");
+	TEST_ASSERT_EQUAL_UINT32(1U, calls);
+	TEST_ASSERT_EQUAL_INT64(3, sum);
+
+	// Method names that only start with, or are a prefix of, a subscribed method are not found
+	client.request("{\"method\":\"sums\",\"params\":[1]}");
+	client.request("{\"method\":\"su\",\"params\":[1]}");
+	TEST_ASSERT_EQUAL_UINT32(1U, calls);
+}
+
+static void test_long_method_name_not_copied()
+{
+	Test_Client client(true);
+
+	// Method names almost as big as the receive buffer are hashed and compared without copying them onto the stack
+	const std::string long_name(BUFFER_SIZE - 64U, 's');
+	client.request("{\"method\":\"" + long_name + "\",\"params\":[1]}");
+	TEST_ASSERT_EQUAL_UINT32(0U, calls);
+
+	client.request("{\"method\":\"sum\",\"params\":[4,5]}");
+	TEST_ASSERT_EQUAL_UINT32(1U, calls);
+	TEST_ASSERT_EQUAL_INT64(9, sum);
+}
+
+static void test_long_number_not_copied()
+{
+	Test_Client client(true);
+
+	// Numbers longer than deserializeJson() accepts are read as 0 instead of being copied onto the stack
+	const std::string long_number = "1" + std::string(BUFFER_SIZE - 64U, '0') + ".5";
+	client.request("{\"method\":\"sum\",\"params\":[2," + long_number + "]}");
+	TEST_ASSERT_EQUAL_UINT32(1U, calls);
+	TEST_ASSERT_EQUAL_INT64(2, sum);
+}
+
+/// @brief Average time in microseconds the given client takes to handle the given request
+static double time_request(Test_Client& client, const std::string& payload)
+{
+	const auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0U; i < BENCHMARK_ITERATIONS; i++)
+	{
+		client.request(payload);
+	}
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / BENCHMARK_ITERATIONS;
+}
+
+static void test_benchmark_events_against_dom()
+{
+	Test_Client dom(false);
+	Test_Client events(true);
+
+	for (const size_t count : { 64U, 512U })
+	{
+		const std::string payload = sum_request(count);
+		const int64_t	  expected = static_cast<int64_t>(count * (count + 1U) / 2U);
+
+		const double dom_us = time_request(dom, payload);
+		TEST_ASSERT_EQUAL_INT64(expected, sum);
+		const double events_us = time_request(events, payload);
+		TEST_ASSERT_EQUAL_INT64(expected, sum);
+
+		char message[96];
+		snprintf(message, sizeof(message), "%3u values, %5u bytes: dom %.1f us, events %.1f us",
+			static_cast<unsigned>(count), static_cast<unsigned>(payload.size()), dom_us, events_us);
+		TEST_MESSAGE(message);
+	}
+	TEST_ASSERT_EQUAL_UINT32(4U * BENCHMARK_ITERATIONS, calls);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_method_name_compared_in_place);
+	RUN_TEST(test_long_method_name_not_copied);
+	RUN_TEST(test_long_number_not_copied);
+	RUN_TEST(test_benchmark_events_against_dom);
+	return UNITY_END();
+}
@@ -0,0 +1,141 @@
+#include "Fake_MQTT_Client.h"
+
+#include <Shared_Attribute_Update.h>
+#include <ThingsBoard.h>
+#include <array>
+#include <unity.h>
+
+// Topic shared attribute updates are received on
+constexpr char ATTRIBUTE_UPDATE_TOPIC[] = "v1/devices/me/attributes";
+
+// Amount of keys of the first callback, spans two words of the interest bitsets,
+// the keys are interned in subscription order so key i has id i
+constexpr size_t KEY_COUNT = 40U;
+
+static char		   key_names[KEY_COUNT][4U];
+static const char* keys[KEY_COUNT];
+
+// Keys on both sides of the word boundary of the interest bitsets, id 31 is the highest bit of the first word
+static const char* const BOUNDARY_KEYS[2U] = { "k31", "k32" };
+
+/// @brief Received subsets of a callback, serialized to compare them as strings
+struct Received
+{
+	size_t		calls;
+	std::string json;
+};
+
+static Received all_keys;
+static Received boundary_keys;
+static Received any_key;
+
+static void record(Received& received, const JsonObjectConst& data)
+{
+	received.calls++;
+	received.json.clear();
+	serializeJson(data, received.json);
+}
+
+static void on_all_keys(const JsonObjectConst& data)
+{
+	record(all_keys, data);
+}
+
+static void on_boundary_keys(const JsonObjectConst& data)
+{
+	record(boundary_keys, data);
+}
+
+static void on_any_key(const JsonObjectConst& data)
+{
+	record(any_key, data);
+}
+
+void setUp()
+{
+	for (size_t i = 0U; i < KEY_COUNT; i++)
+	{
+		snprintf(key_names[i], sizeof(key_names[i]), "k%u", static_cast<unsigned>(i));
+		keys[i] = key_names[i];
+	}
+	all_keys	  = Received();
+	boundary_keys = Received();
+	any_key		  = Received();
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+/// @brief Delivers the given update to a ThingsBoard instance with the three test callbacks subscribed
+static void deliver_update(const char* payload)
+{
+	Fake_MQTT_Client						 client;
+	Shared_Attribute_Update<>				 shared_update;
+	const std::array<IAPI_Implementation*, 1U> apis = { &shared_update };
+	ThingsBoard tb(client, 512U, 512U, Default_Max_Stack_Size, Default_Max_Response_Size, apis.cbegin(),
+		apis.cend());
+	TEST_ASSERT_TRUE(tb.connect("localhost", "token"));
+
+	const Shared_Attribute_Callback callbacks[3U] = { { on_all_keys, keys + 0U, keys + KEY_COUNT },
+		{ on_boundary_keys, BOUNDARY_KEYS + 0U, BOUNDARY_KEYS + 2U }, { on_any_key } };
+	TEST_ASSERT_TRUE(shared_update.Shared_Attributes_Subscribe(callbacks + 0U, callbacks + 3U));
+
+	client.deliver(ATTRIBUTE_UPDATE_TOPIC, payload);
+	(void)tb.loop();
+}
+
+static void test_highest_bit_of_word()
+{
+	deliver_update("{\"k31\":31}");
+	TEST_ASSERT_EQUAL_UINT32(1U, all_keys.calls);
+	TEST_ASSERT_EQUAL_STRING("{\"k31\":31}", all_keys.json.c_str());
+	TEST_ASSERT_EQUAL_UINT32(1U, boundary_keys.calls);
+	TEST_ASSERT_EQUAL_STRING("{\"k31\":31}", boundary_keys.json.c_str());
+}
+
+static void test_keys_across_word_boundary()
+{
+	// Subsets are built in id order, the other keys are not passed to callbacks subscribed to specific keys
+	deliver_update("{\"k39\":39,\"other\":1,\"k32\":32,\"k0\":0,\"k31\":31}");
+	TEST_ASSERT_EQUAL_UINT32(1U, all_keys.calls);
+	TEST_ASSERT_EQUAL_STRING("{\"k0\":0,\"k31\":31,\"k32\":32,\"k39\":39}", all_keys.json.c_str());
+	TEST_ASSERT_EQUAL_UINT32(1U, boundary_keys.calls);
+	TEST_ASSERT_EQUAL_STRING("{\"k31\":31,\"k32\":32}", boundary_keys.json.c_str());
+	TEST_ASSERT_EQUAL_UINT32(1U, any_key.calls);
+	TEST_ASSERT_EQUAL_STRING(
+		"{\"k39\":39,\"other\":1,\"k32\":32,\"k0\":0,\"k31\":31}", any_key.json.c_str());
+}
+
+static void test_every_bit_of_both_words()
+{
+	std::string payload = "{";
+	for (size_t i = 0U; i < KEY_COUNT; i++)
+	{
+		payload += (i == 0U ? "\"" : ",\"") + std::string(keys[i]) + "\":" + std::to_string(i);
+	}
+	payload += "}";
+	deliver_update(payload.c_str());
+	TEST_ASSERT_EQUAL_UINT32(1U, all_keys.calls);
+	TEST_ASSERT_EQUAL_STRING(payload.c_str(), all_keys.json.c_str());
+	TEST_ASSERT_EQUAL_STRING("{\"k31\":31,\"k32\":32}", boundary_keys.json.c_str());
+}
+
+static void test_unsubscribed_keys_only()
+{
+	deliver_update("{\"other\":1}");
+	TEST_ASSERT_EQUAL_UINT32(0U, all_keys.calls);
+	TEST_ASSERT_EQUAL_UINT32(0U, boundary_keys.calls);
+	TEST_ASSERT_EQUAL_UINT32(1U, any_key.calls);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_highest_bit_of_word);
+	RUN_TEST(test_keys_across_word_boundary);
+	RUN_TEST(test_every_bit_of_both_words);
+	RUN_TEST(test_unsubscribed_keys_only);
+	return UNITY_END();
+}
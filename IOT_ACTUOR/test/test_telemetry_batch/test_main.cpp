@@ -0,0 +1,226 @@
+#include "Fake_MQTT_Client.h"
+
+#include <ThingsBoard.h>
+#include <array>
+#include <chrono>
+#include <unity.h>
+
+// Amount of measurement cycles timed per benchmark round, the fastest of the rounds is reported
+constexpr size_t BENCHMARK_ITERATIONS = 10000U;
+constexpr size_t BENCHMARK_ROUNDS	  = 5U;
+
+// Measurements of a cycle of the sensor
+constexpr float TEMPERATURE = 23.4712f;
+constexpr float HUMIDITY	= 41.318f;
+constexpr int	VOC			= 112;
+constexpr float LUX			= 356.83f;
+constexpr float BATTERY		= 3.9117f;
+
+// Keys of the sensor, see IOT_SENSORT/src/main.cpp
+constexpr auto TEMPERATURE_KEY	   = Make_Json_Key("temperature", 2U);
+constexpr auto HUMIDITY_KEY		   = Make_Json_Key("humidity", 1U);
+constexpr auto VOC_KEY			   = Make_Json_Key("voc");
+constexpr auto LUX_KEY			   = Make_Json_Key("lux", 1U);
+constexpr auto BATTERY_KEY		   = Make_Json_Key("battery", 3U);
+constexpr auto TEMP_ALARM_HIGH_KEY = Make_Json_Key("temp_alarm_high");
+constexpr auto TEMP_ALARM_LOW_KEY  = Make_Json_Key("temp_alarm_low");
+constexpr auto VOC_ALARM_KEY	   = Make_Json_Key("voc_alarm");
+constexpr auto BATTERY_ALARM_KEY   = Make_Json_Key("battery_alarm");
+
+/// @brief ThingsBoard instance connected to a client that records every published message
+class Test_Client
+{
+public:
+	/// @brief Constructs the client
+	/// @param send_buffer_size Size of the send buffer of the client, including the header and topic of a message
+	/// @param zero_copy Whether the client supports reserve_publish(), otherwise every message is sent with publish()
+	explicit Test_Client(uint16_t send_buffer_size = 256U, bool zero_copy = true)
+		: m_client(zero_copy)
+		, m_apis{}
+		, m_tb(m_client, 256U, send_buffer_size, Default_Max_Stack_Size, Default_Max_Response_Size, m_apis.cbegin(),
+			  m_apis.cend())
+	{
+		TEST_ASSERT_TRUE(m_tb.connect("localhost", "token"));
+	}
+
+	ThingsBoard& tb()
+	{
+		return m_tb;
+	}
+
+	/// @brief Payload of the only published message, which is removed afterwards
+	std::string take_payload()
+	{
+		TEST_ASSERT_EQUAL_UINT32(1U, m_client.published.size());
+		const std::string payload(m_client.published.front().payload.begin(), m_client.published.front().payload.end());
+		m_client.published.clear();
+		return payload;
+	}
+
+	/// @brief Sets whether published messages are recorded
+	void record(bool enabled)
+	{
+		m_client.record = enabled;
+	}
+
+	/// @brief Amount of recorded messages and the bytes of their topics and payloads, removes them afterwards
+	size_t take_bytes(size_t& messages)
+	{
+		size_t bytes = 0U;
+		for (const Fake_MQTT_Client::Message& message : m_client.published)
+		{
+			bytes += message.topic.size() + message.payload.size();
+		}
+		messages = m_client.published.size();
+		m_client.published.clear();
+		return bytes;
+	}
+
+private:
+	Fake_MQTT_Client						   m_client;
+	const std::array<IAPI_Implementation*, 0U> m_apis;
+	ThingsBoard								   m_tb;
+};
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_batch_matches_json_document()
+{
+	Test_Client client;
+	const char* const	  text = "line\n\"quoted\"\\";
+	const Telemetry		  telemetry[] = { { "temperature", TEMPERATURE }, { "count", -42 },
+		  { "uptime", static_cast<int64_t>(8589934592LL) }, { "on", true }, { "off", false }, { "pi", 3.14159265358979 },
+		  { "escaped \"key\"\t", 1 }, { "text", text } };
+	Telemetry_Batch<8U>	  batch;
+	TEST_ASSERT_TRUE(batch.Add("temperature", TEMPERATURE));
+	TEST_ASSERT_TRUE(batch.Add("count", -42));
+	TEST_ASSERT_TRUE(batch.Add("uptime", static_cast<int64_t>(8589934592LL)));
+	TEST_ASSERT_TRUE(batch.Add("on", true));
+	TEST_ASSERT_TRUE(batch.Add("off", false));
+	TEST_ASSERT_TRUE(batch.Add("pi", 3.14159265358979));
+	TEST_ASSERT_TRUE(batch.Add("escaped \"key\"\t", 1));
+	TEST_ASSERT_TRUE(batch.Add("text", text));
+	TEST_ASSERT_FALSE(batch.Add("full", 0));
+
+	TEST_ASSERT_TRUE(client.tb().sendTelemetry(telemetry + 0U, telemetry + 8U));
+	const std::string document = client.take_payload();
+	TEST_ASSERT_TRUE(client.tb().sendTelemetry(batch));
+	const std::string batched = client.take_payload();
+	TEST_ASSERT_EQUAL_STRING(document.c_str(), batched.c_str());
+	TEST_ASSERT_EQUAL_UINT32(batched.size(), batch.Measure_Json());
+}
+
+static void test_batch_is_sent_as_one_message()
+{
+	Test_Client			client;
+	Telemetry_Batch<5U> batch;
+	TEST_ASSERT_TRUE(batch.Add("temperature", 23.5f));
+	TEST_ASSERT_TRUE(batch.Add("voc", VOC));
+	TEST_ASSERT_TRUE(client.tb().sendTelemetry(batch));
+	TEST_ASSERT_EQUAL_STRING("{\"temperature\":23.5,\"voc\":112}", client.take_payload().c_str());
+}
+
+static void test_largest_sensor_cycle_needs_its_send_buffer()
+{
+	// Every measurement of the sensor at its longest value and every alarm changed
+	Telemetry_Batch<9U> batch;
+	TEST_ASSERT_TRUE(batch.Add(TEMPERATURE_KEY, -39.99f));
+	TEST_ASSERT_TRUE(batch.Add(HUMIDITY_KEY, 99.9f));
+	TEST_ASSERT_TRUE(batch.Add(VOC_KEY, static_cast<uint16_t>(65535U)));
+	TEST_ASSERT_TRUE(batch.Add(LUX_KEY, 121556.9f));
+	TEST_ASSERT_TRUE(batch.Add(BATTERY_KEY, 6.599f));
+	TEST_ASSERT_TRUE(batch.Add(TEMP_ALARM_HIGH_KEY, false));
+	TEST_ASSERT_TRUE(batch.Add(TEMP_ALARM_LOW_KEY, false));
+	TEST_ASSERT_TRUE(batch.Add(VOC_ALARM_KEY, false));
+	TEST_ASSERT_TRUE(batch.Add(BATTERY_ALARM_KEY, false));
+	const size_t json_size = batch.Measure_Json();
+	// Header, topic and payload of the published message
+	const size_t message_size = MQTT_PUBLISH_OVERHEAD + strlen(TELEMETRY_TOPIC) + json_size;
+	// Send buffer the sensor is constructed with, the json is serialized with its null terminator into the send buffer
+	const uint16_t sensor_send_buffer_size =
+		static_cast<uint16_t>(MQTT_PUBLISH_OVERHEAD + sizeof(TELEMETRY_TOPIC) + json_size);
+
+	for (const bool zero_copy : { true, false })
+	{
+		// The payload alone is already bigger than the default buffer, which dropped the telemetry of every cycle
+		Test_Client default_client(Default_Payload_Size, zero_copy);
+		TEST_ASSERT_FALSE(default_client.tb().sendTelemetry(batch));
+		// A buffer that only fits the payload without the header and topic is not enough either
+		Test_Client payload_only_client(static_cast<uint16_t>(message_size - 1U), zero_copy);
+		TEST_ASSERT_FALSE(payload_only_client.tb().sendTelemetry(batch));
+
+		Test_Client sensor_client(sensor_send_buffer_size, zero_copy);
+		TEST_ASSERT_TRUE(sensor_client.tb().sendTelemetry(batch));
+		TEST_ASSERT_EQUAL_UINT32(json_size, sensor_client.take_payload().size());
+	}
+}
+
+/// @brief Times sending the measurements of one cycle with the given method and reports it
+template <typename Send>
+static void time_cycle(const char* name, Send send)
+{
+	Test_Client client;
+	TEST_ASSERT_TRUE(send(client.tb()));
+	size_t		 messages = 0U;
+	const size_t bytes	  = client.take_bytes(messages);
+
+	client.record(false);
+	double fastest_ns = 0.0;
+	for (size_t round = 0U; round < BENCHMARK_ROUNDS; round++)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0U; i < BENCHMARK_ITERATIONS; i++)
+		{
+			TEST_ASSERT_TRUE(send(client.tb()));
+		}
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		const double								   cycle_ns = elapsed.count() / BENCHMARK_ITERATIONS;
+		fastest_ns = (round == 0U || cycle_ns < fastest_ns) ? cycle_ns : fastest_ns;
+	}
+
+	char message[128];
+	snprintf(message, sizeof(message), "%-20s %u messages, %3u bytes of topic and payload, %5.0f ns", name,
+		static_cast<unsigned>(messages), static_cast<unsigned>(bytes), fastest_ns);
+	TEST_MESSAGE(message);
+}
+
+static void test_benchmark_against_send_telemetry()
+{
+	time_cycle("sendTelemetryData x5", [](ThingsBoard& tb) {
+		return tb.sendTelemetryData("temperature", TEMPERATURE) && tb.sendTelemetryData("humidity", HUMIDITY) &&
+			   tb.sendTelemetryData("voc", VOC) && tb.sendTelemetryData("lux", LUX) &&
+			   tb.sendTelemetryData("battery", BATTERY);
+	});
+	time_cycle("sendTelemetry", [](ThingsBoard& tb) {
+		const Telemetry telemetry[5U] = { { "temperature", TEMPERATURE }, { "humidity", HUMIDITY }, { "voc", VOC },
+			{ "lux", LUX }, { "battery", BATTERY } };
+		return tb.sendTelemetry(telemetry + 0U, telemetry + 5U);
+	});
+	time_cycle("Telemetry_Batch", [](ThingsBoard& tb) {
+		Telemetry_Batch<5U> batch;
+		(void)batch.Add("temperature", TEMPERATURE);
+		(void)batch.Add("humidity", HUMIDITY);
+		(void)batch.Add("voc", VOC);
+		(void)batch.Add("lux", LUX);
+		(void)batch.Add("battery", BATTERY);
+		return tb.sendTelemetry(batch);
+	});
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_batch_matches_json_document);
+	RUN_TEST(test_batch_is_sent_as_one_message);
+	RUN_TEST(test_largest_sensor_cycle_needs_its_send_buffer);
+	RUN_TEST(test_benchmark_against_send_telemetry);
+	return UNITY_END();
+}
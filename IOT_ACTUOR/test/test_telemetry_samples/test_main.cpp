@@ -0,0 +1,135 @@
+#include "Fake_MQTT_Client.h"
+
+#include <ThingsBoard.h>
+#include <array>
+#include <string>
+#include <unity.h>
+
+// Amount of samples sent at once, with consecutive timestamps starting at FIRST_TIMESTAMP
+constexpr size_t   SAMPLE_AMOUNT   = 7U;
+constexpr uint64_t FIRST_TIMESTAMP = 1000U;
+
+// Every sample is written as {"ts":1000,"values":{"t":0}}, messages are [..] with a comma between the samples
+constexpr size_t SAMPLE_LENGTH = 28U;
+
+/// @brief Size of the send buffer that fits exactly the given amount of samples into one message, including the header and topic
+static constexpr uint16_t send_buffer_size(size_t samples)
+{
+	return static_cast<uint16_t>(MQTT_PUBLISH_OVERHEAD + sizeof(TELEMETRY_TOPIC) + 1U + samples * (SAMPLE_LENGTH + 1U));
+}
+
+/// @brief Samples with one value each and the timestamp of their index
+static std::array<Telemetry_Batch<1U>, SAMPLE_AMOUNT> make_samples()
+{
+	std::array<Telemetry_Batch<1U>, SAMPLE_AMOUNT> samples;
+	for (size_t i = 0U; i < samples.size(); i++)
+	{
+		TEST_ASSERT_TRUE(samples[i].Add("t", static_cast<int>(i)));
+		samples[i].Set_Timestamp(FIRST_TIMESTAMP + i);
+		TEST_ASSERT_EQUAL_UINT32(SAMPLE_LENGTH, samples[i].Measure_Json());
+	}
+	return samples;
+}
+
+/// @brief Message the samples with the given indices are expected to be combined into
+static std::string expected_message(size_t first, size_t last)
+{
+	std::string message = "[";
+	char		sample[SAMPLE_LENGTH + 1U];
+	for (size_t i = first; i < last; i++)
+	{
+		snprintf(sample, sizeof(sample), "{\"ts\":%u,\"values\":{\"t\":%u}}",
+			static_cast<unsigned>(FIRST_TIMESTAMP + i), static_cast<unsigned>(i));
+		message += (i != first ? "," : "");
+		message += sample;
+	}
+	return message + "]";
+}
+
+/// @brief Sends the given samples over a client with the given send buffer and checks they were split into messages of the given size
+/// @param zero_copy Whether the client supports reserve_publish(), otherwise every message is sent with publish()
+/// @param per_message Amount of samples expected in every message except the last one
+template <size_t SampleAmount>
+static void assert_split(const std::array<Telemetry_Batch<1U>, SampleAmount>& samples, uint16_t buffer_size,
+	bool zero_copy, size_t per_message)
+{
+	Fake_MQTT_Client						   client(zero_copy);
+	const std::array<IAPI_Implementation*, 0U> apis = {};
+	ThingsBoard tb(client, 256U, buffer_size, Default_Max_Stack_Size, Default_Max_Response_Size, apis.cbegin(), apis.cend());
+	TEST_ASSERT_TRUE(tb.connect("localhost", "token"));
+	// Sent twice, so the second call reuses the memory of the first one if the client does not support reserve_publish()
+	for (size_t call = 0U; call < 2U; call++)
+	{
+		TEST_ASSERT_TRUE(tb.sendTelemetrySamples(samples.cbegin(), samples.cend()));
+		TEST_ASSERT_EQUAL_UINT32((SampleAmount + per_message - 1U) / per_message, client.published.size());
+		for (size_t i = 0U; i < client.published.size(); i++)
+		{
+			const size_t	  first = i * per_message;
+			const std::string payload(client.published[i].payload.begin(), client.published[i].payload.end());
+			TEST_ASSERT_EQUAL_STRING(TELEMETRY_TOPIC, client.published[i].topic.c_str());
+			TEST_ASSERT_EQUAL_STRING(
+				expected_message(first, first + per_message < SampleAmount ? first + per_message : SampleAmount).c_str(),
+				payload.c_str());
+		}
+		client.published.clear();
+	}
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_samples_fill_every_message()
+{
+	const std::array<Telemetry_Batch<1U>, SAMPLE_AMOUNT> samples = make_samples();
+	for (const bool zero_copy : { true, false })
+	{
+		assert_split(samples, send_buffer_size(SAMPLE_AMOUNT), zero_copy, SAMPLE_AMOUNT);
+		assert_split(samples, send_buffer_size(3U), zero_copy, 3U);
+		// One byte less than three samples need, the third one moves into the next message
+		assert_split(samples, send_buffer_size(3U) - 1U, zero_copy, 2U);
+		assert_split(samples, send_buffer_size(1U), zero_copy, 1U);
+	}
+}
+
+static void test_sample_too_big_for_the_buffer_is_skipped()
+{
+	std::array<Telemetry_Batch<1U>, SAMPLE_AMOUNT> samples = make_samples();
+	const std::string							   text(2U * SAMPLE_LENGTH, 'x');
+	Telemetry_Batch<1U>							   oversized;
+	TEST_ASSERT_TRUE(oversized.Add("text", text.c_str()));
+	samples[3U] = oversized;
+
+	for (const bool zero_copy : { true, false })
+	{
+		Fake_MQTT_Client						   client(zero_copy);
+		const std::array<IAPI_Implementation*, 0U> apis = {};
+		ThingsBoard tb(client, 256U, send_buffer_size(2U), Default_Max_Stack_Size, Default_Max_Response_Size,
+			apis.cbegin(), apis.cend());
+		TEST_ASSERT_TRUE(tb.connect("localhost", "token"));
+		// Every other sample is still sent, the one before and after the skipped sample are not combined
+		TEST_ASSERT_FALSE(tb.sendTelemetrySamples(samples.cbegin(), samples.cend()));
+		TEST_ASSERT_EQUAL_UINT32(4U, client.published.size());
+		const std::string expected[4U] = { expected_message(0U, 2U), expected_message(2U, 3U), expected_message(4U, 6U),
+			expected_message(6U, 7U) };
+		for (size_t i = 0U; i < 4U; i++)
+		{
+			const std::string payload(client.published[i].payload.begin(), client.published[i].payload.end());
+			TEST_ASSERT_EQUAL_STRING(expected[i].c_str(), payload.c_str());
+		}
+	}
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_samples_fill_every_message);
+	RUN_TEST(test_sample_too_big_for_the_buffer_is_skipped);
+	return UNITY_END();
+}
@@ -0,0 +1,139 @@
+#include <Client_Side_RPC.h>
+#include <Helper.h>
+#include <chrono>
+#include <unity.h>
+
+// Amount of topics built or parsed per benchmark round, the fastest of the rounds is reported
+constexpr size_t BENCHMARK_ITERATIONS = 200000U;
+constexpr size_t BENCHMARK_ROUNDS	  = 5U;
+
+// Format the topics were built with before the constant prefixes
+constexpr char RPC_SEND_REQUEST_TOPIC_FORMAT[] = "v1/devices/me/rpc/request/%u";
+
+// Request id of the parsing benchmark
+constexpr size_t PARSED_REQUEST_ID = 12345U;
+
+/// @brief Builds the topic with the given request id through snprintf, like it was done before the constant prefixes,
+/// the result is written into a fixed buffer instead of a variable length array sized with the first pass
+static size_t format_topic(char* buffer, size_t size, size_t request_id)
+{
+	const int length = Helper::detectSize(RPC_SEND_REQUEST_TOPIC_FORMAT, static_cast<unsigned>(request_id));
+	TEST_ASSERT_TRUE(static_cast<size_t>(length) <= size);
+	return static_cast<size_t>(
+		snprintf(buffer, static_cast<size_t>(length), RPC_SEND_REQUEST_TOPIC_FORMAT, static_cast<unsigned>(request_id)));
+}
+
+/// @brief Parses the request id from the given topic like it was done before the constant prefixes,
+/// by formatting the base topic again only to measure its length
+static size_t format_and_parse(const char* topic)
+{
+	char	  base[64];
+	const int length = Helper::detectSize(RPC_SEND_REQUEST_TOPIC_FORMAT, 0U);
+	TEST_ASSERT_TRUE(static_cast<size_t>(length) <= sizeof(base));
+	(void)snprintf(base, static_cast<size_t>(length), RPC_SEND_REQUEST_TOPIC_FORMAT, 0U);
+	return static_cast<size_t>(atoi(topic + strlen(base) - 1U));
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_build_matches_snprintf()
+{
+	char expected[RPC_SEND_REQUEST_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U];
+	char built[RPC_SEND_REQUEST_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U];
+	// Every amount of digits, on both sides of each power of ten, up to the biggest request id
+	size_t power = 1U;
+	for (size_t digits = 1U; digits <= MAX_DECIMAL_DIGITS; digits++)
+	{
+		for (const size_t number : { power - 1U, power, power + 1U })
+		{
+			snprintf(expected, sizeof(expected), "%s%zu", RPC_SEND_REQUEST_TOPIC, number);
+			const size_t length = Helper::buildTopic(built, RPC_SEND_REQUEST_TOPIC, RPC_SEND_REQUEST_TOPIC_LENGTH, number);
+			TEST_ASSERT_EQUAL_STRING(expected, built);
+			TEST_ASSERT_EQUAL_UINT32(strlen(expected), length);
+		}
+		power = digits < MAX_DECIMAL_DIGITS ? power * 10U : power;
+	}
+	const size_t max = ~static_cast<size_t>(0U);
+	snprintf(expected, sizeof(expected), "%s%zu", RPC_SEND_REQUEST_TOPIC, max);
+	TEST_ASSERT_EQUAL_UINT32(strlen(expected),
+		Helper::buildTopic(built, RPC_SEND_REQUEST_TOPIC, RPC_SEND_REQUEST_TOPIC_LENGTH, max));
+	TEST_ASSERT_EQUAL_STRING(expected, built);
+}
+
+static void test_parse_round_trip()
+{
+	char topic[RPC_RESPONSE_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U];
+	for (const size_t number : { static_cast<size_t>(0U), static_cast<size_t>(7U), static_cast<size_t>(10U),
+			 static_cast<size_t>(65535U), static_cast<size_t>(4294967295U), ~static_cast<size_t>(0U) })
+	{
+		(void)Helper::buildTopic(topic, RPC_RESPONSE_TOPIC, RPC_RESPONSE_TOPIC_LENGTH, number);
+		TEST_ASSERT_TRUE(Helper::parseRequestId(topic, RPC_RESPONSE_TOPIC_LENGTH) == number);
+		TEST_ASSERT_TRUE(Helper::parseRequestId(RPC_RESPONSE_TOPIC, topic) == number);
+	}
+	// Parsing stops at the first character that is not a digit, like the chunk part of firmware response topics
+	TEST_ASSERT_EQUAL_UINT32(42U, Helper::parseRequestId("v2/fw/response/42/chunk/3", sizeof("v2/fw/response/") - 1U));
+	TEST_ASSERT_EQUAL_UINT32(0U, Helper::parseRequestId("v1/devices/me/rpc/response/", RPC_RESPONSE_TOPIC_LENGTH));
+}
+
+/// @brief Fastest time in nanoseconds the given operation takes
+template <typename Operation>
+static double time_operation(Operation operation)
+{
+	double fastest_ns = 0.0;
+	for (size_t round = 0U; round < BENCHMARK_ROUNDS; round++)
+	{
+		size_t	   total = 0U;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0U; i < BENCHMARK_ITERATIONS; i++)
+		{
+			total += operation(i);
+			// Keeps the compiler from hoisting the operation out of the loop
+			asm volatile("" : "+r"(total) : : "memory");
+		}
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		TEST_ASSERT_TRUE(total != 0U);
+		const double operation_ns = elapsed.count() / BENCHMARK_ITERATIONS;
+		fastest_ns				  = (round == 0U || operation_ns < fastest_ns) ? operation_ns : fastest_ns;
+	}
+	return fastest_ns;
+}
+
+static void test_benchmark_against_snprintf()
+{
+	char topic[RPC_SEND_REQUEST_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U];
+	const double format_ns = time_operation([&topic](size_t i) { return format_topic(topic, sizeof(topic), i); });
+	const double build_ns  = time_operation([&topic](size_t i) {
+		 return Helper::buildTopic(topic, RPC_SEND_REQUEST_TOPIC, RPC_SEND_REQUEST_TOPIC_LENGTH, i);
+	 });
+
+	(void)Helper::buildTopic(topic, RPC_SEND_REQUEST_TOPIC, RPC_SEND_REQUEST_TOPIC_LENGTH, PARSED_REQUEST_ID);
+	TEST_ASSERT_EQUAL_UINT32(PARSED_REQUEST_ID, format_and_parse(topic));
+	const double old_parse_ns = time_operation([&topic](size_t i) { return format_and_parse(topic) + i; });
+	const double parse_ns	  = time_operation(
+		[&topic](size_t i) { return Helper::parseRequestId(topic, RPC_SEND_REQUEST_TOPIC_LENGTH) + i; });
+
+	char message[128];
+	snprintf(message, sizeof(message), "topic build: detectSize + snprintf %.0f ns, buildTopic %.0f ns", format_ns,
+		build_ns);
+	TEST_MESSAGE(message);
+	snprintf(message, sizeof(message), "id parse: snprintf + strlen + atoi %.0f ns, parseRequestId %.0f ns",
+		old_parse_ns, parse_ns);
+	TEST_MESSAGE(message);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_build_matches_snprintf);
+	RUN_TEST(test_parse_round_trip);
+	RUN_TEST(test_benchmark_against_snprintf);
+	return UNITY_END();
+}
@@ -0,0 +1,303 @@
+#include <ThingsBoard.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iterator>
+#include <unity.h>
+#include <vector>
+
+// Amount of times every topic is routed per benchmark round, the fastest of the rounds is reported
+constexpr size_t BENCHMARK_ITERATIONS = 2000U;
+constexpr size_t BENCHMARK_ROUNDS	  = 5U;
+
+/// @brief API implementation that only matches topics, compares them the same way the API implementations of the library do
+class Test_API : public IAPI_Implementation
+{
+public:
+	/// @brief How the response topic is compared with received topics
+	enum class Match
+	{
+		EXACT, ///< The whole topic has to be equal, like Shared_Attribute_Update
+		PREFIX ///< The topic has to start with the response topic, like Server_Side_RPC
+	};
+
+	/// @brief Constructs the API implementation
+	/// @param type Process type the topic is routed with
+	/// @param topic Response topic received topics are compared with
+	/// @param match How the response topic is compared
+	/// @param prefix Prefix returned for routing, nullptr to be routed every topic like custom API implementations
+	Test_API(API_Process_Type type, const char* topic, Match match, const char* prefix)
+		: m_type(type)
+		, m_topic(topic)
+		, m_match(match)
+		, m_prefix(prefix)
+	{
+		// Nothing to do
+	}
+
+	API_Process_Type Get_Process_Type() const override
+	{
+		return m_type;
+	}
+
+	void Process_Response(const char* topic, uint8_t* payload, unsigned int length) override
+	{
+		(void)topic;
+		(void)payload;
+		(void)length;
+	}
+
+	void Process_Json_Response(const char* topic, const JsonDocument& data) override
+	{
+		(void)topic;
+		(void)data;
+	}
+
+	bool Compare_Response_Topic(const char* topic) const override
+	{
+		const size_t length = strlen(m_topic);
+		return strncmp(m_topic, topic, m_match == Match::EXACT ? length + 1U : length) == 0;
+	}
+
+	const char* Get_Response_Topic_Prefix() const override
+	{
+		return m_prefix;
+	}
+
+	bool Unsubscribe() override
+	{
+		return true;
+	}
+
+	bool Resubscribe_Topic() override
+	{
+		return true;
+	}
+
+	void loop() override
+	{
+		// Nothing to do
+	}
+
+	void Initialize() override
+	{
+		// Nothing to do
+	}
+
+	void Set_Client_Callbacks(Callback<void, IAPI_Implementation&>::function subscribe_api_callback,
+		Callback<bool, const char* const, const JsonDocument&, const size_t&>::function send_json_callback,
+		Callback<bool, const char* const, const char* const>::function send_json_string_callback,
+		Callback<bool, const char* const>::function subscribe_topic_callback,
+		Callback<bool, const char* const>::function unsubscribe_topic_callback,
+		Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback,
+		Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback,
+		Callback<size_t*>::function get_request_id_callback) override
+	{
+		(void)subscribe_api_callback;
+		(void)send_json_callback;
+		(void)send_json_string_callback;
+		(void)subscribe_topic_callback;
+		(void)unsubscribe_topic_callback;
+		(void)get_receive_size_callback;
+		(void)get_send_size_callback;
+		(void)set_buffer_size_callback;
+		(void)get_request_id_callback;
+	}
+
+private:
+	API_Process_Type m_type;
+	const char*		 m_topic;
+	Match			 m_match;
+	const char*		 m_prefix;
+};
+
+// Every API implementation of the library with its topic and prefix, some of them subscribed twice like multiple instances would be,
+// and custom API implementations, one of them without a prefix
+static Test_API shared_attributes(API_Process_Type::JSON_EVENTS, "v1/devices/me/attributes", Test_API::Match::EXACT,
+	"v1/devices/me/attributes");
+static Test_API attribute_request(API_Process_Type::JSON, "v1/devices/me/attributes/response/", Test_API::Match::PREFIX,
+	"v1/devices/me/attributes/response/");
+static Test_API server_rpc(API_Process_Type::JSON_EVENTS, "v1/devices/me/rpc/request/", Test_API::Match::PREFIX,
+	"v1/devices/me/rpc/request/");
+static Test_API client_rpc(
+	API_Process_Type::JSON, "v1/devices/me/rpc/response/", Test_API::Match::PREFIX, "v1/devices/me/rpc/response/");
+static Test_API ota(API_Process_Type::RAW, "v2/fw/response/0/chunk/", Test_API::Match::PREFIX, "v2/fw/response/");
+static Test_API provision(API_Process_Type::JSON, "/provision/response", Test_API::Match::EXACT, "/provision/response");
+static Test_API gateway_rpc(API_Process_Type::JSON, "v1/gateway/rpc", Test_API::Match::EXACT, "v1/gateway/rpc");
+static Test_API gateway_attributes(
+	API_Process_Type::JSON, "v1/gateway/attributes", Test_API::Match::EXACT, "v1/gateway/attributes");
+static Test_API second_attribute_request(API_Process_Type::JSON, "v1/devices/me/attributes/response/",
+	Test_API::Match::PREFIX, "v1/devices/me/attributes/response/");
+static Test_API second_shared_attributes(API_Process_Type::JSON, "v1/devices/me/attributes", Test_API::Match::EXACT,
+	"v1/devices/me/attributes");
+static Test_API second_server_rpc(API_Process_Type::JSON, "v1/devices/me/rpc/request/", Test_API::Match::PREFIX,
+	"v1/devices/me/rpc/request/");
+static Test_API custom_without_prefix(API_Process_Type::JSON, "custom/topic", Test_API::Match::EXACT, nullptr);
+static Test_API custom_raw(API_Process_Type::RAW, "v2/sw/response/", Test_API::Match::PREFIX, "v2/sw/response/");
+
+static const std::array<IAPI_Implementation*, 13U> APIS = { &shared_attributes, &attribute_request, &server_rpc,
+	&client_rpc, &ota, &provision, &gateway_rpc, &gateway_attributes, &second_attribute_request,
+	&second_shared_attributes, &second_server_rpc, &custom_without_prefix, &custom_raw };
+
+// Received topics, matching one or more API implementations, only matching their prefix or none at all
+static const char* const TOPICS[] = { "v1/devices/me/attributes", "v1/devices/me/attributes/response/7",
+	"v1/devices/me/rpc/request/42", "v1/devices/me/rpc/response/3", "v2/fw/response/0/chunk/12",
+	"v2/fw/response/1/chunk/12", "/provision/response", "/provision/responses", "v1/gateway/rpc",
+	"v1/gateway/attributes", "v1/gateway/attributes/response", "custom/topic", "v2/sw/response/5/chunk/0",
+	"v1/devices/me/telemetry", "v1/devices", "v1/", "", "x" };
+
+constexpr size_t TOPIC_COUNT = sizeof(TOPICS) / sizeof(TOPICS[0]);
+
+/// @brief API implementations that handle the given topic found with a linear scan, raw ones first then json events then json,
+/// each in subscription order, which is the order onMQTTMessage() passes the response to them in
+static std::vector<IAPI_Implementation*> scan(const char* topic)
+{
+	std::vector<IAPI_Implementation*> handlers;
+	for (const API_Process_Type type : { API_Process_Type::RAW, API_Process_Type::JSON_EVENTS, API_Process_Type::JSON })
+	{
+		for (IAPI_Implementation* api : APIS)
+		{
+			if (api->Get_Process_Type() == type && api->Compare_Response_Topic(topic))
+			{
+				handlers.push_back(api);
+			}
+		}
+	}
+	return handlers;
+}
+
+/// @brief API implementations that handle the given topic found with the router
+static std::vector<IAPI_Implementation*> route(const Topic_Router& router, const char* topic)
+{
+	std::vector<IAPI_Implementation*> handlers;
+	const Topic_Route				  found = router.Route(topic);
+	for (auto it = found.first; it != found.last; ++it)
+	{
+		if ((*it)->Compare_Response_Topic(topic))
+		{
+			handlers.push_back(*it);
+		}
+	}
+	return handlers;
+}
+
+void setUp()
+{
+	// Nothing to do
+}
+
+void tearDown()
+{
+	// Nothing to do
+}
+
+static void test_routes_match_linear_scan()
+{
+	Topic_Router router;
+	router.Build(APIS.cbegin(), APIS.cend());
+	for (const char* topic : TOPICS)
+	{
+		const std::vector<IAPI_Implementation*> expected = scan(topic);
+		const std::vector<IAPI_Implementation*> routed	 = route(router, topic);
+		TEST_ASSERT_EQUAL_UINT32_MESSAGE(expected.size(), routed.size(), topic);
+		for (size_t i = 0U; i < expected.size(); i++)
+		{
+			TEST_ASSERT_EQUAL_PTR_MESSAGE(expected[i], routed[i], topic);
+		}
+	}
+}
+
+static void test_routes_are_grouped_by_process_type()
+{
+	Topic_Router router;
+	router.Build(APIS.cbegin(), APIS.cend());
+	const Topic_Route found = router.Route("v1/devices/me/attributes");
+	for (auto it = found.first; it != found.raw_last; ++it)
+	{
+		TEST_ASSERT_TRUE((*it)->Get_Process_Type() == API_Process_Type::RAW);
+	}
+	for (auto it = found.raw_last; it != found.events_last; ++it)
+	{
+		TEST_ASSERT_TRUE((*it)->Get_Process_Type() == API_Process_Type::JSON_EVENTS);
+	}
+	for (auto it = found.events_last; it != found.last; ++it)
+	{
+		TEST_ASSERT_TRUE((*it)->Get_Process_Type() == API_Process_Type::JSON);
+	}
+
+	// Only the API implementations with a prefix of the topic and the one without any prefix are candidates
+	TEST_ASSERT_EQUAL_UINT32(3U, static_cast<size_t>(found.last - found.first));
+	TEST_ASSERT_EQUAL_PTR(&shared_attributes, found.first[0]);
+	TEST_ASSERT_EQUAL_PTR(&second_shared_attributes, found.first[1]);
+	TEST_ASSERT_EQUAL_PTR(&custom_without_prefix, found.first[2]);
+}
+
+/// @brief Fastest time in nanoseconds finding the handlers of one topic takes with the given method
+template <typename Find>
+static double time_topics(Find find)
+{
+	double fastest_ns = 0.0;
+	for (size_t round = 0U; round < BENCHMARK_ROUNDS; round++)
+	{
+		size_t	   total = 0U;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0U; i < BENCHMARK_ITERATIONS; i++)
+		{
+			for (const char* topic : TOPICS)
+			{
+				total += find(topic);
+				// Keeps the compiler from hoisting the search out of the loop
+				asm volatile("" : "+r"(total) : : "memory");
+			}
+		}
+		const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+		TEST_ASSERT_TRUE(total != 0U);
+		const double topic_ns = elapsed.count() / (BENCHMARK_ITERATIONS * TOPIC_COUNT);
+		fastest_ns			  = (round == 0U || topic_ns < fastest_ns) ? topic_ns : fastest_ns;
+	}
+	return fastest_ns;
+}
+
+static void test_benchmark_against_copy_if()
+{
+	Topic_Router router;
+	router.Build(APIS.cbegin(), APIS.cend());
+	const Vector<IAPI_Implementation*> apis(APIS.cbegin(), APIS.cend());
+
+	// Filtering onMQTTMessage() did before the router, one filtered copy of every API implementation per process type
+	const double copy_if_ns = time_topics([&apis](const char* topic) {
+		size_t handlers = 0U;
+		for (const API_Process_Type type : { API_Process_Type::RAW, API_Process_Type::JSON_EVENTS, API_Process_Type::JSON })
+		{
+			Vector<IAPI_Implementation*> filtered = {};
+			std::copy_if(apis.begin(), apis.end(), std::back_inserter(filtered), [&topic, type](const IAPI_Implementation* api) {
+				return api != nullptr && api->Get_Process_Type() == type && api->Compare_Response_Topic(topic);
+			});
+			handlers += filtered.size();
+		}
+		return handlers + 1U;
+	});
+	const double router_ns	= time_topics([&router](const char* topic) {
+		 size_t			   handlers = 0U;
+		 const Topic_Route found	= router.Route(topic);
+		 for (auto it = found.first; it != found.last; ++it)
+		 {
+			 handlers += (*it)->Compare_Response_Topic(topic) ? 1U : 0U;
+		 }
+		 return handlers + 1U;
+	 });
+
+	char message[128];
+	snprintf(message, sizeof(message), "%u APIs, %u topics: copy_if %.0f ns per topic, Topic_Router %.0f ns per topic",
+		static_cast<unsigned>(APIS.size()), static_cast<unsigned>(TOPIC_COUNT), copy_if_ns, router_ns);
+	TEST_MESSAGE(message);
+}
+
+int main()
+{
+	UNITY_BEGIN();
+	RUN_TEST(test_routes_match_linear_scan);
+	RUN_TEST(test_routes_are_grouped_by_process_type);
+	RUN_TEST(test_benchmark_against_copy_if);
+	return UNITY_END();
+}
@@ -11,6 +11,15 @@
 // BATTERY TESTING ENABLE / DISABLE
 #define BAT_TEST_ENABLE true
 
+// LOCAL TRANSPORT ENABLE / DISABLE
+// Sends samples and alarm commands directly to the actuator over UDP, in parallel to ThingsBoard
+#define LOCAL_TRANSPORT_ENABLE true
+
+// PUBLISH QUEUE ENABLE / DISABLE
+// Queues the messages sent to ThingsBoard and sends them from tb.loop(), so a slow connection
+// does not delay the measurements
+#define PUBLISH_QUEUE_ENABLE true
+
 // Thingsboard library debug
 #define THINGSBOARD_ENABLE_DEBUG true
 
@@ -39,6 +48,10 @@ constexpr uint16_t THINGSBOARD_PORT = 8883U;
 constexpr uint16_t THINGSBOARD_PORT = 1883U;
 #endif
 
+// Minimum time between two connection attempts to the ThingsBoard server, connecting blocks until the
+// server answers or the attempt times out, which would otherwise delay every measurement cycle while it is down
+constexpr unsigned long THINGSBOARD_RECONNECT_INTERVAL_MS = 30000UL;
+
 // Whether the given script is using encryption or not,
 // generally recommended as it increases security (communication with the server is not in clear
 // text anymore), it does come with an overhead tough as having an encrypted session requires a lot
@@ -69,6 +82,12 @@ constexpr uint16_t THINGSBOARD_PORT = 1883U;
 // information. Simply install that library and the feature will be enabled automatically.
 #define THINGSBOARD_ENABLE_STREAM_UTILS 0
 
+// Sends the measurements and alarms as Protobuf instead of json, requires the device profile
+// in ThingsBoard to use the Protobuf MQTT payload type with the schema given in main.cpp.
+// Payloads are 3.4 times smaller for the measurements of a cycle (22 instead of 75 bytes) and 5 times
+// smaller when every alarm changes, see test_protobuf_payload of IOT_ACTUOR. Matters on metered or slow uplinks.
+#define THINGSBOARD_ENABLE_PROTOBUF 0
+
 #if ENCRYPTED
 // See https://comodosslstore.com/resources/what-is-a-root-ca-certificate-and-how-do-i-download-it/
 // on how to get the root certificate of the server we want to communicate with,
@@ -105,4 +124,27 @@ mRGunUHBcnWEvgJBQl9nJEiU0Zsnvgc/ubhPgXRR4Xq37Z0j4r7g1SgEEzwxA57d
 emyPxgcYxn/eR44/KJ4EBs+lVDR3veyJm+kXQ99b21/+jh5Xos1AnX5iItreGCc=
 -----END CERTIFICATE-----
 )";
-#endif
\ No newline at end of file
+#endif
+
+#if LOCAL_TRANSPORT_ENABLE
+#include <Local_Frame.h>
+
+// Id of this node in the local frames, has to be unique on the network
+constexpr uint16_t LOCAL_NODE_ID = 1U;
+
+// Multicast group and port every node joins to exchange local frames
+constexpr uint8_t  LOCAL_MULTICAST_GROUP[4] = { 239U, 10U, 42U, 1U };
+constexpr uint16_t LOCAL_PORT               = 4210U;
+
+// Amount of times each command frame is sent, datagrams are not acknowledged
+constexpr uint8_t LOCAL_COMMAND_REPEAT = 3U;
+
+// Key the local frames are tagged with, has to be the same on every node and kept secret,
+// frames tagged with another key are discarded. Change it for every installation
+constexpr Local_Key LOCAL_KEY = { { 0x3BU, 0x91U, 0x5EU, 0xC2U, 0x07U, 0xA4U, 0x6DU, 0xF8U,
+                                    0x12U, 0xB7U, 0x4CU, 0xE9U, 0x80U, 0x2DU, 0x65U, 0x1AU } };
+
+// Amount of sequence numbers reserved in flash at once, the receivers reject sequence numbers they already saw,
+// so the numbering has to continue after a restart without writing the flash for every frame
+constexpr uint32_t LOCAL_SEQUENCE_BLOCK = 1024U;
+#endif
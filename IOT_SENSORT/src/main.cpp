@@ -11,6 +11,15 @@
 
 #include <Arduino_MQTT_Client.h>
 #include <ThingsBoard.h>
+#if PUBLISH_QUEUE_ENABLE
+#include <Queued_MQTT_Client.h>
+#endif
+
+#if LOCAL_TRANSPORT_ENABLE
+#include <Preferences.h>
+#include <Local_Frame.h>
+#include <UDP_Local_Transport.h>
+#endif
 
 // AHT20 Temperature & Humidity sensor
 #if AHT20_ENABLE
@@ -33,6 +42,55 @@ hp_BH1750 bh1750;
 // Battery pin
 #define VBATPIN A13
 
+// Clés de télémétrie des mesures, échappées à la compilation, avec le nombre de décimales envoyées
+constexpr auto TEMPERATURE_KEY = Make_Json_Key("temperature", 2U);
+constexpr auto HUMIDITY_KEY = Make_Json_Key("humidity", 1U);
+constexpr auto VOC_KEY = Make_Json_Key("voc");
+constexpr auto LUX_KEY = Make_Json_Key("lux", 1U);
+constexpr auto BATTERY_KEY = Make_Json_Key("battery", 3U);
+constexpr auto TEMP_ALARM_HIGH_KEY = Make_Json_Key("temp_alarm_high");
+constexpr auto TEMP_ALARM_LOW_KEY = Make_Json_Key("temp_alarm_low");
+constexpr auto VOC_ALARM_KEY = Make_Json_Key("voc_alarm");
+constexpr auto BATTERY_ALARM_KEY = Make_Json_Key("battery_alarm");
+
+// Taille maximale du json d'un cycle : accolades, 8 virgules, les 9 clés et les valeurs les plus longues
+// (-39.99, 99.9, 65535, 121556.9, 6.599 et 4 fois false)
+constexpr size_t MEASUREMENTS_JSON_SIZE = 2U + 8U + TEMPERATURE_KEY.Length() + HUMIDITY_KEY.Length() + VOC_KEY.Length() +
+                                          LUX_KEY.Length() + BATTERY_KEY.Length() + TEMP_ALARM_HIGH_KEY.Length() +
+                                          TEMP_ALARM_LOW_KEY.Length() + VOC_ALARM_KEY.Length() + BATTERY_ALARM_KEY.Length() +
+                                          6U + 4U + 5U + 8U + 5U + 4U * 5U;
+// Tampon d'envoi MQTT : en-tête, sujet et json terminé par un zéro. Les mesures partent en un seul message,
+// le tampon par défaut de Default_Payload_Size (64 octets) les rejetterait à chaque cycle
+constexpr uint16_t SEND_BUFFER_SIZE = MQTT_PUBLISH_OVERHEAD + sizeof(TELEMETRY_TOPIC) + MEASUREMENTS_JSON_SIZE;
+
+#if THINGSBOARD_ENABLE_PROTOBUF
+// Schéma Protobuf de la télémétrie, doit correspondre au schéma du profil de l'appareil dans ThingsBoard :
+// syntax = "proto3";
+// package telemetry;
+// message SensorDataReading {
+//   optional float temperature = 1;
+//   optional float humidity = 2;
+//   optional uint32 voc = 3;
+//   optional float lux = 4;
+//   optional float battery = 5;
+//   optional bool temp_alarm_high = 6;
+//   optional bool temp_alarm_low = 7;
+//   optional bool voc_alarm = 8;
+//   optional bool battery_alarm = 9;
+// }
+constexpr Proto_Field TELEMETRY_SCHEMA[] = {
+    { "temperature", 1U, Proto_Type::PROTO_FLOAT },
+    { "humidity", 2U, Proto_Type::PROTO_FLOAT },
+    { "voc", 3U, Proto_Type::PROTO_UINT32 },
+    { "lux", 4U, Proto_Type::PROTO_FLOAT },
+    { "battery", 5U, Proto_Type::PROTO_FLOAT },
+    { "temp_alarm_high", 6U, Proto_Type::PROTO_BOOL },
+    { "temp_alarm_low", 7U, Proto_Type::PROTO_BOOL },
+    { "voc_alarm", 8U, Proto_Type::PROTO_BOOL },
+    { "battery_alarm", 9U, Proto_Type::PROTO_BOOL },
+};
+#endif
+
 // Initialize underlying client, used to establish a connection
 #if ENCRYPTED
 WiFiClientSecure espClient;
@@ -43,8 +101,28 @@ WiFiClient espClient;
 // Initalize the Mqtt client instance
 Arduino_MQTT_Client mqttClient(espClient);
 
+#if PUBLISH_QUEUE_ENABLE
+// File d'attente des messages, 8 messages par priorité de 256 octets maximum,
+// au plus 512 octets envoyés par appel à tb.loop()
+Queued_MQTT_Client<8U, 256U> queuedClient(mqttClient, 512U);
+
 // Initialize ThingsBoard instance
-ThingsBoard tb(mqttClient);
+ThingsBoard tb(queuedClient, Default_Payload_Size, SEND_BUFFER_SIZE);
+#else
+// Initialize ThingsBoard instance
+ThingsBoard tb(mqttClient, Default_Payload_Size, SEND_BUFFER_SIZE);
+#endif
+
+#if LOCAL_TRANSPORT_ENABLE
+// Direct link to the actuator nodes, works independently of the ThingsBoard server
+UDP_Local_Transport local_transport(IPAddress(LOCAL_MULTICAST_GROUP[0], LOCAL_MULTICAST_GROUP[1],
+                                              LOCAL_MULTICAST_GROUP[2], LOCAL_MULTICAST_GROUP[3]),
+                                    LOCAL_PORT, true);
+
+// Sequence number of the next local frame, numbers up to local_sequence_reserved are reserved in flash
+uint32_t local_sequence = 0;
+uint32_t local_sequence_reserved = 0;
+#endif
 
 // Statuses for subscribing to shared attributes
 bool RPC_subscribed = false;
@@ -55,6 +133,12 @@ bool init_att_published = false;
 // Forward declarations
 void InitWiFi();
 bool reconnect();
+#if LOCAL_TRANSPORT_ENABLE
+void beginLocalSequence();
+uint32_t nextLocalSequence();
+void sendLocalCommand(uint8_t relay, bool state);
+void sendLocalSample(float temp, float humidity, uint16_t voc, float lux, float battery);
+#endif
 
 // Définition des seuils d'alarme
 #define TEMP_HIGH 20.0
@@ -67,6 +151,7 @@ bool reconnect();
 
 // Variables pour suivre l'état des alarmes
 bool temp_alarm = false;
+bool temp_low_alarm = false;
 bool humidity_alarm = false;
 bool voc_alarm = false;
 bool lux_alarm = false;
@@ -79,58 +164,77 @@ uint16_t last_voc = 0;
 float last_lux = 0;
 float last_battery = 0;
 
-void checkAndSendAlarms(float temp, float humidity, uint16_t voc, float lux, float battery) {
+/// @brief Updates the alarm states, changes are sent to the actuator first and added to the measurements sent to ThingsBoard,
+/// so the local commands never wait on the server
+void checkAndSendAlarms(float temp, float humidity, uint16_t voc, float lux, float battery, Telemetry_Batch<9U>& measurements) {
     // Alarme température haute
     if (temp > TEMP_HIGH) {
         if (!temp_alarm) {
-            tb.sendTelemetryData("temp_alarm_high", true);
+#if LOCAL_TRANSPORT_ENABLE
+            sendLocalCommand(LOCAL_RELAY_AC, true);
+#endif
+            measurements.Add(TEMP_ALARM_HIGH_KEY, true);
             temp_alarm = true;
             Serial.printf("ALARME: Température > %.1f°C : %.2f°C\n", TEMP_HIGH, temp);
         }
     } else if (temp_alarm && temp <= TEMP_HIGH) {
-        tb.sendTelemetryData("temp_alarm_high", false);
+#if LOCAL_TRANSPORT_ENABLE
+        sendLocalCommand(LOCAL_RELAY_AC, false);
+#endif
+        measurements.Add(TEMP_ALARM_HIGH_KEY, false);
         temp_alarm = false;
     }
 
     // Alarme température basse
-    static bool temp_low_alarm = false;
     if (temp < TEMP_LOW) {
         if (!temp_low_alarm) {
-            tb.sendTelemetryData("temp_alarm_low", true);
+#if LOCAL_TRANSPORT_ENABLE
+            sendLocalCommand(LOCAL_RELAY_HEATER, true);
+#endif
+            measurements.Add(TEMP_ALARM_LOW_KEY, true);
             temp_low_alarm = true;
             Serial.printf("ALARME: Température < %.1f°C : %.2f°C\n", TEMP_LOW, temp);
         }
     } else if (temp_low_alarm && temp >= TEMP_LOW) {
-        tb.sendTelemetryData("temp_alarm_low", false);
+#if LOCAL_TRANSPORT_ENABLE
+        sendLocalCommand(LOCAL_RELAY_HEATER, false);
+#endif
+        measurements.Add(TEMP_ALARM_LOW_KEY, false);
         temp_low_alarm = false;
     }
 
     // Alarme VOC
     if (voc > VOC_HIGH) {
         if (!voc_alarm) {
-            tb.sendTelemetryData("voc_alarm", true);
+#if LOCAL_TRANSPORT_ENABLE
+            sendLocalCommand(LOCAL_RELAY_VMC, true);
+#endif
+            measurements.Add(VOC_ALARM_KEY, true);
             voc_alarm = true;
             Serial.printf("ALARME: VOC > %d : %d\n", VOC_HIGH, voc);
         }
     } else if (voc_alarm && voc < VOC_HIGH) {
-        tb.sendTelemetryData("voc_alarm", false);
+#if LOCAL_TRANSPORT_ENABLE
+        sendLocalCommand(LOCAL_RELAY_VMC, false);
+#endif
+        measurements.Add(VOC_ALARM_KEY, false);
         voc_alarm = false;
     }
 
     // Forcer l'alarme de luminosité pour test (à retirer si plus utile)
-    // tb.sendTelemetryData("lux_alarm", true);
+    // measurements.Add("lux_alarm", true);
     // Serial.println("ALARME TEST: Luminosité faible (forcée pour test)");
     // lux_alarm = true;
 
     // Vérification batterie (inchangé)
     if (battery < BATTERY_LOW) {
         if (!battery_alarm) {
-            tb.sendTelemetryData("battery_alarm", true);
+            measurements.Add(BATTERY_ALARM_KEY, true);
             battery_alarm = true;
             Serial.printf("ALARME: Batterie faible: %.2fV\n", battery);
         }
     } else if (battery_alarm) {
-        tb.sendTelemetryData("battery_alarm", false);
+        measurements.Add(BATTERY_ALARM_KEY, false);
         battery_alarm = false;
     }
 }
@@ -189,8 +293,19 @@ void setup()
     }
     #endif
 
+    #if THINGSBOARD_ENABLE_PROTOBUF
+    tb.Set_Telemetry_Schema(TELEMETRY_SCHEMA, TELEMETRY_SCHEMA + sizeof(TELEMETRY_SCHEMA) / sizeof(TELEMETRY_SCHEMA[0]));
+    #endif
+
     // Init Wifi connexion
     InitWiFi();
+
+    #if LOCAL_TRANSPORT_ENABLE
+    beginLocalSequence();
+    if (!local_transport.begin()) {
+        Serial.println("Erreur: Impossible de démarrer le transport local!");
+    }
+    #endif
 }
 
 void loop() {
@@ -200,21 +315,34 @@ void loop() {
 
     // Check Thingsboard connection
     if (!tb.connected()) {
-        Serial.printf("Connecting to: (%s) with token (%s)\n", THINGSBOARD_SERVER, TOKEN);
-        if (!tb.connect(THINGSBOARD_SERVER, TOKEN, THINGSBOARD_PORT)) {
-            Serial.println("Failed to connect");
+        // Reconnexion limitée à une tentative par intervalle, la valeur initiale autorise une tentative dès le démarrage
+        static unsigned long last_connect_attempt = 0UL - THINGSBOARD_RECONNECT_INTERVAL_MS;
+        if (millis() - last_connect_attempt >= THINGSBOARD_RECONNECT_INTERVAL_MS) {
+            last_connect_attempt = millis();
+            Serial.printf("Connecting to: (%s) with token (%s)\n", THINGSBOARD_SERVER, TOKEN);
+            if (!tb.connect(THINGSBOARD_SERVER, TOKEN, THINGSBOARD_PORT)) {
+                Serial.println("Failed to connect");
+            }
+        }
+#if !LOCAL_TRANSPORT_ENABLE
+        if (!tb.connected()) {
             return;
         }
+#endif
+        // Keep measuring, the local transport still reaches the actuator without the server
     }
 
+    // Mesures et changements d'alarme du cycle, envoyés en un seul message
+    Telemetry_Batch<9U> measurements;
+
     // Lecture des capteurs
     #if AHT20_ENABLE
     sensors_event_t humidity, temp;
     aht.getEvent(&humidity, &temp);
     last_temp = temp.temperature;
     last_humidity = humidity.relative_humidity;
-    tb.sendTelemetryData("temperature", last_temp);
-    tb.sendTelemetryData("humidity", last_humidity);
+    measurements.Add(TEMPERATURE_KEY, last_temp);
+    measurements.Add(HUMIDITY_KEY, last_humidity);
     #endif
 
     #if SGP40_ENABLE
@@ -233,7 +361,7 @@ void loop() {
             
             last_stabilization = millis();
             // Envoyer le VOC index seulement après la stabilisation
-            tb.sendTelemetryData("voc", last_voc);
+            measurements.Add(VOC_KEY, last_voc);
         } else {
             Serial.println("ERREUR: Signal brut SGP40 invalide!");
         }
@@ -243,7 +371,7 @@ void loop() {
     #if BH1750_ENABLE
     bh1750.start();  // Démarrer une nouvelle mesure
     last_lux = bh1750.getLux();  // Lire la valeur
-    tb.sendTelemetryData("lux", last_lux);
+    measurements.Add(LUX_KEY, last_lux);
     #endif
 
     // Lecture de la tension de la batterie
@@ -252,10 +380,16 @@ void loop() {
     measuredvbat *= 3.3;  // Référence 3.3V
     measuredvbat /= 4095; // 12-bit ADC
     last_battery = measuredvbat;
-    tb.sendTelemetryData("battery", last_battery);
+    measurements.Add(BATTERY_KEY, last_battery);
+
+    // Vérification des alarmes, les commandes locales partent avant l'envoi bloquant à ThingsBoard
+    checkAndSendAlarms(last_temp, last_humidity, last_voc, last_lux, last_battery, measurements);
+
+    #if LOCAL_TRANSPORT_ENABLE
+    sendLocalSample(last_temp, last_humidity, last_voc, last_lux, last_battery);
+    #endif
 
-    // Vérification et envoi des alarmes
-    checkAndSendAlarms(last_temp, last_humidity, last_voc, last_lux, last_battery);
+    tb.sendTelemetry(measurements);
 
     tb.loop();
     delay(2000);  // Attendre 2 secondes entre chaque lecture
@@ -302,3 +436,63 @@ bool reconnect()
     return true;
 }
 
+#if LOCAL_TRANSPORT_ENABLE
+/// @brief Restores the sequence number of the local frames from flash,
+/// continues after the last reserved block so the receivers never see a sequence number twice
+void beginLocalSequence()
+{
+    Preferences preferences;
+    if (!preferences.begin("local", true)) {
+        return;
+    }
+    local_sequence = preferences.getUInt("sequence", 0U);
+    local_sequence_reserved = local_sequence;
+    preferences.end();
+}
+
+/// @brief Returns the sequence number of the next local frame,
+/// reserves the next LOCAL_SEQUENCE_BLOCK numbers in flash once the current block is used up
+uint32_t nextLocalSequence()
+{
+    if (local_sequence == local_sequence_reserved) {
+        Preferences preferences;
+        if (preferences.begin("local", false)) {
+            local_sequence_reserved = local_sequence + LOCAL_SEQUENCE_BLOCK;
+            preferences.putUInt("sequence", local_sequence_reserved);
+            preferences.end();
+        }
+    }
+    return local_sequence++;
+}
+
+/// @brief Sends a relay command directly to the actuator nodes,
+/// repeated because datagrams are not acknowledged and commands are idempotent on the actuator
+void sendLocalCommand(uint8_t relay, bool state)
+{
+    uint8_t buffer[LOCAL_FRAME_MAX_SIZE];
+    const Local_Command command = { relay, state };
+    const size_t length = Local_Frame_Encode_Command(command, nextLocalSequence(), LOCAL_NODE_ID, LOCAL_KEY, buffer, sizeof(buffer));
+    for (uint8_t i = 0; i < LOCAL_COMMAND_REPEAT; i++) {
+        (void)local_transport.send(buffer, length);
+    }
+}
+
+/// @brief Sends the last measurements and the alarm states directly to the other nodes
+void sendLocalSample(float temp, float humidity, uint16_t voc, float lux, float battery)
+{
+    Local_Sample sample;
+    sample.temperature_centi = static_cast<int16_t>(lroundf(temp * 100.0f));
+    sample.humidity_centi = static_cast<uint16_t>(lroundf(humidity * 100.0f));
+    sample.voc = voc;
+    sample.lux_centi = static_cast<uint32_t>(lroundf(lux * 100.0f));
+    sample.battery_millivolt = static_cast<uint16_t>(lroundf(battery * 1000.0f));
+    sample.alarms = (temp_alarm ? LOCAL_ALARM_TEMP_HIGH : 0)
+                  | (temp_low_alarm ? LOCAL_ALARM_TEMP_LOW : 0)
+                  | (voc_alarm ? LOCAL_ALARM_VOC : 0)
+                  | (battery_alarm ? LOCAL_ALARM_BATTERY : 0);
+
+    uint8_t buffer[LOCAL_FRAME_MAX_SIZE];
+    const size_t length = Local_Frame_Encode_Sample(sample, nextLocalSequence(), LOCAL_NODE_ID, LOCAL_KEY, buffer, sizeof(buffer));
+    (void)local_transport.send(buffer, length);
+}
+#endif
@@ -0,0 +1,34 @@
+#ifndef ILocal_Transport_h
+#define ILocal_Transport_h
+
+#include "Local_Frame.h"
+
+/// @brief Transport interface used to exchange frames directly between nodes on the local network,
+/// independent of the connection to the ThingsBoard server. Implementations are polled from the main loop
+/// and never block, which keeps the local control path free of broker and rule chain latency
+class ILocal_Transport
+{
+public:
+	virtual ~ILocal_Transport() = default;
+
+	/// @brief Starts listening for frames, has to be called once the network is available
+	/// @return Whether the transport could be started
+	virtual bool begin() = 0;
+
+	/// @brief Stops listening for frames and releases the underlying resources
+	virtual void end() = 0;
+
+	/// @brief Sends the given encoded frame to the configured peers
+	/// @param data Encoded frame
+	/// @param length Size of the encoded frame
+	/// @return Whether the frame was handed to the network
+	virtual bool send(const uint8_t* data, size_t length) = 0;
+
+	/// @brief Copies the next received frame into the given buffer, does not block if nothing was received
+	/// @param buffer Buffer the received frame is copied into
+	/// @param size Size of the buffer, frames that are bigger are discarded
+	/// @return Size of the received frame or 0 if no frame is pending
+	virtual size_t receive(uint8_t* buffer, size_t size) = 0;
+};
+
+#endif // ILocal_Transport_h
@@ -0,0 +1,246 @@
+#include "Local_Frame.h"
+
+/// @brief Writes the given value as little endian into the buffer and advances it
+template <typename T> static void write_le(uint8_t*& buffer, T value)
+{
+	for (size_t i = 0U; i < sizeof(T); i++)
+	{
+		*buffer++ = static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8U * i));
+	}
+}
+
+/// @brief Reads a little endian value from the buffer and advances it
+template <typename T> static T read_le(const uint8_t*& buffer)
+{
+	uint32_t value = 0U;
+	for (size_t i = 0U; i < sizeof(T); i++)
+	{
+		value |= static_cast<uint32_t>(*buffer++) << (8U * i);
+	}
+	return static_cast<T>(value);
+}
+
+/// @brief Rotates the given value left by the given amount of bits
+static uint64_t rotl(uint64_t value, uint8_t bits)
+{
+	return (value << bits) | (value >> (64U - bits));
+}
+
+/// @brief Mixes the SipHash state, applied twice per message word and four times at the end
+static void sip_round(uint64_t (&v)[4])
+{
+	v[0] += v[1];
+	v[1] = rotl(v[1], 13U) ^ v[0];
+	v[0] = rotl(v[0], 32U);
+	v[2] += v[3];
+	v[3] = rotl(v[3], 16U) ^ v[2];
+	v[0] += v[3];
+	v[3] = rotl(v[3], 21U) ^ v[0];
+	v[2] += v[1];
+	v[1] = rotl(v[1], 17U) ^ v[2];
+	v[2] = rotl(v[2], 32U);
+}
+
+/// @brief Calculates the SipHash-2-4 of the given bytes (https://www.aumasson.jp/siphash/siphash.pdf),
+/// a keyed hash made for short messages, that is fast enough on the nodes to tag every frame
+static uint64_t siphash(const Local_Key& key, const uint8_t* data, size_t length)
+{
+	const uint8_t* key_bytes = key.bytes;
+	const uint64_t k0 = static_cast<uint64_t>(read_le<uint32_t>(key_bytes))
+		| (static_cast<uint64_t>(read_le<uint32_t>(key_bytes)) << 32U);
+	const uint64_t k1 = static_cast<uint64_t>(read_le<uint32_t>(key_bytes))
+		| (static_cast<uint64_t>(read_le<uint32_t>(key_bytes)) << 32U);
+	uint64_t v[4] = { k0 ^ 0x736f6d6570736575ULL, k1 ^ 0x646f72616e646f6dULL,
+		k0 ^ 0x6c7967656e657261ULL, k1 ^ 0x7465646279746573ULL };
+
+	// Every word is read byte by byte, the last one is padded with zeros and contains the length in its top byte
+	uint64_t word = 0U;
+	for (size_t i = 0U; i <= length; i++)
+	{
+		if (i != 0U && i % 8U == 0U)
+		{
+			v[3] ^= word;
+			sip_round(v);
+			sip_round(v);
+			v[0] ^= word;
+			word = 0U;
+		}
+		if (i < length)
+		{
+			word |= static_cast<uint64_t>(data[i]) << (8U * (i % 8U));
+		}
+	}
+	word |= static_cast<uint64_t>(length & 0xFFU) << 56U;
+	v[3] ^= word;
+	sip_round(v);
+	sip_round(v);
+	v[0] ^= word;
+
+	v[2] ^= 0xFFU;
+	for (uint8_t i = 0U; i < 4U; i++)
+	{
+		sip_round(v);
+	}
+	return v[0] ^ v[1] ^ v[2] ^ v[3];
+}
+
+/// @brief Appends the tag over the given frame, that has to be followed by LOCAL_FRAME_TAG_SIZE free bytes
+/// @return Size of the frame including the tag
+static size_t write_tag(const Local_Key& key, uint8_t* frame, size_t length)
+{
+	const uint64_t tag = siphash(key, frame, length);
+	uint8_t*	   end = frame + length;
+	write_le<uint32_t>(end, static_cast<uint32_t>(tag));
+	write_le<uint32_t>(end, static_cast<uint32_t>(tag >> 32U));
+	return length + LOCAL_FRAME_TAG_SIZE;
+}
+
+/// @brief Checks the tag following the given frame, compares every byte regardless of the first difference
+/// to not reveal through the timing how much of a forged tag was correct
+static bool check_tag(const Local_Key& key, const uint8_t* frame, size_t length)
+{
+	const uint64_t tag		= siphash(key, frame, length);
+	uint8_t		   mismatch = 0U;
+	for (size_t i = 0U; i < LOCAL_FRAME_TAG_SIZE; i++)
+	{
+		mismatch |= frame[length + i] ^ static_cast<uint8_t>(tag >> (8U * i));
+	}
+	return mismatch == 0U;
+}
+
+/// @brief Writes the header shared by every frame and advances the buffer
+static void write_header(uint8_t*& buffer, Local_Frame_Type type, uint32_t sequence, uint16_t source)
+{
+	write_le<uint8_t>(buffer, LOCAL_FRAME_MAGIC);
+	write_le<uint8_t>(buffer, LOCAL_FRAME_VERSION);
+	write_le<uint8_t>(buffer, type);
+	write_le<uint32_t>(buffer, sequence);
+	write_le<uint16_t>(buffer, source);
+}
+
+size_t Local_Frame_Encode_Sample(const Local_Sample& sample, uint32_t sequence, uint16_t source,
+	const Local_Key& key, uint8_t* buffer, size_t size)
+{
+	if (buffer == nullptr || size < LOCAL_SAMPLE_FRAME_SIZE)
+	{
+		return 0U;
+	}
+	uint8_t* const frame = buffer;
+	write_header(buffer, LOCAL_FRAME_SAMPLE, sequence, source);
+	write_le<uint16_t>(buffer, static_cast<uint16_t>(sample.temperature_centi));
+	write_le<uint16_t>(buffer, sample.humidity_centi);
+	write_le<uint16_t>(buffer, sample.voc);
+	write_le<uint32_t>(buffer, sample.lux_centi);
+	write_le<uint16_t>(buffer, sample.battery_millivolt);
+	write_le<uint8_t>(buffer, sample.alarms);
+	return write_tag(key, frame, LOCAL_SAMPLE_FRAME_SIZE - LOCAL_FRAME_TAG_SIZE);
+}
+
+size_t Local_Frame_Encode_Command(const Local_Command& command, uint32_t sequence, uint16_t source,
+	const Local_Key& key, uint8_t* buffer, size_t size)
+{
+	if (buffer == nullptr || size < LOCAL_COMMAND_FRAME_SIZE)
+	{
+		return 0U;
+	}
+	uint8_t* const frame = buffer;
+	write_header(buffer, LOCAL_FRAME_COMMAND, sequence, source);
+	write_le<uint8_t>(buffer, command.relay);
+	write_le<uint8_t>(buffer, command.state ? 1U : 0U);
+	return write_tag(key, frame, LOCAL_COMMAND_FRAME_SIZE - LOCAL_FRAME_TAG_SIZE);
+}
+
+bool Local_Frame_Decode(const uint8_t* buffer, size_t length, const Local_Key& key, Local_Frame& frame)
+{
+	if (buffer == nullptr || length < LOCAL_FRAME_HEADER_SIZE)
+	{
+		return false;
+	}
+	const uint8_t* const start = buffer;
+	if (read_le<uint8_t>(buffer) != LOCAL_FRAME_MAGIC || read_le<uint8_t>(buffer) != LOCAL_FRAME_VERSION)
+	{
+		return false;
+	}
+	frame.type	   = static_cast<Local_Frame_Type>(read_le<uint8_t>(buffer));
+	frame.sequence = read_le<uint32_t>(buffer);
+	frame.source   = read_le<uint16_t>(buffer);
+
+	// The tag is checked before anything of the payload is used, frames are only accepted with their exact size,
+	// because the tag directly follows the payload
+	switch (frame.type)
+	{
+		case LOCAL_FRAME_SAMPLE:
+			if (length != LOCAL_SAMPLE_FRAME_SIZE
+				|| !check_tag(key, start, LOCAL_SAMPLE_FRAME_SIZE - LOCAL_FRAME_TAG_SIZE))
+			{
+				return false;
+			}
+			frame.sample.temperature_centi = static_cast<int16_t>(read_le<uint16_t>(buffer));
+			frame.sample.humidity_centi	   = read_le<uint16_t>(buffer);
+			frame.sample.voc			   = read_le<uint16_t>(buffer);
+			frame.sample.lux_centi		   = read_le<uint32_t>(buffer);
+			frame.sample.battery_millivolt = read_le<uint16_t>(buffer);
+			frame.sample.alarms			   = read_le<uint8_t>(buffer);
+			return true;
+		case LOCAL_FRAME_COMMAND:
+			if (length != LOCAL_COMMAND_FRAME_SIZE
+				|| !check_tag(key, start, LOCAL_COMMAND_FRAME_SIZE - LOCAL_FRAME_TAG_SIZE))
+			{
+				return false;
+			}
+			frame.command.relay = read_le<uint8_t>(buffer);
+			frame.command.state = read_le<uint8_t>(buffer) != 0U;
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool Local_Replay_Filter::accept(uint16_t source, uint32_t sequence)
+{
+	Entry* entry = nullptr;
+	for (size_t i = 0U; i < m_count; i++)
+	{
+		if (m_entries[i].source == source)
+		{
+			entry = &m_entries[i];
+			break;
+		}
+	}
+	if (entry == nullptr)
+	{
+		if (m_count == LOCAL_REPLAY_SOURCES)
+		{
+			return false;
+		}
+		entry		  = &m_entries[m_count++];
+		entry->source = source;
+		entry->newest = sequence;
+		entry->seen	  = 0U;
+		return true;
+	}
+
+	if (sequence > entry->newest)
+	{
+		// Shift the window, the previous newest sequence number becomes bit distance - 1
+		const uint32_t distance = sequence - entry->newest;
+		entry->seen = (distance > LOCAL_REPLAY_WINDOW) ? 0U
+			: (distance == LOCAL_REPLAY_WINDOW)		   ? (1U << (LOCAL_REPLAY_WINDOW - 1U))
+													   : ((entry->seen << distance) | (1U << (distance - 1U)));
+		entry->newest = sequence;
+		return true;
+	}
+
+	const uint32_t distance = entry->newest - sequence;
+	if (distance == 0U || distance > LOCAL_REPLAY_WINDOW)
+	{
+		return false;
+	}
+	const uint32_t bit = 1U << (distance - 1U);
+	if ((entry->seen & bit) != 0U)
+	{
+		return false;
+	}
+	entry->seen |= bit;
+	return true;
+}
@@ -0,0 +1,153 @@
+#ifndef Local_Frame_h
+#define Local_Frame_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+// First byte of every frame, allows to quickly discard unrelated datagrams on the same port
+constexpr uint8_t LOCAL_FRAME_MAGIC = 0xA5U;
+
+// Version of the frame layout, frames with another version are discarded
+constexpr uint8_t LOCAL_FRAME_VERSION = 2U;
+
+// Size of the header shared by every frame (magic, version, type, sequence, source node id)
+constexpr size_t LOCAL_FRAME_HEADER_SIZE = 9U;
+
+// Size of the SipHash-2-4 tag appended to every frame, computed over the header and payload
+constexpr size_t LOCAL_FRAME_TAG_SIZE = 8U;
+
+// Size of the different frames including the header and the tag
+constexpr size_t LOCAL_SAMPLE_FRAME_SIZE  = LOCAL_FRAME_HEADER_SIZE + 13U + LOCAL_FRAME_TAG_SIZE;
+constexpr size_t LOCAL_COMMAND_FRAME_SIZE = LOCAL_FRAME_HEADER_SIZE + 2U + LOCAL_FRAME_TAG_SIZE;
+
+// Size of a buffer big enough to hold any frame
+constexpr size_t LOCAL_FRAME_MAX_SIZE = 32U;
+
+// Size of the key shared by every node on the network
+constexpr size_t LOCAL_KEY_SIZE = 16U;
+
+// Amount of sources and of sequence numbers before the newest one the replay filter keeps track of,
+// the window is at most 32 because every sequence number is one bit of a uint32_t
+constexpr size_t   LOCAL_REPLAY_SOURCES = 4U;
+constexpr uint32_t LOCAL_REPLAY_WINDOW	= 32U;
+
+/// @brief Key shared by every node, frames are only accepted if they were tagged with the same key
+struct Local_Key
+{
+	uint8_t bytes[LOCAL_KEY_SIZE];
+};
+
+/// @brief Type of the frame, decides how the payload following the header is decoded
+enum Local_Frame_Type : uint8_t
+{
+	LOCAL_FRAME_SAMPLE	= 1U, // Sensor measurements and alarm states
+	LOCAL_FRAME_COMMAND = 2U  // Relay change requested from another node
+};
+
+/// @brief Index of the actuator relays, used by command frames
+enum Local_Relay : uint8_t
+{
+	LOCAL_RELAY_LIGHT  = 0U,
+	LOCAL_RELAY_VMC	   = 1U,
+	LOCAL_RELAY_HEATER = 2U,
+	LOCAL_RELAY_AC	   = 3U
+};
+
+/// @brief Alarm bits contained in sample frames
+enum Local_Alarm : uint8_t
+{
+	LOCAL_ALARM_TEMP_HIGH = 1U << 0U,
+	LOCAL_ALARM_TEMP_LOW  = 1U << 1U,
+	LOCAL_ALARM_VOC		  = 1U << 2U,
+	LOCAL_ALARM_BATTERY	  = 1U << 3U
+};
+
+/// @brief Sensor measurements, values are fixed point to keep the frame small and free of floats
+struct Local_Sample
+{
+	int16_t	 temperature_centi; // Temperature in hundredths of °C
+	uint16_t humidity_centi;	// Relative humidity in hundredths of %
+	uint16_t voc;				// VOC index
+	uint32_t lux_centi;			// Illuminance in hundredths of lux
+	uint16_t battery_millivolt; // Battery voltage in mV
+	uint8_t	 alarms;			// Active alarms, combination of Local_Alarm bits
+};
+
+/// @brief Relay change requested from another node
+struct Local_Command
+{
+	uint8_t relay; // Relay to switch, one of Local_Relay
+	bool	state; // State the relay is switched to
+};
+
+/// @brief Decoded frame, only the member matching the type is valid
+struct Local_Frame
+{
+	Local_Frame_Type type;
+	uint32_t		 sequence; // Incremented by the sender for every frame, allows to detect losses and replays
+	uint16_t		 source;   // Node id of the sender
+	union
+	{
+		Local_Sample  sample;
+		Local_Command command;
+	};
+};
+
+/// @brief Encodes the given sample into its little endian wire format and tags it
+/// @param sample Measurements to encode
+/// @param sequence Sequence number of the frame, has to increase with every frame of this sender
+/// @param source Node id of the sender
+/// @param key Key shared by every node
+/// @param buffer Buffer the frame is written into
+/// @param size Size of the buffer, has to be at least LOCAL_SAMPLE_FRAME_SIZE
+/// @return Amount of bytes written or 0 if the buffer is too small
+size_t Local_Frame_Encode_Sample(const Local_Sample& sample, uint32_t sequence, uint16_t source,
+	const Local_Key& key, uint8_t* buffer, size_t size);
+
+/// @brief Encodes the given command into its little endian wire format and tags it
+/// @param command Command to encode
+/// @param sequence Sequence number of the frame, has to increase with every frame of this sender
+/// @param source Node id of the sender
+/// @param key Key shared by every node
+/// @param buffer Buffer the frame is written into
+/// @param size Size of the buffer, has to be at least LOCAL_COMMAND_FRAME_SIZE
+/// @return Amount of bytes written or 0 if the buffer is too small
+size_t Local_Frame_Encode_Command(const Local_Command& command, uint32_t sequence, uint16_t source,
+	const Local_Key& key, uint8_t* buffer, size_t size);
+
+/// @brief Decodes the given received bytes, after checking their tag
+/// @param buffer Received bytes
+/// @param length Amount of received bytes
+/// @param key Key shared by every node
+/// @param frame Frame the decoded values are written into
+/// @return Whether the bytes contained a complete frame of a known type and version, tagged with the given key
+bool Local_Frame_Decode(const uint8_t* buffer, size_t length, const Local_Key& key, Local_Frame& frame);
+
+/// @brief Rejects frames that were already received, the tag only proves a frame was created by a node with the key,
+/// but a recorded frame could otherwise be sent again to repeat a command.
+/// Remembers the newest sequence number of each source and which of the LOCAL_REPLAY_WINDOW previous ones were received,
+/// to still accept frames that were reordered on the network. Older sequence numbers are rejected.
+/// Is not persisted, after a restart the first frame of each source is accepted and sets its newest sequence number
+class Local_Replay_Filter
+{
+public:
+	/// @brief Checks whether the given frame was not received yet and marks it as received
+	/// @param source Node id of the sender
+	/// @param sequence Sequence number of the frame
+	/// @return Whether the frame should be handled, false for repeated or too old frames
+	/// or if the frame is from an unknown source and LOCAL_REPLAY_SOURCES are already tracked
+	bool accept(uint16_t source, uint32_t sequence);
+
+private:
+	struct Entry
+	{
+		uint16_t source;
+		uint32_t newest; // Newest received sequence number
+		uint32_t seen;	 // Bit n set if newest - 1 - n was received
+	};
+
+	Entry  m_entries[LOCAL_REPLAY_SOURCES] = {};
+	size_t m_count						   = 0U; // Amount of used entries
+};
+
+#endif // Local_Frame_h
@@ -0,0 +1,93 @@
+#ifndef Loopback_Local_Transport_h
+#define Loopback_Local_Transport_h
+
+#include "ILocal_Transport.h"
+
+#include <string.h>
+
+// Amount of frames that can be pending in one loopback transport before new frames are dropped
+constexpr size_t LOOPBACK_QUEUE_SIZE = 8U;
+
+/// @brief In memory transport without any network, frames sent by one instance are received by its peer.
+/// If no peer is connected the frames are received by the sending instance itself.
+/// Allows exercising the frame handling of both nodes on a host without a network stack
+class Loopback_Local_Transport : public ILocal_Transport
+{
+public:
+	Loopback_Local_Transport() = default;
+
+	/// @brief Connects both instances with each other, so frames sent on one are received on the other
+	/// @param peer Transport that receives the frames sent with this instance
+	void connect(Loopback_Local_Transport& peer)
+	{
+		m_peer		= &peer;
+		peer.m_peer = this;
+	}
+
+	bool begin() override
+	{
+		m_started = true;
+		return true;
+	}
+
+	void end() override
+	{
+		m_started = false;
+		m_head	  = 0U;
+		m_count	  = 0U;
+	}
+
+	bool send(const uint8_t* data, size_t length) override
+	{
+		Loopback_Local_Transport& target = (m_peer != nullptr) ? *m_peer : *this;
+		return target.push(data, length);
+	}
+
+	size_t receive(uint8_t* buffer, size_t size) override
+	{
+		if (m_count == 0U)
+		{
+			return 0U;
+		}
+		const Entry& entry = m_queue[m_head];
+		m_head			   = (m_head + 1U) % LOOPBACK_QUEUE_SIZE;
+		m_count--;
+		if (buffer == nullptr || entry.length > size)
+		{
+			return 0U;
+		}
+		memcpy(buffer, entry.data, entry.length);
+		return entry.length;
+	}
+
+private:
+	struct Entry
+	{
+		uint8_t data[LOCAL_FRAME_MAX_SIZE];
+		size_t	length;
+	};
+
+	/// @brief Queues the given frame to be received by this instance
+	/// @return Whether the frame was queued, fails if not started, too big or the queue is full
+	bool push(const uint8_t* data, size_t length)
+	{
+		if (!m_started || data == nullptr || length > LOCAL_FRAME_MAX_SIZE
+			|| m_count == LOOPBACK_QUEUE_SIZE)
+		{
+			return false;
+		}
+		Entry& entry = m_queue[(m_head + m_count) % LOOPBACK_QUEUE_SIZE];
+		memcpy(entry.data, data, length);
+		entry.length = length;
+		m_count++;
+		return true;
+	}
+
+	Loopback_Local_Transport* m_peer	= nullptr; // Instance that receives the sent frames
+	bool					  m_started = false;
+	Entry					  m_queue[LOOPBACK_QUEUE_SIZE] = {};
+	size_t					  m_head  = 0U; // Index of the oldest pending frame
+	size_t					  m_count = 0U; // Amount of pending frames
+};
+
+#endif // Loopback_Local_Transport_h
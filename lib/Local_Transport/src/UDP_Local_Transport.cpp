@@ -0,0 +1,70 @@
+#include "UDP_Local_Transport.h"
+
+#ifdef ARDUINO
+
+UDP_Local_Transport::UDP_Local_Transport(const IPAddress& address, uint16_t port, bool multicast)
+	: m_udp()
+	, m_address(address)
+	, m_port(port)
+	, m_multicast(multicast)
+	, m_started(false)
+{
+	// Nothing to do
+}
+
+bool UDP_Local_Transport::begin()
+{
+	end();
+	m_started = m_multicast ? m_udp.beginMulticast(m_address, m_port) != 0U : m_udp.begin(m_port) != 0U;
+	return m_started;
+}
+
+void UDP_Local_Transport::end()
+{
+	if (!m_started)
+	{
+		return;
+	}
+	m_udp.stop();
+	m_started = false;
+}
+
+bool UDP_Local_Transport::send(const uint8_t* data, size_t length)
+{
+	if (!m_started || data == nullptr || length == 0U)
+	{
+		return false;
+	}
+	if (m_udp.beginPacket(m_address, m_port) == 0)
+	{
+		return false;
+	}
+	if (m_udp.write(data, length) != length)
+	{
+		return false;
+	}
+	return m_udp.endPacket() != 0;
+}
+
+size_t UDP_Local_Transport::receive(uint8_t* buffer, size_t size)
+{
+	if (!m_started || buffer == nullptr)
+	{
+		return 0U;
+	}
+	const int length = m_udp.parsePacket();
+	if (length <= 0)
+	{
+		return 0U;
+	}
+	// Datagrams that do not fit are not a frame of ours, drop them completely
+	if (static_cast<size_t>(length) > size)
+	{
+		m_udp.flush();
+		return 0U;
+	}
+	const int read = m_udp.read(buffer, size);
+	return read > 0 ? static_cast<size_t>(read) : 0U;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,43 @@
+#ifndef UDP_Local_Transport_h
+#define UDP_Local_Transport_h
+
+#ifdef ARDUINO
+
+#include "ILocal_Transport.h"
+
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+/// @brief Local transport over UDP datagrams, one frame per datagram.
+/// Frames are either sent to a single peer (unicast) or to a multicast group every node joined,
+/// the latter allows adding nodes without configuring their addresses on every other node.
+/// Datagrams are never acknowledged or retransmitted, sample frames are periodic anyway
+/// and command frames are idempotent, so the sender can simply send them multiple times
+class UDP_Local_Transport : public ILocal_Transport
+{
+public:
+	/// @brief Constructs the transport
+	/// @param address Address of the peer for unicast or of the group for multicast
+	/// @param port Port frames are sent to and received on, the same on every node
+	/// @param multicast Whether the address is a multicast group that is joined with begin()
+	UDP_Local_Transport(const IPAddress& address, uint16_t port, bool multicast);
+
+	bool begin() override;
+
+	void end() override;
+
+	bool send(const uint8_t* data, size_t length) override;
+
+	size_t receive(uint8_t* buffer, size_t size) override;
+
+private:
+	WiFiUDP	  m_udp;	   // Underlying socket
+	IPAddress m_address;   // Peer or multicast group address
+	uint16_t  m_port;	   // Port used for sending and receiving
+	bool	  m_multicast; // Whether m_address is a multicast group
+	bool	  m_started;   // Whether begin() succeeded
+};
+
+#endif // ARDUINO
+
+#endif // UDP_Local_Transport_h
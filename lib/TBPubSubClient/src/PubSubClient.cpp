@@ -599,6 +599,36 @@ int PubSubClient::endPublish() {
     return 1;
 }
 
+uint8_t* PubSubClient::reservePublish(const char* topic, size_t plength) {
+    this->reservedLength = 0;
+    if (connected()) {
+        if (this->sendBufferSize < MQTT_MAX_HEADER_SIZE + 2 + strnlen(topic, this->sendBufferSize) + plength) {
+            // Too long
+            return NULL;
+        }
+        // Leave room in the send_buffer for header and variable length field, written once the payload size is known
+        this->reservedLength = writeString(topic,this->send_buffer,MQTT_MAX_HEADER_SIZE);
+        return this->send_buffer + this->reservedLength;
+    }
+    return NULL;
+}
+
+boolean PubSubClient::commitPublish(size_t plength, boolean retained) {
+    uint16_t length = this->reservedLength;
+    this->reservedLength = 0;
+    if (length == 0 || !connected() || length + plength > this->sendBufferSize) {
+        return false;
+    }
+    length += plength;
+
+    // Write the header
+    uint8_t header = MQTTPUBLISH;
+    if (retained) {
+        header |= 1;
+    }
+    return write(header,this->send_buffer,length-MQTT_MAX_HEADER_SIZE);
+}
+
 size_t PubSubClient::write(uint8_t data) {
     lastOutActivity = millis();
     return _client->write(data);
@@ -119,6 +119,8 @@ private:
    uint16_t port;
    Stream* stream;
    int _state;
+   // Length of the header and topic written by reservePublish(), 0 if nothing is reserved
+   uint16_t reservedLength = 0;
 public:
    PubSubClient();
    PubSubClient(Client& client);
@@ -176,6 +178,18 @@ public:
    // Finish off this publish message (started with beginPublish)
    // Returns 1 if the packet was sent successfully, 0 if there was an error
    int endPublish();
+   // Reserve a publish message directly in the send buffer.
+   // This API:
+   //   reservePublish(...)
+   //   write up to plength bytes of payload into the returned pointer
+   //   commitPublish(...)
+   // Allows serializing the payload in place, without copying it into the send buffer afterwards.
+   // The remaining length is only written by commitPublish, so plength is the maximum, not the exact size.
+   // Returns the start of the payload or NULL if not connected or the message would not fit
+   uint8_t* reservePublish(const char* topic, size_t plength);
+   // Send the message reserved with reservePublish, containing the first plength payload bytes
+   // Returns 1 if the packet was sent successfully, 0 if there was an error
+   boolean commitPublish(size_t plength, boolean retained);
    // Write a single byte of payload (only to be used with beginPublish/endPublish)
    virtual size_t write(uint8_t);
    // Write size bytes from buffer into the payload (only to be used with beginPublish/endPublish)
@@ -56,6 +56,14 @@ bool Arduino_MQTT_Client::publish(char const * topic, uint8_t const * payload, s
     return m_mqtt_client.publish(topic, payload, length, false);
 }
 
+uint8_t * Arduino_MQTT_Client::reserve_publish(char const * topic, size_t const & length) {
+    return m_mqtt_client.reservePublish(topic, length);
+}
+
+bool Arduino_MQTT_Client::commit_publish(size_t const & length) {
+    return m_mqtt_client.commitPublish(length, false);
+}
+
 bool Arduino_MQTT_Client::subscribe(char const * topic) {
     return m_mqtt_client.subscribe(topic);
 }
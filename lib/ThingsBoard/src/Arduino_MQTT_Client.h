@@ -47,6 +47,10 @@ class Arduino_MQTT_Client : public IMQTT_Client {
 
     bool publish(char const * topic, uint8_t const * payload, size_t const & length) override;
 
+    uint8_t * reserve_publish(char const * topic, size_t const & length) override;
+
+    bool commit_publish(size_t const & length) override;
+
     bool subscribe(char const * topic) override;
 
     bool unsubscribe(char const * topic) override;
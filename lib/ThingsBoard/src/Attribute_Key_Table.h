@@ -0,0 +1,166 @@
+#ifndef Attribute_Key_Table_h
+#define Attribute_Key_Table_h
+
+// Local includes.
+#include "Callback.h"
+#include "RPC_Method_Table.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+// Returned by Attribute_Key_Table::Find() if no callback is subscribed to the given key.
+size_t constexpr ATTRIBUTE_KEY_NOT_FOUND = ~static_cast<size_t>(0U);
+// Amount of key ids each word of an interest bitset holds.
+size_t constexpr ATTRIBUTE_KEY_BITS = 32U;
+
+
+/// @brief Calculates the amount of words a bitset requires to hold one bit for each of the given amount of keys, can be evaluated at compile time
+/// @param key_count Amount of keys the bitset has to hold
+/// @return Amount of words
+constexpr size_t Attribute_Key_Words(size_t key_count) {
+    return (key_count + ATTRIBUTE_KEY_BITS - 1U) / ATTRIBUTE_KEY_BITS;
+}
+
+
+/// @brief Interns the attribute keys of subscribed callbacks into consecutive ids and holds for every callback a bitset with the ids of the keys it is subscribed to.
+/// Received keys therefore only have to be hashed once to find their id, afterwards the callbacks interested in them are found by intersecting bitsets instead of comparing strings.
+/// The table is rebuilt from the complete data container every time a callback is subscribed, keys are only referenced and not copied.
+/// Keys are looked up with the same open addressing hash table and FNV-1a hash the RPC_Method_Table uses
+#if THINGSBOARD_ENABLE_DYNAMIC
+class Attribute_Key_Table {
+#else
+/// @tparam MaxCallbacks Maximum amount of callbacks the table has to hold an interest bitset for
+/// @tparam MaxAttributes Maximum amount of keys each callback can be subscribed to
+template <size_t MaxCallbacks, size_t MaxAttributes>
+class Attribute_Key_Table {
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+  public:
+    /// @brief Rebuilds the table from the given callbacks, the index of a callback is its distance from the given first iterator
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first callback, has to provide the Get_Attributes() method
+    /// @param last Iterator pointing to one past the last callback
+    template <typename InputIterator>
+    void Build(InputIterator const & first, InputIterator const & last) {
+        m_slots.clear();
+        m_keys.clear();
+        m_interests.clear();
+#if THINGSBOARD_ENABLE_DYNAMIC
+        size_t attribute_count = 0U;
+        for (auto it = first; it != last; ++it) {
+            attribute_count += it->Get_Attributes().size();
+        }
+        size_t const size = RPC_Method_Table_Size(attribute_count);
+#else
+        size_t constexpr size = RPC_Method_Table_Size(MaxCallbacks * MaxAttributes);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        for (size_t i = 0U; i < size; i++) {
+            m_slots.push_back(Key_Slot());
+        }
+
+        for (auto it = first; it != last; ++it) {
+            for (auto const & key : it->Get_Attributes()) {
+                if (Helper::stringIsNullorEmpty(key)) {
+                    continue;
+                }
+                size_t const slot = Find_Slot(key, RPC_Method_Hash(key));
+                if (m_slots[slot].id != ATTRIBUTE_KEY_NOT_FOUND) {
+                    continue;
+                }
+                m_slots[slot].hash = RPC_Method_Hash(key);
+                m_slots[slot].id = m_keys.size();
+                m_slots[slot].key = key;
+                m_keys.push_back(key);
+            }
+        }
+
+        // Ids are only known once every key has been interned, therefore the bitsets are filled in a second pass
+        m_word_count = Attribute_Key_Words(m_keys.size());
+        for (auto it = first; it != last; ++it) {
+            size_t const interest = m_interests.size();
+            for (size_t i = 0U; i < m_word_count; i++) {
+                m_interests.push_back(0U);
+            }
+            for (auto const & key : it->Get_Attributes()) {
+                size_t const id = Find(key);
+                if (id != ATTRIBUTE_KEY_NOT_FOUND) {
+                    m_interests[interest + id / ATTRIBUTE_KEY_BITS] |= static_cast<uint32_t>(1U) << (id % ATTRIBUTE_KEY_BITS);
+                }
+            }
+        }
+    }
+
+    /// @brief Finds the id of the given key
+    /// @param key Received key, nullptr is never found
+    /// @return Id of the key or ATTRIBUTE_KEY_NOT_FOUND if no callback is subscribed to that key
+    size_t Find(char const * key) const {
+        if (m_slots.empty() || key == nullptr) {
+            return ATTRIBUTE_KEY_NOT_FOUND;
+        }
+        return m_slots[Find_Slot(key, RPC_Method_Hash(key))].id;
+    }
+
+    /// @brief Gets the key with the given id
+    /// @param id Id returned by Find(), has to be smaller than Get_Key_Count()
+    /// @return Key as it was passed by the subscribed callback
+    char const * Get_Key(size_t const & id) const {
+        return m_keys[id];
+    }
+
+    /// @brief Gets the amount of distinct keys the subscribed callbacks are subscribed to, ids are always smaller than this amount
+    /// @return Amount of interned keys
+    size_t Get_Key_Count() const {
+        return m_keys.size();
+    }
+
+    /// @brief Gets the amount of words every interest bitset consists of
+    /// @return Amount of words
+    size_t Get_Word_Count() const {
+        return m_word_count;
+    }
+
+    /// @brief Gets the bitset with the ids of the keys the given callback is subscribed to, bit id % ATTRIBUTE_KEY_BITS of word id / ATTRIBUTE_KEY_BITS is set for every key
+    /// @param index Index of the callback in the data container the table was built from
+    /// @return Pointer to the first of Get_Word_Count() words or nullptr if no callback is subscribed to any specific key
+    uint32_t const * Get_Interest(size_t const & index) const {
+        if (m_word_count == 0U) {
+            return nullptr;
+        }
+        return &m_interests[index * m_word_count];
+    }
+
+  private:
+    /// @brief Slot of the hash table, empty if the id is ATTRIBUTE_KEY_NOT_FOUND
+    struct Key_Slot {
+        uint32_t   hash = {};                       // Hash of the key
+        size_t     id = ATTRIBUTE_KEY_NOT_FOUND;    // Id the key was interned as
+        char const *key = {};                       // Key of the slot, compared if the hashes are equal
+    };
+
+    /// @brief Finds the slot containing the given key or the empty slot it would be inserted into, the table is always atleast half empty, therefore probing ends in an empty slot at the latest
+    size_t Find_Slot(char const * key, uint32_t const & hash) const {
+        size_t const mask = m_slots.size() - 1U;
+        size_t slot = hash & mask;
+        while (m_slots[slot].id != ATTRIBUTE_KEY_NOT_FOUND && (m_slots[slot].hash != hash || strcmp(m_slots[slot].key, key) != 0)) {
+            slot = (slot + 1U) & mask;
+        }
+        return slot;
+    }
+
+    size_t                                                                                              m_word_count = {}; // Amount of words every interest bitset consists of
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Key_Slot>                                                                                    m_slots = {};      // Slots of the hash table, the size is always a power of two
+    Vector<char const *>                                                                                m_keys = {};       // Interned keys, indexed by their id
+    Vector<uint32_t>                                                                                    m_interests = {};  // Interest bitsets of every callback one after the other
+#else
+    Array<Key_Slot, RPC_Method_Table_Size(MaxCallbacks * MaxAttributes)>                                m_slots = {};      // Slots of the hash table, the size is always a power of two
+    Array<char const *, MaxCallbacks * MaxAttributes>                                                   m_keys = {};       // Interned keys, indexed by their id
+    Array<uint32_t, MaxCallbacks * Attribute_Key_Words(MaxCallbacks * MaxAttributes)>                   m_interests = {};  // Interest bitsets of every callback one after the other
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+};
+
+#endif // Attribute_Key_Table_h
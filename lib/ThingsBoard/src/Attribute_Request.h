@@ -4,12 +4,15 @@
 // Local includes.
 #include "Attribute_Request_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Pending_Request_Map.h"
 
 
 // Attribute request API topics.
-char constexpr ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/%u";
+char constexpr ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/";
+size_t constexpr ATTRIBUTE_REQUEST_TOPIC_LENGTH = sizeof(ATTRIBUTE_REQUEST_TOPIC) - 1U;
 char constexpr ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC[] = "v1/devices/me/attributes/response/+";
 char constexpr ATTRIBUTE_RESPONSE_TOPIC[] = "v1/devices/me/attributes/response/";
+size_t constexpr ATTRIBUTE_RESPONSE_TOPIC_LENGTH = sizeof(ATTRIBUTE_RESPONSE_TOPIC) - 1U;
 // Client side attribute request keys.
 char constexpr CLIENT_REQUEST_KEYS[] = "clientKeys";
 char constexpr CLIENT_RESPONSE_KEY[] = "client";
@@ -40,8 +43,17 @@ template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxAttri
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 class Attribute_Request : public IAPI_Implementation {
   public:
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Constructor
+    /// @param expected_requests Amount of requests that are expected to wait on a response at the same time, their slots are allocated up front,
+    /// so that sending requests does not allocate or reallocate as long as no more requests are waiting on a response at the same time, default = Default_Subscriptions_Amount (1)
+    Attribute_Request(size_t const & expected_requests = Default_Subscriptions_Amount) {
+        m_attribute_requests.reserve(expected_requests);
+    }
+#else
     /// @brief Constructor
     Attribute_Request() = default;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
 
     /// @brief Requests one client-side attribute calllback,
     /// that will be called if the key-value pair from the server for the given client-side attributes is received.
@@ -82,60 +94,43 @@ class Attribute_Request : public IAPI_Implementation {
     }
 
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
-        size_t const request_id = Helper::parseRequestId(ATTRIBUTE_RESPONSE_TOPIC, topic);
+        size_t const request_id = Helper::parseRequestId(topic, ATTRIBUTE_RESPONSE_TOPIC_LENGTH);
         JsonObjectConst object = data.template as<JsonObjectConst>();
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_DYNAMIC
-        auto it = std::find_if(m_attribute_request_callbacks.begin(), m_attribute_request_callbacks.end(), [&request_id](Attribute_Request_Callback & attribute_request) {
-#else
-        auto it = std::find_if(m_attribute_request_callbacks.begin(), m_attribute_request_callbacks.end(), [&request_id](Attribute_Request_Callback<MaxAttributes> & attribute_request) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-            return attribute_request.Get_Request_ID() == request_id;
-        });
-        if (it != m_attribute_request_callbacks.end()) {
-            auto & attribute_request = *it;
-#else
-        for (auto it = m_attribute_request_callbacks.begin(); it != m_attribute_request_callbacks.end(); ++it) {
-            auto & attribute_request = *it;
-
-            if (attribute_request.Get_Request_ID() != request_id) {
-                continue;
-            }
-#endif // THINGSBOARD_ENABLE_STL
-            char const * attribute_response_key = attribute_request.Get_Attribute_Key();
+        auto attribute_request = m_attribute_requests.Find(request_id);
+        if (attribute_request != nullptr) {
+            char const * attribute_response_key = attribute_request->Get_Attribute_Key();
             if (attribute_response_key == nullptr) {
 #if THINGSBOARD_ENABLE_DEBUG
                 Logger::printfln(ATT_KEY_NOT_FOUND);
 #endif // THINGSBOARD_ENABLE_DEBUG
-                goto delete_callback;
             }
-
-            if (object.containsKey(attribute_response_key)) {
-                object = object[attribute_response_key];
+            else {
+                if (object.containsKey(attribute_response_key)) {
+                    object = object[attribute_response_key];
+                }
+                attribute_request->Call_Callback(object);
             }
 
-            attribute_request.Stop_Timeout_Timer();
-            attribute_request.Call_Callback(object);
-
-            delete_callback:
-            // Delete callback because the changes have been requested and the callback is no longer needed
-            Helper::remove(m_attribute_request_callbacks, it);
-#if !THINGSBOARD_ENABLE_STL
-            break;
-#endif // !THINGSBOARD_ENABLE_STL
+            // Delete callback because the changes have been requested and the callback is no longer needed.
+            // Erased by id instead of the pointer, because the callback might have sent another request and therefore inserted into the map
+            (void)m_attribute_requests.Erase(request_id);
         }
 
         // Unsubscribe from the shared attribute request topic,
         // if we are not waiting for any further responses with shared attributes from the server.
         // Will be resubscribed if another request is sent anyway
-        if (m_attribute_request_callbacks.empty()) {
+        if (m_attribute_requests.empty()) {
             (void)Attributes_Request_Unsubscribe();
         }
     }
 
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(ATTRIBUTE_RESPONSE_TOPIC, topic, strlen(ATTRIBUTE_RESPONSE_TOPIC)) == 0;
+        return strncmp(ATTRIBUTE_RESPONSE_TOPIC, topic, ATTRIBUTE_RESPONSE_TOPIC_LENGTH) == 0;
+    }
+
+    char const * Get_Response_Topic_Prefix() const override {
+        return ATTRIBUTE_RESPONSE_TOPIC;
     }
 
     bool Unsubscribe() override {
@@ -146,13 +141,20 @@ class Attribute_Request : public IAPI_Implementation {
         return Unsubscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        for (auto & attribute_request : m_attribute_request_callbacks) {
-            attribute_request.Update_Timeout_Timer();
+        size_t request_id = 0U;
+        bool timed_out = false;
+        while (m_attribute_requests.Next_Timed_Out(request_id)) {
+            m_attribute_requests.Find(request_id)->Call_Timeout_Callback();
+            (void)m_attribute_requests.Erase(request_id);
+            timed_out = true;
+        }
+
+        // Timed out requests will never receive a response anymore, therefore we unsubscribe the same way as if we had received it
+        if (timed_out && m_attribute_requests.empty()) {
+            (void)Attributes_Request_Unsubscribe();
         }
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
@@ -162,7 +164,6 @@ class Attribute_Request : public IAPI_Implementation {
         m_send_json_callback.Set_Callback(send_json_callback);
         m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
         m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
-        m_get_request_id_callback.Set_Callback(get_request_id_callback);
     }
 
   private:
@@ -198,7 +199,8 @@ class Attribute_Request : public IAPI_Implementation {
 #else
         Attribute_Request_Callback<MaxAttributes> * registered_callback = nullptr;
 #endif // THINGSBOARD_ENABLE_DYNAMIC
-        if (!Attributes_Request_Subscribe(callback, registered_callback)) {
+        size_t request_id = 0U;
+        if (!Attributes_Request_Subscribe(callback, registered_callback, request_id)) {
             return false;
         }
         else if (registered_callback == nullptr) {
@@ -243,33 +245,26 @@ class Attribute_Request : public IAPI_Implementation {
         // and because there is not enough space the value would simply be "undefined" instead. Which would cause the request to not be sent correctly
         request_buffer[attribute_request_key] = static_cast<const char*>(request);
 
-        size_t * p_request_id = m_get_request_id_callback.Call_Callback();
-        if (p_request_id == nullptr) {
-            Logger::printfln(REQUEST_ID_NULL);
-            return false;
-        }
-        auto & request_id = *p_request_id;
-
-        registered_callback->Set_Request_ID(++request_id);
+        registered_callback->Set_Request_ID(request_id);
         registered_callback->Set_Attribute_Key(attribute_response_key);
-        registered_callback->Start_Timeout_Timer();
 
-        char topic[Helper::detectSize(ATTRIBUTE_REQUEST_TOPIC, request_id)] = {};
-        (void)snprintf(topic, sizeof(topic), ATTRIBUTE_REQUEST_TOPIC, request_id);
+        char topic[ATTRIBUTE_REQUEST_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U] = {};
+        (void)Helper::buildTopic(topic, ATTRIBUTE_REQUEST_TOPIC, ATTRIBUTE_REQUEST_TOPIC_LENGTH, request_id);
         return m_send_json_callback.Call_Callback(topic, request_buffer, Helper::Measure_Json(request_buffer));
     }
 
     /// @brief Subscribes to attribute response topic
     /// @param callback Callback method that will be called
     /// @param registered_callback Editable pointer to a reference of the local version that was copied from the passed callback
+    /// @param request_id Id the local version was inserted with, has to be sent with the request
     /// @return Whether requesting the given callback was successful or not
 #if THINGSBOARD_ENABLE_DYNAMIC
-    bool Attributes_Request_Subscribe(Attribute_Request_Callback const & callback, Attribute_Request_Callback * & registered_callback) {
+    bool Attributes_Request_Subscribe(Attribute_Request_Callback const & callback, Attribute_Request_Callback * & registered_callback, size_t & request_id) {
 #else
-    bool Attributes_Request_Subscribe(Attribute_Request_Callback<MaxAttributes> const & callback, Attribute_Request_Callback<MaxAttributes> * & registered_callback) {
+    bool Attributes_Request_Subscribe(Attribute_Request_Callback<MaxAttributes> const & callback, Attribute_Request_Callback<MaxAttributes> * & registered_callback, size_t & request_id) {
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 #if !THINGSBOARD_ENABLE_DYNAMIC
-        if (m_attribute_request_callbacks.size() + 1 > m_attribute_request_callbacks.capacity()) {
+        if (m_attribute_requests.size() + 1 > MaxSubscriptions) {
             Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, MAX_SUBSCRIPTIONS_TEMPLATE_NAME, CLIENT_SHARED_ATTRIBUTE_SUBSCRIPTIONS);
             return false;
         }
@@ -278,25 +273,23 @@ class Attribute_Request : public IAPI_Implementation {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
           return false;
         }
-        m_attribute_request_callbacks.push_back(callback);
-        registered_callback = &m_attribute_request_callbacks.back();
-        return true;
+        registered_callback = m_attribute_requests.Insert(callback, callback.Get_Timeout(), request_id);
+        return registered_callback != nullptr;
     }
 
     /// @brief Unsubscribes all client-side or shared attributes request callbacks
     /// @return Whether unsubcribing the previously subscribed callbacks
     /// and from the  attribute response topic, was successful or not
     bool Attributes_Request_Unsubscribe() {
-        m_attribute_request_callbacks.clear();
+        m_attribute_requests.clear();
         return m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
     }
 
     Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};          // Send json document callback
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};    // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};  // Unubscribe mqtt topic client callback
-    Callback<size_t *>                                                       m_get_request_id_callback = {};     // Get internal request id callback
 
-    // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
+    // Slot map (grows on the heap or is limited to MaxSubscriptions, depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), holds copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
     // This can be done because all Callback methods mostly consists of pointers to actual object so copying them
     // does not require a huge memory overhead and is acceptable especially in comparsion to possible problems that could
@@ -305,9 +298,9 @@ class Attribute_Request : public IAPI_Implementation {
     // Therefore copy-by-value has been choosen as for this specific use case it is more advantageous,
     // especially because at most we copy internal vectors or array, that will only ever contain a few pointers
 #if THINGSBOARD_ENABLE_DYNAMIC
-    Vector<Attribute_Request_Callback>                                       m_attribute_request_callbacks = {}; // Client-side or shared attribute request callback vector
+    Pending_Request_Map<Attribute_Request_Callback>                                          m_attribute_requests = {}; // Client-side or shared attribute requests waiting on a response, keyed by request id
 #else
-    Array<Attribute_Request_Callback<MaxAttributes>, MaxSubscriptions>       m_attribute_request_callbacks = {}; // Client-side or shared attribute request callback array
+    Pending_Request_Map<Attribute_Request_Callback<MaxAttributes>, MaxSubscriptions>         m_attribute_requests = {}; // Client-side or shared attribute requests waiting on a response, keyed by request id
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 };
 
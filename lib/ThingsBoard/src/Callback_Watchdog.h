@@ -0,0 +1,41 @@
+#ifndef Callback_Watchdog_h
+#define Callback_Watchdog_h
+
+// Local includes.
+#include "Timeout_Wheel.h"
+
+
+/// @brief Wrapper class which allows to start a timer and if it is not stopped in the given time then the callback that was passed will be called,
+/// which informs the user of the failure to stop the timer in time, meaning a timeout has occured.
+/// The class is a node of the global Timeout_Wheel, which is embedded into the class that owns the watchdog, meaning starting or stopping it does not create, start or delete any timer in the background.
+/// Instead all watchdogs share the same wheel, that is ticked from the ThingsBoard loop() method, which removes the need for a Hardware Timer with Interrupts or a timer task per watchdog.
+/// The class instance is meant to be started with once() which will then call the registered callback after the timeout has passed.
+/// if the detach() method has not been called yet.
+/// This results in behaviour similair to a esp task watchdog but without as high of an accuracy and without restarting the device,
+/// allowing to let it fail and handle the error case silently by the user in the callback method
+class Callback_Watchdog : public Timeout_Node {
+  public:
+    /// @brief Constructs empty timeout timer callback, will result in never being called. Internals are simply default constructed as nullptr
+    Callback_Watchdog() = default;
+
+    /// @brief Constructs callback, will be called if the timeout time passes without detach() being called
+    /// @param callback Callback method that will be called as soon as the timer wheel has processed that the given timeout time passed
+    explicit Callback_Watchdog(function callback)
+      : Timeout_Node(callback)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Starts the watchdog timer once for the given timeout, restarts it if it was already started
+    /// @param timeout_microseconds Amount of microseconds until the detach() method is excpected to have been called or the initally given callback method will be called
+    void once(uint64_t const & timeout_microseconds) {
+        Timeout_Wheel::Get_Instance().Arm(*this, timeout_microseconds);
+    }
+
+    /// @brief Stops the currently ongoing watchdog timer and ensures the callback is not called. Timer can simply be restarted with calling once() again
+    void detach() {
+        Cancel();
+    }
+};
+
+#endif // Callback_Watchdog_h
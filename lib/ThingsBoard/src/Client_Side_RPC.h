@@ -4,12 +4,15 @@
 // Local includes.
 #include "RPC_Request_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Pending_Request_Map.h"
 
 
 // Client side RPC topics.
 char constexpr RPC_RESPONSE_SUBSCRIBE_TOPIC[] = "v1/devices/me/rpc/response/+";
 char constexpr RPC_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/";
-char constexpr RPC_SEND_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/%u";
+size_t constexpr RPC_RESPONSE_TOPIC_LENGTH = sizeof(RPC_RESPONSE_TOPIC) - 1U;
+char constexpr RPC_SEND_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
+size_t constexpr RPC_SEND_REQUEST_TOPIC_LENGTH = sizeof(RPC_SEND_REQUEST_TOPIC) - 1U;
 // Log messages.
 char constexpr CLIENT_RPC_METHOD_NULL[] = "Client-side RPC method name is NULL";
 #if !THINGSBOARD_ENABLE_DYNAMIC
@@ -35,8 +38,17 @@ template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxReque
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 class Client_Side_RPC : public IAPI_Implementation {
   public:
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Constructor
+    /// @param expected_requests Amount of requests that are expected to wait on a response at the same time, their slots are allocated up front,
+    /// so that sending requests does not allocate or reallocate as long as no more requests are waiting on a response at the same time, default = Default_Subscriptions_Amount (1)
+    Client_Side_RPC(size_t const & expected_requests = Default_Subscriptions_Amount) {
+        m_rpc_requests.reserve(expected_requests);
+    }
+#else
     /// @brief Constructor
     Client_Side_RPC() = default;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
 
     /// @brief Requests one client-side RPC callback,
     /// that will be called if a response from the server for the method with the given name is received.
@@ -53,7 +65,8 @@ class Client_Side_RPC : public IAPI_Implementation {
             return false;
         }
         RPC_Request_Callback * registered_callback = nullptr;
-        if (!RPC_Request_Subscribe(callback, registered_callback)) {
+        size_t request_id = 0U;
+        if (!RPC_Request_Subscribe(callback, registered_callback, request_id)) {
             return false;
         }
         else if (registered_callback == nullptr) {
@@ -84,22 +97,15 @@ class Client_Side_RPC : public IAPI_Implementation {
 #if !THINGSBOARD_ENABLE_DYNAMIC
         if (request_buffer.overflowed()) {
             Logger::printfln(RPC_REQUEST_OVERFLOWED, MaxRequestRPC);
+            (void)m_rpc_requests.Erase(request_id);
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
 
-        size_t * p_request_id = m_get_request_id_callback.Call_Callback();
-        if (p_request_id == nullptr) {
-            Logger::printfln(REQUEST_ID_NULL);
-            return false;
-        }
-        auto & request_id = *p_request_id;
-
-        registered_callback->Set_Request_ID(++request_id);
-        registered_callback->Start_Timeout_Timer();
+        registered_callback->Set_Request_ID(request_id);
 
-        char topic[Helper::detectSize(RPC_SEND_REQUEST_TOPIC, request_id)] = {};
-        (void)snprintf(topic, sizeof(topic), RPC_SEND_REQUEST_TOPIC, request_id);
+        char topic[RPC_SEND_REQUEST_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U] = {};
+        (void)Helper::buildTopic(topic, RPC_SEND_REQUEST_TOPIC, RPC_SEND_REQUEST_TOPIC_LENGTH, request_id);
         return m_send_json_callback.Call_Callback(topic, request_buffer, Helper::Measure_Json(request_buffer));
     }
 
@@ -112,42 +118,31 @@ class Client_Side_RPC : public IAPI_Implementation {
     }
 
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
-        size_t const request_id = Helper::parseRequestId(RPC_RESPONSE_TOPIC, topic);
-
-#if THINGSBOARD_ENABLE_STL
-        auto it = std::find_if(m_rpc_request_callbacks.begin(), m_rpc_request_callbacks.end(), [&request_id](RPC_Request_Callback & rpc_request) {
-            return rpc_request.Get_Request_ID() == request_id;
-        });
-        if (it != m_rpc_request_callbacks.end()) {
-            auto & rpc_request = *it;
-#else
-        for (auto it = m_rpc_request_callbacks.begin(); it != m_rpc_request_callbacks.end(); ++it) {
-            auto & rpc_request = *it;
-
-            if (rpc_request.Get_Request_ID() != request_id) {
-                continue;
-            }
-#endif // THINGSBOARD_ENABLE_STL
-            rpc_request.Stop_Timeout_Timer();
-            rpc_request.Call_Callback(data);
-
-            // Delete callback because the changes have been requested and the callback is no longer needed
-            Helper::remove(m_rpc_request_callbacks, it);
-#if !THINGSBOARD_ENABLE_STL
-            break;
-#endif // !THINGSBOARD_ENABLE_STL
+        size_t const request_id = Helper::parseRequestId(topic, RPC_RESPONSE_TOPIC_LENGTH);
+
+        auto rpc_request = m_rpc_requests.Find(request_id);
+        if (rpc_request != nullptr) {
+            rpc_request->Call_Callback(data);
+
+            // Delete callback because the changes have been requested and the callback is no longer needed.
+            // Erased by id instead of the pointer, because the callback might have sent another request and therefore inserted into the map
+            (void)m_rpc_requests.Erase(request_id);
         }
 
         // Attempt to unsubscribe from the shared attribute request topic,
         // if we are not waiting for any further responses with shared attributes from the server.
         // Will be resubscribed if another request is sent anyway
-        if (m_rpc_request_callbacks.empty()) {
+        if (m_rpc_requests.empty()) {
             (void)RPC_Request_Unsubscribe();
         }
     }
 
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(RPC_RESPONSE_TOPIC, topic, strlen(RPC_RESPONSE_TOPIC)) == 0;
+        return strncmp(RPC_RESPONSE_TOPIC, topic, RPC_RESPONSE_TOPIC_LENGTH) == 0;
+    }
+
+    char const * Get_Response_Topic_Prefix() const override {
+        return RPC_RESPONSE_TOPIC;
     }
 
     bool Unsubscribe() override {
@@ -158,13 +153,20 @@ class Client_Side_RPC : public IAPI_Implementation {
         return Unsubscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        for (auto & rpc_request : m_rpc_request_callbacks) {
-            rpc_request.Update_Timeout_Timer();
+        size_t request_id = 0U;
+        bool timed_out = false;
+        while (m_rpc_requests.Next_Timed_Out(request_id)) {
+            m_rpc_requests.Find(request_id)->Call_Timeout_Callback();
+            (void)m_rpc_requests.Erase(request_id);
+            timed_out = true;
+        }
+
+        // Timed out requests will never receive a response anymore, therefore we unsubscribe the same way as if we had received it
+        if (timed_out && m_rpc_requests.empty()) {
+            (void)RPC_Request_Unsubscribe();
         }
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
@@ -174,7 +176,6 @@ class Client_Side_RPC : public IAPI_Implementation {
         m_send_json_callback.Set_Callback(send_json_callback);
         m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
         m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
-        m_get_request_id_callback.Set_Callback(get_request_id_callback);
     }
 
   private:
@@ -183,10 +184,11 @@ class Client_Side_RPC : public IAPI_Implementation {
     /// See https://thingsboard.io/docs/user-guide/rpc/#client-side-rpc for more information
     /// @param callback Callback method that will be called
     /// @param registered_callback Editable pointer to a reference of the local version that was copied from the passed callback
+    /// @param request_id Id the local version was inserted with, has to be sent with the request
     /// @return Whether requesting the given callback was successful or not
-    bool RPC_Request_Subscribe(RPC_Request_Callback const & callback, RPC_Request_Callback * & registered_callback) {
+    bool RPC_Request_Subscribe(RPC_Request_Callback const & callback, RPC_Request_Callback * & registered_callback, size_t & request_id) {
 #if !THINGSBOARD_ENABLE_DYNAMIC
-        if (m_rpc_request_callbacks.size() + 1 > m_rpc_request_callbacks.capacity()) {
+        if (m_rpc_requests.size() + 1 > MaxSubscriptions) {
             Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, MAX_SUBSCRIPTIONS_TEMPLATE_NAME, CLIENT_SIDE_RPC_SUBSCRIPTIONS);
             return false;
         }
@@ -195,25 +197,23 @@ class Client_Side_RPC : public IAPI_Implementation {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, RPC_RESPONSE_SUBSCRIBE_TOPIC);
             return false;
         }
-        m_rpc_request_callbacks.push_back(callback);
-        registered_callback = &m_rpc_request_callbacks.back();
-        return true;
+        registered_callback = m_rpc_requests.Insert(callback, callback.Get_Timeout(), request_id);
+        return registered_callback != nullptr;
     }
 
     /// @brief Unsubscribes all client-side RPC request callbacks
     /// @return Whether unsubcribing the previously subscribed callbacks
     /// and from the client-side RPC response topic, was successful or not
     bool RPC_Request_Unsubscribe() {
-        m_rpc_request_callbacks.clear();
+        m_rpc_requests.clear();
         return m_unsubscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC);
     }
 
     Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};          // Send json document callback
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};    // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};  // Unubscribe mqtt topic client callback
-    Callback<size_t *>                                                       m_get_request_id_callback = {};     // Get internal request id callback
 
-    // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
+    // Slot map (grows on the heap or is limited to MaxSubscriptions, depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), holds copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
     // This can be done because all Callback methods mostly consists of pointers to actual object so copying them
     // does not require a huge memory overhead and is acceptable especially in comparsion to possible problems that could
@@ -222,9 +222,9 @@ class Client_Side_RPC : public IAPI_Implementation {
     // Therefore copy-by-value has been choosen as for this specific use case it is more advantageous,
     // especially because at most we copy internal vectors or array, that will only ever contain a few pointers
 #if THINGSBOARD_ENABLE_DYNAMIC
-    Vector<RPC_Request_Callback>                                             m_rpc_request_callbacks = {};       // Server side RPC callbacks vector
+    Pending_Request_Map<RPC_Request_Callback>                                m_rpc_requests = {};                // Client-side RPC requests waiting on a response, keyed by request id
 #else
-    Array<RPC_Request_Callback, MaxSubscriptions>                            m_rpc_request_callbacks = {};       // Server side RPC callbacks array
+    Pending_Request_Map<RPC_Request_Callback, MaxSubscriptions>              m_rpc_requests = {};                // Client-side RPC requests waiting on a response, keyed by request id
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 };
 
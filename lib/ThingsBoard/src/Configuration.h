@@ -53,8 +53,8 @@
 #    endif
 #  endif
 
-// Use the esp_timer header internally for handling timeouts and callbacks, as long as the header exists, because it is more efficient than the Arduino Ticker implementation,
-// because we can stop the timer without having to delete it, removing the need to create a new timer to restart it. Because instead we can simply stop and start again.
+// Use the esp_timer header internally as the time source of the timer wheel handling timeouts and callbacks, as long as the header exists, because it returns a 64-bit time in microseconds that never wraps around,
+// compared to the Arduino micros() method that wraps around after roughly 71 minutes.
 // Only exists following major version 3 minor version 0 on ESP32 (https://github.com/espressif/esp-idf/releases/tag/v3.0-rc1)and major version 3 minor version 1 on ESP8266 (https://github.com/espressif/ESP8266_RTOS_SDK/releases/tag/v3.1-rc1)
 #  ifndef THINGSBOARD_USE_ESP_TIMER
 #    ifdef __has_include
@@ -168,4 +168,14 @@
 #    endif
 #  endif
 
+// Enables sending telemetry and attribute data as Protobuf messages instead of json, required if the MQTT transport payload type of the ThingsBoard device profile is Protobuf.
+// Messages are encoded with the compile time schemas set with Set_Telemetry_Schema() and Set_Attribute_Schema(), which need to match the .proto schemas entered in the device profile.
+// Every key-value pair based send method is encoded, already serialized json (sendTelemetryJson(), sendTelemetryString() and the attribute equivalents) and timestamped samples
+// sent with sendTelemetrySamples() are still sent as json. Each message is one plain Protobuf message without a length prefix, which is what ThingsBoard parses the MQTT payload as.
+// Protobuf messages are smaller than the equivalent json, because keys are replaced by field numbers and values are encoded in binary instead of text.
+// See https://thingsboard.io/docs/user-guide/device-profiles/#mqtt-device-payload for more information.
+#  ifndef THINGSBOARD_ENABLE_PROTOBUF
+#    define THINGSBOARD_ENABLE_PROTOBUF 0
+#  endif
+
 #endif // Configuration_h
@@ -0,0 +1,432 @@
+#ifndef Gateway_h
+#define Gateway_h
+
+// Local includes.
+#include "Gateway_RPC_Callback.h"
+#include "IAPI_Implementation.h"
+#include "Json_Arena.h"
+#include "RPC_Method_Table.h"
+#include "Telemetry_Batch.h"
+
+
+// Gateway API topics.
+char constexpr GATEWAY_CONNECT_TOPIC[] = "v1/gateway/connect";
+char constexpr GATEWAY_DISCONNECT_TOPIC[] = "v1/gateway/disconnect";
+char constexpr GATEWAY_TELEMETRY_TOPIC[] = "v1/gateway/telemetry";
+char constexpr GATEWAY_ATTRIBUTE_TOPIC[] = "v1/gateway/attributes";
+char constexpr GATEWAY_RPC_TOPIC[] = "v1/gateway/rpc";
+// Gateway API keys.
+char constexpr GATEWAY_DEVICE_KEY[] = "device";
+char constexpr GATEWAY_TYPE_KEY[] = "type";
+char constexpr GATEWAY_DATA_KEY[] = "data";
+char constexpr GATEWAY_ID_KEY[] = "id";
+char constexpr GATEWAY_ERROR_KEY[] = "error";
+// Errors responded with if a request can not be answered by a subscribed callback.
+char constexpr GATEWAY_RPC_METHOD_NOT_FOUND[] = "Method not found";
+char constexpr GATEWAY_RPC_RESPONSE_TOO_BIG[] = "Response overflowed";
+// Log messages.
+char constexpr GATEWAY_RPC_RESPONSE_OVERFLOWED[] = "Gateway RPC response overflowed, increase MaxRPC (%u)";
+#if !THINGSBOARD_ENABLE_DYNAMIC
+char constexpr GATEWAY_RPC_SUBSCRIPTIONS[] = "gateway RPC";
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_DEBUG
+char constexpr GATEWAY_RPC_DATA_NULL[] = "Gateway RPC request does not contain the device name";
+char constexpr GATEWAY_RPC_CB_NOT_FOUND[] = "No subscribed callback for gateway rpc with device (%s) and methodname (%s)";
+char constexpr CALLING_GATEWAY_RPC_CB[] = "Calling subscribed callback for gateway rpc with device (%s) and methodname (%s)";
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+
+/// @brief Values measured by one device connected through the gateway, multiple samples are sent in one single message with Gateway::Gateway_Send_Telemetry()
+/// @tparam MaxKeyValuePairAmount Maximum amount of key-value pairs of one sample
+template <size_t MaxKeyValuePairAmount>
+struct Gateway_Sample {
+    char const                              *device; // Name of the device the values belong to, has to be set
+    Telemetry_Batch<MaxKeyValuePairAmount>  values;  // Values and the optional timestamp they were acquired at
+};
+
+
+/// @brief Handles the internal implementation of the ThingsBoard gateway API, which allows one device to send and receive data for many other devices over its own single MQTT connection.
+/// The other devices do not need their own network connection, they are created on the server with the name they are connected with and are shown as separate devices.
+/// See https://thingsboard.io/docs/reference/gateway-mqtt-api/ for more information
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+#if THINGSBOARD_ENABLE_DYNAMIC
+template <typename Logger = DefaultLogger>
+#else
+/// @tparam MaxSubscriptions Maximum amount of simultaneous gateway rpc subscriptions over all devices.
+/// Once the maximum amount has been reached it is not possible to increase the size, this is done because it allows to allcoate the memory on the stack instead of the heap, default = Default_Subscriptions_Amount (1)
+/// @tparam MaxRPC Maximum amount of key-value pairs that will ever be sent in the subscribed callback method of a Gateway_RPC_Callback, allows to use a StaticJsonDocument on the stack in the background.
+/// See https://arduinojson.org/v6/assistant/ for more information on how to estimate the required size and divide the result by 16 to receive the required MaxRPC value, default = Default_RPC_Amount (0)
+template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxRPC = Default_RPC_Amount, typename Logger = DefaultLogger>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+class Gateway : public IAPI_Implementation {
+  public:
+    /// @brief Constructor
+    Gateway()
+      : m_json_filter()
+    {
+        // Only the device name and the request are used, every other field of the request is skipped while deserializing
+        m_json_filter[GATEWAY_DEVICE_KEY] = true;
+        JsonObject request = m_json_filter.createNestedObject(GATEWAY_DATA_KEY);
+        request[GATEWAY_ID_KEY] = true;
+        request[RPC_METHOD_KEY] = true;
+        request[RPC_PARAMS_KEY] = true;
+    }
+
+    /// @brief Informs the server that the device with the given name is now connected through the gateway, creates the device on the server if it does not exist yet.
+    /// Has to be called again for every device after the gateway itself has reconnected
+    /// @param device_name Name of the device connected through the gateway
+    /// @param device_type Name of the device profile used if the device has to be created, nullptr uses the default profile
+    /// @return Whether sending the connect message was successful or not
+    bool Gateway_Connect(char const * device_name, char const * device_type = nullptr) {
+        StaticJsonDocument<JSON_OBJECT_SIZE(2)> json_buffer;
+        json_buffer[GATEWAY_DEVICE_KEY] = device_name;
+        if (device_type != nullptr) {
+            json_buffer[GATEWAY_TYPE_KEY] = device_type;
+        }
+        return m_send_json_callback.Call_Callback(GATEWAY_CONNECT_TOPIC, json_buffer, Helper::Measure_Json(json_buffer));
+    }
+
+    /// @brief Informs the server that the device with the given name is not connected through the gateway anymore
+    /// @param device_name Name of the device connected through the gateway
+    /// @return Whether sending the disconnect message was successful or not
+    bool Gateway_Disconnect(char const * device_name) {
+        StaticJsonDocument<JSON_OBJECT_SIZE(1)> json_buffer;
+        json_buffer[GATEWAY_DEVICE_KEY] = device_name;
+        return m_send_json_callback.Call_Callback(GATEWAY_DISCONNECT_TOPIC, json_buffer, Helper::Measure_Json(json_buffer));
+    }
+
+    /// @brief Sends the samples of multiple devices as telemetry data in one single message, formatted as {"Device A":[{..},{..}],"Device B":[{..}]}.
+    /// Samples of the same device do not have to be next to each other, they are grouped by the device name and keep their relative order.
+    /// Samples with a timestamp are sent as {"ts":..,"values":{..}}, samples without one receive the time the server received the message at.
+    /// See https://thingsboard.io/docs/reference/gateway-mqtt-api/#telemetry-upload-api for more information
+    /// @tparam InputIterator Class that points to the begin and end iterator of a container of Gateway_Sample instances,
+    /// allows for using / passing either std::vector, std::array or a plain array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first sample in the data container
+    /// @param last Iterator pointing to the end of the data container (last sample + 1)
+    /// @return Whether sending the samples was successful or not
+    template<typename InputIterator>
+    bool Gateway_Send_Telemetry(InputIterator const & first, InputIterator const & last) {
+        return Send_Samples(GATEWAY_TELEMETRY_TOPIC, first, last, true);
+    }
+
+    /// @brief Sends the client-side attributes of multiple devices in one single message, formatted as {"Device A":{..},"Device B":{..}}.
+    /// Multiple samples of the same device are merged into one object, the timestamp of the samples has to be left unset, because attributes do not have a timestamp.
+    /// See https://thingsboard.io/docs/reference/gateway-mqtt-api/#publish-attribute-update-to-the-server for more information
+    /// @tparam InputIterator Class that points to the begin and end iterator of a container of Gateway_Sample instances,
+    /// allows for using / passing either std::vector, std::array or a plain array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first sample in the data container
+    /// @param last Iterator pointing to the end of the data container (last sample + 1)
+    /// @return Whether sending the attributes was successful or not
+    template<typename InputIterator>
+    bool Gateway_Send_Attributes(InputIterator const & first, InputIterator const & last) {
+        return Send_Samples(GATEWAY_ATTRIBUTE_TOPIC, first, last, false);
+    }
+
+    /// @brief Subscribes multiple gateway RPC callbacks, that will be called if a request from the server for the device and method with the given name is received.
+    /// Can be called even if we are currently not connected to the cloud, the topic is subscribed automatically by the library once the device has established a connection to the cloud.
+    /// See https://thingsboard.io/docs/reference/gateway-mqtt-api/#server-side-rpc for more information
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @return Whether subscribing the given callbacks was successful or not
+    template<typename InputIterator>
+    bool Gateway_RPC_Subscribe(InputIterator const & first, InputIterator const & last) {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        size_t const size = Helper::distance(first, last);
+        if (m_rpc_callbacks.size() + size > m_rpc_callbacks.capacity()) {
+            Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, MAX_SUBSCRIPTIONS_TEMPLATE_NAME, GATEWAY_RPC_SUBSCRIPTIONS);
+            return false;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        (void)m_subscribe_topic_callback.Call_Callback(GATEWAY_RPC_TOPIC);
+        m_rpc_callbacks.insert(m_rpc_callbacks.end(), first, last);
+        m_method_table.Build_With_Device(m_rpc_callbacks.begin(), m_rpc_callbacks.end());
+        return true;
+    }
+
+    /// @brief Subscribe one gateway RPC callback, that will be called if a request from the server for the device and method with the given name is received.
+    /// Can be called even if we are currently not connected to the cloud, the topic is subscribed automatically by the library once the device has established a connection to the cloud.
+    /// See https://thingsboard.io/docs/reference/gateway-mqtt-api/#server-side-rpc for more information
+    /// @param callback Callback method that will be called
+    /// @return Whether subscribing the given callback was successful or not
+    bool Gateway_RPC_Subscribe(Gateway_RPC_Callback const & callback) {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        if (m_rpc_callbacks.size() + 1 > m_rpc_callbacks.capacity()) {
+            Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, MAX_SUBSCRIPTIONS_TEMPLATE_NAME, GATEWAY_RPC_SUBSCRIPTIONS);
+            return false;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        (void)m_subscribe_topic_callback.Call_Callback(GATEWAY_RPC_TOPIC);
+        m_rpc_callbacks.push_back(callback);
+        m_method_table.Build_With_Device(m_rpc_callbacks.begin(), m_rpc_callbacks.end());
+        return true;
+    }
+
+    /// @brief Unsubcribes all gateway RPC callbacks.
+    /// @return Whether unsubcribing all the previously subscribed callbacks
+    /// and from the gateway rpc topic, was successful or not
+    bool Gateway_RPC_Unsubscribe() {
+        m_rpc_callbacks.clear();
+        m_method_table.Clear();
+        return m_unsubscribe_topic_callback.Call_Callback(GATEWAY_RPC_TOPIC);
+    }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Gets the biggest size the JsonDocument passed to the subscribed callbacks to enter their response has ever required.
+    /// The memory for that JsonDocument is kept between requests and only grown if a callback with a bigger response size is called
+    /// @return Biggest amount of bytes ever required to hold a response
+    size_t Get_Response_Arena_High_Water_Mark() const {
+        return m_response_arena.High_Water_Mark();
+    }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+    API_Process_Type Get_Process_Type() const override {
+        return API_Process_Type::JSON;
+    }
+
+    void Process_Response(char const *, uint8_t *, unsigned int) override {
+        // Nothing to do
+    }
+
+    void Process_Json_Response(char const *, JsonDocument const & data) override {
+        char const * device_name = data[GATEWAY_DEVICE_KEY];
+        JsonVariantConst const request = data[GATEWAY_DATA_KEY];
+        char const * method_name = request[RPC_METHOD_KEY];
+        if (device_name == nullptr) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(GATEWAY_RPC_DATA_NULL);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return;
+        }
+
+        // The gateway has to respond to every request for one of its devices, otherwise the server waits for the response until the request times out
+        size_t const index = m_method_table.Find(device_name, method_name);
+        if (index == RPC_METHOD_NOT_FOUND) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(GATEWAY_RPC_CB_NOT_FOUND, device_name, method_name != nullptr ? method_name : "");
+#endif // THINGSBOARD_ENABLE_DEBUG
+            Send_Error_Response(device_name, request[GATEWAY_ID_KEY], GATEWAY_RPC_METHOD_NOT_FOUND);
+            return;
+        }
+        Gateway_RPC_Callback const & rpc = m_rpc_callbacks[index];
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(CALLING_GATEWAY_RPC_CB, device_name, method_name);
+#endif // THINGSBOARD_ENABLE_DEBUG
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+        size_t const & rpc_response_size = rpc.Get_Response_Size();
+        TBArenaJsonDocument json_buffer(rpc_response_size, Json_Arena_Allocator(m_response_arena));
+#else
+        size_t constexpr rpc_response_size = MaxRPC;
+        StaticJsonDocument<JSON_OBJECT_SIZE(MaxRPC)> json_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        rpc.Call_Callback(request[RPC_PARAMS_KEY], json_buffer);
+
+        if (json_buffer.overflowed()) {
+            Logger::printfln(GATEWAY_RPC_RESPONSE_OVERFLOWED, rpc_response_size);
+            Send_Error_Response(device_name, request[GATEWAY_ID_KEY], GATEWAY_RPC_RESPONSE_TOO_BIG);
+            return;
+        }
+        Send_Response(device_name, request[GATEWAY_ID_KEY], json_buffer);
+    }
+
+    bool Compare_Response_Topic(char const * topic) const override {
+        return strcmp(GATEWAY_RPC_TOPIC, topic) == 0;
+    }
+
+    char const * Get_Response_Topic_Prefix() const override {
+        return GATEWAY_RPC_TOPIC;
+    }
+
+    JsonDocument const * Get_Json_Filter() const override {
+        return &m_json_filter;
+    }
+
+    bool Unsubscribe() override {
+        return Gateway_RPC_Unsubscribe();
+    }
+
+    bool Resubscribe_Topic() override {
+        if (!m_rpc_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(GATEWAY_RPC_TOPIC)) {
+            Logger::printfln(SUBSCRIBE_TOPIC_FAILED, GATEWAY_RPC_TOPIC);
+            return false;
+        }
+        return true;
+    }
+
+    void loop() override {
+        // Nothing to do
+    }
+
+    void Initialize() override {
+        // Nothing to do
+    }
+
+    void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function, Callback<uint16_t>::function, Callback<bool, uint16_t, uint16_t>::function, Callback<size_t *>::function) override {
+        m_send_json_callback.Set_Callback(send_json_callback);
+        m_send_json_string_callback.Set_Callback(send_json_string_callback);
+        m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
+        m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
+    }
+
+  private:
+    template <typename TWriter>
+    using Formatter = ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::TextFormatter<TWriter>;
+
+    /// @brief Sends the given response to the request with the given id for the given device, wrapped with the device name and request id
+    /// @param device_name Name of the device the request was meant for
+    /// @param id Id of the request
+    /// @param data Response entered by the callback
+    void Send_Response(char const * device_name, JsonVariantConst const & id, JsonDocument const & data) {
+#if THINGSBOARD_ENABLE_DYNAMIC
+        TBArenaJsonDocument response(JSON_OBJECT_SIZE(3U) + data.memoryUsage(), Json_Arena_Allocator(m_envelope_arena));
+#else
+        StaticJsonDocument<JSON_OBJECT_SIZE(3U) + JSON_OBJECT_SIZE(MaxRPC > 1U ? MaxRPC : 1U)> response;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        response[GATEWAY_DEVICE_KEY] = device_name;
+        response[GATEWAY_ID_KEY] = id;
+        response[GATEWAY_DATA_KEY] = data;
+        (void)m_send_json_callback.Call_Callback(GATEWAY_RPC_TOPIC, response, Helper::Measure_Json(response));
+    }
+
+    /// @brief Sends a response containing only the given error to the request with the given id for the given device
+    /// @param device_name Name of the device the request was meant for
+    /// @param id Id of the request
+    /// @param error Reason the request could not be answered by a subscribed callback
+    void Send_Error_Response(char const * device_name, JsonVariantConst const & id, char const * error) {
+        StaticJsonDocument<JSON_OBJECT_SIZE(1U)> data;
+        data[GATEWAY_ERROR_KEY] = error;
+        Send_Response(device_name, id, data);
+    }
+
+    /// @brief Serializes the given samples grouped by their device into one json string and sends it over the given topic.
+    /// The json is written into memory kept between calls, which is only grown if a message bigger than every previous one is sent
+    /// @param topic Topic the message is sent over
+    /// @param first Iterator pointing to the first sample in the data container
+    /// @param last Iterator pointing to the end of the data container (last sample + 1)
+    /// @param as_array Whether the samples of one device are written as an array of objects (telemetry) or merged into one object (attributes)
+    /// @return Whether sending the message was successful or not
+    template<typename InputIterator>
+    bool Send_Samples(char const * topic, InputIterator const & first, InputIterator const & last, bool as_array) {
+        // Measured first, so the buffer has exactly the needed size and the json can not be cut off
+        size_t const json_size = Write_Samples(nullptr, 0U, first, last, as_array);
+        char * json = static_cast<char *>(m_send_arena.Allocate(json_size + 1U));
+        if (json == nullptr) {
+            return false;
+        }
+        size_t const written = Write_Samples(json, json_size + 1U, first, last, as_array);
+        json[written] = '\0';
+        bool const result = m_send_json_string_callback.Call_Callback(topic, json);
+        m_send_arena.Deallocate(json);
+        return result;
+    }
+
+    /// @brief Writes the given samples grouped by their device, a sample is only written together with the first sample of the same device
+    /// @param buffer Buffer the json is written into, nullptr to only measure the length
+    /// @param size Size of the buffer, including the null terminator
+    /// @param first Iterator pointing to the first sample in the data container
+    /// @param last Iterator pointing to the end of the data container (last sample + 1)
+    /// @param as_array Whether the samples of one device are written as an array of objects or merged into one object
+    /// @return Length of the json without the null terminator, or the length written so far if the buffer was too small
+    template<typename InputIterator>
+    size_t Write_Samples(char * buffer, size_t const & size, InputIterator const & first, InputIterator const & last, bool as_array) const {
+        size_t written = 0U;
+        Write_Char(buffer, size, written, '{');
+        for (InputIterator device = first; device != last; ++device) {
+            if (Is_Duplicate_Device(first, device)) {
+                continue;
+            }
+            if (device != first) {
+                Write_Char(buffer, size, written, ',');
+            }
+            Write_Device_Name(buffer, size, written, (*device).device);
+            Write_Char(buffer, size, written, ':');
+            Write_Char(buffer, size, written, as_array ? '[' : '{');
+            bool first_sample = true;
+            for (InputIterator sample = device; sample != last; ++sample) {
+                // Empty objects can not be merged, because that would leave a dangling comma
+                if (strcmp((*sample).device, (*device).device) != 0 || (!as_array && (*sample).values.Empty())) {
+                    continue;
+                }
+                if (!first_sample) {
+                    Write_Char(buffer, size, written, ',');
+                }
+                first_sample = false;
+                Write_Values(buffer, size, written, (*sample).values, as_array);
+            }
+            Write_Char(buffer, size, written, as_array ? ']' : '}');
+        }
+        Write_Char(buffer, size, written, '}');
+        return written;
+    }
+
+    /// @brief Whether a sample before the given one has the same device, meaning the given sample was already written together with that sample
+    template<typename InputIterator>
+    static bool Is_Duplicate_Device(InputIterator const & first, InputIterator const & device) {
+        for (InputIterator previous = first; previous != device; ++previous) {
+            if (strcmp((*previous).device, (*device).device) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Writes a single character, if it still fits into the buffer
+    static void Write_Char(char * buffer, size_t const & size, size_t & written, char value) {
+        if (buffer != nullptr && written + 1U < size) {
+            buffer[written] = value;
+        }
+        written++;
+    }
+
+    /// @brief Writes the quoted and escaped device name, if it still fits into the buffer
+    static void Write_Device_Name(char * buffer, size_t const & size, size_t & written, char const * device_name) {
+        if (buffer == nullptr) {
+            Formatter<ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::DummyWriter> formatter(ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::DummyWriter{});
+            formatter.writeString(device_name);
+            written += formatter.bytesWritten();
+            return;
+        }
+        size_t const remaining = written + 1U < size ? size - written - 1U : 0U;
+        Formatter<ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::StaticStringWriter> formatter(ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::StaticStringWriter(buffer + written, remaining));
+        formatter.writeString(device_name);
+        written += formatter.bytesWritten();
+    }
+
+    /// @brief Writes the json object of the given values, if it still fits into the buffer.
+    /// Merged objects are written without their surrounding braces, so the key-value pairs of multiple samples end up in the same object
+    template<size_t MaxKeyValuePairAmount>
+    static void Write_Values(char * buffer, size_t const & size, size_t & written, Telemetry_Batch<MaxKeyValuePairAmount> const & values, bool as_array) {
+        size_t const length = values.Measure_Json();
+        size_t const braces = as_array ? 0U : 2U;
+        if (buffer != nullptr && written + length < size && values.Serialize_Json(buffer + written, size - written) == length && !as_array) {
+            memmove(buffer + written, buffer + written + 1U, length - braces);
+        }
+        written += length - braces;
+    }
+
+    Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};         // Send json document callback
+    Callback<bool, char const * const, char const * const>                   m_send_json_string_callback = {};  // Send json string callback
+    Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};   // Subscribe mqtt topic client callback
+    Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {}; // Unubscribe mqtt topic client callback
+    StaticJsonDocument<JSON_OBJECT_SIZE(2U) + JSON_OBJECT_SIZE(3U)>          m_json_filter;                     // Fields of the request that are deserialized
+    Json_Arena                                                               m_send_arena = {};                 // Memory reused by the json of every telemetry and attribute message, only grows
+
+    // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
+    // even if the user only temporarily created the object before the method was called
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Gateway_RPC_Callback>                                             m_rpc_callbacks = {};              // Gateway RPC callbacks vector
+    RPC_Method_Table                                                         m_method_table = {};               // Index of the gateway RPC callbacks by device name and method name
+    Json_Arena                                                               m_response_arena = {};             // Memory reused by the response entered by every gateway RPC callback, only grows
+    Json_Arena                                                               m_envelope_arena = {};             // Memory reused by the message wrapping that response with the device name and request id, only grows
+#else
+    Array<Gateway_RPC_Callback, MaxSubscriptions>                            m_rpc_callbacks = {};              // Gateway RPC callbacks array
+    RPC_Method_Table<MaxSubscriptions>                                       m_method_table = {};               // Index of the gateway RPC callbacks by device name and method name
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+};
+
+#endif // Gateway_h
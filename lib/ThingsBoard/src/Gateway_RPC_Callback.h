@@ -0,0 +1,51 @@
+#ifndef Gateway_RPC_Callback_h
+#define Gateway_RPC_Callback_h
+
+// Local includes.
+#include "RPC_Callback.h"
+
+
+/// @brief Gateway RPC callback wrapper, server-side RPC callback that is only called for requests to one device connected through the gateway.
+/// Documentation about the specific use of the Gateway RPC API in ThingsBoard can be found here https://thingsboard.io/docs/reference/gateway-mqtt-api/#server-side-rpc
+class Gateway_RPC_Callback : public RPC_Callback {
+  public:
+    /// @brief Constructs empty callback, will result in never being called. Internals are simply default constructed as nullptr
+    Gateway_RPC_Callback() = default;
+
+    /// @brief Constructs callback, will be called upon gateway RPC request arrival for the given device with the given method name
+    /// @param device_name Name of the device connected through the gateway, the request is meant for
+    /// @param method_name Name we expect to be sent via. server-side RPC so that this method callback will be called
+    /// @param callback Callback method that will be called upon data arrival with the given data that was received serialized into a JsonDocument
+    /// and should enter data into the JsonDocument, can be empty if the RPC widget does not expect any response.
+    /// See https://arduinojson.org/v6/api/jsondocument/ for more information on how to enter data into a JsonDocument
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @param response_size Internal size the JsonDocument should be able to hold to contain the response to the server side RPC call.
+    /// Use JSON_OBJECT_SIZE() and pass the amount of key value pair to calculate the estimated size. See https://arduinojson.org/v6/assistant/ for more information on how to estimate the required size, default = Default_RPC_Amount (0)
+    Gateway_RPC_Callback(char const * device_name, char const * method_name, function callback, size_t const & response_size = JSON_OBJECT_SIZE(Default_RPC_Amount))
+      : RPC_Callback(method_name, callback, response_size)
+#else
+    Gateway_RPC_Callback(char const * device_name, char const * method_name, function callback)
+      : RPC_Callback(method_name, callback)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      , m_device_name(device_name)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Gets the poiner to the underlying name of the device the callback handles requests for
+    /// @return Pointer to the passed device name
+    char const * Get_Device_Name() const {
+        return m_device_name;
+    }
+
+    /// @brief Sets the poiner to the underlying name of the device the callback handles requests for
+    /// @param device_name Pointer to the passed device name
+    void Set_Device_Name(char const * device_name) {
+        m_device_name = device_name;
+    }
+
+  private:
+    char const *m_device_name = {}; // Device name
+};
+
+#endif // Gateway_RPC_Callback_h
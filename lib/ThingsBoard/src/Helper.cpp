@@ -0,0 +1,241 @@
+// Header include.
+#include "Helper.h"
+
+// Local includes.
+#include "Constants.h"
+
+// Library includes.
+#include <stdint.h>
+#include <string.h>
+
+size_t Helper::getOccurences(uint8_t const * bytes, char symbol, unsigned int length) {
+    size_t count = 0;
+    if (bytes == nullptr) {
+        return count;
+    }
+    for (size_t i = 0; i < length; ++i) {
+        if (bytes[i] == symbol) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// Word read at once by countJsonElements(), every constant repeats one byte into every byte of the word.
+using Scan_Word = size_t;
+Scan_Word constexpr SCAN_ONES = static_cast<Scan_Word>(~static_cast<Scan_Word>(0U)) / 0xFFU;
+Scan_Word constexpr SCAN_LOW_BITS = SCAN_ONES * 0x7FU;
+// Bit that differs between '[' and '{' as well as between ']' and '}', setting it allows to search for both symbols with one comparison,
+// because no other byte results in '{' or '}' once the bit has been set.
+Scan_Word constexpr SCAN_CASE_BIT = SCAN_ONES * 0x20U;
+
+/// @brief Marks every byte of the given word that is equal to the given symbol, the marked bytes are set to 0x80 and all other bytes to 0x00.
+/// Unlike the common (word - 0x01..) & ~word & 0x80.. zero byte check, the result does not contain false positives, which allows counting the marks
+/// @param word Bytes that should be compared
+/// @param symbol Byte searched for, repeated into every byte of the word
+/// @return Word with the highest bit set in every byte that is equal to the symbol
+static Scan_Word markSymbol(Scan_Word word, Scan_Word symbol) {
+    Scan_Word const difference = word ^ symbol;
+    // Highest bit is set if any of the lower bits is set, or-ing the byte itself adds the highest bit, meaning only bytes equal to the symbol stay 0
+    Scan_Word const non_zero = ((difference & SCAN_LOW_BITS) + SCAN_LOW_BITS) | difference;
+    return ~(non_zero | SCAN_LOW_BITS);
+}
+
+/// @brief Counts the bytes marked by markSymbol()
+/// @param marked Word with the highest bit set in every marked byte
+/// @return Amount of marked bytes
+static size_t countMarked(Scan_Word marked) {
+    // Moves the mark into the lowest bit of each byte, the multiplication then sums all bytes into the highest byte, which can not overflow because a word has less than 256 bytes
+    return static_cast<size_t>(((marked >> 7U) * SCAN_ONES) >> ((sizeof(Scan_Word) - 1U) * 8U));
+}
+
+/// @brief Marks every byte of the given word that follows an odd amount of marked bytes in memory order, including the marked byte itself.
+/// Applied to the quotes of a word without escapes, this marks every byte inside of a string that starts in the word, including its opening quote
+/// @param marked Word with the highest bit set in every marked byte
+/// @return Word with every byte set to 0xFF that follows an odd amount of marked bytes and all other bytes set to 0x00
+static Scan_Word prefixParity(Scan_Word marked) {
+    Scan_Word parity = (marked >> 7U) * 0xFFU;
+    for (size_t shift = 8U; shift < sizeof(Scan_Word) * 8U; shift <<= 1U) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        parity ^= parity >> shift;
+#else
+        parity ^= parity << shift;
+#endif // defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    }
+    return parity;
+}
+
+/// @brief Position in the payload that is carried from one byte or word to the next
+struct Scan_State {
+    size_t count = {};      // Amount of ',', '{' and '[' symbols so far
+    size_t depth = {};      // Amount of objects or arrays currently open
+    bool in_string = {};    // Whether the last quote opened a string
+    bool escaped = {};      // Whether the last byte was a backslash inside of a string, meaning the next byte can not close the string
+};
+
+/// @brief Updates the nesting depth with the given symbol
+/// @param symbol Byte of the payload, outside of any string
+/// @param depth Amount of objects or arrays currently open
+/// @param max_nesting Maximum amount of objects or arrays that may be nested into each other
+/// @return Whether the depth is still within the limit
+static bool trackNesting(uint8_t symbol, size_t & depth, size_t max_nesting) {
+    if (symbol == '{' || symbol == '[') {
+        return ++depth <= max_nesting;
+    }
+    else if ((symbol == '}' || symbol == ']') && depth != 0U) {
+        --depth;
+    }
+    return true;
+}
+
+/// @brief Updates whether the given symbol is inside of a string and the nesting depth with symbols outside of strings
+/// @param symbol Byte of the payload
+/// @param state Position in the payload
+/// @param max_nesting Maximum amount of objects or arrays that may be nested into each other
+/// @return Whether the depth is still within the limit
+static bool trackSymbol(uint8_t symbol, Scan_State & state, size_t max_nesting) {
+    if (state.escaped) {
+        state.escaped = false;
+    }
+    else if (state.in_string) {
+        state.escaped = symbol == '\\';
+        state.in_string = symbol != '"';
+    }
+    else if (symbol == '"') {
+        state.in_string = true;
+    }
+    else {
+        return trackNesting(symbol, state.depth, max_nesting);
+    }
+    return true;
+}
+
+/// @brief Counts the given symbol if it is used to estimate the size of the JsonDocument and updates the position in the payload
+/// @param symbol Byte of the payload
+/// @param state Position in the payload
+/// @param max_nesting Maximum amount of objects or arrays that may be nested into each other
+/// @return Whether the depth is still within the limit
+static bool scanSymbol(uint8_t symbol, Scan_State & state, size_t max_nesting) {
+    if (symbol == ',' || symbol == '{' || symbol == '[') {
+        state.count++;
+    }
+    return trackSymbol(symbol, state, max_nesting);
+}
+
+bool Helper::countJsonElements(uint8_t const * bytes, unsigned int length, size_t max_nesting, size_t & element_count) {
+    Scan_State state = {};
+    size_t index = 0U;
+    if (bytes == nullptr) {
+        element_count = state.count;
+        return true;
+    }
+
+    // Bytes before the first aligned word are scanned one at a time, because unaligned word reads are slow or not even supported on some boards
+    for (; index < length && reinterpret_cast<uintptr_t>(bytes + index) % sizeof(Scan_Word) != 0U; ++index) {
+        if (!scanSymbol(bytes[index], state, max_nesting)) {
+            return false;
+        }
+    }
+
+    for (; index + sizeof(Scan_Word) <= length; index += sizeof(Scan_Word)) {
+        Scan_Word word = {};
+        memcpy(&word, bytes + index, sizeof(word));
+        Scan_Word const folded = word | SCAN_CASE_BIT;
+        Scan_Word const opening = markSymbol(folded, SCAN_ONES * '{');
+        Scan_Word const closing = markSymbol(folded, SCAN_ONES * '}');
+        // Symbols inside of strings are counted as well, which can only overestimate the size
+        state.count += countMarked(markSymbol(word, SCAN_ONES * ',')) + countMarked(opening);
+
+        // Escaped characters depend on the amount of backslashes in front of them, therefore only words without any are scanned at once
+        if (!state.escaped && markSymbol(word, SCAN_ONES * '\\') == 0U) {
+            Scan_Word inside = prefixParity(markSymbol(word, SCAN_ONES * '"'));
+            if (state.in_string) {
+                inside = ~inside;
+            }
+            size_t const opening_outside = countMarked(opening & ~inside);
+            size_t const closing_outside = countMarked(closing & ~inside);
+            if (closing_outside <= state.depth && state.depth + opening_outside <= max_nesting) {
+                // Even if every opening bracket came before every closing one the limit could not have been exceeded and no closing bracket can find the depth at 0,
+                // therefore the order of the brackets does not matter
+                state.depth = state.depth + opening_outside - closing_outside;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                state.in_string = (inside & 0xFFU) != 0U;
+#else
+                state.in_string = (inside >> ((sizeof(Scan_Word) - 1U) * 8U)) != 0U;
+#endif // defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+                continue;
+            }
+        }
+
+        // Whether the limit was exceeded inside of the word or which brackets are escaped depends on the order of the symbols
+        for (size_t offset = 0U; offset < sizeof(Scan_Word); ++offset) {
+            if (!trackSymbol(bytes[index + offset], state, max_nesting)) {
+                return false;
+            }
+        }
+    }
+
+    for (; index < length; ++index) {
+        if (!scanSymbol(bytes[index], state, max_nesting)) {
+            return false;
+        }
+    }
+    element_count = state.count;
+    return true;
+}
+
+void Helper::mergeJsonFilter(JsonVariant destination, JsonVariantConst source) {
+    if (destination == true) {
+        return;
+    }
+    else if (!source.is<JsonObjectConst>()) {
+        if (source == true) {
+            destination.set(true);
+        }
+        return;
+    }
+
+    JsonObject object = destination.is<JsonObject>() ? destination.as<JsonObject>() : destination.to<JsonObject>();
+    for (JsonPairConst const member : source.as<JsonObjectConst>()) {
+        char const * key = member.key().c_str();
+        if (!object.containsKey(key)) {
+            object[key] = nullptr;
+        }
+        mergeJsonFilter(object[key], member.value());
+    }
+}
+
+bool Helper::stringIsNullorEmpty(char const * str) {
+    return str == nullptr || str[0] == '\0';
+}
+
+size_t Helper::parseRequestId(char const * base_topic, char const * received_topic) {
+    return parseRequestId(received_topic, strlen(base_topic));
+}
+
+size_t Helper::parseRequestId(char const * received_topic, size_t const & base_topic_length) {
+    // Remove the not needed part of the received topic string, which is everything before the request id,
+    // therefore we ignore the section before that which is the base topic, that seperates the topic from the request id.
+    // Meaning the index we attempt to parse at, is simply the length of the base topic
+    size_t request_id = 0U;
+    for (char const * digit = received_topic + base_topic_length; *digit >= '0' && *digit <= '9'; digit++) {
+        request_id = request_id * 10U + static_cast<size_t>(*digit - '0');
+    }
+    return request_id;
+}
+
+size_t Helper::appendNumber(char * buffer, size_t number) {
+    size_t const digits = Decimal_Digits(number);
+    buffer[digits] = '\0';
+    // Digits are calculated from the least significant one, therefore the buffer is filled from the back
+    for (size_t i = digits; i > 0U; i--) {
+        buffer[i - 1U] = static_cast<char>('0' + number % 10U);
+        number /= 10U;
+    }
+    return digits;
+}
+
+size_t Helper::buildTopic(char * buffer, char const * base_topic, size_t const & base_topic_length, size_t const & number) {
+    (void)memcpy(buffer, base_topic, base_topic_length);
+    return base_topic_length + appendNumber(buffer + base_topic_length, number);
+}
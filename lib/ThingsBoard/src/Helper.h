@@ -14,6 +14,17 @@
 #include <stdio.h>
 
 
+/// @brief Calculates the amount of decimal digits the given number consists of, can be evaluated at compile time
+/// @param value Number to count the digits of
+/// @return Amount of digits, atleast 1
+constexpr size_t Decimal_Digits(size_t value) {
+    return value < 10U ? 1U : 1U + Decimal_Digits(value / 10U);
+}
+
+// Maximum amount of decimal digits a request id or any other size_t number can consist of, allows to size buffers for topics containing numbers at compile time
+size_t constexpr MAX_DECIMAL_DIGITS = Decimal_Digits(~static_cast<size_t>(0U));
+
+
 /// @brief Static helper class that includes some uniliterally used functionalities in multiple places, especially the ThingsBoardHttp and ThingsBoard implementations
 class Helper {
   public:
@@ -40,6 +51,24 @@ class Helper {
     /// @return Amount of occurences of the given symbol
     static size_t getOccurences(uint8_t const * bytes, char symbol, unsigned int length);
 
+    /// @brief Counts the symbols used to estimate the size of the JsonDocument required to deserialize the given json payload, meaning the amount of ',', '{' and '[' symbols combined,
+    /// and checks whether the payload is nested deeper than the given limit. Reads one word at a time instead of one byte at a time and only needs one pass over the payload,
+    /// instead of one pass per symbol like getOccurences(). Symbols inside of strings are counted as well, which can only overestimate the size,
+    /// but brackets inside of strings do not count as nesting, therefore every payload not nested deeper than the limit passes the check
+    /// @param bytes Byte payload that we want to count the symbols in
+    /// @param length Length of the byte payload. Ensure to never pass a length that is longer than the actualy payload, because this will cause this method to read outside of the bounds of the buffer
+    /// @param max_nesting Maximum amount of objects or arrays that may be nested into each other
+    /// @param element_count Amount of ',', '{' and '[' symbols combined, only set if the payload is not nested deeper than the limit
+    /// @return Whether the payload is not nested deeper than the given limit
+    static bool countJsonElements(uint8_t const * bytes, unsigned int length, size_t max_nesting, size_t & element_count);
+
+    /// @brief Merges the given json filter into the given destination filter, so that the destination allows every field atleast one of them allows.
+    /// A field allowed completely (true) by one of them stays allowed completely, keys are not copied and have to stay valid for as long as the destination is used.
+    /// See https://arduinojson.org/v6/api/json/deserializejson/#filtering for more information on the structure of the filter
+    /// @param destination Filter that is extended
+    /// @param source Filter that is merged into the destination
+    static void mergeJsonFilter(JsonVariant destination, JsonVariantConst source);
+
     /// @brief Returns wheter the given string is either a nullptr or is an empty string,
     /// meaning it only contains a null terminator and no other characters
     /// @param str String that we want to check for emptiness
@@ -54,6 +83,28 @@ class Helper {
     /// @return Converted integral request id if possible or 0 if parsing as an integer failed
     static size_t parseRequestId(char const * base_topic, char const * received_topic);
 
+    /// @brief Returns the portion of the received topic after the base topic as an integer, without having to measure the length of the base topic first.
+    /// Parses the digits directly instead of using atoi, meaning the complete range of size_t is supported
+    /// @param received_topic Received topic that contains the base topic as well as the request id parameter (v1/devices/me/rpc/response/$request_id)
+    /// @param base_topic_length Length of the base portion of the topic, meant to be evaluated at compile time with sizeof(base_topic) - 1
+    /// @return Converted integral request id or 0 if the topic does not continue with any digits after the base topic
+    static size_t parseRequestId(char const * received_topic, size_t const & base_topic_length);
+
+    /// @brief Writes the given number as decimal digits followed by a null terminator into the given buffer, without going through snprintf
+    /// @param buffer Buffer the number is written into, has to be able to hold atleast MAX_DECIMAL_DIGITS + 1 characters
+    /// @param number Number that should be written
+    /// @return Amount of written digits, not counting the null terminator
+    static size_t appendNumber(char * buffer, size_t number);
+
+    /// @brief Builds a topic consisting of the given constant base topic directly followed by the given number, replaces formatting "base_topic%u" with snprintf.
+    /// Because the length of the base topic is known at compile time, the required buffer size is known as well and the topic does not have to be formatted twice, once to measure and once to write it
+    /// @param buffer Buffer the null terminated topic is written into, has to be able to hold atleast base_topic_length + MAX_DECIMAL_DIGITS + 1 characters
+    /// @param base_topic Base portion of the topic that does not contain any parameters (v1/devices/me/rpc/response/)
+    /// @param base_topic_length Length of the base portion of the topic, meant to be evaluated at compile time with sizeof(base_topic) - 1
+    /// @param number Number that is appended to the base topic, normally the request id
+    /// @return Length of the built topic, not counting the null terminator
+    static size_t buildTopic(char * buffer, char const * base_topic, size_t const & base_topic_length, size_t const & number);
+
     /// @brief Calculates the total size of the string the serializeJson method would produce including the null end terminator.
     /// Be aware that null terminator will later not be serialied in the serializeJson() call,
     /// meaning the returned written amount of bytes is the return value of this method - 1.
@@ -6,6 +6,7 @@
 #include "Constants.h"
 #include "DefaultLogger.h"
 #include "API_Process_Type.h"
+#include "Json_Pull_Parser.h"
 
 // Library include.
 #if THINGSBOARD_ENABLE_STL
@@ -55,6 +56,15 @@ class IAPI_Implementation {
     /// @param data Payload sent by the server over our given topic, that contains our key value pairs
     virtual void Process_Json_Response(char const * topic, JsonDocument const & data) = 0;
 
+    /// @brief Process callback that will be called upon response arrival, if the api implementation uses API_Process_Type::JSON_EVENTS
+    /// and is responsible for reading the payload key by key and calling the appropriate previously subscribed callbacks.
+    /// Every api implementation receives its own parser, which starts at the beginning of the payload
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param parser Parser for the payload sent by the server over our given topic, Next() has not been called yet
+    virtual void Process_Json_Events(char const *, Json_Pull_Parser &) {
+        // Nothing to do
+    }
+
     /// @brief Compares received response topic and the topic this api implementation handles responses on,
     /// messages from all other topics are ignored and only messages from topics that match are handled.
     /// For the comparsion we either compare the full expected string with the null termination, if the response topic does not include additional parameters.
@@ -63,6 +73,25 @@ class IAPI_Implementation {
     /// @return Whether the received response topic matches the topic this api implementation handles responses on
     virtual bool Compare_Response_Topic(char const * topic) const = 0;
 
+    /// @brief Gets the part every response topic this api implementation handles starts with, allows to route received responses
+    /// to only the api implementations that could handle them, instead of calling Compare_Response_Topic() on every single one.
+    /// Compare_Response_Topic() is still called for every response starting with the returned prefix, meaning the prefix does not have to be exact
+    /// and can also be the static part before the parameters of a topic (v2/fw/response/ for v2/fw/response/1/chunk/0).
+    /// Has to stay the same and the returned string has to stay valid for as long as the api implementation is subscribed
+    /// @return Part every handled response topic starts with or nullptr, which routes every received response to this api implementation, default = nullptr
+    virtual char const * Get_Response_Topic_Prefix() const {
+        return nullptr;
+    }
+
+    /// @brief Gets the filter restricting the fields deserialized from received responses to the ones this api implementation actually uses,
+    /// which reduces the time needed to parse big payloads and the memory used by the deserialized fields.
+    /// Filters of multiple api implementations the same response is routed to are merged, if atleast one of them returns nullptr the complete payload is deserialized.
+    /// See https://arduinojson.org/v6/api/json/deserializejson/#filtering for more information on the structure of the filter
+    /// @return Filter that has to stay valid until the next subscription changes or nullptr if the complete payload is required, default = nullptr
+    virtual JsonDocument const * Get_Json_Filter() const {
+        return nullptr;
+    }
+
     /// @brief Unsubcribes all callbacks, to clear up any ongoing subscriptions and stop receiving information over the previously subscribed topic
     /// @return Whether unsubcribing all the previously subscribed callbacks
     /// and from the previously subscribed topic, was successful or not
@@ -73,12 +102,9 @@ class IAPI_Implementation {
     /// @return Whether resubscribing was successfull or not
     virtual bool Resubscribe_Topic() = 0;
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Internal loop method to update inernal timers for API calls that can timeout.
-    /// Only exists on boards that can not use the ESP Timer, because that one uses the FreeRTOS timer in the background instead
-    /// and therefore does not require calling a loop method
+    /// @brief Internal loop method to expire requests that share a single timeout list, for API calls that can timeout.
+    /// Timers embedded into the API as a Callback_Watchdog do not need to be updated, because they are handled by the global Timeout_Wheel instead
     virtual void loop() = 0;
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     /// @brief Method that allows to construct internal objects, after the required callback member methods have been set already.
     /// Required for API Implementations that subscribe further API calls, because immediately calling in the constructor can lead,
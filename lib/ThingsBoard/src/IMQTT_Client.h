@@ -90,13 +90,33 @@ class IMQTT_Client {
     /// should return false if an internal error occured or the connection has been lost
     virtual bool loop() = 0;
 
-    /// @brief Sends the given payload over the previously established connection with connect
+    /// @brief Sends the given payload over the previously established connection with connect.
+    /// Messages reserved with reserve_publish() are sent by commit_publish() without calling this method,
+    /// implementations that override publish() of another client to observe or change sent messages have to override commit_publish() as well
     /// @param topic Topic that the message is sent over, where different MQTT topics expect a different kind of payload
     /// @param payload Payload containg the json data that should be sent
     /// @param length Length of the payload in bytes
     /// @return Whether publishing the payload on the given topic was successful or not
     virtual bool publish(char const * topic, uint8_t const * payload, size_t const & length) = 0;
 
+    /// @brief Writes the header and topic of a message directly into the internal send buffer and returns where the payload has to be written to,
+    /// allows to serialize the payload in place instead of copying it into the send buffer with publish() afterwards.
+    /// The message is only sent once commit_publish() is called, a reserved message that is not committed is simply overwritten by the next message.
+    /// Optional, clients that do not support writing into their send buffer keep the default implementation and publish() is used instead
+    /// @param topic Topic that the message is sent over, where different MQTT topics expect a different kind of payload
+    /// @param length Maximum length of the payload in bytes
+    /// @return Start of the payload in the send buffer or nullptr if the message could not be reserved
+    virtual uint8_t * reserve_publish(char const *, size_t const &) {
+        return nullptr;
+    }
+
+    /// @brief Sends the message previously reserved with reserve_publish()
+    /// @param length Actual length of the payload written into the send buffer, has to be smaller or equal to the reserved length
+    /// @return Whether publishing the payload on the reserved topic was successful or not
+    virtual bool commit_publish(size_t const &) {
+        return false;
+    }
+
     /// @brief Subscribes to MQTT message on the given topic, which will cause an internal callback to be called for each message received on that topic from the server,
     /// it should then, call the previously configured callback with set_data_callback() with the received data
     /// @param topic Topic we want to receive a notification about if messages are sent by the server
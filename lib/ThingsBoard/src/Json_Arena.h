@@ -0,0 +1,172 @@
+#ifndef Json_Arena_h
+#define Json_Arena_h
+
+// Local include.
+#include "Constants.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/// @brief Persistent memory region that is reused by every JsonDocument constructed with a Json_Arena_Allocator pointing to it.
+/// The region is only ever grown, once it is big enough for the biggest document handled so far, constructing and destroying documents does not call malloc or free anymore,
+/// which prevents fragmenting the heap if many documents with different sizes are allocated one after the other, for example while receiving a burst of RPC requests.
+/// The arena contains one document at a time, the memory is reused as soon as the document has been destroyed,
+/// if a second document is constructed while the first one is still alive it is allocated on the heap instead, like a TBJsonDocument would be.
+/// The memory is kept until the arena itself is destroyed, the biggest size ever allocated can be read with High_Water_Mark() to decide on a fitting maximum response size.
+/// Allocate() and Deallocate() can also be called directly, to reuse the memory for serialized json instead of a JsonDocument
+class Json_Arena {
+  public:
+    /// @brief Constructs an empty arena, memory is only allocated once the first document is constructed
+    Json_Arena() = default;
+
+    /// @brief Frees the memory region of the arena, every document using it has to be destroyed beforehand
+    ~Json_Arena() {
+        Heap_Free(m_buffer);
+    }
+
+    // Documents keep a pointer to the arena, copying it would result in two arenas freeing the same memory region
+    Json_Arena(Json_Arena const &) = delete;
+    Json_Arena & operator=(Json_Arena const &) = delete;
+
+    /// @brief Hands out the memory region of the arena, grows it beforehand if it is smaller than the requested size
+    /// @param size Amount of bytes the document requires
+    /// @return Pointer to the memory region or nullptr if growing the arena failed
+    void * Allocate(size_t const & size) {
+        if (size > m_high_water_mark) {
+            m_high_water_mark = size;
+        }
+        if (m_in_use) {
+            return Heap_Allocate(size);
+        }
+        if (size > m_capacity) {
+            // The previous content is not needed anymore, freeing before allocating allows the heap to merge the old region into the new one
+            Heap_Free(m_buffer);
+            m_buffer = Heap_Allocate(size);
+            m_capacity = (m_buffer != nullptr) ? size : 0U;
+        }
+        if (m_buffer == nullptr) {
+            // Documents never deallocate a nullptr, therefore the arena may not be marked as used
+            return nullptr;
+        }
+        m_in_use = true;
+        return m_buffer;
+    }
+
+    /// @brief Returns the memory region to the arena, so that the next document can reuse it
+    /// @param pointer Pointer previously returned by Allocate() or Reallocate()
+    void Deallocate(void * pointer) {
+        if (pointer == nullptr) {
+            return;
+        }
+        else if (pointer != m_buffer) {
+            Heap_Free(pointer);
+            return;
+        }
+        m_in_use = false;
+    }
+
+    /// @brief Resizes the given memory region, only grows the arena and keeps its content if the new size is bigger than the current capacity
+    /// @param pointer Pointer previously returned by Allocate() or Reallocate()
+    /// @param size Amount of bytes the document requires
+    /// @return Pointer to the resized memory region or nullptr if growing failed
+    void * Reallocate(void * pointer, size_t const & size) {
+        if (size > m_high_water_mark) {
+            m_high_water_mark = size;
+        }
+        if (pointer != m_buffer || pointer == nullptr) {
+            return Heap_Reallocate(pointer, size);
+        }
+        else if (size <= m_capacity) {
+            return m_buffer;
+        }
+        void * buffer = Heap_Reallocate(m_buffer, size);
+        if (buffer == nullptr) {
+            return nullptr;
+        }
+        m_buffer = buffer;
+        m_capacity = size;
+        return m_buffer;
+    }
+
+    /// @brief Gets the current size of the memory region of the arena
+    /// @return Amount of bytes currently reserved by the arena
+    size_t Capacity() const {
+        return m_capacity;
+    }
+
+    /// @brief Gets the biggest size any document allocated with this arena has ever required, including documents that did not fit into the arena and were allocated on the heap
+    /// @return Biggest amount of bytes ever requested
+    size_t High_Water_Mark() const {
+        return m_high_water_mark;
+    }
+
+  private:
+    static void * Heap_Allocate(size_t const & size) {
+#if THINGSBOARD_ENABLE_PSRAM
+        return heap_caps_malloc(size, MALLOC_CAP_SPIRAM);
+#else
+        return malloc(size);
+#endif // THINGSBOARD_ENABLE_PSRAM
+    }
+
+    static void * Heap_Reallocate(void * pointer, size_t const & size) {
+#if THINGSBOARD_ENABLE_PSRAM
+        return heap_caps_realloc(pointer, size, MALLOC_CAP_SPIRAM);
+#else
+        return realloc(pointer, size);
+#endif // THINGSBOARD_ENABLE_PSRAM
+    }
+
+    static void Heap_Free(void * pointer) {
+#if THINGSBOARD_ENABLE_PSRAM
+        heap_caps_free(pointer);
+#else
+        free(pointer);
+#endif // THINGSBOARD_ENABLE_PSRAM
+    }
+
+    void   *m_buffer = {};          // Memory region reused by every document
+    size_t m_capacity = {};         // Size of the memory region
+    size_t m_high_water_mark = {};  // Biggest size ever requested
+    bool   m_in_use = {};           // Whether a document currently uses the memory region
+};
+
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+
+/// @brief ArduinoJson allocator that allocates the memory pool of a JsonDocument from the given Json_Arena, see https://arduinojson.org/v6/api/basicjsondocument/ for more information
+class Json_Arena_Allocator {
+  public:
+    /// @brief Constructs an allocator that uses the given arena
+    /// @param arena Arena the memory is allocated from, has to outlive every document using this allocator
+    Json_Arena_Allocator(Json_Arena & arena)
+      : m_arena(&arena)
+    {
+        // Nothing to do
+    }
+
+    void * allocate(size_t size) {
+        return m_arena->Allocate(size);
+    }
+
+    void deallocate(void * pointer) {
+        m_arena->Deallocate(pointer);
+    }
+
+    void * reallocate(void * pointer, size_t new_size) {
+        return m_arena->Reallocate(pointer, new_size);
+    }
+
+  private:
+    Json_Arena *m_arena = {}; // Arena the memory is allocated from
+};
+
+using TBArenaJsonDocument = BasicJsonDocument<Json_Arena_Allocator>;
+
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+#endif // Json_Arena_h
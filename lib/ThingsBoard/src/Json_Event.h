@@ -0,0 +1,24 @@
+#ifndef Json_Event_h
+#define Json_Event_h
+
+// Library include.
+#include <stdint.h>
+
+
+/// @brief Possible events a Json_Pull_Parser emits while walking over a json payload, in the order they appear in the payload.
+/// Every event references the part of the payload it was read from, meaning nothing is copied or allocated while parsing
+enum class Json_Event : uint8_t {
+    OBJECT_BEGIN, ///< Opening brace of an object, followed by alternating KEY and value events until the matching OBJECT_END
+    OBJECT_END, ///< Closing brace of the object opened by the matching OBJECT_BEGIN
+    ARRAY_BEGIN, ///< Opening bracket of an array, followed by value events until the matching ARRAY_END
+    ARRAY_END, ///< Closing bracket of the array opened by the matching ARRAY_BEGIN
+    KEY, ///< Key of a key-value pair inside of an object, the following event is its value
+    STRING, ///< String value
+    NUMBER, ///< Integer or floating point value
+    BOOLEAN, ///< true or false
+    NULL_VALUE, ///< null
+    END, ///< Complete payload was read successfully, every further call returns the same event
+    ERROR ///< Payload is not valid json or nested deeper than allowed, every further call returns the same event
+};
+
+#endif // Json_Event_h
@@ -0,0 +1,124 @@
+#ifndef Json_Key_h
+#define Json_Key_h
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Decimal places of a key without precision policy, floating point values are written with ArduinoJson's default formatting
+uint8_t constexpr DEFAULT_DECIMALS = UINT8_MAX;
+// Maximum decimal places of a precision policy, keeps the scale factor in 32 bits
+uint8_t constexpr MAX_DECIMALS = 9U;
+
+
+/// @brief Compile-time list of indices, used to initialize every character of the fragment array in a constexpr constructor
+/// @tparam Indices Indices of the characters
+template <size_t... Indices>
+struct Index_Sequence {};
+
+/// @brief Builds the Index_Sequence from 0 to Size - 1
+/// @tparam Size Amount of indices
+/// @tparam Indices Already built indices
+template <size_t Size, size_t... Indices>
+struct Make_Index_Sequence : Make_Index_Sequence<Size - 1U, Size - 1U, Indices...> {};
+
+template <size_t... Indices>
+struct Make_Index_Sequence<0U, Indices...> {
+    using type = Index_Sequence<Indices...>;
+};
+
+
+/// @brief Json object key, that is quoted and escaped at compile time into the complete "key": fragment.
+/// Allows to write the key with one single copy instead of escaping and copying it character by character on every serialization.
+/// Escapes the same characters ArduinoJson does (quote, backslash, \b, \f, \n, \r and \t), therefore the resulting json is identical.
+/// Additionally the key can contain a precision policy, which defines to how many decimal places floating point values are rounded when written with the key.
+/// Create instances with Make_Json_Key(), for example constexpr auto TEMPERATURE_KEY = Make_Json_Key("temperature", 2U);
+/// @tparam KeySize Size of the string literal the key is created from, including the null terminator
+template <size_t KeySize>
+class Json_Key {
+  public:
+    /// @brief Builds the fragment from the given string literal
+    /// @param key String literal containing the unescaped key
+    /// @param decimals Decimal places floating point values are rounded to, DEFAULT_DECIMALS keeps ArduinoJson's formatting
+    constexpr Json_Key(char const (&key)[KeySize], uint8_t decimals = DEFAULT_DECIMALS)
+      : Json_Key(key, decimals, typename Make_Index_Sequence<FRAGMENT_SIZE>::type{})
+    {
+        // Nothing to do
+    }
+
+    /// @brief Quoted and escaped key followed by a colon, is null terminated
+    /// @return Pointer to the first character of the fragment
+    constexpr char const * Fragment() const {
+        return m_fragment;
+    }
+
+    /// @brief Length of the fragment without the null terminator
+    /// @return Amount of characters in the fragment
+    constexpr size_t Length() const {
+        return m_length;
+    }
+
+    /// @brief Decimal places floating point values written with this key are rounded to
+    /// @return Decimal places or DEFAULT_DECIMALS if there is no precision policy
+    constexpr uint8_t Decimals() const {
+        return m_decimals;
+    }
+
+  private:
+    // Every character could need escaping, plus the two quotes, the colon and the null terminator
+    static constexpr size_t FRAGMENT_SIZE = 2U * (KeySize - 1U) + 4U;
+
+    template <size_t... Indices>
+    constexpr Json_Key(char const (&key)[KeySize], uint8_t decimals, Index_Sequence<Indices...>)
+      : m_fragment{ Fragment_Char(key, Escaped_Length(key, KeySize - 1U), Indices)... }
+      , m_length(Escaped_Length(key, KeySize - 1U) + 3U)
+      , m_decimals(decimals > MAX_DECIMALS ? DEFAULT_DECIMALS : decimals)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Character following the backslash if the given character needs escaping
+    /// @return Escape character or 0 if the character is written as is
+    static constexpr char Escape_Char(char c) {
+        return c == '"' ? '"' : c == '\\' ? '\\' : c == '\b' ? 'b' : c == '\f' ? 'f' : c == '\n' ? 'n' : c == '\r' ? 'r' : c == '\t' ? 't' : '\0';
+    }
+
+    /// @brief Length of the given string once escaped
+    static constexpr size_t Escaped_Length(char const * key, size_t length) {
+        return length == 0U ? 0U : (Escape_Char(*key) != '\0' ? 2U : 1U) + Escaped_Length(key + 1U, length - 1U);
+    }
+
+    /// @brief Character at the given index of the escaped string
+    static constexpr char Escaped_Char(char const * key, size_t length, size_t index) {
+        return length == 0U ? '\0'
+            : Escape_Char(*key) != '\0'
+                ? (index == 0U ? '\\' : index == 1U ? Escape_Char(*key) : Escaped_Char(key + 1U, length - 1U, index - 2U))
+                : (index == 0U ? *key : Escaped_Char(key + 1U, length - 1U, index - 1U));
+    }
+
+    /// @brief Character at the given index of the complete "key": fragment
+    static constexpr char Fragment_Char(char const (&key)[KeySize], size_t escaped_length, size_t index) {
+        return index == 0U ? '"'
+            : index <= escaped_length ? Escaped_Char(key, KeySize - 1U, index - 1U)
+            : index == escaped_length + 1U ? '"'
+            : index == escaped_length + 2U ? ':'
+            : '\0';
+    }
+
+    char    m_fragment[FRAGMENT_SIZE]; // Quoted and escaped key followed by a colon
+    size_t  m_length;                  // Length of the fragment without the null terminator
+    uint8_t m_decimals;                // Decimal places floating point values are rounded to
+};
+
+/// @brief Creates a Json_Key from the given string literal, deduces the size of the literal
+/// @tparam KeySize Size of the string literal, including the null terminator
+/// @param key String literal containing the unescaped key
+/// @param decimals Decimal places floating point values are rounded to, DEFAULT_DECIMALS keeps ArduinoJson's formatting
+/// @return Key containing the quoted and escaped fragment
+template <size_t KeySize>
+constexpr Json_Key<KeySize> Make_Json_Key(char const (&key)[KeySize], uint8_t decimals = DEFAULT_DECIMALS) {
+    return Json_Key<KeySize>(key, decimals);
+}
+
+#endif // Json_Key_h
@@ -0,0 +1,480 @@
+#ifndef Json_Pull_Parser_h
+#define Json_Pull_Parser_h
+
+// Local includes.
+#include "Configuration.h"
+#include "Json_Event.h"
+
+// Library includes.
+#include <ArduinoJson.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+// Maximum amount of objects or arrays the parser can track nested into each other, one bit of the container stack is used per level.
+size_t constexpr JSON_PULL_PARSER_MAX_NESTING = 32U;
+// Maximum amount of characters of a number that can be converted to a floating point value, the same limit deserializeJson() uses.
+size_t constexpr JSON_PULL_PARSER_MAX_NUMBER_LENGTH = 63U;
+
+
+/// @brief Event driven json parser, which walks over the payload once and emits an event for every key and value, instead of deserializing it into a JsonDocument.
+/// Keys, strings and numbers are only referenced in the payload and decoded on request, therefore the parser uses the same small constant amount of memory regardless of the size of the payload
+/// and never allocates. The payload is not modified, meaning multiple parsers can walk over the same payload one after the other.
+/// Like deserializeJson() the parser stops after the first complete value and ignores anything following it, see https://arduinojson.org/v6/api/json/deserializejson/ for more information
+class Json_Pull_Parser {
+  public:
+    /// @brief Constructs a parser without payload, the first call to Next() returns Json_Event::ERROR
+    Json_Pull_Parser() = default;
+
+    /// @brief Constructs a parser for the given payload, nothing is read until Next() is called
+    /// @param payload Json payload, does not have to be null terminated and has to stay valid for as long as the parser or any value read from it is used
+    /// @param length Amount of bytes the payload consists of
+    /// @param max_nesting Maximum amount of objects or arrays that may be nested into each other, at most JSON_PULL_PARSER_MAX_NESTING, default = ARDUINOJSON_DEFAULT_NESTING_LIMIT
+    Json_Pull_Parser(uint8_t const * payload, size_t const & length, size_t const & max_nesting = ARDUINOJSON_DEFAULT_NESTING_LIMIT)
+      : m_position(payload)
+      , m_end(payload + length)
+      , m_max_nesting(max_nesting < JSON_PULL_PARSER_MAX_NESTING ? max_nesting : JSON_PULL_PARSER_MAX_NESTING)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Reads the next key or value from the payload
+    /// @return Event describing what was read, the token it was read from can be accessed until Next() is called again
+    Json_Event Next() {
+        if (m_event == Json_Event::END || m_event == Json_Event::ERROR) {
+            return m_event;
+        }
+        Skip_Whitespace();
+        switch (m_state) {
+            case Parse_State::VALUE:
+                return Read_Value();
+            case Parse_State::FIRST_KEY:
+                if (Peek() == '}') {
+                    return Close(Json_Event::OBJECT_END);
+                }
+                return Read_Key();
+            case Parse_State::COLON:
+                if (Peek() != ':') {
+                    return Fail();
+                }
+                m_position++;
+                Skip_Whitespace();
+                return Read_Value();
+            case Parse_State::FIRST_VALUE:
+                if (Peek() == ']') {
+                    return Close(Json_Event::ARRAY_END);
+                }
+                return Read_Value();
+            case Parse_State::SEPARATOR:
+                return Read_Separator();
+        }
+        return Fail();
+    }
+
+    /// @brief Skips the current value, if it is an object or array every event until the matching end event is skipped as well.
+    /// If the current event is a key, its value is skipped. Has no effect on any other event
+    /// @return Whether the value was skipped successfully or the payload is invalid
+    bool Skip() {
+        if (m_event == Json_Event::KEY) {
+            (void)Next();
+        }
+        if (m_event == Json_Event::OBJECT_BEGIN || m_event == Json_Event::ARRAY_BEGIN) {
+            size_t const depth = m_depth - 1U;
+            do {
+                (void)Next();
+            } while (m_event != Json_Event::ERROR && !(m_depth == depth && (m_event == Json_Event::OBJECT_END || m_event == Json_Event::ARRAY_END)));
+        }
+        return m_event != Json_Event::ERROR;
+    }
+
+    /// @brief Moves this parser past the current value and returns a parser for only that value, which allows to pass parts of the payload to other methods.
+    /// If the current event is a key, its value is used. Has to be called on a key or on the event that begins a value
+    /// @return Parser for the current value or a parser without payload if the value is invalid
+    Json_Pull_Parser Take_Value() {
+        if (m_event == Json_Event::KEY) {
+            (void)Next();
+        }
+        uint8_t const * begin = m_token;
+        size_t const enclosing = (m_event == Json_Event::OBJECT_BEGIN || m_event == Json_Event::ARRAY_BEGIN) ? m_depth - 1U : m_depth;
+        if (!Skip()) {
+            return Json_Pull_Parser();
+        }
+        return Json_Pull_Parser(begin, (m_token + m_token_length) - begin, m_max_nesting - enclosing);
+    }
+
+    /// @brief Gets the event returned by the last call to Next()
+    /// @return Current event
+    Json_Event Get_Event() const {
+        return m_event;
+    }
+
+    /// @brief Gets the amount of objects and arrays the current event is nested in, the begin and end event of an object or array are counted as inside of it
+    /// @return Current nesting depth
+    size_t Get_Depth() const {
+        return m_depth;
+    }
+
+    /// @brief Gets the part of the payload the current event was read from, keys and strings include their quotes and are not unescaped
+    /// @return Pointer to the first byte of the current token
+    uint8_t const * Get_Token() const {
+        return m_token;
+    }
+
+    /// @brief Gets the amount of bytes the part of the payload the current event was read from consists of
+    /// @return Length of the current token
+    size_t Get_Token_Length() const {
+        return m_token_length;
+    }
+
+    /// @brief Gets the amount of characters the current key or string consists of once unescaped, without null termination
+    /// @return Length of the unescaped string or 0 if the current event is neither a key nor a string
+    size_t Get_String_Length() const {
+        size_t length = 0U;
+        (void)Decode_String([&length](char const *, size_t const & count) {
+            length += count;
+            return true;
+        });
+        return length;
+    }
+
+    /// @brief Copies the unescaped current key or string into the given buffer and null terminates it
+    /// @param buffer Buffer the string is copied into
+    /// @param size Size of the buffer, has to be atleast Get_String_Length() + 1
+    /// @return Whether the current event is a key or string and it was copied completely
+    bool Get_String(char * buffer, size_t const & size) const {
+        if (size == 0U || (m_event != Json_Event::KEY && m_event != Json_Event::STRING)) {
+            return false;
+        }
+        size_t length = 0U;
+        bool const copied = Decode_String([&](char const * characters, size_t const & count) {
+            if (length + count >= size) {
+                return false;
+            }
+            memcpy(buffer + length, characters, count);
+            length += count;
+            return true;
+        });
+        buffer[length] = '\0';
+        return copied;
+    }
+
+    /// @brief Compares the unescaped current key or string with the given string, without copying it
+    /// @param value Null terminated string to compare with
+    /// @return Whether the current event is a key or string equal to the given string
+    bool String_Equals(char const * value) const {
+        if (value == nullptr || (m_event != Json_Event::KEY && m_event != Json_Event::STRING)) {
+            return false;
+        }
+        bool const equal = Decode_String([&value](char const * characters, size_t const & count) {
+            if (strncmp(value, characters, count) != 0) {
+                return false;
+            }
+            value += count;
+            return true;
+        });
+        return equal && *value == '\0';
+    }
+
+    /// @brief Passes the unescaped current key or string to the given consumer in parts, without copying it into a buffer first.
+    /// Allows to hash or compare received strings of any length in place, unescaped sequences are passed as one part and escaped characters encoded as UTF-8
+    /// @tparam Consumer Callable receiving a pointer to the characters and their amount, returns whether reading should continue
+    /// @param consumer Receives the parts of the string in order
+    /// @return Whether the current event is a key or string and it was passed to the consumer completely
+    template <typename Consumer>
+    bool Read_String(Consumer consumer) const {
+        return Decode_String(consumer);
+    }
+
+    /// @brief Gets the current boolean value
+    /// @return Whether the current event is the boolean true
+    bool Get_Bool() const {
+        return m_event == Json_Event::BOOLEAN && *m_token == 't';
+    }
+
+    /// @brief Gets the current number as an integer, numbers with fraction or exponent are truncated
+    /// @return Current number or 0 if the current event is not a number
+    JsonInteger Get_Integer() const {
+        if (m_event != Json_Event::NUMBER) {
+            return 0;
+        }
+        uint8_t const * position = m_token;
+        uint8_t const * end = m_token + m_token_length;
+        bool const negative = *position == '-';
+        if (negative) {
+            position++;
+        }
+        JsonUInt value = 0U;
+        for (; position != end; position++) {
+            if (*position < '0' || *position > '9') {
+                return static_cast<JsonInteger>(Get_Float());
+            }
+            value = value * 10U + (*position - '0');
+        }
+        return negative ? -static_cast<JsonInteger>(value) : static_cast<JsonInteger>(value);
+    }
+
+    /// @brief Gets the current number as a floating point value
+    /// @return Current number or 0 if the current event is not a number or longer than JSON_PULL_PARSER_MAX_NUMBER_LENGTH
+    JsonFloat Get_Float() const {
+        if (m_event != Json_Event::NUMBER || m_token_length > JSON_PULL_PARSER_MAX_NUMBER_LENGTH) {
+            return 0;
+        }
+        // The payload is not null terminated, therefore the token is copied into a buffer of fixed size before converting it
+        char number[JSON_PULL_PARSER_MAX_NUMBER_LENGTH + 1U] = {};
+        memcpy(number, m_token, m_token_length);
+        return static_cast<JsonFloat>(strtod(number, nullptr));
+    }
+
+  private:
+    /// @brief What has to follow next in the payload
+    enum class Parse_State : uint8_t {
+        VALUE,       ///< Any value, at the start of the payload or after a comma inside of an array
+        FIRST_KEY,   ///< Key or the end of the object, after the opening brace
+        COLON,       ///< Colon followed by a value, after a key
+        FIRST_VALUE, ///< Value or the end of the array, after the opening bracket
+        SEPARATOR    ///< Comma or the end of the enclosing object or array, after a value
+    };
+
+    uint8_t Peek() const {
+        return m_position != m_end ? *m_position : '\0';
+    }
+
+    void Skip_Whitespace() {
+        while (m_position != m_end && (*m_position == ' ' || *m_position == '\t' || *m_position == '\n' || *m_position == '\r')) {
+            m_position++;
+        }
+    }
+
+    Json_Event Emit(Json_Event const & event, Parse_State const & state) {
+        m_state = state;
+        m_event = event;
+        return m_event;
+    }
+
+    Json_Event Fail() {
+        m_event = Json_Event::ERROR;
+        return m_event;
+    }
+
+    Json_Event Close(Json_Event const & event) {
+        m_token = m_position++;
+        m_token_length = 1U;
+        m_depth--;
+        return Emit(event, Parse_State::SEPARATOR);
+    }
+
+    Json_Event Read_Separator() {
+        // The first complete value ends the payload, like with deserializeJson() anything following it is ignored
+        if (m_depth == 0U) {
+            return Emit(Json_Event::END, Parse_State::SEPARATOR);
+        }
+        bool const object = (m_containers >> (m_depth - 1U)) & 1U;
+        if (Peek() == ',') {
+            m_position++;
+            Skip_Whitespace();
+            return object ? Read_Key() : Read_Value();
+        }
+        else if (Peek() == (object ? '}' : ']')) {
+            return Close(object ? Json_Event::OBJECT_END : Json_Event::ARRAY_END);
+        }
+        return Fail();
+    }
+
+    Json_Event Read_Key() {
+        if (Peek() != '"' || !Read_String()) {
+            return Fail();
+        }
+        return Emit(Json_Event::KEY, Parse_State::COLON);
+    }
+
+    Json_Event Read_Value() {
+        m_token = m_position;
+        switch (Peek()) {
+            case '{':
+            case '[': {
+                if (m_depth >= m_max_nesting) {
+                    return Fail();
+                }
+                bool const object = *m_position == '{';
+                m_containers = object ? (m_containers | (1U << m_depth)) : (m_containers & ~(1U << m_depth));
+                m_depth++;
+                m_position++;
+                m_token_length = 1U;
+                return object ? Emit(Json_Event::OBJECT_BEGIN, Parse_State::FIRST_KEY) : Emit(Json_Event::ARRAY_BEGIN, Parse_State::FIRST_VALUE);
+            }
+            case '"':
+                return Read_String() ? Emit(Json_Event::STRING, Parse_State::SEPARATOR) : Fail();
+            case 't':
+                return Read_Literal("true", Json_Event::BOOLEAN);
+            case 'f':
+                return Read_Literal("false", Json_Event::BOOLEAN);
+            case 'n':
+                return Read_Literal("null", Json_Event::NULL_VALUE);
+            default:
+                return Read_Number();
+        }
+    }
+
+    bool Read_String() {
+        m_token = m_position++;
+        while (m_position < m_end) {
+            uint8_t const character = *m_position;
+            if (character == '"') {
+                m_position++;
+                m_token_length = m_position - m_token;
+                return true;
+            }
+            else if (character < 0x20U) {
+                return false;
+            }
+            // Escaped character is skipped, so that an escaped quote does not end the string
+            m_position += (character == '\\') ? 2U : 1U;
+        }
+        return false;
+    }
+
+    Json_Event Read_Literal(char const * literal, Json_Event const & event) {
+        size_t const length = strlen(literal);
+        if (static_cast<size_t>(m_end - m_position) < length || memcmp(m_position, literal, length) != 0) {
+            return Fail();
+        }
+        m_position += length;
+        m_token_length = length;
+        return Emit(event, Parse_State::SEPARATOR);
+    }
+
+    Json_Event Read_Number() {
+        if (Peek() == '-') {
+            m_position++;
+        }
+        if (Peek() < '0' || Peek() > '9') {
+            return Fail();
+        }
+        // Integers are the common case, fraction and exponent are only checked for once the digits end
+        while (m_position != m_end && static_cast<uint8_t>(*m_position - '0') <= 9U) {
+            m_position++;
+        }
+        while (m_position != m_end && (static_cast<uint8_t>(*m_position - '0') <= 9U || *m_position == '.' || *m_position == 'e' || *m_position == 'E' || *m_position == '+' || *m_position == '-')) {
+            m_position++;
+        }
+        m_token_length = m_position - m_token;
+        return Emit(Json_Event::NUMBER, Parse_State::SEPARATOR);
+    }
+
+    static uint32_t Read_Hex(uint8_t const * position) {
+        uint32_t value = 0U;
+        for (size_t i = 0U; i < 4U; i++) {
+            uint8_t const character = position[i];
+            uint32_t digit = 0U;
+            if (character >= '0' && character <= '9') {
+                digit = character - '0';
+            }
+            else if ((character | 0x20U) >= 'a' && (character | 0x20U) <= 'f') {
+                digit = (character | 0x20U) - 'a' + 10U;
+            }
+            else {
+                return ~0U;
+            }
+            value = (value << 4U) | digit;
+        }
+        return value;
+    }
+
+    /// @brief Unescapes the current key or string and passes it to the given consumer in parts, unescaped sequences are passed as one part and escaped characters encoded as UTF-8
+    /// @param consumer Receives a pointer to the characters and their amount, returns whether decoding should continue
+    /// @return Whether the complete string was passed to the consumer
+    template <typename Consumer>
+    bool Decode_String(Consumer consumer) const {
+        if (m_event != Json_Event::KEY && m_event != Json_Event::STRING) {
+            return false;
+        }
+        // Read_String() already ensured the token starts and ends with a quote and no escape sequence is cut off by the closing quote
+        uint8_t const * position = m_token + 1U;
+        uint8_t const * end = m_token + m_token_length - 1U;
+        while (position != end) {
+            uint8_t const * unescaped = position;
+            while (position != end && *position != '\\') {
+                position++;
+            }
+            if (position != unescaped && !consumer(reinterpret_cast<char const *>(unescaped), static_cast<size_t>(position - unescaped))) {
+                return false;
+            }
+            if (position == end) {
+                break;
+            }
+
+            char character[4U] = {};
+            size_t count = 1U;
+            switch (position[1U]) {
+                case 'b': character[0U] = '\b'; break;
+                case 'f': character[0U] = '\f'; break;
+                case 'n': character[0U] = '\n'; break;
+                case 'r': character[0U] = '\r'; break;
+                case 't': character[0U] = '\t'; break;
+                case 'u': {
+                    if (end - position < 6) {
+                        return false;
+                    }
+                    uint32_t code_point = Read_Hex(position + 2U);
+                    // High surrogate has to be followed by an escaped low surrogate, together they encode one code point above U+FFFF
+                    if (code_point >= 0xD800U && code_point <= 0xDBFFU && end - position >= 12 && position[6U] == '\\' && position[7U] == 'u') {
+                        uint32_t const low = Read_Hex(position + 8U);
+                        if (low >= 0xDC00U && low <= 0xDFFFU) {
+                            code_point = 0x10000U + ((code_point - 0xD800U) << 10U) + (low - 0xDC00U);
+                            position += 6U;
+                        }
+                    }
+                    if (code_point == ~0U) {
+                        return false;
+                    }
+                    else if (code_point < 0x80U) {
+                        character[0U] = static_cast<char>(code_point);
+                    }
+                    else if (code_point < 0x800U) {
+                        character[0U] = static_cast<char>(0xC0U | (code_point >> 6U));
+                        character[1U] = static_cast<char>(0x80U | (code_point & 0x3FU));
+                        count = 2U;
+                    }
+                    else if (code_point < 0x10000U) {
+                        character[0U] = static_cast<char>(0xE0U | (code_point >> 12U));
+                        character[1U] = static_cast<char>(0x80U | ((code_point >> 6U) & 0x3FU));
+                        character[2U] = static_cast<char>(0x80U | (code_point & 0x3FU));
+                        count = 3U;
+                    }
+                    else {
+                        character[0U] = static_cast<char>(0xF0U | (code_point >> 18U));
+                        character[1U] = static_cast<char>(0x80U | ((code_point >> 12U) & 0x3FU));
+                        character[2U] = static_cast<char>(0x80U | ((code_point >> 6U) & 0x3FU));
+                        character[3U] = static_cast<char>(0x80U | (code_point & 0x3FU));
+                        count = 4U;
+                    }
+                    position += 4U;
+                    break;
+                }
+                default:
+                    // Quote, backslash and slash are simply escaped by the backslash
+                    character[0U] = static_cast<char>(position[1U]);
+                    break;
+            }
+            position += 2U;
+            if (!consumer(character, count)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    uint8_t const *m_position = {};                   // Next byte that has not been read yet
+    uint8_t const *m_end = {};                        // One past the last byte of the payload
+    uint8_t const *m_token = {};                      // First byte of the token the current event was read from
+    size_t        m_token_length = {};                // Amount of bytes of the token the current event was read from
+    size_t        m_max_nesting = {};                 // Maximum amount of objects or arrays nested into each other
+    size_t        m_depth = {};                       // Amount of objects or arrays the parser is currently inside of
+    uint32_t      m_containers = {};                  // One bit per nesting level, set if the container at that level is an object and cleared if it is an array
+    Parse_State   m_state = Parse_State::VALUE;       // What has to follow next in the payload
+    Json_Event    m_event = Json_Event::NULL_VALUE;   // Event returned by the last call to Next(), placeholder that is neither END nor ERROR until Next() is called
+};
+
+#endif // Json_Pull_Parser_h
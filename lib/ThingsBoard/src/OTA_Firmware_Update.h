@@ -8,13 +8,18 @@
 #include "IAPI_Implementation.h"
 
 
-uint8_t constexpr MAX_FW_TOPIC_SIZE = 33U;
 uint8_t constexpr OTA_ATTRIBUTE_KEYS_AMOUNT = 5U;
 char constexpr NO_FW_REQUEST_RESPONSE[] = "Did not receive requested shared attribute firmware keys. Ensure keys exist and device is connected";
 // Firmware topics.
-char constexpr FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/%u/chunk/";
+char constexpr FIRMWARE_RESPONSE_BASE_TOPIC[] = "v2/fw/response/";
+size_t constexpr FIRMWARE_RESPONSE_BASE_TOPIC_LENGTH = sizeof(FIRMWARE_RESPONSE_BASE_TOPIC) - 1U;
 char constexpr FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC[] = "v2/fw/response/+";
-char constexpr FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/%u/chunk/%u";
+char constexpr FIRMWARE_REQUEST_BASE_TOPIC[] = "v2/fw/request/";
+size_t constexpr FIRMWARE_REQUEST_BASE_TOPIC_LENGTH = sizeof(FIRMWARE_REQUEST_BASE_TOPIC) - 1U;
+char constexpr FIRMWARE_CHUNK_TOPIC[] = "/chunk/";
+size_t constexpr FIRMWARE_CHUNK_TOPIC_LENGTH = sizeof(FIRMWARE_CHUNK_TOPIC) - 1U;
+// Firmware response topic consists of v2/fw/response/$request_id/chunk/ and the request topic additionally of the chunk index at the end
+size_t constexpr MAX_FW_TOPIC_SIZE = FIRMWARE_REQUEST_BASE_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + FIRMWARE_CHUNK_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U;
 // Firmware data keys.
 char constexpr CURR_FW_TITLE_KEY[] = "current_fw_title";
 char constexpr CURR_FW_VER_KEY[] = "current_fw_version";
@@ -30,7 +35,6 @@ char constexpr CHECKSUM_AGORITM_SHA256[] = "SHA256";
 char constexpr CHECKSUM_AGORITM_SHA384[] = "SHA384";
 char constexpr CHECKSUM_AGORITM_SHA512[] = "SHA512";
 // Log messages.
-char constexpr NUMBER_PRINTF[] = "%u";
 char constexpr NO_FW[] = "Missing shared attribute firmware keys. Ensure you assigned an OTA update with binary";
 char constexpr EMPTY_FW[] = "Received shared attribute firmware keys were NULL";
 char constexpr FW_NOT_FOR_US[] = "Received firmware title (%s) is different and not meant for this device (%s)";
@@ -71,13 +75,14 @@ class OTA_Firmware_Update : public IAPI_Implementation {
       , m_ota(OTA_Firmware_Update::staticPublishChunk, OTA_Firmware_Update::staticFirmwareSend, OTA_Firmware_Update::staticUnsubscribe)
 #endif // THINGSBOARD_ENABLE_STL
       , m_response_topic()
+      , m_response_topic_length()
       , m_fw_attribute_update()
       , m_fw_attribute_request()
     {
         // Can be ignored, because the topic is set correctly once we start an update anyway, therefore we simply insert 0 as the request id for now.
         // It just has to be set to an actual value that is not an empty string, because that would make the internal callback receive all other responses from the server as well,
         // even if they are not meant for this class and we are not currently updating the device
-        (void)snprintf(m_response_topic, sizeof(m_response_topic), FIRMWARE_RESPONSE_TOPIC, 0U);
+        m_response_topic_length = Build_Chunk_Topic(m_response_topic, FIRMWARE_RESPONSE_BASE_TOPIC, FIRMWARE_RESPONSE_BASE_TOPIC_LENGTH, 0U);
 #if !THINGSBOARD_ENABLE_STL
         m_subscribedInstance = nullptr;
 #endif // !THINGSBOARD_ENABLE_STL
@@ -182,10 +187,8 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     }
 
     void Process_Response(char const * topic, uint8_t * payload, unsigned int length) override {
-        size_t const & request_id = m_fw_callback.Get_Request_ID();
-        char response_topic[Helper::detectSize(FIRMWARE_RESPONSE_TOPIC, request_id)] = {};
-        (void)snprintf(response_topic, sizeof(response_topic), FIRMWARE_RESPONSE_TOPIC, request_id);
-        size_t const chunk = Helper::parseRequestId(response_topic, topic);
+        // Topic was already compared to the response topic, therefore the chunk index directly follows its known length
+        size_t const chunk = Helper::parseRequestId(topic, m_response_topic_length);
         m_ota.Process_Firmware_Packet(chunk, payload, length);
     }
 
@@ -194,7 +197,11 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     }
 
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(m_response_topic, topic, strlen(m_response_topic)) == 0;
+        return strncmp(m_response_topic, topic, m_response_topic_length) == 0;
+    }
+
+    char const * Get_Response_Topic_Prefix() const override {
+        return FIRMWARE_RESPONSE_BASE_TOPIC;
     }
 
     bool Unsubscribe() override {
@@ -206,11 +213,9 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         return Firmware_OTA_Subscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        m_ota.update();
+        // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         m_subscribe_api_callback.Call_Callback(m_fw_attribute_update);
@@ -254,7 +259,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
 
         m_fw_callback = callback;
         m_fw_callback.Set_Request_ID(++request_id);
-        (void)snprintf(m_response_topic, sizeof(m_response_topic), FIRMWARE_RESPONSE_TOPIC, request_id);
+        m_response_topic_length = Build_Chunk_Topic(m_response_topic, FIRMWARE_RESPONSE_BASE_TOPIC, FIRMWARE_RESPONSE_BASE_TOPIC_LENGTH, request_id);
         return true;
     }
 
@@ -297,14 +302,27 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         uint16_t const & chunk_size = m_fw_callback.Get_Chunk_Size();
 
         // Convert the interger size into a readable string
-        char size[Helper::detectSize(NUMBER_PRINTF, chunk_size)] = {};
-        (void)snprintf(size, sizeof(size), NUMBER_PRINTF, chunk_size);
+        char size[MAX_DECIMAL_DIGITS + 1U] = {};
+        (void)Helper::appendNumber(size, chunk_size);
 
-        char topic[Helper::detectSize(FIRMWARE_REQUEST_TOPIC, request_id, request_chunck)] = {};
-        (void)snprintf(topic, sizeof(topic), FIRMWARE_REQUEST_TOPIC, request_id, request_chunck);
+        char topic[MAX_FW_TOPIC_SIZE] = {};
+        size_t const length = Build_Chunk_Topic(topic, FIRMWARE_REQUEST_BASE_TOPIC, FIRMWARE_REQUEST_BASE_TOPIC_LENGTH, request_id);
+        (void)Helper::appendNumber(topic + length, request_chunck);
         return m_send_json_string_callback.Call_Callback(topic, size);
     }
 
+    /// @brief Builds the part of the firmware topic both requests and responses share, which is the given base topic followed by the request id and the chunk part of the topic (v2/fw/response/$request_id/chunk/)
+    /// @param buffer Buffer the null terminated topic is written into, has to be able to hold atleast MAX_FW_TOPIC_SIZE characters
+    /// @param base_topic Base portion of the topic that does not contain any parameters (v2/fw/response/ or v2/fw/request/)
+    /// @param base_topic_length Length of the base portion of the topic
+    /// @param request_id Request ID corresponding to the extact OTA update package
+    /// @return Length of the built topic, not counting the null terminator
+    static size_t Build_Chunk_Topic(char * buffer, char const * base_topic, size_t const & base_topic_length, size_t const & request_id) {
+        size_t const length = Helper::buildTopic(buffer, base_topic, base_topic_length, request_id);
+        (void)memcpy(buffer + length, FIRMWARE_CHUNK_TOPIC, sizeof(FIRMWARE_CHUNK_TOPIC));
+        return length + FIRMWARE_CHUNK_TOPIC_LENGTH;
+    }
+
     /// @brief Handler if the firmware shared attribute request times out without getting a response.
     /// Is used to signal that the update could not be started, because the current firmware information could not be fetched
     void Request_Timeout() {
@@ -467,6 +485,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     bool                                                                     m_changed_buffer_size = {};               // Whether the buffer size had to be changed, because the previous internal buffer size was to small to hold the firmware chunks
     OTA_Handler<Logger>                                                      m_ota = {};                               // Class instance that handles the flashing and creating a hash from the given received binary firmware data
     char                                                                     m_response_topic[MAX_FW_TOPIC_SIZE] = {}; // Firmware response topic that contains the specific request ID of the firmware we actually want to download
+    size_t                                                                   m_response_topic_length = {};             // Length of the firmware response topic, the index of the received chunk directly follows it
 #if !THINGSBOARD_ENABLE_DYNAMIC
     Shared_Attribute_Update<1U, OTA_ATTRIBUTE_KEYS_AMOUNT, Logger>           m_fw_attribute_update = {};               // API implementation to be informed if needed fw attributes have been updated
     Attribute_Request<1U, OTA_ATTRIBUTE_KEYS_AMOUNT, Logger>                 m_fw_attribute_request = {};              // API implementation to request the needed fw attributes to start updating
@@ -3,6 +3,7 @@
 
 // Local include.
 #include "Configuration.h"
+#include "Constants.h"
 
 // Local include.
 #include "Callback_Watchdog.h"
@@ -12,6 +13,7 @@
 #include "Helper.h"
 
 // Library includes.
+#include <stdlib.h>
 #include <string.h>
 
 
@@ -33,6 +35,7 @@ char constexpr ERROR_UPDATE_END[] = "Error during flash updater not all bytes wr
 char constexpr CHECKSUM_VERIFICATION_FAILED[] = "Calculated checksum (%s), not the same as expected checksum (%s)";
 char constexpr FW_UPDATE_ABORTED[] = "Firmware update aborted";
 char constexpr CHUNK_REQUEST_TIMED_OUT[] = "Failed to receive requested chunk (%u) in (%llu) us. Internet connection might have been lost";
+char constexpr UNABLE_TO_ALLOCATE_CHUNK_WINDOW[] = "Allocating memory to buffer (%u) chunks failed, falling back to requesting one chunk at a time";
 #if THINGSBOARD_ENABLE_DEBUG
 char constexpr FW_CHUNK[] = "Receive chunk (%u), with size (%u) bytes";
 char constexpr HASH_EXPECTED[] = "Expected checksum: (%s)";
@@ -41,10 +44,14 @@ char constexpr FW_UPDATE_SUCCESS[] = "Update success";
 #endif // THINGSBOARD_ENABLE_DEBUG
 // Maximum size consists of size required for byte representation of the hash * 2 because every byte is 2 hex characters + 1 for null termination
 size_t constexpr FIRMWARE_HASH_SIZE = (MBEDTLS_MD_MAX_SIZE * 2U) + 1;
+// Maximum amount of chunks that can be requested at once, bigger windows configured in the OTA_Update_Callback are limited to this value
+uint8_t constexpr OTA_MAX_CHUNK_WINDOW = 16U;
 
 
 /// @brief Handles the complete processing of received binary firmware data, including flashing it onto the device,
-/// creating a hash of the received data and in the end ensuring that the complete OTA firmware was flashes successfully and that the hash is the one we initally received
+/// creating a hash of the received data and in the end ensuring that the complete OTA firmware was flashes successfully and that the hash is the one we initally received.
+/// Up to the configured chunk window of chunks are requested at once, each with its own timeout, so that only the chunks that actually timed out are requested again.
+/// Chunks that arrive before the chunks in front of them are copied into a reorder buffer, which ensures the flash memory and the hash are still written in order
 /// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set
 template <typename Logger>
 class OTA_Handler {
@@ -64,12 +71,27 @@ class OTA_Handler {
       , m_hash()
       , m_total_chunks(0U)
       , m_requested_chunks(0U)
+      , m_next_chunk(0U)
       , m_retries(0U)
+      , m_window(0U)
+      , m_slots()
+      , m_reorder_buffer(nullptr)
+      , m_free_buffers()
+      , m_free_buffer_count(0U)
       , m_watchdog(std::bind(&OTA_Handler::Handle_Request_Timeout, this))
     {
         // Nothing to do
     }
 
+    /// @brief Destructor
+    ~OTA_Handler() {
+        Free_Reorder_Buffer();
+    }
+
+    // The reorder buffer is owned by the instance, copying it would result in two instances freeing the same memory region
+    OTA_Handler(OTA_Handler const &) = delete;
+    OTA_Handler & operator=(OTA_Handler const &) = delete;
+
     /// @brief Starts the firmware update with requesting the first firmware packet and initalizes the underlying needed components
     /// @param fw_callback Callback method that contains configuration information, about the over the air update
     /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
@@ -98,31 +120,95 @@ class OTA_Handler {
     }
 
     /// @brief Uses the given firmware packet data and process it. Starting with writing the given amount of bytes of the packet data into flash memory and
-    /// into a hash function that will be used to compare the expected complete binary file and the actually received binary file
+    /// into a hash function that will be used to compare the expected complete binary file and the actually received binary file.
+    /// If chunks in front of the given chunk are still missing, the packet data is instead copied into the reorder buffer and only written once all previous chunks have been written
     /// @param current_chunk Index of the chunk we recieved the binary data for
     /// @param payload Firmware packet data of the current chunk
     /// @param total_bytes Amount of bytes in the current firmware packet data
     void Process_Firmware_Packet(size_t const & current_chunk, uint8_t * payload, size_t const & total_bytes)  {
-        if (current_chunk != m_requested_chunks) {
+        // Chunks that have not been requested or have already been received are discarded,
+        // can happen if a chunk was requested again because it timed out and the first response still arrives afterwards
+        if (current_chunk < m_requested_chunks || current_chunk >= m_next_chunk || Get_Slot(current_chunk).received) {
             Logger::printfln(RECEIVED_UNEXPECTED_CHUNK, current_chunk, m_requested_chunks);
             return;
         }
         size_t expected_chunk_size = 0U;
-        if (!Received_Valid_Chunk_Size(total_bytes, expected_chunk_size)) {
+        if (!Received_Valid_Chunk_Size(current_chunk, total_bytes, expected_chunk_size)) {
             Logger::printfln(RECEIVED_UNEXPECTED_CHUNK_SIZE, expected_chunk_size, total_bytes);
             return;
         }
 
-        m_watchdog.detach();
     #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(FW_CHUNK, current_chunk, total_bytes);
     #endif // THINGSBOARD_ENABLE_DEBUG
 
-        if (current_chunk == 0U) {
+        Chunk_Slot & slot = Get_Slot(current_chunk);
+        slot.received = true;
+        if (current_chunk != m_requested_chunks) {
+            // There are always less chunks received ahead of the next chunk we write than buffers, because the window contains the next chunk as well
+            slot.buffer = m_free_buffers[--m_free_buffer_count];
+            slot.size = total_bytes;
+            (void)memcpy(Get_Buffer(slot.buffer), payload, total_bytes);
+            Arm_Watchdog();
+            return;
+        }
+
+        if (!Write_Firmware_Packet(payload, total_bytes)) {
+            return;
+        }
+
+        // Write every chunk that was received ahead of time and is now next in order
+        while (m_requested_chunks < m_next_chunk && Get_Slot(m_requested_chunks).received) {
+            Chunk_Slot & buffered_slot = Get_Slot(m_requested_chunks);
+            m_free_buffers[m_free_buffer_count++] = buffered_slot.buffer;
+            if (!Write_Firmware_Packet(Get_Buffer(buffered_slot.buffer), buffered_slot.size)) {
+                return;
+            }
+        }
+
+        // Reset retries as the current chunk has been downloaded and handled successfully
+        m_retries = m_fw_callback->Get_Chunk_Retries();
+        Request_Next_Firmware_Packet();
+    }
+
+  private:
+    /// @brief Chunk of the window that has been requested, but not yet written
+    struct Chunk_Slot {
+        Timeout_Wheel::Time start = {};    // Time the chunk was last requested at
+        size_t              size = {};     // Amount of bytes of the chunk that were copied into the reorder buffer
+        uint8_t             buffer = {};   // Index of the buffer in the reorder buffer the chunk was copied into
+        bool                received = {}; // Whether the chunk has been received ahead of time and is waiting in the reorder buffer
+    };
+
+    /// @brief Checks whether the received chunk size matches the expected chunk size, should be the configured chunk size of the OTA_Update_Callback, CHUNK_SIZE (4096) per default
+    /// and it should be the remaining bytes to fill the total firmware size with the last received chunk. If that is not the case then something went wrong with the request and we have to rerequest that specific chunk,
+    /// because if we do not do that we would write missing or only partial binary data to flash and into the hash, meaning the complete OTA update will be invalidated at the end and has to be restarted
+    /// @param current_chunk Index of the chunk we recieved the binary data for
+    /// @param received_chunk_size Size in bytes of the received chunk
+    /// @param expected_chunk_size Variable the expected chunk size for the received chunk will be copied into
+    /// @return Whether the received chunk has the expected size or not
+    bool Received_Valid_Chunk_Size(size_t const & current_chunk, size_t const & received_chunk_size, size_t & expected_chunk_size) {
+        bool const is_last_chunk = current_chunk + 1 >= m_total_chunks;
+        if (is_last_chunk) {
+            size_t const last_chunk_expected_size = m_fw_size % m_fw_callback->Get_Chunk_Size();
+            expected_chunk_size = last_chunk_expected_size;
+            return received_chunk_size == last_chunk_expected_size;
+        }
+        expected_chunk_size = m_fw_callback->Get_Chunk_Size();
+        return received_chunk_size == m_fw_callback->Get_Chunk_Size();
+    }
+
+    /// @brief Writes the given firmware packet data of the next chunk in order into flash memory and the hash and informs the user about the progress
+    /// @param payload Firmware packet data of the next chunk in order
+    /// @param total_bytes Amount of bytes in the firmware packet data
+    /// @return Whether the chunk was written successfully and the update should continue, if not the failure has already been handled
+    bool Write_Firmware_Packet(uint8_t * payload, size_t const & total_bytes) {
+        if (m_requested_chunks == 0U) {
             // Initialize Flash
             if (!m_fw_updater->begin(m_fw_size)) {
                 Logger::printfln(ERROR_UPDATE_BEGIN);
-                return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_BEGIN);
+                Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_BEGIN);
+                return false;
             }
         }
 
@@ -132,58 +218,38 @@ class OTA_Handler {
             char message[Helper::detectSize(ERROR_UPDATE_WRITE, written_bytes, total_bytes)] = {};
             (void)snprintf(message, sizeof(message), ERROR_UPDATE_WRITE, written_bytes, total_bytes);
             Logger::printfln(message);
-            return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+            Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+            return false;
         }
 
         // Update value only if writing to flash was a success, result is ignored,
         // because it can only fail if the input parameters are invalid
         (void)m_hash.update(payload, total_bytes);
 
-        m_requested_chunks = current_chunk + 1;
+        m_requested_chunks++;
         m_fw_callback->Call_Progress_Callback(m_requested_chunks, m_total_chunks);
 
         // Ensure to check if the update was cancelled during the progress callback,
         // if it was the callback variable was reset and there is no need to request the next firmware packet
         if (m_fw_callback == nullptr) {
             Logger::printfln(OTA_CB_IS_NULL);
-            return Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, OTA_CB_IS_NULL);
-        }
-
-        // Reset retries as the current chunk has been downloaded and handled successfully
-        m_retries = m_fw_callback->Get_Chunk_Retries();
-        Request_Next_Firmware_Packet();
-    }
-
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Used to update the watchdog timer which uses a simple software time in the background. Ensure to call recently often for higher precision.
-    /// Meaning the timer is actually triggered closer to the specified waiting time
-    void update() {
-        m_watchdog.update();
-    }
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-  private:
-    /// @brief Checks whether the received chunk size matches the expected chunk size, should be the configured chunk size of the OTA_Update_Callback, CHUNK_SIZE (4096) per default
-    /// and it should be the remaining bytes to fill the total firmware size with the last received chunk. If that is not the case then something went wrong with the request and we have to rerequest that specific chunk,
-    /// because if we do not do that we would write missing or only partial binary data to flash and into the hash, meaning the complete OTA update will be invalidated at the end and has to be restarted
-    /// @param received_chunk_size Size in bytes of the received chunk
-    /// @param expected_chunk_size Variable the expected chunk size for the currently requested chunk will be copied into
-    /// @return Whether the received chunk has the expected size or not
-    bool Received_Valid_Chunk_Size(size_t const & received_chunk_size, size_t & expected_chunk_size) {
-        bool const is_last_chunk = m_requested_chunks + 1 >= m_total_chunks;
-        if (is_last_chunk) {
-            size_t const last_chunk_expected_size = m_fw_size % m_fw_callback->Get_Chunk_Size();
-            expected_chunk_size = last_chunk_expected_size;
-            return received_chunk_size == last_chunk_expected_size;
+            Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, OTA_CB_IS_NULL);
+            return false;
         }
-        expected_chunk_size = m_fw_callback->Get_Chunk_Size();
-        return received_chunk_size == m_fw_callback->Get_Chunk_Size();
+        return true;
     }
 
-    /// @brief Restarts or starts the firmware update and its needed components and then requests the first firmware chunk
+    /// @brief Restarts or starts the firmware update and its needed components and then requests the first firmware chunks
     void Request_First_Firmware_Packet()  {
         m_requested_chunks = 0U;
+        m_next_chunk = 0U;
         m_retries = m_fw_callback->Get_Chunk_Retries();
+        Allocate_Reorder_Buffer();
+        // Every buffer is free again, because chunks that were received ahead of time are discarded and requested again
+        m_free_buffer_count = 0U;
+        for (uint8_t buffer = 0U; buffer + 1U < m_window; buffer++) {
+            m_free_buffers[m_free_buffer_count++] = buffer;
+        }
         // Hash start result is ignored, because it can only fail if the input parameters are invalid
         (void)m_hash.start(m_fw_checksum_algorithm);
         m_watchdog.detach();
@@ -191,30 +257,144 @@ class OTA_Handler {
         Request_Next_Firmware_Packet();
     }
 
-    /// @brief Requests the next firmware chunk of the OTA firmware if there are any left
-    /// and starts the timer that ensures we request the same chunk again if we have not received a response yet
+    /// @brief Requests the next firmware chunks of the OTA firmware until the window is full, if there are any left
+    /// and starts the timer that ensures we request the same chunks again if we have not received a response yet
     void Request_Next_Firmware_Packet()  {
         // Check if we have already requested and handled the last remaining chunk
         if (m_requested_chunks >= m_total_chunks) {
-            Finish_Firmware_Update();   
+            m_watchdog.detach();
+            Finish_Firmware_Update();
             return;
         }
 
-        if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), m_requested_chunks)) {
-            Logger::printfln(UNABLE_TO_REQUEST_CHUNCKS);
+        while (m_next_chunk < m_total_chunks && m_next_chunk - m_requested_chunks < m_window) {
+            Chunk_Slot & slot = Get_Slot(m_next_chunk);
+            slot.received = false;
+            Request_Firmware_Packet(m_next_chunk, slot);
+            m_next_chunk++;
         }
 
         // Watchdog gets started no matter if publishing request was successful or not in hopes,
         // that after the given timeout the callback calls this method again and can then publish the request successfully.
         // This works because the request fails most of the time, because the internet connection might have been temporarily disconnected.
         // Therefore waiting a while and then retrying, means we might be reconnected again
-        m_watchdog.once(m_fw_callback->Get_Timeout());
+        Arm_Watchdog();
+    }
+
+    /// @brief Requests all firmware chunks in the window again, that have not been received in the given timeout time yet,
+    /// chunks that have been received already or whose timeout has not passed yet are not requested again
+    void Request_Timed_Out_Firmware_Packets() {
+        Timeout_Wheel::Time const now = Timeout_Wheel::Now();
+        for (size_t chunk = m_requested_chunks; chunk < m_next_chunk; chunk++) {
+            Chunk_Slot & slot = Get_Slot(chunk);
+            if (!slot.received && Get_Remaining(slot, now) == 0U) {
+                Request_Firmware_Packet(chunk, slot);
+            }
+        }
+        Arm_Watchdog();
+    }
+
+    /// @brief Publishes the request for the given firmware chunk and starts its timeout
+    /// @param chunk Index of the chunk that should be requested
+    /// @param slot Slot of the window the chunk is part of
+    void Request_Firmware_Packet(size_t const & chunk, Chunk_Slot & slot) {
+        if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), chunk)) {
+            Logger::printfln(UNABLE_TO_REQUEST_CHUNCKS);
+        }
+        slot.start = Timeout_Wheel::Now();
+    }
+
+    /// @brief Starts the watchdog with the remaining time of the chunk in the window that times out first, the watchdog is shared by all chunks in the window,
+    /// because they all use the same timeout and at most OTA_MAX_CHUNK_WINDOW chunks have to be compared
+    void Arm_Watchdog() {
+        Timeout_Wheel::Time const now = Timeout_Wheel::Now();
+        uint64_t remaining = m_fw_callback->Get_Timeout();
+        for (size_t chunk = m_requested_chunks; chunk < m_next_chunk; chunk++) {
+            Chunk_Slot const & slot = Get_Slot(chunk);
+            if (slot.received) {
+                continue;
+            }
+            uint64_t const chunk_remaining = Get_Remaining(slot, now);
+            if (chunk_remaining < remaining) {
+                remaining = chunk_remaining;
+            }
+        }
+        m_watchdog.once(remaining);
+    }
+
+    /// @brief Gets the amount of microseconds until the request of the given chunk times out
+    /// @param slot Slot of the window the requested chunk is part of
+    /// @param now Current time
+    /// @return Remaining microseconds or 0 if the request has already timed out
+    uint64_t Get_Remaining(Chunk_Slot const & slot, Timeout_Wheel::Time const & now) const {
+        uint64_t const & timeout = m_fw_callback->Get_Timeout();
+        uint64_t const elapsed = static_cast<Timeout_Wheel::Time>(now - slot.start);
+        return elapsed >= timeout ? 0U : timeout - elapsed;
+    }
+
+    /// @brief Gets the slot of the window the given chunk is part of, chunks in the window never share the same slot
+    /// @param chunk Index of the chunk that is part of the window
+    /// @return Slot of the window
+    Chunk_Slot & Get_Slot(size_t const & chunk) {
+        return m_slots[chunk % m_window];
+    }
+
+    /// @brief Gets the memory region of the given buffer of the reorder buffer
+    /// @param buffer Index of the buffer
+    /// @return Pointer to the first byte of the buffer, which can hold exactly one chunk
+    uint8_t * Get_Buffer(uint8_t const & buffer) {
+        return m_reorder_buffer + (static_cast<size_t>(buffer) * m_fw_callback->Get_Chunk_Size());
+    }
+
+    /// @brief Allocates the reorder buffer for the configured chunk window, which requires one chunk size less than the window,
+    /// because the next chunk in order is always written directly. Falls back to a window of one chunk, if there is not enough heap memory
+    void Allocate_Reorder_Buffer() {
+        Free_Reorder_Buffer();
+        m_window = m_fw_callback->Get_Chunk_Window();
+        if (m_window > OTA_MAX_CHUNK_WINDOW) {
+            m_window = OTA_MAX_CHUNK_WINDOW;
+        }
+        else if (m_window == 0U) {
+            m_window = 1U;
+        }
+        if (m_window == 1U) {
+            return;
+        }
+        size_t const size = static_cast<size_t>(m_window - 1U) * m_fw_callback->Get_Chunk_Size();
+#if THINGSBOARD_ENABLE_PSRAM
+        m_reorder_buffer = static_cast<uint8_t *>(heap_caps_malloc(size, MALLOC_CAP_SPIRAM));
+#else
+        m_reorder_buffer = static_cast<uint8_t *>(malloc(size));
+#endif // THINGSBOARD_ENABLE_PSRAM
+        if (m_reorder_buffer == nullptr) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_CHUNK_WINDOW, m_window);
+            m_window = 1U;
+        }
+    }
+
+    /// @brief Stops waiting on any requested chunk and frees the reorder buffer, is called as soon as the update has finished,
+    /// because it is only needed while chunks are still being downloaded. Responses to chunks that were still requested are discarded afterwards
+    void Discard_Window() {
+        m_watchdog.detach();
+        m_next_chunk = m_requested_chunks;
+        Free_Reorder_Buffer();
+    }
+
+    /// @brief Frees the reorder buffer
+    void Free_Reorder_Buffer() {
+#if THINGSBOARD_ENABLE_PSRAM
+        heap_caps_free(m_reorder_buffer);
+#else
+        free(m_reorder_buffer);
+#endif // THINGSBOARD_ENABLE_PSRAM
+        m_reorder_buffer = nullptr;
     }
 
     /// @brief Completes the firmware update, which consists of checking the complete hash of the firmware binary if the initally received value,
     /// both should be the same and if that is not the case that means that we received invalid firmware binary data and have to restart the update.
     /// If checking the hash was successfull we attempt to finish flashing the ota partition and then inform the user that the update was successfull
     void Finish_Firmware_Update()  {
+        Discard_Window();
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADED, "");
 
         char calculated_checksum[FIRMWARE_HASH_SIZE] = {};
@@ -253,6 +433,7 @@ class OTA_Handler {
     /// @param error_message Error message that should be printed if we abort the update
     void Handle_Failure(OTA_Failure_Response const & failure_response, char const * error_message)  {
         if (m_retries <= 0) {
+            Discard_Window();
             (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
             m_fw_callback->Call_Callback(false);
             (void)m_finish_callback.Call_Callback();
@@ -265,12 +446,13 @@ class OTA_Handler {
 
         switch (failure_response) {
             case OTA_Failure_Response::RETRY_CHUNK:
-                Request_Next_Firmware_Packet();
+                Request_Timed_Out_Firmware_Packets();
                 break;
             case OTA_Failure_Response::RETRY_UPDATE:
                 Request_First_Firmware_Packet();
                 break;
             case OTA_Failure_Response::RETRY_NOTHING:
+                Discard_Window();
                 (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
                 m_fw_callback->Call_Callback(false);
                 (void)m_finish_callback.Call_Callback();
@@ -284,25 +466,41 @@ class OTA_Handler {
     /// @brief Callback that will be called if we did not receive the firmware chunk response in the given timeout time
     void Handle_Request_Timeout()  {
         uint64_t const & timeout = m_fw_callback->Get_Timeout();
-        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout)] = {};
-        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout);
+        Timeout_Wheel::Time const now = Timeout_Wheel::Now();
+        // Report the first chunk that timed out, the next chunk in order is always still missing and the fallback if the others have not timed out
+        size_t timed_out_chunk = m_requested_chunks;
+        for (size_t chunk = m_requested_chunks; chunk < m_next_chunk; chunk++) {
+            Chunk_Slot const & slot = Get_Slot(chunk);
+            if (!slot.received && Get_Remaining(slot, now) == 0U) {
+                timed_out_chunk = chunk;
+                break;
+            }
+        }
+        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, timed_out_chunk, timeout)] = {};
+        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, timed_out_chunk, timeout);
         Logger::printfln(message);
         Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
     }
 
-    const OTA_Update_Callback                              *m_fw_callback = {};                    // Callback method that contains configuration information, about the over the air update
-    Callback<bool, size_t const &, size_t const &>         m_publish_callback = {};                // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
-    Callback<bool, char const * const, char const * const> m_send_fw_state_callback = {};          // Callback that is used to send information about the current state of the over the air update
-    Callback<bool>                                         m_finish_callback = {};                 // Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
-    size_t                                                 m_fw_size = {};                         // Total size of the firmware binary we will receive. Allows for a binary size of up to theoretically 4 GB
-    char                                                   m_fw_checksum[FIRMWARE_HASH_SIZE] = {}; // Checksum of the complete firmware binary, should be the same as the actually written data in the end
-    mbedtls_md_type_t                                      m_fw_checksum_algorithm = {};           // Algorithm type used to hash the firmware binary
-    IUpdater                                               *m_fw_updater = {};                     // Interface implementation that writes received firmware binary data onto the given device
-    HashGenerator                                          m_hash = {};                            // Class instance that allows to generate a hash from received firmware binary data
-    size_t                                                 m_total_chunks = {};                    // Total amount of chunks that need to be received to get the complete firmware binary
-    size_t                                                 m_requested_chunks = {};                // Amount of successfully requested and received firmware binary chunks
-    uint8_t                                                m_retries = {};                         // Amount of request retries we attempt for each chunk, increasing makes the connection more stable
-    Callback_Watchdog                                      m_watchdog = {};                        // Class instances that allows to timeout if we do not receive a response for a requested chunk in the given time
+    const OTA_Update_Callback                              *m_fw_callback = {};                       // Callback method that contains configuration information, about the over the air update
+    Callback<bool, size_t const &, size_t const &>         m_publish_callback = {};                   // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
+    Callback<bool, char const * const, char const * const> m_send_fw_state_callback = {};             // Callback that is used to send information about the current state of the over the air update
+    Callback<bool>                                         m_finish_callback = {};                    // Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
+    size_t                                                 m_fw_size = {};                            // Total size of the firmware binary we will receive. Allows for a binary size of up to theoretically 4 GB
+    char                                                   m_fw_checksum[FIRMWARE_HASH_SIZE] = {};    // Checksum of the complete firmware binary, should be the same as the actually written data in the end
+    mbedtls_md_type_t                                      m_fw_checksum_algorithm = {};              // Algorithm type used to hash the firmware binary
+    IUpdater                                               *m_fw_updater = {};                        // Interface implementation that writes received firmware binary data onto the given device
+    HashGenerator                                          m_hash = {};                               // Class instance that allows to generate a hash from received firmware binary data
+    size_t                                                 m_total_chunks = {};                       // Total amount of chunks that need to be received to get the complete firmware binary
+    size_t                                                 m_requested_chunks = {};                   // Amount of successfully requested and received firmware binary chunks
+    size_t                                                 m_next_chunk = {};                         // Index of the next chunk that has not been requested yet, chunks between it and m_requested_chunks are in the window
+    uint8_t                                                m_retries = {};                            // Amount of request retries we attempt for each chunk, increasing makes the connection more stable
+    uint8_t                                                m_window = {};                             // Amount of chunks that are requested at once, limited to OTA_MAX_CHUNK_WINDOW
+    Chunk_Slot                                             m_slots[OTA_MAX_CHUNK_WINDOW] = {};        // Chunks in the window, the slot of each chunk is its index modulo the window
+    uint8_t                                                *m_reorder_buffer = {};                    // Memory region holding one chunk less than the window, for chunks that were received ahead of time
+    uint8_t                                                m_free_buffers[OTA_MAX_CHUNK_WINDOW] = {}; // Indices of the buffers in the reorder buffer that are currently not used by any chunk
+    uint8_t                                                m_free_buffer_count = {};                  // Amount of buffers that are currently not used by any chunk
+    Callback_Watchdog                                      m_watchdog = {};                           // Class instances that allows to timeout if we do not receive a response for a requested chunk in the given time
 };
 
 #endif // OTA_Handler_h
@@ -12,6 +12,7 @@
 uint8_t constexpr CHUNK_RETRIES = 12U;
 uint16_t constexpr CHUNK_SIZE = (4U * 1024U);
 uint64_t constexpr REQUEST_TIMEOUT = (5U * 1000U * 1000U);
+uint8_t constexpr CHUNK_WINDOW = 1U;
 
 
 /// @brief Over the air firmware update callback wrapper,
@@ -45,7 +46,10 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     // because the whole chunk is saved into the heap before it can be processed and is then erased again after it has been used, default = CHUNK_SIZE
     /// @param timeout Maximum amount of time in microseconds for the OTA firmware update for each seperate chunk,
     /// until that chunk counts as a timeout, retries is then subtraced by one and the download is retried, default = REQUEST_TIMEOUT
-    OTA_Update_Callback(char const * current_fw_title, char const * current_fw_version, IUpdater * updater, function finished_callback, Callback<void, size_t const &, size_t const &>::function progress_callback = nullptr, Callback<void>::function update_starting_callback = nullptr, uint8_t chunk_retries = CHUNK_RETRIES, uint16_t chunk_size = CHUNK_SIZE, uint64_t const & timeout_microseconds = REQUEST_TIMEOUT);
+    /// @param chunk_window Amount of chunks that are requested at once, without waiting for the response of the previous chunk. Increasing it shortens the download time,
+    /// because the time the server needs to respond has to be waited only once for each window instead of once for each chunk, but every chunk besides the first one in the window requires an additional chunk size of heap memory,
+    /// because chunks that arrive before the chunks in front of them are buffered until they can be written in order. Limited to OTA_MAX_CHUNK_WINDOW, default = CHUNK_WINDOW
+    OTA_Update_Callback(char const * current_fw_title, char const * current_fw_version, IUpdater * updater, function finished_callback, Callback<void, size_t const &, size_t const &>::function progress_callback = nullptr, Callback<void>::function update_starting_callback = nullptr, uint8_t chunk_retries = CHUNK_RETRIES, uint16_t chunk_size = CHUNK_SIZE, uint64_t const & timeout_microseconds = REQUEST_TIMEOUT, uint8_t chunk_window = CHUNK_WINDOW);
 
     /// @brief Gets the current firmware title, used to decide if an OTA firmware update is already installed and therefore should not be downladed,
     /// this is only done if the title of the update and the current firmware title are the same because if they are not then this firmware is meant for another device type
@@ -143,6 +147,15 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     /// @param timeout_microseconds Timeout time until we expect a response from the server
     void Set_Timeout(uint64_t const & timeout_microseconds);
 
+    /// @brief Gets the amount of chunks that are requested at once, without waiting for the response of the previous chunk
+    /// @return Amount of chunks that are requested at once
+    uint8_t Get_Chunk_Window() const;
+
+    /// @brief Sets the amount of chunks that are requested at once, without waiting for the response of the previous chunk,
+    /// every chunk besides the first one in the window requires an additional chunk size of heap memory while the update is ongoing
+    /// @param chunk_window Amount of chunks that are requested at once
+    void Set_Chunk_Window(uint8_t chunk_window);
+
   private:
     char const                                     *m_current_fw_title = {};        // Current firmware title of device
     char const                                     *m_current_fw_version = {};      // Current firmware version of device
@@ -153,6 +166,7 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     uint8_t                                        m_chunk_retries = {};            // Maximum amount of retries for a single chunk to be downloaded and flashed successfully
     uint16_t                                       m_chunk_size = {};               // Size of chunks the firmware data will be split into
     uint64_t                                       m_timeout_microseconds = {};     // How long we wait for each chunck to arrive before declaring it as failed
+    uint8_t                                        m_chunk_window = {};             // Amount of chunks requested at once without waiting for the previous response
 };
 
 #endif // OTA_Update_Callback_h
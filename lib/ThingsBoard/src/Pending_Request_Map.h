@@ -0,0 +1,308 @@
+#ifndef Pending_Request_Map_h
+#define Pending_Request_Map_h
+
+// Local includes.
+#include "Callback.h"
+#include "Timeout_Wheel.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+
+
+// Amount of lower bits of a request id that contain the index of the slot, the bits above contain its generation
+size_t constexpr PENDING_REQUEST_INDEX_BITS = 16U;
+// Amount of bits of a request id that contain the generation of the slot, the server parses request ids as signed 32-bit integers,
+// therefore the id is kept below 2^31 on every platform instead of using all upper bits of size_t
+size_t constexpr PENDING_REQUEST_GENERATION_BITS = 15U;
+// Index used to mark the end of the free and the timeout lists
+size_t constexpr PENDING_REQUEST_NONE = ~static_cast<size_t>(0U);
+// Amount of distinct timeout values that are kept in their own timeout list
+size_t constexpr PENDING_REQUEST_TIMEOUT_LANES = 4U;
+
+
+/// @brief Generational slot map holding the requests we are still waiting on a response for, keyed by the request id that is sent to the cloud and returned in the response topic.
+/// The request id is not a counter but the handle of the slot itself, the lower PENDING_REQUEST_INDEX_BITS contain the index of the slot and the PENDING_REQUEST_GENERATION_BITS above them the generation of the slot.
+/// The generation is increased every time a slot is erased, which allows to look up, insert and erase requests in constant time,
+/// while responses that arrive after their request has already timed out are still rejected, even if the slot has been reused by another request in the meantime.
+/// Erased slots are kept in a free list and reused before the underlying data container grows, meaning once enough slots exist no further allocations are done.
+/// With THINGSBOARD_ENABLE_DYNAMIC the slots for the expected amount of requests should be allocated up front with reserve(), more requests than that still grow and therefore reallocate the slots.
+/// Requests with a timeout are additionally kept in intrusive lists ordered by their deadline, which replaces one timer per request.
+/// They are not armed in the Timeout_Wheel, because slots are moved once the dynamic data container grows, which would invalidate the links of an embedded timer node.
+/// Each distinct timeout value gets its own list, because requests with the same timeout expire in the order they were inserted,
+/// they are therefore appended to the end of their list in constant time and only the heads of the lists ever have to be checked for expiry.
+/// Only if there are more than PENDING_REQUEST_TIMEOUT_LANES distinct timeout values, the remaining ones share the first list and are sorted into it
+/// @tparam T Request that is stored in the slots, has to be default constructible and copy assignable
+#if THINGSBOARD_ENABLE_DYNAMIC
+template <typename T>
+class Pending_Request_Map {
+#else
+/// @tparam MaxRequests Maximum amount of requests that can be waiting on a response at the same time
+template <typename T, size_t MaxRequests>
+class Pending_Request_Map {
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+  public:
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Allocates the slots for the given amount of requests, so that inserting up to that many requests at the same time never reallocates
+    /// @param capacity Amount of requests that are expected to wait on a response at the same time, capped to the amount of slots a request id can address
+    void reserve(size_t capacity) {
+        size_t constexpr max_capacity = static_cast<size_t>(1U) << PENDING_REQUEST_INDEX_BITS;
+        m_slots.reserve(capacity < max_capacity ? capacity : max_capacity);
+    }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+    /// @brief Inserts a copy of the given request into a free slot and starts its timeout
+    /// @param request Request that should be copied into the slot
+    /// @param timeout_microseconds Amount of microseconds until the request is returned by Next_Timed_Out(), if it has not been erased until then. 0 means the request never times out
+    /// @param request_id Id the request was inserted with and that has to be sent to the cloud, never 0
+    /// @return Pointer to the inserted copy, valid until the next call to Insert() or nullptr if there is no free slot left
+    T * Insert(T const & request, uint64_t const & timeout_microseconds, size_t & request_id) {
+        if (m_free_head == PENDING_REQUEST_NONE) {
+#if THINGSBOARD_ENABLE_DYNAMIC
+            if (m_slots.size() >= (static_cast<size_t>(1U) << PENDING_REQUEST_INDEX_BITS)) {
+                return nullptr;
+            }
+            m_slots.push_back(Request_Slot());
+#else
+            if (m_slots.size() >= m_slots.capacity()) {
+                return nullptr;
+            }
+            m_slots.push_back(Request_Slot());
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+            m_free_head = m_slots.size() - 1U;
+        }
+
+        size_t const index = m_free_head;
+        Request_Slot & slot = m_slots[index];
+        m_free_head = slot.next;
+        slot.request = request;
+        slot.occupied = true;
+        slot.next = PENDING_REQUEST_NONE;
+        slot.previous = PENDING_REQUEST_NONE;
+        slot.timeout_microseconds = timeout_microseconds;
+        if (timeout_microseconds != 0U) {
+            slot.start = Timeout_Wheel::Now();
+            Link_Timeout(index);
+        }
+        m_size++;
+        request_id = (slot.generation << PENDING_REQUEST_INDEX_BITS) | index;
+        return &slot.request;
+    }
+
+    /// @brief Looks up the request with the given id
+    /// @param request_id Id the request was inserted with, ids of already erased requests are never found
+    /// @return Pointer to the request, valid until the next call to Insert() or nullptr if there is no request with the given id
+    T * Find(size_t const & request_id) {
+        size_t const index = Get_Index(request_id);
+        if (index == PENDING_REQUEST_NONE) {
+            return nullptr;
+        }
+        return &m_slots[index].request;
+    }
+
+    /// @brief Erases the request with the given id and stops its timeout
+    /// @param request_id Id the request was inserted with
+    /// @return Whether a request with the given id existed or not
+    bool Erase(size_t const & request_id) {
+        size_t const index = Get_Index(request_id);
+        if (index == PENDING_REQUEST_NONE) {
+            return false;
+        }
+        Free_Slot(index);
+        return true;
+    }
+
+    /// @brief Removes a request whose deadline has already passed from its timeout list, only the first request of each list has to be checked.
+    /// The request itself stays in its slot, so that its timeout callback can still be called, before it is erased with the returned id
+    /// @param request_id Id of the timed out request
+    /// @return Whether a request has timed out or not, meant to be called in a loop until it returns false
+    bool Next_Timed_Out(size_t & request_id) {
+        Time const now = Timeout_Wheel::Now();
+        for (auto const & lane : m_lanes) {
+            if (lane.head == PENDING_REQUEST_NONE) {
+                continue;
+            }
+            size_t const index = lane.head;
+            Request_Slot & slot = m_slots[index];
+            if (Get_Remaining(slot, now) != 0U) {
+                continue;
+            }
+            Unlink_Timeout(index);
+            slot.timeout_microseconds = 0U;
+            request_id = (slot.generation << PENDING_REQUEST_INDEX_BITS) | index;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief Erases all requests, ids of previously inserted requests are never found afterwards
+    void clear() {
+        for (size_t index = 0U; index < m_slots.size(); index++) {
+            if (m_slots[index].occupied) {
+                Free_Slot(index);
+            }
+        }
+    }
+
+    /// @brief Gets the amount of requests that are still waiting on a response
+    /// @return Amount of inserted requests
+    size_t size() const {
+        return m_size;
+    }
+
+    /// @brief Whether there are no requests waiting on a response
+    /// @return Whether the map is empty or not
+    bool empty() const {
+        return m_size == 0U;
+    }
+
+  private:
+    using Time = Timeout_Wheel::Time;
+
+    /// @brief Slot of the map, either holds a request or is part of the free list
+    struct Request_Slot {
+        T        request = {};                         // Request waiting on a response
+        size_t   generation = 1U;                      // Generation of the slot, upper bits of the request id, never 0 so that no request id is ever 0
+        size_t   next = PENDING_REQUEST_NONE;          // Next slot in the timeout list or in the free list if the slot is not occupied
+        size_t   previous = PENDING_REQUEST_NONE;      // Previous slot in the timeout list
+        size_t   lane = {};                            // Timeout list the slot is part of
+        Time     start = {};                           // Time the request was inserted at
+        uint64_t timeout_microseconds = {};            // Timeout of the request, 0 if the request is not part of the timeout list
+        bool     occupied = {};                        // Whether the slot holds a request or not
+    };
+
+    /// @brief Gets the amount of microseconds until the given request times out
+    /// @param slot Slot that is part of the timeout list
+    /// @param now Current time
+    /// @return Remaining microseconds or 0 if the request has already timed out
+    static uint64_t Get_Remaining(Request_Slot const & slot, Time const & now) {
+        uint64_t const elapsed = static_cast<Time>(now - slot.start);
+        return elapsed >= slot.timeout_microseconds ? 0U : slot.timeout_microseconds - elapsed;
+    }
+
+    /// @brief Gets the index of the slot the given request id points to
+    /// @param request_id Id the request was inserted with
+    /// @return Index of the slot or PENDING_REQUEST_NONE if the slot is empty or has been reused with another generation
+    size_t Get_Index(size_t const & request_id) const {
+        size_t const index = request_id & ((static_cast<size_t>(1U) << PENDING_REQUEST_INDEX_BITS) - 1U);
+        if (index >= m_slots.size() || (request_id >> (PENDING_REQUEST_INDEX_BITS + PENDING_REQUEST_GENERATION_BITS)) != 0U) {
+            return PENDING_REQUEST_NONE;
+        }
+        Request_Slot const & slot = m_slots[index];
+        if (!slot.occupied || slot.generation != (request_id >> PENDING_REQUEST_INDEX_BITS)) {
+            return PENDING_REQUEST_NONE;
+        }
+        return index;
+    }
+
+    /// @brief Timeout list of all requests with the same timeout value
+    struct Timeout_Lane {
+        size_t   head = PENDING_REQUEST_NONE;          // Slot with the earliest deadline
+        size_t   tail = PENDING_REQUEST_NONE;          // Slot with the latest deadline
+        uint64_t timeout_microseconds = {};            // Timeout value of the slots in the list, only meaningful if the list is not empty
+    };
+
+    /// @brief Gets the timeout list a slot with the given timeout is inserted into,
+    /// which is the list with the same timeout value, an empty list or if neither exists the first list
+    /// @param timeout_microseconds Timeout of the inserted slot
+    /// @return Index of the timeout list
+    size_t Get_Lane(uint64_t const & timeout_microseconds) const {
+        size_t empty_lane = PENDING_REQUEST_NONE;
+        for (size_t lane = 0U; lane < PENDING_REQUEST_TIMEOUT_LANES; lane++) {
+            if (m_lanes[lane].head == PENDING_REQUEST_NONE) {
+                if (empty_lane == PENDING_REQUEST_NONE) {
+                    empty_lane = lane;
+                }
+            }
+            else if (m_lanes[lane].timeout_microseconds == timeout_microseconds) {
+                return lane;
+            }
+        }
+        return empty_lane == PENDING_REQUEST_NONE ? 0U : empty_lane;
+    }
+
+    /// @brief Inserts the given slot into its timeout list after the last slot with an earlier or equal deadline,
+    /// which is always the current tail if the list only contains requests with the same timeout
+    /// @param index Slot with a timeout that is not yet part of a timeout list
+    void Link_Timeout(size_t const & index) {
+        Request_Slot & slot = m_slots[index];
+        slot.lane = Get_Lane(slot.timeout_microseconds);
+        Timeout_Lane & lane = m_lanes[slot.lane];
+        if (lane.head == PENDING_REQUEST_NONE) {
+            lane.timeout_microseconds = slot.timeout_microseconds;
+        }
+        Time const now = slot.start;
+        size_t previous = lane.tail;
+        while (previous != PENDING_REQUEST_NONE && Get_Remaining(m_slots[previous], now) > slot.timeout_microseconds) {
+            previous = m_slots[previous].previous;
+        }
+
+        size_t const next = previous == PENDING_REQUEST_NONE ? lane.head : m_slots[previous].next;
+        slot.previous = previous;
+        slot.next = next;
+        if (previous == PENDING_REQUEST_NONE) {
+            lane.head = index;
+        }
+        else {
+            m_slots[previous].next = index;
+        }
+        if (next == PENDING_REQUEST_NONE) {
+            lane.tail = index;
+        }
+        else {
+            m_slots[next].previous = index;
+        }
+    }
+
+    /// @brief Removes the given slot from its timeout list
+    /// @param index Slot that is part of a timeout list
+    void Unlink_Timeout(size_t const & index) {
+        Request_Slot & slot = m_slots[index];
+        Timeout_Lane & lane = m_lanes[slot.lane];
+        if (slot.previous == PENDING_REQUEST_NONE) {
+            lane.head = slot.next;
+        }
+        else {
+            m_slots[slot.previous].next = slot.next;
+        }
+        if (slot.next == PENDING_REQUEST_NONE) {
+            lane.tail = slot.previous;
+        }
+        else {
+            m_slots[slot.next].previous = slot.previous;
+        }
+        slot.next = PENDING_REQUEST_NONE;
+        slot.previous = PENDING_REQUEST_NONE;
+    }
+
+    /// @brief Stops the timeout of the given slot, releases the request it holds and pushes it onto the free list with the next generation
+    /// @param index Occupied slot
+    void Free_Slot(size_t const & index) {
+        Request_Slot & slot = m_slots[index];
+        if (slot.timeout_microseconds != 0U) {
+            Unlink_Timeout(index);
+            slot.timeout_microseconds = 0U;
+        }
+        slot.request = T();
+        slot.occupied = false;
+        // Generation wraps around before it would overflow the request id, skipping 0
+        slot.generation = (slot.generation + 1U) & ((static_cast<size_t>(1U) << PENDING_REQUEST_GENERATION_BITS) - 1U);
+        if (slot.generation == 0U) {
+            slot.generation = 1U;
+        }
+        slot.next = m_free_head;
+        m_free_head = index;
+        m_size--;
+    }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Request_Slot>                m_slots = {};                           // Slots holding the requests, only grows if the free list is empty
+#else
+    Array<Request_Slot, MaxRequests>    m_slots = {};                           // Slots holding the requests, only grows if the free list is empty
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    size_t                              m_size = {};                            // Amount of occupied slots
+    size_t                              m_free_head = PENDING_REQUEST_NONE;     // First slot of the free list
+    Timeout_Lane                        m_lanes[PENDING_REQUEST_TIMEOUT_LANES] = {}; // Timeout lists, one for each distinct timeout value
+};
+
+#endif // Pending_Request_Map_h
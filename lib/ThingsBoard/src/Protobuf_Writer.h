@@ -0,0 +1,160 @@
+#ifndef Protobuf_Writer_h
+#define Protobuf_Writer_h
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/// @brief Scalar value types of a field in a .proto schema, that telemetry and attribute values can be encoded as.
+/// See https://protobuf.dev/programming-guides/proto3/#scalar for more information
+enum class Proto_Type : uint8_t {
+    PROTO_DOUBLE, ///< double, 64 bit little endian floating point
+    PROTO_FLOAT, ///< float, 32 bit little endian floating point
+    PROTO_INT32, ///< int32, varint where negative values are sign extended to 10 bytes
+    PROTO_INT64, ///< int64, varint where negative values always take 10 bytes
+    PROTO_UINT32, ///< uint32, varint, negative values can not be encoded
+    PROTO_UINT64, ///< uint64, varint, negative values can not be encoded
+    PROTO_SINT32, ///< sint32, zigzag encoded varint, efficient for negative values
+    PROTO_SINT64, ///< sint64, zigzag encoded varint, efficient for negative values
+    PROTO_BOOL, ///< bool, single byte varint
+    PROTO_STRING ///< string, length-delimited UTF-8 text
+};
+
+/// @brief Field of a .proto message schema, maps the key of a telemetry or attribute key-value pair to the number and type of the field it is encoded as.
+/// An array of fields forms the compile time schema of one message, it has to match the schema entered in the ThingsBoard device profile,
+/// for example the field { "temperature", 1U, Proto_Type::PROTO_FLOAT } corresponds to "optional float temperature = 1;"
+struct Proto_Field {
+    char const  *key;    // Key of the key-value pair that is encoded as this field
+    uint32_t    number;  // Field number in the .proto schema
+    Proto_Type  type;    // Scalar type of the field in the .proto schema
+};
+
+/// @brief Wire types of encoded fields, see https://protobuf.dev/programming-guides/encoding/#structure for more information
+enum class Proto_Wire_Type : uint8_t {
+    WIRE_VARINT = 0U, ///< Variable length integer
+    WIRE_I64 = 1U, ///< Fixed 64 bit
+    WIRE_LEN = 2U, ///< Length-delimited
+    WIRE_I32 = 5U ///< Fixed 32 bit
+};
+
+/// @brief Writes protobuf encoded fields into a fixed size buffer, without allocating any memory.
+/// If no buffer is given the writer only counts the bytes that would be written, which allows to measure the exact message size first
+class Protobuf_Writer {
+  public:
+    /// @brief Constructs a writer for the given buffer
+    /// @param buffer Buffer the fields are written into, nullptr to only count the bytes
+    /// @param size Size of the buffer
+    Protobuf_Writer(uint8_t * buffer, size_t const & size)
+      : m_buffer(buffer)
+      , m_size(size)
+      , m_written(0U)
+      , m_overflowed(false)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Writes the tag of a field, which consists of the field number and the wire type
+    /// @param number Field number in the .proto schema
+    /// @param wire_type Wire type of the following value
+    void Write_Tag(uint32_t number, Proto_Wire_Type wire_type) {
+        Write_Varint((static_cast<uint64_t>(number) << 3U) | static_cast<uint8_t>(wire_type));
+    }
+
+    /// @brief Writes a variable length integer, 7 bits per byte with the most significant bit set on all but the last byte
+    /// @param value Value to write
+    void Write_Varint(uint64_t value) {
+        while (value >= 0x80U) {
+            Write_Byte(static_cast<uint8_t>(value | 0x80U));
+            value >>= 7U;
+        }
+        Write_Byte(static_cast<uint8_t>(value));
+    }
+
+    /// @brief Writes a zigzag encoded variable length integer, maps small negative values to small positive values
+    /// @param value Value to write
+    void Write_Zigzag(int64_t value) {
+        Write_Varint((static_cast<uint64_t>(value) << 1U) ^ static_cast<uint64_t>(value >> 63U));
+    }
+
+    /// @brief Writes 32 bits in little endian order
+    /// @param value Value to write
+    void Write_Fixed32(uint32_t value) {
+        for (uint8_t i = 0U; i < 4U; i++) {
+            Write_Byte(static_cast<uint8_t>(value >> (8U * i)));
+        }
+    }
+
+    /// @brief Writes 64 bits in little endian order
+    /// @param value Value to write
+    void Write_Fixed64(uint64_t value) {
+        for (uint8_t i = 0U; i < 8U; i++) {
+            Write_Byte(static_cast<uint8_t>(value >> (8U * i)));
+        }
+    }
+
+    /// @brief Writes a float bit by bit
+    /// @param value Value to write
+    void Write_Float(float value) {
+        uint32_t bits = 0U;
+        memcpy(&bits, &value, sizeof(bits));
+        Write_Fixed32(bits);
+    }
+
+    /// @brief Writes a double bit by bit
+    /// @param value Value to write
+    void Write_Double(double value) {
+        uint64_t bits = 0U;
+        memcpy(&bits, &value, sizeof(bits));
+        Write_Fixed64(bits);
+    }
+
+    /// @brief Writes the length followed by the given bytes
+    /// @param data Bytes to write
+    /// @param length Amount of bytes to write
+    void Write_Length_Delimited(char const * data, size_t const & length) {
+        Write_Varint(length);
+        if (m_buffer != nullptr) {
+            if (m_written + length > m_size) {
+                m_overflowed = true;
+                return;
+            }
+            memcpy(m_buffer + m_written, data, length);
+        }
+        m_written += length;
+    }
+
+    /// @brief Amount of bytes written or counted so far
+    /// @return Amount of bytes
+    size_t Written() const {
+        return m_written;
+    }
+
+    /// @brief Whether a write did not fit into the buffer anymore
+    /// @return Whether the encoded message is incomplete
+    bool Overflowed() const {
+        return m_overflowed;
+    }
+
+  private:
+    /// @brief Writes a single byte, if it still fits into the buffer
+    /// @param value Byte to write
+    void Write_Byte(uint8_t value) {
+        if (m_buffer != nullptr) {
+            if (m_written >= m_size) {
+                m_overflowed = true;
+                return;
+            }
+            m_buffer[m_written] = value;
+        }
+        m_written++;
+    }
+
+    uint8_t  *m_buffer = {};     // Buffer the fields are written into, nullptr if only counting
+    size_t   m_size = {};        // Size of the buffer
+    size_t   m_written = {};     // Amount of bytes written so far
+    bool     m_overflowed = {};  // Whether a write did not fit into the buffer
+};
+
+#endif // Protobuf_Writer_h
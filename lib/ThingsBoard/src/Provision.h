@@ -111,6 +111,10 @@ class Provision : public IAPI_Implementation {
         return strncmp(PROV_RESPONSE_TOPIC, topic, strlen(PROV_RESPONSE_TOPIC) + 1) == 0;
     }
 
+    char const * Get_Response_Topic_Prefix() const override {
+        return PROV_RESPONSE_TOPIC;
+    }
+
     bool Unsubscribe() override {
         return Provision_Unsubscribe();
     }
@@ -119,11 +123,9 @@ class Provision : public IAPI_Implementation {
         return Unsubscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        m_provision_callback.Update_Timeout_Timer();
+        // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
@@ -164,11 +164,6 @@ class Provision_Callback : public Callback<void, JsonDocument const &> {
     /// @param timeout_microseconds Timeout time until timeout callback is called
     void Set_Timeout(uint64_t const & timeout_microseconds);
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Updates the internal timeout timer
-    void Update_Timeout_Timer();
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
     /// @brief Starts the internal timeout timer if we actually received a configured valid timeout time and a valid callback.
     /// Is called as soon as the request is actually sent
     void Start_Timeout_Timer();
@@ -0,0 +1,208 @@
+#ifndef Publish_Queue_h
+#define Publish_Queue_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Library includes.
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/// @brief Priority of a queued message, messages with a higher priority are always sent before any message with a lower priority
+enum class Publish_Priority : uint8_t {
+    PRIORITY_HIGH, ///< Responses and state changes the server is waiting for, for example RPC responses and client-side attributes
+    PRIORITY_NORMAL ///< Periodic data that is not time critical, for example telemetry
+};
+
+/// @brief Decides which message is discarded if a message is pushed while the queue of its priority is full
+enum class Drop_Policy : uint8_t {
+    DROP_OLDEST, ///< Discards the oldest queued message to make room, keeps the most recent data
+    DROP_NEWEST ///< Discards the pushed message, keeps the messages in the order they were queued
+};
+
+
+/// @brief Bounded queue of pre-serialized MQTT messages, which can be pushed to from multiple tasks at once and is popped from by one single task.
+/// Lock-free, pushing never blocks on a slow or disconnected socket and never waits for another task, therefore it can also be called from tasks with a higher priority than the consumer.
+/// Each priority has its own ring of Capacity slots, every slot contains one complete message, meaning the topic followed by the payload, copied into the slot when pushed.
+/// Implemented as a ring of slots with a sequence number each, see https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue for more information on the underlying algorithm.
+/// Slots are claimed and released in two steps, which allows to copy the message into or out of the slot without holding any lock and without copying it a second time
+/// @tparam Capacity Amount of messages that can be queued per priority, has to be a power of two
+/// @tparam MaxMessageSize Maximum size of the topic, including its null terminator, and the payload of one message combined
+template <size_t Capacity, size_t MaxMessageSize>
+class Publish_Queue {
+    static_assert(Capacity != 0U && (Capacity & (Capacity - 1U)) == 0U, "Capacity has to be a power of two");
+
+  public:
+    /// @brief Constructs an empty queue
+    /// @param policy Decides which message is discarded if a message is pushed while the queue of its priority is full
+    Publish_Queue(Drop_Policy policy = Drop_Policy::DROP_OLDEST)
+      : m_rings()
+      , m_policy(policy)
+      , m_dropped(0U)
+    {
+        for (auto & ring : m_rings) {
+            for (size_t i = 0U; i < Capacity; i++) {
+                ring.slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+            ring.enqueue_position.store(0U, std::memory_order_relaxed);
+            ring.dequeue_position.store(0U, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Copies the given message into the queue, can be called from multiple tasks at once
+    /// @param topic Topic the message is published on
+    /// @param payload Payload of the message
+    /// @param length Length of the payload in bytes
+    /// @param priority Priority of the message
+    /// @return Whether the message was queued, false if it is bigger than MaxMessageSize or was discarded because of the DROP_NEWEST policy
+    bool Push(char const * topic, uint8_t const * payload, size_t const & length, Publish_Priority priority) {
+        size_t const topic_size = strlen(topic) + 1U;
+        if (topic_size + length > MaxMessageSize) {
+            m_dropped.fetch_add(1U, std::memory_order_relaxed);
+            return false;
+        }
+
+        Ring & ring = m_rings[static_cast<uint8_t>(priority)];
+        size_t position = 0U;
+        Slot * slot = Claim_Enqueue(ring, position);
+        // Every discarded message makes room for one message, but another producer might take that room first, so only retry a limited amount of times
+        for (size_t attempt = 0U; slot == nullptr && m_policy == Drop_Policy::DROP_OLDEST && attempt < Capacity; attempt++) {
+            size_t oldest_position = 0U;
+            if (Slot * const oldest = Claim_Dequeue(ring, oldest_position)) {
+                oldest->sequence.store(oldest_position + Capacity, std::memory_order_release);
+                m_dropped.fetch_add(1U, std::memory_order_relaxed);
+            }
+            slot = Claim_Enqueue(ring, position);
+        }
+        if (slot == nullptr) {
+            m_dropped.fetch_add(1U, std::memory_order_relaxed);
+            return false;
+        }
+
+        memcpy(slot->data, topic, topic_size);
+        memcpy(slot->data + topic_size, payload, length);
+        slot->topic_size = topic_size;
+        slot->length = length;
+        slot->sequence.store(position + 1U, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Pops the oldest message with the highest priority and passes it to the given function, may only be called from the single consumer task.
+    /// The message is removed from the queue even if the function fails, because it can not be put back in front of messages that were queued in the meantime
+    /// @tparam Function Callable with the signature bool(char const * topic, uint8_t const * payload, size_t const & length)
+    /// @param function Function the message is passed to, the pointers are only valid until it returns
+    /// @param length Length of the payload of the popped message in bytes, 0 if the queue is empty
+    /// @return Result of the function or false if the queue is empty
+    template <typename Function>
+    bool Pop(Function function, size_t & length) {
+        length = 0U;
+        for (auto & ring : m_rings) {
+            size_t position = 0U;
+            Slot * const slot = Claim_Dequeue(ring, position);
+            if (slot == nullptr) {
+                continue;
+            }
+            length = slot->length;
+            bool const result = function(reinterpret_cast<char const *>(slot->data), slot->data + slot->topic_size, slot->length);
+            slot->sequence.store(position + Capacity, std::memory_order_release);
+            return result;
+        }
+        return false;
+    }
+
+    /// @brief Whether any message is queued, only a snapshot if other tasks are currently pushing
+    /// @return Whether all priorities are empty
+    bool Empty() const {
+        for (auto const & ring : m_rings) {
+            if (ring.enqueue_position.load(std::memory_order_acquire) != ring.dequeue_position.load(std::memory_order_acquire)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Amount of messages discarded since the queue was constructed, because they were too big or because the queue was full
+    /// @return Amount of discarded messages
+    uint32_t Dropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+  private:
+    // Rings per priority, one for each value of Publish_Priority
+    static constexpr size_t PRIORITY_AMOUNT = 2U;
+
+    /// @brief Slot containing one message, the sequence number decides whether the slot is currently free for the producer with the same position
+    /// or filled for the consumer with the position one lower. Any other value means the slot is currently claimed by another producer or consumer
+    struct Slot {
+        std::atomic<size_t> sequence;               // Position of the producer or consumer the slot is currently available to
+        size_t              topic_size;             // Size of the topic, including its null terminator
+        size_t              length;                 // Length of the payload following the topic
+        uint8_t             data[MaxMessageSize];   // Topic followed by the payload
+    };
+
+    /// @brief Ring of slots of one priority, the positions increase infinitely and are mapped to the slot with the lower bits
+    struct Ring {
+        Slot                slots[Capacity];        // Slots containing the messages
+        std::atomic<size_t> enqueue_position;       // Position the next message is pushed to
+        std::atomic<size_t> dequeue_position;       // Position the next message is popped from
+    };
+
+    /// @brief Claims the next free slot for writing, the slot has to be released by storing position + 1 into its sequence once the message has been copied into it
+    /// @param ring Ring the slot is claimed from
+    /// @param position Position of the claimed slot
+    /// @return Claimed slot or nullptr if the ring is full
+    static Slot * Claim_Enqueue(Ring & ring, size_t & position) {
+        position = ring.enqueue_position.load(std::memory_order_relaxed);
+        while (true) {
+            Slot & slot = ring.slots[position & (Capacity - 1U)];
+            intptr_t const difference = static_cast<intptr_t>(slot.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position);
+            if (difference == 0) {
+                if (ring.enqueue_position.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+                    return &slot;
+                }
+            }
+            else if (difference < 0) {
+                return nullptr;
+            }
+            else {
+                position = ring.enqueue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// @brief Claims the oldest filled slot for reading, the slot has to be released by storing position + Capacity into its sequence once the message has been read
+    /// @param ring Ring the slot is claimed from
+    /// @param position Position of the claimed slot
+    /// @return Claimed slot or nullptr if the ring is empty
+    static Slot * Claim_Dequeue(Ring & ring, size_t & position) {
+        position = ring.dequeue_position.load(std::memory_order_relaxed);
+        while (true) {
+            Slot & slot = ring.slots[position & (Capacity - 1U)];
+            intptr_t const difference = static_cast<intptr_t>(slot.sequence.load(std::memory_order_acquire)) - static_cast<intptr_t>(position + 1U);
+            if (difference == 0) {
+                if (ring.dequeue_position.compare_exchange_weak(position, position + 1U, std::memory_order_relaxed)) {
+                    return &slot;
+                }
+            }
+            else if (difference < 0) {
+                return nullptr;
+            }
+            else {
+                position = ring.dequeue_position.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    Ring                  m_rings[PRIORITY_AMOUNT] = {}; // Rings per priority, ordered from the highest to the lowest priority
+    Drop_Policy           m_policy = {};                 // Decides which message is discarded if a ring is full
+    std::atomic<uint32_t> m_dropped = {};                // Amount of discarded messages
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Publish_Queue_h
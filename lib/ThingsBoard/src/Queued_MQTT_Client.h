@@ -0,0 +1,157 @@
+#ifndef Queued_MQTT_Client_h
+#define Queued_MQTT_Client_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Local includes.
+#include "IMQTT_Client.h"
+#include "IAPI_Implementation.h"
+#include "Publish_Queue.h"
+
+
+/// @brief MQTT Client interface implementation that wraps another IMQTT_Client and publishes asynchronously.
+/// Published messages are only copied into a Publish_Queue and are sent by the wrapped client once loop() is called, which ThingsBoard::loop() does every time.
+/// Therefore the send methods of ThingsBoard do not block on a slow or disconnected socket anymore and can be called from other tasks than the one calling loop(),
+/// as long as only ThingsBoard::loop() and the methods connecting, subscribing or configuring the client are called from that one task.
+/// Telemetry is queued with normal priority, every other message, for example attributes and RPC responses, with high priority.
+/// Writing directly into the send buffer is not supported, because another task might publish at the same time, instead ThingsBoard serializes into its own buffer and the message is copied once into the queue.
+/// Messages stay queued while the client is disconnected and are sent once the connection has been reestablished, as long as they are not discarded by the Drop_Policy in the meantime
+/// @tparam Capacity Amount of messages that can be queued per priority, has to be a power of two
+/// @tparam MaxMessageSize Maximum size of the topic, including its null terminator, and the payload of one message combined
+template <size_t Capacity, size_t MaxMessageSize>
+class Queued_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructs a IMQTT_Client implementation that queues messages published on the given client
+    /// @param client Client that actually sends the queued messages
+    /// @param byte_budget Payload bytes sent per call to loop(), loop() stops sending once the budget has been reached, meaning it always sends atleast one message.
+    /// Limits how long one call to loop() can block, 0 sends every queued message
+    /// @param policy Decides which message is discarded if a message is published while the queue of its priority is full
+    Queued_MQTT_Client(IMQTT_Client & client, size_t const & byte_budget = 0U, Drop_Policy policy = Drop_Policy::DROP_OLDEST)
+      : m_client(client)
+      , m_queue(policy)
+      , m_byte_budget(byte_budget)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Queues the given message with the given priority, can be called from multiple tasks at once
+    /// @param topic Topic the message is published on
+    /// @param payload Payload of the message
+    /// @param length Length of the payload in bytes
+    /// @param priority Priority of the message
+    /// @return Whether the message was queued
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length, Publish_Priority priority) {
+        return m_queue.Push(topic, payload, length, priority);
+    }
+
+    /// @brief Amount of messages discarded since the client was constructed, because they were too big or because the queue was full
+    /// @return Amount of discarded messages
+    uint32_t dropped() const {
+        return m_queue.Dropped();
+    }
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
+        m_client.set_data_callback(callback);
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_client.set_connect_callback(callback);
+    }
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        return m_client.set_buffer_size(receive_buffer_size, send_buffer_size);
+    }
+
+    uint16_t get_receive_buffer_size() override {
+        return m_client.get_receive_buffer_size();
+    }
+
+    uint16_t get_send_buffer_size() override {
+        // Messages bigger than a queue slot are discarded, even if they would fit into the send buffer of the wrapped client
+        uint16_t const send_buffer_size = m_client.get_send_buffer_size();
+        return send_buffer_size < MaxMessageSize ? send_buffer_size : static_cast<uint16_t>(MaxMessageSize);
+    }
+
+    void set_server(char const * domain, uint16_t port) override {
+        m_client.set_server(domain, port);
+    }
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override {
+        return m_client.connect(client_id, user_name, password);
+    }
+
+    void disconnect() override {
+        m_client.disconnect();
+    }
+
+    bool loop() override {
+        bool const result = m_client.loop();
+        if (!m_client.connected()) {
+            return result;
+        }
+
+        size_t sent_bytes = 0U;
+        size_t popped_length = 0U;
+        auto const send = [this](char const * topic, uint8_t const * payload, size_t const & length) {
+            return m_client.publish(topic, payload, length);
+        };
+        while (m_byte_budget == 0U || sent_bytes < m_byte_budget) {
+            if (!m_queue.Pop(send, popped_length)) {
+                // Either empty or the connection was lost while sending, remaining messages are sent in the next call
+                break;
+            }
+            sent_bytes += popped_length;
+        }
+        return result;
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        return publish(topic, payload, length, strcmp(topic, TELEMETRY_TOPIC) == 0 ? Publish_Priority::PRIORITY_NORMAL : Publish_Priority::PRIORITY_HIGH);
+    }
+
+    bool subscribe(char const * topic) override {
+        return m_client.subscribe(topic);
+    }
+
+    bool unsubscribe(char const * topic) override {
+        return m_client.unsubscribe(topic);
+    }
+
+    bool connected() override {
+        return m_client.connected();
+    }
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+    // Streamed messages are bigger than the send buffer and can not be queued, they are still sent synchronously by the wrapped client
+
+    bool begin_publish(char const * topic, size_t const & length) override {
+        return m_client.begin_publish(topic, length);
+    }
+
+    bool end_publish() override {
+        return m_client.end_publish();
+    }
+
+    size_t write(uint8_t payload_byte) override {
+        return m_client.write(payload_byte);
+    }
+
+    size_t write(uint8_t const * buffer, size_t const & size) override {
+        return m_client.write(buffer, size);
+    }
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    IMQTT_Client                            &m_client;          // Client that actually sends the queued messages
+    Publish_Queue<Capacity, MaxMessageSize> m_queue;            // Messages that have not been sent yet
+    size_t                                  m_byte_budget = {}; // Payload bytes sent per call to loop(), 0 if unlimited
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Queued_MQTT_Client_h
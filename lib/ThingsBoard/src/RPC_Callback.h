@@ -4,6 +4,7 @@
 // Local includes.
 #include "Callback.h"
 #include "Constants.h"
+#include "Json_Pull_Parser.h"
 
 
 /// @brief Server-side RPC callback wrapper,
@@ -11,6 +12,9 @@
 /// Documentation about the specific use of Server-side RPC in ThingsBoard can be found here https://thingsboard.io/docs/user-guide/rpc/#server-side-rpc
 class RPC_Callback : public Callback<void, JsonVariantConst const &, JsonDocument &> {
   public:
+    /// @brief Stream callback signature, receives the parameters as a pull parser instead of a deserialized JsonVariantConst
+    using stream_function = Callback<void, Json_Pull_Parser &, JsonDocument &>::function;
+
     /// @brief Constructs empty callback, will result in never being called. Internals are simply default constructed as nullptr
     RPC_Callback() = default;
 
@@ -35,6 +39,31 @@ class RPC_Callback : public Callback<void, JsonVariantConst const &, JsonDocumen
         // Nothing to do
     }
 
+    /// @brief Constructs stream callback, will be called upon server-side RPC request arrival with the given method name,
+    /// but only if the Server_Side_RPC instance it is subscribed to processes requests as json events.
+    /// Instead of the deserialized parameters it receives a parser for only the parameters, which allows to handle parameters of any size with constant memory
+    /// @param method_name Name we expect to be sent via. server-side RPC so that this method callback will be called
+    /// @param callback Callback method that will be called upon data arrival with a parser for the parameters that were received, Next() has not been called yet on it.
+    /// Should enter data into the JsonDocument, can be empty if the RPC widget does not expect any response.
+    /// See https://arduinojson.org/v6/api/jsondocument/ for more information on how to enter data into a JsonDocument
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @param response_size Internal size the JsonDocument should be able to hold to contain the response to the server side RPC call.
+    /// Use JSON_OBJECT_SIZE() and pass the amount of key value pair to calculate the estimated size. See https://arduinojson.org/v6/assistant/ for more information on how to estimate the required size, default = Default_RPC_Amount (0)
+    RPC_Callback(char const * method_name, stream_function callback, size_t const & response_size = JSON_OBJECT_SIZE(Default_RPC_Amount))
+#else
+    RPC_Callback(char const * method_name, stream_function callback)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      : Callback()
+      , m_method_name(method_name)
+#if THINGSBOARD_ENABLE_DYNAMIC
+      , m_response_size(response_size)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      , m_stream_callback(callback)
+      , m_stream(true)
+    {
+        // Nothing to do
+    }
+
     /// @brief Gets the poiner to the underlying name we expect to be sent via. server-side RPC so that this method callback will be called
     /// @return Pointer to the passed method name
     char const * Get_Name() const {
@@ -47,6 +76,19 @@ class RPC_Callback : public Callback<void, JsonVariantConst const &, JsonDocumen
         m_method_name = method_name;
     }
 
+    /// @brief Calls the stream callback that was subscribed, if this instance was constructed with one
+    /// @param params Parser for only the received parameters
+    /// @param response JsonDocument the response should be entered into
+    void Call_Stream_Callback(Json_Pull_Parser & params, JsonDocument & response) const {
+        m_stream_callback.Call_Callback(params, response);
+    }
+
+    /// @brief Gets whether this instance was constructed with a stream callback, which receives the parameters as a pull parser
+    /// @return Whether the parameters have to be passed as a pull parser
+    bool Is_Stream_Callback() const {
+        return m_stream;
+    }
+
 #if THINGSBOARD_ENABLE_DYNAMIC
     /// @brief Gets the internal size the JsonDocument needs to have to contain the response to the server side RPC call.
     /// @return Internal JsonDocument size
@@ -67,6 +109,8 @@ class RPC_Callback : public Callback<void, JsonVariantConst const &, JsonDocumen
 #if THINGSBOARD_ENABLE_DYNAMIC
     size_t     m_response_size = {}; // Required size to contain the response
 #endif // THINGSBOARD_ENABLE_DYNAMIC
+    Callback<void, Json_Pull_Parser &, JsonDocument &> m_stream_callback = {}; // Callback receiving the parameters as a pull parser
+    bool       m_stream = {};        // Whether the stream callback is used instead of the deserialized one
 };
 
 #endif // RPC_Callback_h
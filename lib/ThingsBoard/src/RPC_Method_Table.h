@@ -0,0 +1,221 @@
+#ifndef RPC_Method_Table_h
+#define RPC_Method_Table_h
+
+// Local include.
+#include "Callback.h"
+#include "Json_Pull_Parser.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+// FNV-1a 32 bit parameters, see http://www.isthe.com/chongo/tech/comp/fnv/ for more information.
+uint32_t constexpr RPC_METHOD_HASH_OFFSET = 2166136261U;
+uint32_t constexpr RPC_METHOD_HASH_PRIME = 16777619U;
+// Returned by RPC_Method_Table::Find() if no callback with the given method name is subscribed.
+size_t constexpr RPC_METHOD_NOT_FOUND = ~static_cast<size_t>(0U);
+
+
+/// @brief Calculates the FNV-1a hash of the given method name, can be evaluated at compile time,
+/// which allows to compare or switch over received method names with hashes of constant method names, without calculating those hashes at runtime
+/// @param method_name Null terminated method name
+/// @param hash Hash of the characters before the given method name, default = RPC_METHOD_HASH_OFFSET
+/// @return Hash of the method name
+constexpr uint32_t RPC_Method_Hash(char const * method_name, uint32_t hash = RPC_METHOD_HASH_OFFSET) {
+    return (*method_name == '\0') ? hash : RPC_Method_Hash(method_name + 1, static_cast<uint32_t>((hash ^ static_cast<uint8_t>(*method_name)) * RPC_METHOD_HASH_PRIME));
+}
+
+/// @brief Calculates the FNV-1a hash of the given device name and method name, separated by a null byte so that the same characters split differently between them result in different keys
+/// @param device_name Null terminated device name
+/// @param method_name Null terminated method name
+/// @return Hash of the device name and method name
+constexpr uint32_t RPC_Method_Hash(char const * device_name, char const * method_name) {
+    return RPC_Method_Hash(method_name, static_cast<uint32_t>(RPC_Method_Hash(device_name) * RPC_METHOD_HASH_PRIME));
+}
+
+/// @brief Calculates the amount of slots a RPC_Method_Table requires for the given amount of methods, can be evaluated at compile time.
+/// The smallest power of two that keeps the table atleast half empty, which keeps probe sequences short and guarantees that every lookup ends in an empty slot
+/// @param method_count Amount of methods the table should be able to hold
+/// @param size Size to start searching from, has to be a power of two, default = 1
+/// @return Amount of slots
+constexpr size_t RPC_Method_Table_Size(size_t method_count, size_t size = 1U) {
+    return (size >= method_count * 2U) ? size : RPC_Method_Table_Size(method_count, size * 2U);
+}
+
+
+/// @brief Open addressing hash table with linear probing, which maps the method names of subscribed RPC callbacks to their index in the data container they are stored in.
+/// Gateway RPC callbacks are mapped by their device name and method name instead, see Build_With_Device().
+/// The table is rebuilt from the complete data container every time a callback is subscribed, meaning lookups never have to handle deleted slots.
+/// Lookups compare the hash first and only compare the complete method name if the hashes are equal, therefore only callbacks with exactly the received method name are found.
+/// If multiple callbacks have the same method name, the one subscribed first is found, like it would be when iterating over the data container
+#if THINGSBOARD_ENABLE_DYNAMIC
+class RPC_Method_Table {
+#else
+/// @tparam MaxMethods Maximum amount of methods the table has to hold, the slots are allocated once with the size calculated at compile time by RPC_Method_Table_Size()
+template <size_t MaxMethods>
+class RPC_Method_Table {
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+  public:
+    /// @brief Rebuilds the table from the given callbacks, the index of a callback is its distance from the given first iterator
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first callback, has to provide the Get_Name() method
+    /// @param last Iterator pointing to one past the last callback
+    template <typename InputIterator>
+    void Build(InputIterator const & first, InputIterator const & last) {
+        Build(first, last, false, [](decltype(*first)) -> char const * {
+            return nullptr;
+        });
+    }
+
+    /// @brief Rebuilds the table from the given gateway callbacks, which are found by their device name and method name together with Find(device_name, method_name)
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first callback, has to provide the Get_Device_Name() and Get_Name() methods
+    /// @param last Iterator pointing to one past the last callback
+    template <typename InputIterator>
+    void Build_With_Device(InputIterator const & first, InputIterator const & last) {
+        Build(first, last, true, [](decltype(*first) callback) -> char const * {
+            return callback.Get_Device_Name();
+        });
+    }
+
+    /// @brief Removes every method from the table
+    void Clear() {
+        m_slots.clear();
+    }
+
+    /// @brief Finds the callback with exactly the given method name
+    /// @param method_name Received method name, nullptr is never found
+    /// @return Index of the callback or RPC_METHOD_NOT_FOUND if no callback with that method name was subscribed
+    size_t Find(char const * method_name) const {
+        if (method_name == nullptr) {
+            return RPC_METHOD_NOT_FOUND;
+        }
+        return Find(RPC_Method_Hash(method_name), [method_name](Method_Slot const & slot) {
+            return slot.device_name == nullptr && strcmp(slot.method_name, method_name) == 0;
+        });
+    }
+
+    /// @brief Finds the gateway callback with exactly the given device name and method name, requires the table to be built with Build_With_Device()
+    /// @param device_name Received device name, nullptr is never found
+    /// @param method_name Received method name, nullptr is never found
+    /// @return Index of the callback or RPC_METHOD_NOT_FOUND if no callback for that device with that method name was subscribed
+    size_t Find(char const * device_name, char const * method_name) const {
+        if (device_name == nullptr || method_name == nullptr) {
+            return RPC_METHOD_NOT_FOUND;
+        }
+        return Find(RPC_Method_Hash(device_name, method_name), [device_name, method_name](Method_Slot const & slot) {
+            return slot.device_name != nullptr && strcmp(slot.device_name, device_name) == 0 && strcmp(slot.method_name, method_name) == 0;
+        });
+    }
+
+    /// @brief Finds the callback with exactly the method name the given parser currently points to.
+    /// The received string is hashed and compared in place, therefore it is never copied and can be of any length
+    /// @param parser Parser whose current event is the received method name, any other event is never found
+    /// @return Index of the callback or RPC_METHOD_NOT_FOUND if no callback with that method name was subscribed
+    size_t Find(Json_Pull_Parser const & parser) const {
+        uint32_t hash = RPC_METHOD_HASH_OFFSET;
+        bool const read = parser.Read_String([&hash](char const * characters, size_t const & count) {
+            for (size_t i = 0U; i < count; i++) {
+                hash = static_cast<uint32_t>((hash ^ static_cast<uint8_t>(characters[i])) * RPC_METHOD_HASH_PRIME);
+            }
+            return true;
+        });
+        if (!read) {
+            return RPC_METHOD_NOT_FOUND;
+        }
+        return Find(hash, [&parser](Method_Slot const & slot) {
+            return slot.device_name == nullptr && parser.String_Equals(slot.method_name);
+        });
+    }
+
+  private:
+    /// @brief Slot of the table, empty if the index is RPC_METHOD_NOT_FOUND
+    struct Method_Slot {
+        uint32_t   hash = {};                       // Hash of the device name and method name or only the method name
+        size_t     index = RPC_METHOD_NOT_FOUND;     // Index of the callback in the data container the table was built from
+        char const *device_name = {};               // Device name of the gateway callback or nullptr if the table was built without device names
+        char const *method_name = {};               // Method name of the callback, compared if the hashes are equal
+    };
+
+    /// @brief Rebuilds the table from the given callbacks, keyed by their method name and optionally by their device name
+    /// @param first Iterator pointing to the first callback, has to provide the Get_Name() method
+    /// @param last Iterator pointing to one past the last callback
+    /// @param with_device Whether callbacks are keyed by their device name as well, callbacks without device name are then skipped
+    /// @param get_device_name Returns the device name of the given callback, only called if with_device is set
+    template <typename InputIterator, typename Device_Name_Getter>
+    void Build(InputIterator const & first, InputIterator const & last, bool const & with_device, Device_Name_Getter get_device_name) {
+        m_slots.clear();
+#if THINGSBOARD_ENABLE_DYNAMIC
+        size_t const size = RPC_Method_Table_Size(Helper::distance(first, last));
+#else
+        size_t constexpr size = RPC_Method_Table_Size(MaxMethods);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        for (size_t i = 0U; i < size; i++) {
+            m_slots.push_back(Method_Slot());
+        }
+
+        size_t index = 0U;
+        for (auto it = first; it != last; ++it, ++index) {
+            char const * device_name = with_device ? get_device_name(*it) : nullptr;
+            char const * method_name = it->Get_Name();
+            if (Helper::stringIsNullorEmpty(method_name) || (with_device && Helper::stringIsNullorEmpty(device_name))) {
+                continue;
+            }
+            uint32_t const hash = (device_name != nullptr) ? RPC_Method_Hash(device_name, method_name) : RPC_Method_Hash(method_name);
+            size_t slot = hash & (size - 1U);
+            while (m_slots[slot].index != RPC_METHOD_NOT_FOUND && (m_slots[slot].hash != hash || !Equal_Keys(m_slots[slot], device_name, method_name))) {
+                slot = (slot + 1U) & (size - 1U);
+            }
+            if (m_slots[slot].index != RPC_METHOD_NOT_FOUND) {
+                // Callback with the same key was subscribed before and is therefore the one that is called
+                continue;
+            }
+            m_slots[slot].hash = hash;
+            m_slots[slot].index = index;
+            m_slots[slot].device_name = device_name;
+            m_slots[slot].method_name = method_name;
+        }
+    }
+
+    /// @brief Whether the given slot has the given device name and method name
+    static bool Equal_Keys(Method_Slot const & slot, char const * device_name, char const * method_name) {
+        if ((slot.device_name == nullptr) != (device_name == nullptr) || (device_name != nullptr && strcmp(slot.device_name, device_name) != 0)) {
+            return false;
+        }
+        return strcmp(slot.method_name, method_name) == 0;
+    }
+
+    /// @brief Finds the callback with the given hash whose key is equal to the received one
+    /// @tparam Equals Callable receiving a used slot, returns whether its key is equal to the received one
+    /// @param hash Hash of the received key
+    /// @param equals Compares the keys of subscribed callbacks with the received one, only called if the hashes are equal
+    /// @return Index of the callback or RPC_METHOD_NOT_FOUND if no callback with that method name was subscribed
+    template <typename Equals>
+    size_t Find(uint32_t const & hash, Equals equals) const {
+        if (m_slots.empty()) {
+            return RPC_METHOD_NOT_FOUND;
+        }
+        size_t const mask = m_slots.size() - 1U;
+        // The table is always atleast half empty, therefore probing ends in an empty slot at the latest
+        for (size_t slot = hash & mask; m_slots[slot].index != RPC_METHOD_NOT_FOUND; slot = (slot + 1U) & mask) {
+            if (m_slots[slot].hash == hash && equals(m_slots[slot])) {
+                return m_slots[slot].index;
+            }
+        }
+        return RPC_METHOD_NOT_FOUND;
+    }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Method_Slot>                                           m_slots = {}; // Slots of the table, the size is always a power of two
+#else
+    Array<Method_Slot, RPC_Method_Table_Size(MaxMethods)>          m_slots = {}; // Slots of the table, the size is always a power of two
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+};
+
+#endif // RPC_Method_Table_h
@@ -1,7 +1,7 @@
 // Header include.
 #include "RPC_Request_Callback.h"
 
-RPC_Request_Callback::RPC_Request_Callback(char const * method_name, function received_callback, JsonArray const * parameters, uint64_t const & timeout_microseconds, Callback_Watchdog::function timeout_callback) :
+RPC_Request_Callback::RPC_Request_Callback(char const * method_name, function received_callback, JsonArray const * parameters, uint64_t const & timeout_microseconds, Callback<void>::function timeout_callback) :
     Callback(received_callback),
     m_method_name(method_name),
     m_parameters(parameters),
@@ -44,23 +44,10 @@ void RPC_Request_Callback::Set_Timeout(uint64_t const & timeout_microseconds) {
     m_timeout_microseconds = timeout_microseconds;
 }
 
-#if !THINGSBOARD_USE_ESP_TIMER
-void RPC_Request_Callback::Update_Timeout_Timer() {
-    m_timeout_callback.update();
+void RPC_Request_Callback::Call_Timeout_Callback() const {
+    m_timeout_callback.Call_Callback();
 }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
-void RPC_Request_Callback::Start_Timeout_Timer() {
-    if (m_timeout_microseconds == 0U) {
-        return;
-    }
-    m_timeout_callback.once(m_timeout_microseconds);
-}
-
-void RPC_Request_Callback::Stop_Timeout_Timer() {
-    m_timeout_callback.detach();
-}
-
-void RPC_Request_Callback::Set_Timeout_Callback(Callback_Watchdog::function timeout_callback) {
-    m_timeout_callback = Callback_Watchdog(timeout_callback);
+void RPC_Request_Callback::Set_Timeout_Callback(Callback<void>::function timeout_callback) {
+    m_timeout_callback.Set_Callback(timeout_callback);
 }
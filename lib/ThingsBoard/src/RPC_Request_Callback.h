@@ -2,7 +2,7 @@
 #define RPC_Request_Callback_h
 
 // Local includes.
-#include "Callback_Watchdog.h"
+#include "Callback.h"
 
 
 /// @brief Client-side RPC callback wrapper,
@@ -22,7 +22,7 @@ class RPC_Request_Callback : public Callback<void, JsonDocument const &> {
     /// If the value is 0 we will not start the timer and therefore never call the timeout callback method, default = 0
     /// @param timeout_callback Optional callback method that will be called upon request timeout (did not receive a response in the given timeout time). Can happen if the requested method does not exist on the cloud,
     /// or if the connection could not be established, default = nullptr
-    RPC_Request_Callback(char const * method_name, function received_callback, JsonArray const * parameters = nullptr, uint64_t const & timeout_microseconds = 0U, Callback_Watchdog::function timeout_callback = nullptr);
+    RPC_Request_Callback(char const * method_name, function received_callback, JsonArray const * parameters = nullptr, uint64_t const & timeout_microseconds = 0U, Callback<void>::function timeout_callback = nullptr);
 
     /// @brief Gets the unique request identifier that is connected to the original request,
     /// and will be later used to verifiy which RPC_Request_Callback
@@ -60,29 +60,19 @@ class RPC_Request_Callback : public Callback<void, JsonDocument const &> {
     /// @param timeout_microseconds Timeout time until timeout callback is called
     void Set_Timeout(uint64_t const & timeout_microseconds);
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Updates the internal timeout timer
-    void Update_Timeout_Timer();
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-    /// @brief Starts the internal timeout timer if we actually received a configured valid timeout time and a valid callback.
-    /// Is called as soon as the request is actually sent
-    void Start_Timeout_Timer();
-
-    /// @brief Stops the internal timeout timer, is called as soon as an answer is received from the cloud
-    /// if it isn't we call the previously subscribed callback instead
-    void Stop_Timeout_Timer();
+    /// @brief Calls the callback method that was subscribed for the request timing out, is called by the owning API once the timeout time passed without having received a response
+    void Call_Timeout_Callback() const;
 
     /// @brief Sets the callback method that will be called upon request timeout (did not receive a response in the given timeout time)
     /// @param timeout_callback Callback function that will be called
-    void Set_Timeout_Callback(Callback_Watchdog::function timeout_callback);
+    void Set_Timeout_Callback(Callback<void>::function timeout_callback);
 
   private:
     char const                    *m_method_name = {};          // Method name
     JsonArray const               *m_parameters = {};          // Parameter json
     size_t                        m_request_id = {};           // Id the request was called with
     uint64_t                      m_timeout_microseconds = {}; // Timeout time until we expect response to request
-    Callback_Watchdog             m_timeout_callback = {};     // Handles callback that will be called if request times out
+    Callback<void>                m_timeout_callback = {};     // Callback that will be called if request times out
 };
 
 #endif // RPC_Request_Callback_h
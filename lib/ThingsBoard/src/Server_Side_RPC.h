@@ -4,14 +4,22 @@
 // Local includes.
 #include "RPC_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Json_Arena.h"
+#include "RPC_Method_Table.h"
 
 
 // Server side RPC topics.
 char constexpr RPC_SUBSCRIBE_TOPIC[] = "v1/devices/me/rpc/request/+";
 char constexpr RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
-char constexpr RPC_SEND_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/%u";
+size_t constexpr RPC_REQUEST_TOPIC_LENGTH = sizeof(RPC_REQUEST_TOPIC) - 1U;
+char constexpr RPC_SEND_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/";
+size_t constexpr RPC_SEND_RESPONSE_TOPIC_LENGTH = sizeof(RPC_SEND_RESPONSE_TOPIC) - 1U;
+// Parameters passed to stream callbacks if the request did not contain any.
+char constexpr NULL_PARAMS[] = "null";
 // Log messages.
 char constexpr RPC_RESPONSE_OVERFLOWED[] = "Server-side RPC response overflowed, increase MaxRPC (%u)";
+char constexpr RPC_CALLBACK_PROCESS_TYPE_MISMATCH[] = "Server-side RPC callback for method (%s) can not be called, stream callbacks require json events to be enabled and other callbacks require them to be disabled";
+char constexpr RPC_REQUEST_INVALID[] = "Server-side RPC request is not a valid json object";
 #if !THINGSBOARD_ENABLE_DYNAMIC
 char constexpr SERVER_SIDE_RPC_SUBSCRIPTIONS[] = "server-side RPC";
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
@@ -39,7 +47,17 @@ template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxRPC =
 class Server_Side_RPC : public IAPI_Implementation {
   public:
     /// @brief Constructor
-    Server_Side_RPC() = default;
+    /// @param json_events Whether received requests are read event by event with a Json_Pull_Parser instead of being deserialized into a JsonDocument.
+    /// Uses the same small amount of memory regardless of the size of the request, but only calls callbacks constructed with a stream callback,
+    /// which receive a parser for the parameters instead of the deserialized parameters, default = false
+    Server_Side_RPC(bool const & json_events = false)
+      : m_json_filter()
+      , m_json_events(json_events)
+    {
+        // Only the method name and its parameters are used, every other field of the request is skipped while deserializing
+        m_json_filter[RPC_METHOD_KEY] = true;
+        m_json_filter[RPC_PARAMS_KEY] = true;
+    }
 
     /// @brief Subscribes multiple server side RPC callbacks,
     /// that will be called if a request from the server for the method with the given name is received.
@@ -67,6 +85,7 @@ class Server_Side_RPC : public IAPI_Implementation {
         (void)m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
         // Push back complete vector into our local m_rpc_callbacks vector.
         m_rpc_callbacks.insert(m_rpc_callbacks.end(), first, last);
+        m_method_table.Build(m_rpc_callbacks.begin(), m_rpc_callbacks.end());
         return true;
     }
 
@@ -89,6 +108,7 @@ class Server_Side_RPC : public IAPI_Implementation {
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
         (void)m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
         m_rpc_callbacks.push_back(callback);
+        m_method_table.Build(m_rpc_callbacks.begin(), m_rpc_callbacks.end());
         return true;
     }
 
@@ -98,11 +118,21 @@ class Server_Side_RPC : public IAPI_Implementation {
     /// and from the rpc topic, was successful or not
     bool RPC_Unsubscribe() {
         m_rpc_callbacks.clear();
+        m_method_table.Clear();
         return m_unsubscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
     }
 
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Gets the biggest size the JsonDocument passed to the subscribed callbacks to enter their response has ever required.
+    /// The memory for that JsonDocument is kept between requests and only grown if a callback with a bigger response size is called
+    /// @return Biggest amount of bytes ever required to hold a response
+    size_t Get_Response_Arena_High_Water_Mark() const {
+        return m_response_arena.High_Water_Mark();
+    }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
     API_Process_Type Get_Process_Type() const override {
-        return API_Process_Type::JSON;
+        return m_json_events ? API_Process_Type::JSON_EVENTS : API_Process_Type::JSON;
     }
 
     void Process_Response(char const * topic, uint8_t * payload, unsigned int length) override {
@@ -118,61 +148,94 @@ class Server_Side_RPC : public IAPI_Implementation {
         }
         char const * method_name = data[RPC_METHOD_KEY];
 
-#if THINGSBOARD_ENABLE_STL
-        auto it = std::find_if(m_rpc_callbacks.begin(), m_rpc_callbacks.end(), [&method_name](RPC_Callback const & rpc) {
-            char const * subscribedMethodName = rpc.Get_Name();
-            return (!Helper::stringIsNullorEmpty(subscribedMethodName) && strncmp(subscribedMethodName, method_name, strlen(subscribedMethodName)) == 0);
-        });
-        if (it != m_rpc_callbacks.end()) {
-            auto & rpc = *it;
-#else
-        for (auto const & rpc : m_rpc_callbacks) {
-            char const * subscribedMethodName = rpc.Get_Name();
-            if (Helper::stringIsNullorEmpty(subscribedMethodName) || strncmp(subscribedMethodName, method_name, strlen(subscribedMethodName)) != 0) {
-              continue;
-            }
-#endif // THINGSBOARD_ENABLE_STL
+        // Exact match of the method name, found with one hash lookup instead of comparing every subscribed method name
+        size_t const index = m_method_table.Find(method_name);
+        if (index == RPC_METHOD_NOT_FOUND) {
+            return;
+        }
+        RPC_Callback const & rpc = m_rpc_callbacks[index];
+
 #if THINGSBOARD_ENABLE_DEBUG
-            if (!data.containsKey(RPC_PARAMS_KEY)) {
-                Logger::printfln(NO_RPC_PARAMS_PASSED);
-            }
+        if (!data.containsKey(RPC_PARAMS_KEY)) {
+            Logger::printfln(NO_RPC_PARAMS_PASSED);
+        }
 #endif // THINGSBOARD_ENABLE_DEBUG
 
 #if THINGSBOARD_ENABLE_DEBUG
-            Logger::printfln(CALLING_RPC_CB, method_name);
+        Logger::printfln(CALLING_RPC_CB, method_name);
 #endif // THINGSBOARD_ENABLE_DEBUG
 
-            JsonVariantConst const param = data[RPC_PARAMS_KEY];
-#if THINGSBOARD_ENABLE_DYNAMIC
-            size_t const & rpc_response_size = rpc.Get_Response_Size();
-            TBJsonDocument json_buffer(rpc_response_size);
-#else
-            size_t constexpr rpc_response_size = MaxRPC;
-            StaticJsonDocument<JSON_OBJECT_SIZE(MaxRPC)> json_buffer;
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-            rpc.Call_Callback(param, json_buffer);
+        JsonVariantConst const param = data[RPC_PARAMS_KEY];
+        Call_RPC_Callback(topic, rpc, param, nullptr);
+    }
+
+    void Process_Json_Events(char const * topic, Json_Pull_Parser & parser) override {
+        if (parser.Next() != Json_Event::OBJECT_BEGIN) {
+            Logger::printfln(RPC_REQUEST_INVALID);
+            return;
+        }
 
-            if (json_buffer.isNull()) {
+        // The method name and the parameters can be received in any order, therefore the parameters are only marked and read once the callback is known
+        size_t index = RPC_METHOD_NOT_FOUND;
+        bool method_received = false;
+        Json_Pull_Parser params = {};
+        bool params_received = false;
+        while (parser.Next() == Json_Event::KEY) {
+            if (parser.String_Equals(RPC_METHOD_KEY)) {
+                if (parser.Next() != Json_Event::STRING) {
+                    (void)parser.Skip();
+                    continue;
+                }
+                // Compared in place, because the received method name can be arbitrarily long and copying it would require a buffer sized by the payload
+                index = m_method_table.Find(parser);
+                method_received = true;
 #if THINGSBOARD_ENABLE_DEBUG
-                Logger::printfln(RPC_RESPONSE_NULL);
+                if (index != RPC_METHOD_NOT_FOUND) {
+                    Logger::printfln(CALLING_RPC_CB, m_rpc_callbacks[index].Get_Name());
+                }
 #endif // THINGSBOARD_ENABLE_DEBUG
-                return;
             }
-            else if (json_buffer.overflowed()) {
-                Logger::printfln(RPC_RESPONSE_OVERFLOWED, rpc_response_size);
-                return;
+            else if (parser.String_Equals(RPC_PARAMS_KEY)) {
+                params = parser.Take_Value();
+                params_received = true;
             }
-
-            size_t const request_id = Helper::parseRequestId(RPC_REQUEST_TOPIC, topic);
-            char responseTopic[Helper::detectSize(RPC_SEND_RESPONSE_TOPIC, request_id)] = {};
-            (void)snprintf(responseTopic, sizeof(responseTopic), RPC_SEND_RESPONSE_TOPIC, request_id);
-            (void)m_send_json_callback.Call_Callback(responseTopic, json_buffer, Helper::Measure_Json(json_buffer));
+            else {
+                (void)parser.Skip();
+            }
+        }
+        if (parser.Get_Event() != Json_Event::OBJECT_END) {
+            Logger::printfln(RPC_REQUEST_INVALID);
+            return;
+        }
+        else if (!method_received) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(SERVER_RPC_METHOD_NULL);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return;
+        }
+        else if (index == RPC_METHOD_NOT_FOUND) {
             return;
         }
+
+        if (!params_received) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(NO_RPC_PARAMS_PASSED);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            params = Json_Pull_Parser(reinterpret_cast<uint8_t const *>(NULL_PARAMS), strlen(NULL_PARAMS));
+        }
+        Call_RPC_Callback(topic, m_rpc_callbacks[index], JsonVariantConst(), &params);
     }
 
     bool Compare_Response_Topic(char const * topic) const override {
-        return strncmp(RPC_REQUEST_TOPIC, topic, strlen(RPC_REQUEST_TOPIC)) == 0;
+        return strncmp(RPC_REQUEST_TOPIC, topic, RPC_REQUEST_TOPIC_LENGTH) == 0;
+    }
+
+    char const * Get_Response_Topic_Prefix() const override {
+        return RPC_REQUEST_TOPIC;
+    }
+
+    JsonDocument const * Get_Json_Filter() const override {
+        return &m_json_filter;
     }
 
     bool Unsubscribe() override {
@@ -187,11 +250,9 @@ class Server_Side_RPC : public IAPI_Implementation {
         return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
         // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
@@ -204,9 +265,53 @@ class Server_Side_RPC : public IAPI_Implementation {
     }
 
   private:
+    /// @brief Calls the given callback with the received parameters and sends the response it entered, if there is any
+    /// @param topic Topic the request was received over, contains the request id the response is sent with
+    /// @param rpc Callback subscribed for the received method name
+    /// @param param Deserialized parameters, only used if no parser is passed
+    /// @param params Parser for the parameters, if the request was processed as json events or nullptr if it was deserialized
+    void Call_RPC_Callback(char const * topic, RPC_Callback const & rpc, JsonVariantConst const & param, Json_Pull_Parser * params) {
+        if (rpc.Is_Stream_Callback() != (params != nullptr)) {
+            Logger::printfln(RPC_CALLBACK_PROCESS_TYPE_MISMATCH, rpc.Get_Name());
+            return;
+        }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+        size_t const & rpc_response_size = rpc.Get_Response_Size();
+        TBArenaJsonDocument json_buffer(rpc_response_size, Json_Arena_Allocator(m_response_arena));
+#else
+        size_t constexpr rpc_response_size = MaxRPC;
+        StaticJsonDocument<JSON_OBJECT_SIZE(MaxRPC)> json_buffer;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        if (params != nullptr) {
+            rpc.Call_Stream_Callback(*params, json_buffer);
+        }
+        else {
+            rpc.Call_Callback(param, json_buffer);
+        }
+
+        if (json_buffer.isNull()) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(RPC_RESPONSE_NULL);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return;
+        }
+        else if (json_buffer.overflowed()) {
+            Logger::printfln(RPC_RESPONSE_OVERFLOWED, rpc_response_size);
+            return;
+        }
+
+        size_t const request_id = Helper::parseRequestId(topic, RPC_REQUEST_TOPIC_LENGTH);
+        char responseTopic[RPC_SEND_RESPONSE_TOPIC_LENGTH + MAX_DECIMAL_DIGITS + 1U] = {};
+        (void)Helper::buildTopic(responseTopic, RPC_SEND_RESPONSE_TOPIC, RPC_SEND_RESPONSE_TOPIC_LENGTH, request_id);
+        (void)m_send_json_callback.Call_Callback(responseTopic, json_buffer, Helper::Measure_Json(json_buffer));
+    }
+
     Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};         // Send json document callback
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};   // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {}; // Unubscribe mqtt topic client callback
+    StaticJsonDocument<JSON_OBJECT_SIZE(2U)>                                 m_json_filter;                     // Fields of the request that are deserialized
+    bool                                                                     m_json_events = {};                // Whether requests are processed as json events instead of being deserialized
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
@@ -218,9 +323,15 @@ class Server_Side_RPC : public IAPI_Implementation {
     // especially because at most we copy internal vectors or array, that will only ever contain a few pointers
 #if THINGSBOARD_ENABLE_DYNAMIC
     Vector<RPC_Callback>                                                     m_rpc_callbacks = {};              // Server side RPC callbacks vector
+    Json_Arena                                                               m_response_arena = {};             // Memory reused by the response of every server side RPC request, only grows
 #else
     Array<RPC_Callback, MaxSubscriptions>                                    m_rpc_callbacks = {};              // Server side RPC callbacks array
 #endif // THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_DYNAMIC
+    RPC_Method_Table                                                         m_method_table = {};               // Index of the server side RPC callbacks by method name
+#else
+    RPC_Method_Table<MaxSubscriptions>                                       m_method_table = {};               // Index of the server side RPC callbacks by method name
+#endif // THINGSBOARD_ENABLE_DYNAMIC
 };
 
 #endif // Server_Side_RPC_h
@@ -4,6 +4,8 @@
 // Local includes.
 #include "Shared_Attribute_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Attribute_Key_Table.h"
+#include "Json_Arena.h"
 
 
 // Log messages.
@@ -26,7 +28,15 @@ template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxAttri
 class Shared_Attribute_Update : public IAPI_Implementation {
   public:
     /// @brief Constructor
-    Shared_Attribute_Update() = default;
+    Shared_Attribute_Update()
+#if THINGSBOARD_ENABLE_DYNAMIC
+      : m_json_filter(JSON_OBJECT_SIZE(1U))
+#else
+      : m_json_filter()
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    {
+        Update_Subscribed_Keys();
+    }
 
     /// @brief Subscribes multiple shared attribute callbacks,
     /// that will be called if the key-value pair from the server for the given shared attributes is received.
@@ -54,6 +64,7 @@ class Shared_Attribute_Update : public IAPI_Implementation {
         (void)m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
         // Push back complete vector into our local m_shared_attribute_update_callbacks vector.
         m_shared_attribute_update_callbacks.insert(m_shared_attribute_update_callbacks.end(), first, last);
+        Update_Subscribed_Keys();
         return true;
     }
 
@@ -80,6 +91,7 @@ class Shared_Attribute_Update : public IAPI_Implementation {
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
         (void)m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
         m_shared_attribute_update_callbacks.push_back(callback);
+        Update_Subscribed_Keys();
         return true;
     }
 
@@ -89,6 +101,7 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     /// and from the attribute topic, was successful or not
     bool Shared_Attributes_Unsubscribe() {
         m_shared_attribute_update_callbacks.clear();
+        Update_Subscribed_Keys();
         return m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
     }
 
@@ -106,57 +119,59 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             object = object[SHARED_RESPONSE_KEY];
         }
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_CXX20
-#if THINGSBOARD_ENABLE_DYNAMIC
-        auto filtered_shared_attribute_update_callbacks = m_shared_attribute_update_callbacks | std::views::filter([&object](Shared_Attribute_Callback const & shared_attribute) {
-#else
-        auto filtered_shared_attribute_update_callbacks = m_shared_attribute_update_callbacks | std::views::filter([&object](Shared_Attribute_Callback<MaxAttributes> const & shared_attribute) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-#else
+        // Every received key is hashed once to find its id, the value is remembered by that id,
+        // so that the subsets passed to the callbacks can be built without searching the received object again
+        size_t const word_count = m_key_table.Get_Word_Count();
 #if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<Shared_Attribute_Callback> filtered_shared_attribute_update_callbacks = {};
-        std::copy_if(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end(), std::back_inserter(filtered_shared_attribute_update_callbacks), [&object](Shared_Attribute_Callback const & shared_attribute) {
+        uint32_t updated_keys[word_count + 1U] = {};
 #else
-        Array<Shared_Attribute_Callback<MaxAttributes>, MaxSubscriptions> filtered_shared_attribute_update_callbacks = {};
-        std::copy_if(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end(), std::back_inserter(filtered_shared_attribute_update_callbacks), [&object](Shared_Attribute_Callback<MaxAttributes> const & shared_attribute) {
+        uint32_t updated_keys[Attribute_Key_Words(MaxSubscriptions * MaxAttributes) + 1U] = {};
 #endif // THINGSBOARD_ENABLE_DYNAMIC
-#endif // THINGSBOARD_ENABLE_CXX20
-            return (shared_attribute.Get_Attributes().empty() || std::find_if(shared_attribute.Get_Attributes().begin(), shared_attribute.Get_Attributes().end(), [&object](const char * att) {
-                return object.containsKey(att);
-            }) != shared_attribute.Get_Attributes().end());
-        });
+        for (JsonPairConst const pair : object) {
+            size_t const id = m_key_table.Find(pair.key().c_str());
+            if (id == ATTRIBUTE_KEY_NOT_FOUND) {
+                continue;
+            }
+            updated_keys[id / ATTRIBUTE_KEY_BITS] |= static_cast<uint32_t>(1U) << (id % ATTRIBUTE_KEY_BITS);
+            m_updated_values[id] = pair.value();
+        }
 
-        for (auto const & shared_attribute : filtered_shared_attribute_update_callbacks) {
-#else
+        size_t index = 0U;
         for (auto const & shared_attribute : m_shared_attribute_update_callbacks) {
+            uint32_t const * interest = m_key_table.Get_Interest(index++);
             if (shared_attribute.Get_Attributes().empty()) {
                 // No specifc keys were subscribed so we call the callback anyway, assumed to be subscribed to any update
                 shared_attribute.Call_Callback(object);
                 continue;
             }
 
-            char const * requested_att = nullptr;
-
-            for (auto const & att : shared_attribute.Get_Attributes()) {
-                if (Helper::stringIsNullorEmpty(att)) {
-                    continue;
-                }
-                // Check if the request contained any of our requested keys and
-                // break early if the key was requested from this callback.
-                if (object.containsKey(att)) {
-                    requested_att = att;
-                    break;
+            // Check if the response contained any of the keys subscribed by this callback,
+            // if it did not we simply continue with the next subscribed callback.
+            size_t updated_count = 0U;
+            for (size_t word = 0U; word < word_count; word++) {
+                for (uint32_t bits = interest[word] & updated_keys[word]; bits != 0U; bits &= bits - 1U) {
+                    updated_count++;
                 }
             }
-
-            // Check if this callback did not request any keys that were in this response,
-            // if there were not we simply continue with the next subscribed callback.
-            if (requested_att == nullptr) {
+            if (updated_count == 0U) {
                 continue;
             }
-#endif // THINGSBOARD_ENABLE_STL
-            shared_attribute.Call_Callback(object);
+
+            // Only the updated keys this callback is subscribed to are passed, the values are linked and not copied
+#if THINGSBOARD_ENABLE_DYNAMIC
+            TBArenaJsonDocument subset(JSON_OBJECT_SIZE(updated_count), Json_Arena_Allocator(m_subset_arena));
+#else
+            StaticJsonDocument<JSON_OBJECT_SIZE(MaxAttributes)> subset;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+            JsonObject subset_object = subset.template to<JsonObject>();
+            for (size_t word = 0U; word < word_count; word++) {
+                // Visit only the set bits, lowest first, by clearing the lowest set bit after each one
+                for (uint32_t bits = interest[word] & updated_keys[word]; bits != 0U; bits &= bits - 1U) {
+                    size_t const id = word * ATTRIBUTE_KEY_BITS + static_cast<size_t>(__builtin_ctz(bits));
+                    subset_object[m_key_table.Get_Key(id)].shallowCopy(m_updated_values[id]);
+                }
+            }
+            shared_attribute.Call_Callback(subset.template as<JsonObjectConst>());
         }
     }
 
@@ -164,6 +179,14 @@ class Shared_Attribute_Update : public IAPI_Implementation {
         return strncmp(ATTRIBUTE_TOPIC, topic, strlen(ATTRIBUTE_TOPIC) + 1) == 0;
     }
 
+    char const * Get_Response_Topic_Prefix() const override {
+        return ATTRIBUTE_TOPIC;
+    }
+
+    JsonDocument const * Get_Json_Filter() const override {
+        return m_filter_keys ? &m_json_filter : nullptr;
+    }
+
     bool Unsubscribe() override {
         return Shared_Attributes_Unsubscribe();
     }
@@ -176,11 +199,9 @@ class Shared_Attribute_Update : public IAPI_Implementation {
         return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
         // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
@@ -192,6 +213,39 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     }
 
   private:
+    /// @brief Interns the keys of every subscribed callback and rebuilds the filter from them, so that only those keys are deserialized.
+    /// Keys are allowed on the root object and inside of the shared object, because the server sends the update in either of the two structures.
+    /// If atleast one callback is subscribed to every key, nothing is filtered
+    void Update_Subscribed_Keys() {
+        m_key_table.Build(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end());
+        size_t const key_count = m_key_table.Get_Key_Count();
+#if THINGSBOARD_ENABLE_DYNAMIC
+        m_updated_values.clear();
+        for (size_t id = 0U; id < key_count; id++) {
+            m_updated_values.push_back(JsonVariantConst());
+        }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+        m_filter_keys = true;
+        for (auto const & shared_attribute : m_shared_attribute_update_callbacks) {
+            if (shared_attribute.Get_Attributes().empty()) {
+                m_filter_keys = false;
+                return;
+            }
+        }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+        m_json_filter = TBJsonDocument(JSON_OBJECT_SIZE(key_count + 1U) + JSON_OBJECT_SIZE(key_count));
+#else
+        m_json_filter.clear();
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        JsonObject shared = m_json_filter.createNestedObject(SHARED_RESPONSE_KEY);
+        for (size_t id = 0U; id < key_count; id++) {
+            m_json_filter[m_key_table.Get_Key(id)] = true;
+            shared[m_key_table.Get_Key(id)] = true;
+        }
+    }
+
     Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};          // Subscribe mqtt topic client callback
     Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};        // Unubscribe mqtt topic client callback
 
@@ -208,6 +262,20 @@ class Shared_Attribute_Update : public IAPI_Implementation {
 #else
     Array<Shared_Attribute_Callback<MaxAttributes>, MaxSubscriptions>        m_shared_attribute_update_callbacks = {}; // Shared attribute update callbacks array
 #endif // THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_DYNAMIC
+    TBJsonDocument                                                           m_json_filter;                            // Subscribed keys that are deserialized
+#else
+    StaticJsonDocument<JSON_OBJECT_SIZE(MaxSubscriptions * MaxAttributes + 1U) + JSON_OBJECT_SIZE(MaxSubscriptions * MaxAttributes)> m_json_filter; // Subscribed keys that are deserialized
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    bool                                                                     m_filter_keys = {};                       // Whether every subscribed callback is only subscribed to specific keys
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Attribute_Key_Table                                                      m_key_table = {};                         // Ids of the subscribed keys and the keys each callback is subscribed to
+    Vector<JsonVariantConst>                                                 m_updated_values = {};                    // Values of the last received update, indexed by the id of their key
+    Json_Arena                                                               m_subset_arena = {};                      // Memory reused by the subset of the update passed to each callback, only grows
+#else
+    Attribute_Key_Table<MaxSubscriptions, MaxAttributes>                     m_key_table = {};                         // Ids of the subscribed keys and the keys each callback is subscribed to
+    JsonVariantConst                                                         m_updated_values[MaxSubscriptions * MaxAttributes] = {}; // Values of the last received update, indexed by the id of their key
+#endif // THINGSBOARD_ENABLE_DYNAMIC
 };
 
 #endif // Shared_Attribute_Update_h
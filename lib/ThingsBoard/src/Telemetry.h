@@ -112,6 +112,28 @@ class Telemetry {
         return false;
     }
 
+    /// @brief Adds the key-value pair to the given batch, with the type of the value it was constructed from
+    /// @tparam TBatch Telemetry_Batch the key-value pair should be added to
+    /// @param batch Batch the key-value pair should be added to
+    /// @return Whether adding was successful or not, fails if the record has no key or the batch is full
+    template <typename TBatch>
+    bool AddToBatch(TBatch & batch) const {
+        switch (m_type) {
+            case DataType::TYPE_BOOL:
+                return batch.Add(m_key, m_value.boolean);
+            case DataType::TYPE_INT:
+                return batch.Add(m_key, m_value.integer);
+            case DataType::TYPE_REAL:
+                return batch.Add(m_key, m_value.real);
+            case DataType::TYPE_STR:
+                return batch.Add(m_key, m_value.str);
+            default:
+                // Nothing to do
+                break;
+        }
+        return false;
+    }
+
   private:
     /// @brief Data container, which contains one of the possibly passed values
     union Data {
@@ -0,0 +1,513 @@
+#ifndef Telemetry_Batch_h
+#define Telemetry_Batch_h
+
+// Local includes.
+#include "Configuration.h"
+#include "Json_Key.h"
+#if THINGSBOARD_ENABLE_PROTOBUF
+#include "Protobuf_Writer.h"
+#endif // THINGSBOARD_ENABLE_PROTOBUF
+
+// Library includes.
+#include <ArduinoJson.h>
+#if THINGSBOARD_ENABLE_STL
+#include <type_traits>
+#endif // THINGSBOARD_ENABLE_STL
+
+
+/// @brief Fixed capacity collection of telemetry or attribute key-value pairs, that is written as a json object without ever creating a JsonDocument.
+/// Keys, types and values are kept in seperate arrays (structure of arrays) and written in one forward pass directly into the given buffer,
+/// the exact length of the resulting json is calculated beforehand, which allows to reserve the MQTT message before serializing.
+/// Keys and string values are only stored as pointers and therefore need to live on for as long as the batch is used.
+/// Keys added as a Json_Key are written with one single copy of their pre-escaped fragment, plain keys are escaped while writing.
+/// Values are formatted and escaped the same way ArduinoJson does, therefore the resulting json is identical to the one built with the Telemetry class.
+/// Except for floating point values added with a precision policy, those are rounded to a fixed-point integer when added and written with integer operations only,
+/// which is faster than the generic float decomposition and removes noise digits, for example 3.7 instead of 3.70000005 for a battery voltage with 3 decimal places
+/// Optionally the batch can contain the timestamp the values were acquired at, it is then written as {"ts":..,"values":{..}} instead,
+/// so the server stores the acquisition time instead of the arrival time of the message.
+/// @tparam MaxKeyValuePairAmount Maximum amount of key-value pairs that can be added to the batch
+template <size_t MaxKeyValuePairAmount>
+class Telemetry_Batch {
+  public:
+    /// @brief Creates an empty batch
+    Telemetry_Batch()
+      : m_keys()
+      , m_key_lengths()
+      , m_decimals()
+      , m_types()
+      , m_values()
+      , m_size(0U)
+      , m_timestamp(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Adds a key-value pair with an integral value
+    /// @tparam T Type of the passed value, is required to be integral,
+    /// to ensure this method isn't used instead of the float one by mistake
+    /// @param key Key of the key value pair we want to add
+    /// @param value Value of the key value pair we want to add
+    /// @return Whether there was enough space left to add the key-value pair or not
+    template <typename T,
+#if THINGSBOARD_ENABLE_STL
+              typename std::enable_if<std::is_integral<T>::value>::type* = nullptr>
+#else
+              typename ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::enable_if<ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::is_integral<T>::value>::type* = nullptr>
+#endif // THINGSBOARD_ENABLE_STL
+    bool Add(char const * key, T const & value) {
+        Data data;
+        data.integer = value;
+        return Add(key, DataType::TYPE_INT, data);
+    }
+
+    /// @brief Adds a key-value pair with a floating point value
+    /// @tparam T Type of the passed value, is required to be a floating point,
+    /// to ensure this method isn't used instead of the boolean one by mistake
+    /// @param key Key of the key value pair we want to add
+    /// @param value Value of the key value pair we want to add
+    /// @return Whether there was enough space left to add the key-value pair or not
+    template <typename T,
+#if THINGSBOARD_ENABLE_STL
+              typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+#else
+              typename ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::enable_if<ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::is_floating_point<T>::value>::type* = nullptr>
+#endif // THINGSBOARD_ENABLE_STL
+    bool Add(char const * key, T const & value) {
+        Data data;
+        data.real = value;
+        return Add(key, DataType::TYPE_REAL, data);
+    }
+
+    /// @brief Adds a key-value pair with a floating point value, that is rounded to the given decimal places
+    /// @tparam T Type of the passed value, is required to be a floating point
+    /// @param key Key of the key value pair we want to add
+    /// @param value Value of the key value pair we want to add
+    /// @param decimals Decimal places the value is rounded to, values that are not finite or too big to be scaled are added without rounding
+    /// @return Whether there was enough space left to add the key-value pair or not
+    template <typename T,
+#if THINGSBOARD_ENABLE_STL
+              typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+#else
+              typename ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::enable_if<ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::is_floating_point<T>::value>::type* = nullptr>
+#endif // THINGSBOARD_ENABLE_STL
+    bool Add(char const * key, T const & value, uint8_t decimals) {
+        if (decimals > MAX_DECIMALS) {
+            return Add(key, value);
+        }
+        // Calculate in the type of the value, to keep float on the single precision FPU
+        T const scaled = value * static_cast<T>(Power_Of_Ten(decimals));
+        if (!(scaled > static_cast<T>(INT64_MIN) && scaled < static_cast<T>(INT64_MAX))) {
+            return Add(key, value);
+        }
+        Data data;
+        data.integer = static_cast<int64_t>(scaled < 0 ? scaled - static_cast<T>(0.5) : scaled + static_cast<T>(0.5));
+        if (!Add(key, DataType::TYPE_FIXED, data)) {
+            return false;
+        }
+        m_decimals[m_size - 1U] = decimals;
+        return true;
+    }
+
+    /// @brief Adds a key-value pair with a boolean value
+    /// @param key Key of the key value pair we want to add
+    /// @param value Value of the key value pair we want to add
+    /// @return Whether there was enough space left to add the key-value pair or not
+    bool Add(char const * key, bool value) {
+        Data data;
+        data.boolean = value;
+        return Add(key, DataType::TYPE_BOOL, data);
+    }
+
+    /// @brief Adds a key-value pair with a string value
+    /// @param key Key of the key value pair we want to add
+    /// @param value Value of the key value pair we want to add, needs to live on for as long as the batch is used
+    /// @return Whether there was enough space left to add the key-value pair or not
+    bool Add(char const * key, char const * value) {
+        if (value == nullptr) {
+            return false;
+        }
+        Data data;
+        data.str = value;
+        return Add(key, DataType::TYPE_STR, data);
+    }
+
+    /// @brief Adds a key-value pair with a key that has been quoted and escaped at compile time
+    /// @tparam KeySize Size of the string literal the key was created from
+    /// @tparam T Type of the passed value, any type accepted by the other Add() methods
+    /// @param key Pre-escaped key of the key value pair we want to add, needs to live on for as long as the batch is used
+    /// @param value Value of the key value pair we want to add
+    /// @return Whether there was enough space left to add the key-value pair or not
+    template <size_t KeySize, typename T>
+    bool Add(Json_Key<KeySize> const & key, T const & value) {
+        if (!Add_With_Policy(key.Fragment(), value, key.Decimals())) {
+            return false;
+        }
+        m_key_lengths[m_size - 1U] = key.Length();
+        return true;
+    }
+
+    /// @brief Sets the time the values were acquired at
+    /// @param timestamp Unix time in milliseconds, 0 removes the timestamp and lets the server use the arrival time instead
+    void Set_Timestamp(uint64_t const & timestamp) {
+        m_timestamp = timestamp;
+    }
+
+    /// @brief Time the values were acquired at
+    /// @return Unix time in milliseconds or 0 if no timestamp is set
+    uint64_t const & Timestamp() const {
+        return m_timestamp;
+    }
+
+    /// @brief Removes all previously added key-value pairs and the timestamp
+    void Clear() {
+        m_size = 0U;
+        m_timestamp = 0U;
+    }
+
+    /// @brief Amount of key-value pairs in the batch
+    /// @return Amount of added key-value pairs
+    size_t Size() const {
+        return m_size;
+    }
+
+    /// @brief Whether no key-value pair has been added yet
+    /// @return Whether the batch is empty or not
+    bool Empty() const {
+        return m_size == 0U;
+    }
+
+    /// @brief Calculates the exact length of the json object written by Serialize_Json(), without writing anything
+    /// @return Length of the json object without the null terminator
+    size_t Measure_Json() const {
+        Formatter<ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::DummyWriter> formatter(ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::DummyWriter{});
+        Write_Object(formatter);
+        return formatter.bytesWritten();
+    }
+
+    /// @brief Writes all key-value pairs as a json object into the given buffer, followed by a null terminator
+    /// @param buffer Buffer the json object is written into
+    /// @param size Size of the buffer, needs to be atleast Measure_Json() + 1
+    /// @return Length of the written json object without the null terminator or 0 if the buffer was too small
+    size_t Serialize_Json(char * buffer, size_t const & size) const {
+        if (buffer == nullptr || size == 0U) {
+            return 0U;
+        }
+        Formatter<ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::StaticStringWriter> formatter(ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::StaticStringWriter(buffer, size - 1U));
+        Write_Object(formatter);
+        size_t const length = formatter.bytesWritten();
+        // Writer silently stops at the end of the buffer, reaching it means the json object was cut off
+        if (length >= size - 1U && Measure_Json() != length) {
+            buffer[0] = '\0';
+            return 0U;
+        }
+        buffer[length] = '\0';
+        return length;
+    }
+
+#if THINGSBOARD_ENABLE_PROTOBUF
+    /// @brief Calculates the exact size of the Protobuf message written by Serialize_Protobuf(), without writing anything.
+    /// The timestamp is not part of the message, because the Protobuf schema of the device profile only describes the values
+    /// @param first Pointer to the first field of the message schema
+    /// @param last Pointer to the end of the message schema (last field + 1)
+    /// @param size Size of the encoded message
+    /// @return Whether every key-value pair has a field in the schema, that its value can be encoded as
+    bool Measure_Protobuf(Proto_Field const * first, Proto_Field const * last, size_t & size) const {
+        Protobuf_Writer writer(nullptr, 0U);
+        if (!Write_Message(writer, first, last)) {
+            return false;
+        }
+        size = writer.Written();
+        return true;
+    }
+
+    /// @brief Writes all key-value pairs as the fields of a Protobuf message with the given schema into the given buffer
+    /// @param first Pointer to the first field of the message schema
+    /// @param last Pointer to the end of the message schema (last field + 1)
+    /// @param buffer Buffer the message is written into
+    /// @param size Size of the buffer, needs to be atleast the size returned by Measure_Protobuf()
+    /// @return Size of the written message or 0 if the buffer was too small or a key-value pair could not be encoded
+    size_t Serialize_Protobuf(Proto_Field const * first, Proto_Field const * last, uint8_t * buffer, size_t const & size) const {
+        if (buffer == nullptr) {
+            return 0U;
+        }
+        Protobuf_Writer writer(buffer, size);
+        if (!Write_Message(writer, first, last) || writer.Overflowed()) {
+            return 0U;
+        }
+        return writer.Written();
+    }
+#endif // THINGSBOARD_ENABLE_PROTOBUF
+
+  private:
+    template <typename TWriter>
+    using Formatter = ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::TextFormatter<TWriter>;
+
+    /// @brief Data container, which contains one of the possibly added values
+    union Data {
+        const char  *str;
+        bool        boolean;
+        int64_t     integer;
+        double      real;
+    };
+
+    /// @brief Data type that the data container of a key-value pair holds
+    enum class DataType: uint8_t {
+        TYPE_BOOL, ///< Key value-pair with a boolean value
+        TYPE_INT, ///< Key value-pair with an integral value
+        TYPE_REAL, ///< Key value-pair with a real (float, double) value
+        TYPE_FIXED, ///< Key value-pair with a real value, rounded and scaled to an integral value with the decimal places of the key-value pair
+        TYPE_STR ///< Key value-pair with a string value
+    };
+
+    /// @brief Scale factor of the given decimal places
+    /// @param decimals Decimal places, needs to be atmost MAX_DECIMALS
+    /// @return 10 to the power of decimals
+    static constexpr uint32_t Power_Of_Ten(uint8_t decimals) {
+        return decimals == 0U ? 1U : 10U * Power_Of_Ten(decimals - 1U);
+    }
+
+    /// @brief Adds a floating point value with the precision policy of its key
+    template <typename T,
+#if THINGSBOARD_ENABLE_STL
+              typename std::enable_if<std::is_floating_point<T>::value>::type* = nullptr>
+#else
+              typename ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::enable_if<ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::is_floating_point<T>::value>::type* = nullptr>
+#endif // THINGSBOARD_ENABLE_STL
+    bool Add_With_Policy(char const * key, T const & value, uint8_t decimals) {
+        return decimals == DEFAULT_DECIMALS ? Add(key, value) : Add(key, value, decimals);
+    }
+
+    /// @brief Adds any other value, the precision policy only applies to floating point values
+    template <typename T,
+#if THINGSBOARD_ENABLE_STL
+              typename std::enable_if<!std::is_floating_point<T>::value>::type* = nullptr>
+#else
+              typename ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::enable_if<!ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::is_floating_point<T>::value>::type* = nullptr>
+#endif // THINGSBOARD_ENABLE_STL
+    bool Add_With_Policy(char const * key, T const & value, uint8_t /*decimals*/) {
+        return Add(key, value);
+    }
+
+    /// @brief Appends the given key-value pair to the seperate arrays
+    /// @param key Key of the key value pair we want to add
+    /// @param type Type of the value in the data container
+    /// @param data Data container holding the value
+    /// @return Whether there was enough space left to add the key-value pair or not
+    bool Add(char const * key, DataType type, Data const & data) {
+        if (key == nullptr || m_size >= MaxKeyValuePairAmount) {
+            return false;
+        }
+        m_keys[m_size] = key;
+        m_key_lengths[m_size] = 0U;
+        m_decimals[m_size] = DEFAULT_DECIMALS;
+        m_types[m_size] = type;
+        m_values[m_size] = data;
+        m_size++;
+        return true;
+    }
+
+    /// @brief Writes all key-value pairs as a json object with the given formatter
+    /// @tparam TWriter Writer the formatter writes into, either counting only or into a buffer
+    /// @param formatter Formatter the json object is written with
+    template <typename TWriter>
+    void Write_Object(Formatter<TWriter> & formatter) const {
+        if (m_timestamp != 0U) {
+            formatter.writeRaw("{\"ts\":");
+            formatter.writeInteger(m_timestamp);
+            formatter.writeRaw(",\"values\":");
+        }
+        formatter.writeRaw('{');
+        for (size_t i = 0U; i < m_size; i++) {
+            if (i != 0U) {
+                formatter.writeRaw(',');
+            }
+            if (m_key_lengths[i] != 0U) {
+                formatter.writeRaw(m_keys[i], m_key_lengths[i]);
+            }
+            else {
+                formatter.writeString(m_keys[i]);
+                formatter.writeRaw(':');
+            }
+            switch (m_types[i]) {
+                case DataType::TYPE_BOOL:
+                    formatter.writeBoolean(m_values[i].boolean);
+                    break;
+                case DataType::TYPE_INT:
+                    formatter.writeInteger(m_values[i].integer);
+                    break;
+                case DataType::TYPE_REAL:
+                    formatter.writeFloat(m_values[i].real);
+                    break;
+                case DataType::TYPE_FIXED:
+                    Write_Fixed(formatter, m_values[i].integer, m_decimals[i]);
+                    break;
+                case DataType::TYPE_STR:
+                    formatter.writeString(m_values[i].str);
+                    break;
+            }
+        }
+        formatter.writeRaw('}');
+        if (m_timestamp != 0U) {
+            formatter.writeRaw('}');
+        }
+    }
+
+#if THINGSBOARD_ENABLE_PROTOBUF
+    /// @brief Whether the key of the given key-value pair is the same as the given unescaped key
+    /// @param index Index of the key-value pair
+    /// @param key Unescaped key to compare with
+    /// @return Whether both keys are equal
+    bool Key_Equals(size_t const & index, char const * key) const {
+        if (m_key_lengths[index] == 0U) {
+            return strcmp(m_keys[index], key) == 0;
+        }
+        // Compare without the quotes and colon of the fragment, keys that needed escaping are never matched
+        size_t const length = m_key_lengths[index] - 3U;
+        return strncmp(m_keys[index] + 1U, key, length) == 0 && key[length] == '\0';
+    }
+
+    /// @brief Writes every key-value pair as the field with the same key in the given schema
+    /// @param writer Writer the fields are written with
+    /// @param first Pointer to the first field of the message schema
+    /// @param last Pointer to the end of the message schema (last field + 1)
+    /// @return Whether every key-value pair has a field in the schema, that its value can be encoded as
+    bool Write_Message(Protobuf_Writer & writer, Proto_Field const * first, Proto_Field const * last) const {
+        for (size_t i = 0U; i < m_size; i++) {
+            Proto_Field const * field = first;
+            while (field != last && !Key_Equals(i, field->key)) {
+                ++field;
+            }
+            if (field == last || !Write_Field(writer, *field, i)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Writes the value of the given key-value pair as the given field
+    /// @param writer Writer the field is written with
+    /// @param field Field the value is encoded as
+    /// @param index Index of the key-value pair
+    /// @return Whether the value can be encoded as the type of the field
+    bool Write_Field(Protobuf_Writer & writer, Proto_Field const & field, size_t const & index) const {
+        Data const & value = m_values[index];
+        bool is_integral = false;
+        int64_t integer = 0;
+        double real = 0.0;
+        switch (m_types[index]) {
+            case DataType::TYPE_BOOL:
+                is_integral = true;
+                integer = value.boolean ? 1 : 0;
+                real = static_cast<double>(integer);
+                break;
+            case DataType::TYPE_INT:
+                is_integral = true;
+                integer = value.integer;
+                real = static_cast<double>(integer);
+                break;
+            case DataType::TYPE_REAL:
+                real = value.real;
+                break;
+            case DataType::TYPE_FIXED:
+                real = static_cast<double>(value.integer) / Power_Of_Ten(m_decimals[index]);
+                break;
+            case DataType::TYPE_STR:
+                if (field.type != Proto_Type::PROTO_STRING) {
+                    return false;
+                }
+                writer.Write_Tag(field.number, Proto_Wire_Type::WIRE_LEN);
+                writer.Write_Length_Delimited(value.str, strlen(value.str));
+                return true;
+        }
+
+        switch (field.type) {
+            case Proto_Type::PROTO_DOUBLE:
+                writer.Write_Tag(field.number, Proto_Wire_Type::WIRE_I64);
+                writer.Write_Double(real);
+                return true;
+            case Proto_Type::PROTO_FLOAT:
+                writer.Write_Tag(field.number, Proto_Wire_Type::WIRE_I32);
+                writer.Write_Float(static_cast<float>(real));
+                return true;
+            case Proto_Type::PROTO_INT32:
+            case Proto_Type::PROTO_SINT32:
+                if (!is_integral || integer < INT32_MIN || integer > INT32_MAX) {
+                    return false;
+                }
+                break;
+            case Proto_Type::PROTO_UINT32:
+                if (!is_integral || integer < 0 || integer > static_cast<int64_t>(UINT32_MAX)) {
+                    return false;
+                }
+                break;
+            case Proto_Type::PROTO_UINT64:
+            case Proto_Type::PROTO_BOOL:
+                if (!is_integral || integer < 0 || (field.type == Proto_Type::PROTO_BOOL && integer > 1)) {
+                    return false;
+                }
+                break;
+            case Proto_Type::PROTO_INT64:
+            case Proto_Type::PROTO_SINT64:
+                if (!is_integral) {
+                    return false;
+                }
+                break;
+            case Proto_Type::PROTO_STRING:
+                return false;
+        }
+
+        writer.Write_Tag(field.number, Proto_Wire_Type::WIRE_VARINT);
+        if (field.type == Proto_Type::PROTO_SINT32 || field.type == Proto_Type::PROTO_SINT64) {
+            writer.Write_Zigzag(integer);
+        }
+        else {
+            writer.Write_Varint(static_cast<uint64_t>(integer));
+        }
+        return true;
+    }
+#endif // THINGSBOARD_ENABLE_PROTOBUF
+
+    /// @brief Writes the given scaled value as a decimal number, trailing zeros of the decimal places are omitted
+    /// @tparam TWriter Writer the formatter writes into, either counting only or into a buffer
+    /// @param formatter Formatter the number is written with
+    /// @param scaled Value multiplied by 10 to the power of decimals
+    /// @param decimals Decimal places of the scaled value
+    template <typename TWriter>
+    static void Write_Fixed(Formatter<TWriter> & formatter, int64_t const & scaled, uint8_t decimals) {
+        uint64_t magnitude = static_cast<uint64_t>(scaled);
+        if (scaled < 0) {
+            formatter.writeRaw('-');
+            magnitude = ~magnitude + 1U;
+        }
+        uint32_t const scale = Power_Of_Ten(decimals);
+        uint32_t fraction = 0U;
+        // Avoid the slow 64 bit division for the common case of values that fit into 32 bits
+        if (magnitude <= UINT32_MAX) {
+            uint32_t const small_magnitude = static_cast<uint32_t>(magnitude);
+            formatter.writeInteger(small_magnitude / scale);
+            fraction = small_magnitude % scale;
+        }
+        else {
+            formatter.writeInteger(magnitude / scale);
+            fraction = static_cast<uint32_t>(magnitude % scale);
+        }
+        if (fraction == 0U) {
+            return;
+        }
+        while (fraction % 10U == 0U) {
+            fraction /= 10U;
+            decimals--;
+        }
+        formatter.writeDecimals(fraction, static_cast<int8_t>(decimals));
+    }
+
+    char const *  m_keys[MaxKeyValuePairAmount] = {};        // Keys of the added key-value pairs, or their "key": fragment
+    size_t        m_key_lengths[MaxKeyValuePairAmount] = {}; // Length of the fragment or 0 if the key is plain and still needs escaping
+    uint8_t       m_decimals[MaxKeyValuePairAmount] = {};    // Decimal places of each TYPE_FIXED value
+    DataType      m_types[MaxKeyValuePairAmount] = {};       // Type of the value of each added key-value pair
+    Data          m_values[MaxKeyValuePairAmount] = {};      // Value of each added key-value pair
+    size_t        m_size = {};                               // Amount of added key-value pairs
+    uint64_t      m_timestamp = {};                          // Unix time in milliseconds the values were acquired at, 0 if not set
+};
+
+#endif // Telemetry_Batch_h
@@ -0,0 +1,84 @@
+#ifndef Telemetry_Range_h
+#define Telemetry_Range_h
+
+// Local includes.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_PROTOBUF
+
+// Local includes.
+#include "Telemetry.h"
+#include "Telemetry_Batch.h"
+
+
+/// @brief Container of Telemetry instances that is encoded as the fields of one single Protobuf message, the same way a Telemetry_Batch with the same key-value pairs is.
+/// Each instance is encoded on its own and the resulting fields are simply concatenated, which is valid because a Protobuf message is nothing more than the sequence of its fields.
+/// Therefore the amount of instances does not need to be known at compile time and nothing is copied, the container needs to live on for as long as the range is used
+/// @tparam InputIterator Class that points to the begin and end iterator
+/// of the given data container, allows for using / passing either std::vector or std::array.
+/// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+template <typename InputIterator>
+class Telemetry_Range {
+  public:
+    /// @brief Constructs a range over the given container
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    Telemetry_Range(InputIterator const & first, InputIterator const & last)
+      : m_first(first)
+      , m_last(last)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Calculates the exact size of the Protobuf message written by Serialize_Protobuf(), without writing anything
+    /// @param first Pointer to the first field of the message schema
+    /// @param last Pointer to the end of the message schema (last field + 1)
+    /// @param size Size of the encoded message
+    /// @return Whether every key-value pair has a field in the schema, that its value can be encoded as
+    bool Measure_Protobuf(Proto_Field const * first, Proto_Field const * last, size_t & size) const {
+        size = 0U;
+        for (InputIterator it = m_first; it != m_last; ++it) {
+            Telemetry_Batch<1U> field;
+            size_t field_size = 0U;
+            if (!(*it).AddToBatch(field) || !field.Measure_Protobuf(first, last, field_size)) {
+                return false;
+            }
+            size += field_size;
+        }
+        return true;
+    }
+
+    /// @brief Writes all key-value pairs as the fields of a Protobuf message with the given schema into the given buffer
+    /// @param first Pointer to the first field of the message schema
+    /// @param last Pointer to the end of the message schema (last field + 1)
+    /// @param buffer Buffer the message is written into
+    /// @param size Size of the buffer, needs to be atleast the size returned by Measure_Protobuf()
+    /// @return Size of the written message or 0 if the buffer was too small or a key-value pair could not be encoded
+    size_t Serialize_Protobuf(Proto_Field const * first, Proto_Field const * last, uint8_t * buffer, size_t const & size) const {
+        if (buffer == nullptr) {
+            return 0U;
+        }
+        size_t written = 0U;
+        for (InputIterator it = m_first; it != m_last; ++it) {
+            Telemetry_Batch<1U> field;
+            if (!(*it).AddToBatch(field)) {
+                return 0U;
+            }
+            // Every encoded field is atleast a tag and a value, therefore 0 always means the field could not be written
+            size_t const field_size = field.Serialize_Protobuf(first, last, buffer + written, size - written);
+            if (field_size == 0U) {
+                return 0U;
+            }
+            written += field_size;
+        }
+        return written;
+    }
+
+  private:
+    InputIterator m_first = {}; // Iterator pointing to the first element in the data container
+    InputIterator m_last = {};  // Iterator pointing to the end of the data container
+};
+
+#endif // THINGSBOARD_ENABLE_PROTOBUF
+
+#endif // Telemetry_Range_h
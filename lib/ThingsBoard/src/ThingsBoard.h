@@ -7,6 +7,11 @@
 #include "IMQTT_Client.h"
 #include "DefaultLogger.h"
 #include "Telemetry.h"
+#include "Telemetry_Batch.h"
+#include "Telemetry_Range.h"
+#include "Json_Arena.h"
+#include "Topic_Router.h"
+#include "Timeout_Wheel.h"
 
 // Library includes.
 #if THINGSBOARD_ENABLE_STREAM_UTILS
@@ -19,12 +24,16 @@ char constexpr PROV_ACCESS_TOKEN[] = "provision";
 // Log messages.
 char constexpr UNABLE_TO_DE_SERIALIZE_JSON[] = "Unable to de-serialize received json data with error (DeserializationError::%s)";
 char constexpr INVALID_BUFFER_SIZE[] = "Send buffer size (%u) to small for the given payloads size (%u), increase with setBufferSize accordingly or install the StreamUtils library";
+char constexpr JSON_NESTING_EXCEEDED[] = "Discarding received json data nested deeper than the nesting limit (%u), increase ARDUINOJSON_DEFAULT_NESTING_LIMIT accordingly";
 char constexpr UNABLE_TO_ALLOCATE_BUFFER[] = "Allocating memory for the internal MQTT buffer failed";
 char constexpr MAX_ENDPOINTS_AMOUNT_TEMPLATE_NAME[] = "MaxEndpointsAmount";
 #if THINGSBOARD_ENABLE_DYNAMIC
 char constexpr MAXIMUM_RESPONSE_EXCEEDED[] = "Prevented allocation on the heap (%u) for JsonDocument. Discarding message that is bigger than maximum response size (%u)";
 char constexpr HEAP_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for JsonDocument. Ensure there is enough heap memory left";
 #endif // THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_PROTOBUF
+char constexpr UNABLE_TO_ENCODE_PROTOBUF[] = "Unable to encode Protobuf message, ensure every key has a field with a compatible type in the schema";
+#endif // THINGSBOARD_ENABLE_PROTOBUF
 #if THINGSBOARD_ENABLE_DEBUG
 char constexpr RECEIVE_MESSAGE[] = "Received (%u) bytes of data from server over topic (%s)";
 char constexpr ALLOCATING_JSON[] = "Allocated internal JsonDocument for MQTT server response with size (%u)";
@@ -33,6 +42,8 @@ char constexpr SEND_SERIALIZED[] = "Hidden, because json data is bigger than buf
 #endif // THINGSBOARD_ENABLE_DEBUG
 // Claim topics.
 char constexpr CLAIM_TOPIC[] = "v1/devices/me/claim";
+// Bytes of the send buffer used by the MQTT publish packet itself, fixed header with the remaining length and the length of the topic.
+size_t constexpr MQTT_PUBLISH_OVERHEAD = 7U;
 // Claim data keys.
 char constexpr SECRET_KEY[] = "secretKey";
 char constexpr DURATION_KEY[] = "durationMs";
@@ -130,6 +141,7 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_STL
             api->Initialize();
         }
+        m_topic_router.Build(m_api_implementations.begin(), m_api_implementations.end());
         (void)setBufferSize(receive_buffer_size, send_buffer_size);
         // Initialize callback.
 #if THINGSBOARD_ENABLE_STL
@@ -177,6 +189,14 @@ class ThingsBoardSized {
     void setMaxResponseSize(size_t const & max_response_size) {
         m_max_response_size = max_response_size;
     }
+
+    /// @brief Gets the biggest size the internal JsonDocument holding a received payload has ever required.
+    /// The memory for that JsonDocument is kept between messages and only grown if a bigger payload is received, meaning the arena currently reserves atleast this amount of bytes on the heap.
+    /// Can be used to find a fitting value for setMaxResponseSize(), after the device received every kind of message it expects atleast once
+    /// @return Biggest amount of bytes ever required to deserialize a received payload
+    size_t getReceiveArenaHighWaterMark() const {
+        return m_receive_arena.High_Water_Mark();
+    }
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 
     /// @brief Sets the size of the buffer for the underlying network client that will be used to establish the connection to ThingsBoard.
@@ -248,17 +268,16 @@ class ThingsBoardSized {
     }
 
     /// @brief Receives / sends any outstanding messages from and to the MQTT broker.
-    /// Additionally when not being able to use the ESP Timer, it updates the internal timeout timers
+    /// Additionally it ticks the global timer wheel, which calls the callbacks of every internal timeout timer that has expired, and expires timed out requests
     /// @return Whether sending or receiving the oustanding the messages was successful or not
     bool loop() {
-#if !THINGSBOARD_USE_ESP_TIMER
+        Timeout_Wheel::Get_Instance().tick();
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
                 continue;
             }
             api->loop();
         }
-#endif // !THINGSBOARD_USE_ESP_TIMER
         return m_client.loop();
     }
 
@@ -296,7 +315,20 @@ class ThingsBoardSized {
         // if it would allocate the memory on the heap instead to ensure no stack overflow occurs
         else
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
-        if (json_size > getMaximumStackSize()) {
+        // Serialize directly into the send buffer of the client, behind the already written topic,
+        // removes the temporary buffer as well as copying and measuring the payload again before it is sent
+        if (uint8_t * const payload = m_client.reserve_publish(topic, json_size)) {
+            size_t const written = serializeJson(source, payload, json_size);
+            if (written < json_size - 1) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                return result;
+            }
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(SEND_MESSAGE, topic, reinterpret_cast<char const *>(payload));
+#endif // THINGSBOARD_ENABLE_DEBUG
+            result = m_client.commit_publish(written);
+        }
+        else if (json_size > getMaximumStackSize()) {
             char* json = new char[json_size]();
             if (serializeJson(source, json, json_size) < json_size - 1) {
                 Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
@@ -361,6 +393,7 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_STL
         api.Initialize();
         m_api_implementations.push_back(&api);
+        m_topic_router.Build(m_api_implementations.begin(), m_api_implementations.end());
     }
 
     /// @brief Copies the non-owning pointers to the given API implementations, into the local data container.
@@ -393,6 +426,7 @@ class ThingsBoardSized {
             api->Initialize();
         }
         m_api_implementations.insert(m_api_implementations.end(), first, last);
+        m_topic_router.Build(m_api_implementations.begin(), m_api_implementations.end());
     }
 
     //----------------------------------------------------------------------------
@@ -430,6 +464,19 @@ class ThingsBoardSized {
         return sendKeyValue(key, value);
     }
 
+    /// @brief Attempts to send telemetry data with the given pre-escaped key and value of the given type.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @tparam KeySize Size of the string literal the key was created from
+    /// @tparam T Type of the passed value
+    /// @param key Key of the key value pair we want to send, quoted and escaped at compile time
+    /// @param value Value of the key value pair we want to send
+    /// @return Whether sending the data was successful or not
+    template<size_t KeySize, typename T>
+    bool sendTelemetryData(Json_Key<KeySize> const & key, T const & value) {
+        Telemetry_Batch<1U> batch;
+        return batch.Add(key, value) && Send_Batch(batch, true);
+    }
+
     /// @brief Attempts to send aggregated telemetry data, expects iterators to a container containing Telemetry class instances.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @tparam InputIterator Class that points to the begin and end iterator
@@ -453,6 +500,94 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_DYNAMIC
     }
 
+    /// @brief Attempts to send all key-value pairs of the given batch as telemetry data, without building a JsonDocument.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @tparam MaxKeyValuePairAmount Maximum amount of key-value pairs the batch can hold
+    /// @param batch Batch containing the key-value pairs we want to send
+    /// @return Whether sending the telemetry data was successful or not
+    template<size_t MaxKeyValuePairAmount>
+    bool sendTelemetry(Telemetry_Batch<MaxKeyValuePairAmount> const & batch) {
+        return Send_Batch(batch, true);
+    }
+
+    /// @brief Attempts to send multiple timestamped samples as telemetry data, each sample is a Telemetry_Batch with the timestamp set to the acquisition time.
+    /// Samples are sent as [{"ts":..,"values":{..}},..] and as many samples as fit into the send buffer are combined into one message,
+    /// more samples are automatically split into multiple messages. Always sent as json, even if a Protobuf telemetry schema is set.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @tparam InputIterator Class that points to the begin and end iterator of a container of Telemetry_Batch instances,
+    /// allows for using / passing either std::vector, std::array or a plain array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first sample in the data container
+    /// @param last Iterator pointing to the end of the data container (last sample + 1)
+    /// @return Whether sending all samples was successful or not, samples that do not fit into the send buffer on their own are skipped
+    template<typename InputIterator>
+    bool sendTelemetrySamples(InputIterator const & first, InputIterator const & last) {
+        size_t const send_buffer_size = m_client.get_send_buffer_size();
+        // Topic without its null terminator, but the samples are serialized with one, which is not sent
+        size_t const overhead = MQTT_PUBLISH_OVERHEAD + sizeof(TELEMETRY_TOPIC);
+        if (send_buffer_size <= overhead) {
+            return false;
+        }
+        size_t const capacity = send_buffer_size - overhead;
+        bool result = true;
+
+        InputIterator chunk_first = first;
+        while (chunk_first != last) {
+            // Opening bracket, followed by every sample with either a comma or the closing bracket
+            size_t chunk_length = 1U;
+            size_t sample_length = 0U;
+            InputIterator chunk_last = chunk_first;
+            while (chunk_last != last) {
+                sample_length = (*chunk_last).Measure_Json();
+                if (chunk_length + sample_length + 1U > capacity) {
+                    break;
+                }
+                chunk_length += sample_length + 1U;
+                ++chunk_last;
+            }
+
+            if (chunk_last == chunk_first) {
+                Logger::printfln(INVALID_BUFFER_SIZE, send_buffer_size, sample_length + 1U + overhead);
+                result = false;
+                ++chunk_first;
+                continue;
+            }
+
+            uint8_t * payload = m_client.reserve_publish(TELEMETRY_TOPIC, chunk_length + 1U);
+            // Only needed if the client does not support writing into its send buffer, the memory is kept and reused by every following message
+            char * json = payload != nullptr ? reinterpret_cast<char *>(payload) : static_cast<char *>(m_send_arena.Allocate(chunk_length + 1U));
+            if (json == nullptr) {
+                Logger::printfln(UNABLE_TO_ALLOCATE_BUFFER);
+                return false;
+            }
+
+            size_t written = 0U;
+            json[written++] = '[';
+            for (InputIterator it = chunk_first; it != chunk_last; ++it) {
+                written += (*it).Serialize_Json(json + written, chunk_length + 1U - written);
+                json[written++] = ',';
+            }
+            json[written - 1U] = ']';
+            json[written] = '\0';
+
+            if (written != chunk_length) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                result = false;
+            }
+            else {
+#if THINGSBOARD_ENABLE_DEBUG
+                Logger::printfln(SEND_MESSAGE, TELEMETRY_TOPIC, json);
+#endif // THINGSBOARD_ENABLE_DEBUG
+                result = (payload != nullptr ? m_client.commit_publish(written) : m_client.publish(TELEMETRY_TOPIC, reinterpret_cast<uint8_t const *>(json), written)) && result;
+            }
+            if (payload == nullptr) {
+                m_send_arena.Deallocate(json);
+            }
+            chunk_first = chunk_last;
+        }
+        return result;
+    }
+
     /// @brief Attempts to send custom json telemetry string.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @param json String containing our json key value pairs we want to attempt to send
@@ -485,6 +620,19 @@ class ThingsBoardSized {
         return sendKeyValue(key, value, false);
     }
 
+    /// @brief Attempts to send attribute data with the given pre-escaped key and value of the given type.
+    /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
+    /// @tparam KeySize Size of the string literal the key was created from
+    /// @tparam T Type of the passed value
+    /// @param key Key of the key value pair we want to send, quoted and escaped at compile time
+    /// @param value Value of the key value pair we want to send
+    /// @return Whether sending the data was successful or not
+    template<size_t KeySize, typename T>
+    bool sendAttributeData(Json_Key<KeySize> const & key, T const & value) {
+        Telemetry_Batch<1U> batch;
+        return batch.Add(key, value) && Send_Batch(batch, false);
+    }
+
     /// @brief Attempts to send aggregated attribute data, expects iterators to a container containing Attribute class instances.
     /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
     /// @tparam InputIterator Class that points to the begin and end iterator
@@ -508,6 +656,16 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_DYNAMIC
     }
 
+    /// @brief Attempts to send all key-value pairs of the given batch as attribute data, without building a JsonDocument.
+    /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
+    /// @tparam MaxKeyValuePairAmount Maximum amount of key-value pairs the batch can hold
+    /// @param batch Batch containing the key-value pairs we want to send
+    /// @return Whether sending the attribute data was successful or not
+    template<size_t MaxKeyValuePairAmount>
+    bool sendAttributes(Telemetry_Batch<MaxKeyValuePairAmount> const & batch) {
+        return Send_Batch(batch, false);
+    }
+
     /// @brief Attempts to send custom json attribute string.
     /// See https://thingsboard.io/docs/user-guide/attributes/ for more information
     /// @param json String containing our json key value pairs we want to attempt to send
@@ -526,6 +684,33 @@ class ThingsBoardSized {
         return Send_Json(ATTRIBUTE_TOPIC, source, json_size);
     }
 
+#if THINGSBOARD_ENABLE_PROTOBUF
+    //----------------------------------------------------------------------------
+    // Protobuf API
+
+    /// @brief Sets the schema telemetry data is encoded with as Protobuf messages instead of json,
+    /// has to match the telemetry .proto schema of the ThingsBoard device profile. Affects every sendTelemetry() and sendTelemetryData() overload,
+    /// except sendTelemetryJson() and sendTelemetryString(), which send the already serialized json as is, and sendTelemetrySamples(), because the schema can not describe timestamped samples.
+    /// See https://thingsboard.io/docs/user-guide/device-profiles/#mqtt-device-payload for more information
+    /// @param first Pointer to the first field of the schema, has to live on for as long as the instance of this class
+    /// @param last Pointer to the end of the schema (last field + 1), passing the same pointer as first sends json again
+    void Set_Telemetry_Schema(Proto_Field const * first, Proto_Field const * last) {
+        m_telemetry_schema_first = first;
+        m_telemetry_schema_last = last;
+    }
+
+    /// @brief Sets the schema attribute data is encoded with as Protobuf messages instead of json,
+    /// has to match the attributes .proto schema of the ThingsBoard device profile. Affects every sendAttributes() and sendAttributeData() overload,
+    /// except sendAttributeJson() and sendAttributeString(), which send the already serialized json as is.
+    /// See https://thingsboard.io/docs/user-guide/device-profiles/#mqtt-device-payload for more information
+    /// @param first Pointer to the first field of the schema, has to live on for as long as the instance of this class
+    /// @param last Pointer to the end of the schema (last field + 1), passing the same pointer as first sends json again
+    void Set_Attribute_Schema(Proto_Field const * first, Proto_Field const * last) {
+        m_attribute_schema_first = first;
+        m_attribute_schema_last = last;
+    }
+#endif // THINGSBOARD_ENABLE_PROTOBUF
+
   private:
 #if THINGSBOARD_ENABLE_STREAM_UTILS
     /// @brief Serialize the custom attribute source into the underlying client.
@@ -641,6 +826,12 @@ class ThingsBoardSized {
         if (t.IsEmpty()) {
             return false;
         }
+#if THINGSBOARD_ENABLE_PROTOBUF
+        if (Has_Schema(telemetry)) {
+            Telemetry_Batch<1U> batch;
+            return t.AddToBatch(batch) && Send_Batch(batch, telemetry);
+        }
+#endif // THINGSBOARD_ENABLE_PROTOBUF
 
         StaticJsonDocument<JSON_OBJECT_SIZE(1)> json_buffer;
         if (!t.SerializeKeyValue(json_buffer)) {
@@ -667,16 +858,23 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_DYNAMIC
     bool sendDataArray(InputIterator const & first, InputIterator const & last, bool telemetry) {
         size_t const size = Helper::distance(first, last);
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        if (size > MaxKeyValuePairAmount) {
+            Logger::printfln(TOO_MANY_JSON_FIELDS, size, "MaxKeyValuePairAmount", MaxKeyValuePairAmount);
+            return false;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_PROTOBUF
+        if (Has_Schema(telemetry)) {
+            return size != 0U && Send_Protobuf(telemetry, Telemetry_Range<InputIterator>(first, last));
+        }
+#endif // THINGSBOARD_ENABLE_PROTOBUF
 #if THINGSBOARD_ENABLE_DYNAMIC
         // char const * are stored as only a pointer inside the JsonDocument --> zero copy, meaning the size for the strings is 0 bytes.
         // Data structure size, therefore only depends on the amount of key value pairs passed.
         // See https://arduinojson.org/v6/assistant/ for more information on the needed size for the JsonDocument
         TBJsonDocument json_buffer(JSON_OBJECT_SIZE(size));
 #else
-        if (size > MaxKeyValuePairAmount) {
-            Logger::printfln(TOO_MANY_JSON_FIELDS, size, "MaxKeyValuePairAmount", MaxKeyValuePairAmount);
-            return false;
-        }
         StaticJsonDocument<JSON_OBJECT_SIZE(MaxKeyValuePairAmount)> json_buffer;
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 
@@ -697,6 +895,120 @@ class ThingsBoardSized {
         return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer)) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer));
     }
 
+    /// @brief Attempts to send all key-value pairs of the given batch as attribute or telemetry data.
+    /// The exact json length is known beforehand, therefore the json is written in one pass directly into the send buffer of the client if supported,
+    /// or otherwise into a temporary buffer that is then published
+    /// @tparam MaxKeyValuePairAmount Maximum amount of key-value pairs the batch can hold
+    /// @param batch Batch containing the key-value pairs we want to send
+    /// @param telemetry Whether the data we want to send should be sent over the attribute or telemtry topic
+    /// @return Whether sending the data was successful or not
+    template<size_t MaxKeyValuePairAmount>
+    bool Send_Batch(Telemetry_Batch<MaxKeyValuePairAmount> const & batch, bool telemetry) {
+        if (batch.Empty()) {
+            return false;
+        }
+#if THINGSBOARD_ENABLE_PROTOBUF
+        if (Has_Schema(telemetry)) {
+            return Send_Protobuf(telemetry, batch);
+        }
+#endif // THINGSBOARD_ENABLE_PROTOBUF
+        char const * const topic = telemetry ? TELEMETRY_TOPIC : ATTRIBUTE_TOPIC;
+        size_t const json_size = batch.Measure_Json() + 1U;
+        bool result = false;
+
+        if (uint8_t * const payload = m_client.reserve_publish(topic, json_size)) {
+            size_t const written = batch.Serialize_Json(reinterpret_cast<char *>(payload), json_size);
+            if (written != json_size - 1U) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                return result;
+            }
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(SEND_MESSAGE, topic, reinterpret_cast<char const *>(payload));
+#endif // THINGSBOARD_ENABLE_DEBUG
+            result = m_client.commit_publish(written);
+        }
+        else if (json_size > getMaximumStackSize()) {
+            char* json = new char[json_size]();
+            if (batch.Serialize_Json(json, json_size) != json_size - 1U) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            }
+            else {
+                result = Send_Json_String(topic, json);
+            }
+            delete[] json;
+            json = nullptr;
+        }
+        else {
+            char json[json_size] = {};
+            if (batch.Serialize_Json(json, json_size) != json_size - 1U) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                return result;
+            }
+            result = Send_Json_String(topic, json);
+        }
+
+        return result;
+    }
+
+#if THINGSBOARD_ENABLE_PROTOBUF
+    /// @brief Whether attribute or telemetry data is encoded as Protobuf messages instead of json
+    /// @param telemetry Whether the schema of the telemetry or of the attribute data is checked
+    /// @return Whether a schema has been set or not
+    bool Has_Schema(bool telemetry) const {
+        return telemetry ? m_telemetry_schema_first != m_telemetry_schema_last : m_attribute_schema_first != m_attribute_schema_last;
+    }
+
+    /// @brief Attempts to send all key-value pairs of the given batch or range as a Protobuf message with the attribute or telemetry schema.
+    /// The message is a plain Protobuf message without a length prefix, because the MQTT packet already contains the length and ThingsBoard parses the payload as exactly one message.
+    /// The message is encoded directly into the send buffer of the client if supported, or otherwise into a temporary buffer that is then published
+    /// @tparam TValues Either a Telemetry_Batch or a Telemetry_Range
+    /// @param telemetry Whether the data we want to send should be sent over the attribute or telemtry topic
+    /// @param values Batch or range containing the key-value pairs we want to send
+    /// @return Whether sending the data was successful or not
+    template<typename TValues>
+    bool Send_Protobuf(bool telemetry, TValues const & values) {
+        char const * const topic = telemetry ? TELEMETRY_TOPIC : ATTRIBUTE_TOPIC;
+        Proto_Field const * const first = telemetry ? m_telemetry_schema_first : m_attribute_schema_first;
+        Proto_Field const * const last = telemetry ? m_telemetry_schema_last : m_attribute_schema_last;
+        size_t message_size = 0U;
+        if (!values.Measure_Protobuf(first, last, message_size)) {
+            Logger::printfln(UNABLE_TO_ENCODE_PROTOBUF);
+            return false;
+        }
+        bool result = false;
+
+        if (uint8_t * const payload = m_client.reserve_publish(topic, message_size)) {
+            size_t const written = values.Serialize_Protobuf(first, last, payload, message_size);
+            if (written != message_size) {
+                Logger::printfln(UNABLE_TO_ENCODE_PROTOBUF);
+                return result;
+            }
+            result = m_client.commit_publish(written);
+        }
+        else if (message_size > getMaximumStackSize()) {
+            uint8_t* message = new uint8_t[message_size]();
+            if (values.Serialize_Protobuf(first, last, message, message_size) != message_size) {
+                Logger::printfln(UNABLE_TO_ENCODE_PROTOBUF);
+            }
+            else {
+                result = m_client.publish(topic, message, message_size);
+            }
+            delete[] message;
+            message = nullptr;
+        }
+        else {
+            uint8_t message[message_size] = {};
+            if (values.Serialize_Protobuf(first, last, message, message_size) != message_size) {
+                Logger::printfln(UNABLE_TO_ENCODE_PROTOBUF);
+                return result;
+            }
+            result = m_client.publish(topic, message, message_size);
+        }
+
+        return result;
+    }
+#endif // THINGSBOARD_ENABLE_PROTOBUF
+
     /// @brief MQTT callback that will be called if a publish message is received from the server
     /// Payload contains data from the internal buffer of the MQTT client,
     /// therefore the buffer and the specific memory region the payload points too and the following length bytes need to live on for as long as this method has not finished.
@@ -712,48 +1024,48 @@ class ThingsBoardSized {
         Logger::printfln(RECEIVE_MESSAGE, length, topic);
 #endif // THINGSBOARD_ENABLE_DEBUG
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_CXX20
-        auto filtered_raw_api_implementations = m_api_implementations | std::views::filter([&topic](IAPI_Implementation const * api) {
-#else
-#if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<IAPI_Implementation *> filtered_raw_api_implementations = {};
-#else
-        Array<IAPI_Implementation *, MaxEndpointsAmount> filtered_raw_api_implementations = {};
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-        std::copy_if(m_api_implementations.begin(), m_api_implementations.end(), std::back_inserter(filtered_raw_api_implementations), [&topic](IAPI_Implementation const * api) {
-#endif // THINGSBOARD_ENABLE_CXX20
-            return (api != nullptr && api->Get_Process_Type() == API_Process_Type::RAW && api->Compare_Response_Topic(topic));
-        });
-
-        for (auto & api : filtered_raw_api_implementations) {
+        // Finds every api implementation that could handle the topic with one walk over the prefix trie, without allocating memory
+        Topic_Route const route = m_topic_router.Route(topic);
+        bool processed_response_as_raw = false;
+        for (auto it = route.first; it != route.raw_last; ++it) {
+            IAPI_Implementation * api = *it;
+            if (!api->Compare_Response_Topic(topic)) {
+                continue;
+            }
             api->Process_Response(topic, payload, length);
+            processed_response_as_raw = true;
         }
 
-        // If the filtered api implementations was not emtpy it means the response was processed as its raw bytes representation atleast once,
-        // and because we interpreted it as raw bytes instead of json, we skip the further processing of those raw bytes as json.
+        // If the response was processed as its raw bytes representation atleast once, we skip the further processing of those raw bytes as json.
         // We do that because the received response is in that case not even valid json in the first place and would therefore simply fail deserialization
-        if (!filtered_raw_api_implementations.empty()) {
+        if (processed_response_as_raw) {
             return;
         }
-#else
-        bool processed_response_as_raw = false;
-        for (auto & api : m_api_implementations) {
-            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::RAW || !api->Compare_Response_Topic(topic)) {
+
+        // Api implementations processing the response as json events each walk over the unmodified payload with their own parser,
+        // which neither counts the elements of the payload nor allocates a JsonDocument for it
+        for (auto it = route.raw_last; it != route.events_last; ++it) {
+            IAPI_Implementation * api = *it;
+            if (!api->Compare_Response_Topic(topic)) {
                 continue;
             }
-            api->Process_Response(topic, payload, length);
-            processed_response_as_raw = true;
+            Json_Pull_Parser parser(payload, length, ARDUINOJSON_DEFAULT_NESTING_LIMIT);
+            api->Process_Json_Events(topic, parser);
         }
 
-        if (processed_response_as_raw) {
+        // Nothing has to be deserialized if the response was not routed to any api implementation processing it as json
+        if (route.events_last == route.last) {
             return;
         }
-#endif // THINGSBOARD_ENABLE_STL
 
         // Calculate size with the total amount of commas, always denotes the end of a key-value pair besides for the last element in an array or in an object where the comma is not permitted,
-        // therfore we have to add the space for another key-value pair for all the occurences of thoose symbols as well
-        size_t const size = Helper::getOccurences(payload, ',', length) + Helper::getOccurences(payload, '{', length) + Helper::getOccurences(payload, '[', length);
+        // therfore we have to add the space for another key-value pair for all the occurences of thoose symbols as well.
+        // Payloads nested deeper than deserializeJson allows are discarded in the same pass, before any memory is allocated for them
+        size_t size = 0U;
+        if (!Helper::countJsonElements(payload, length, ARDUINOJSON_DEFAULT_NESTING_LIMIT, size)) {
+            Logger::printfln(JSON_NESTING_EXCEEDED, ARDUINOJSON_DEFAULT_NESTING_LIMIT);
+            return;
+        }
 #if THINGSBOARD_ENABLE_DYNAMIC
         // Buffer that we deserialize is writeable and not read only and therefore stored as a pointer inside the JsonDocument --> zero copy, meaning the size for the received payload is 0 bytes.
         // Data structure size, therefore only depends on the amount of key value pairs received.
@@ -763,9 +1075,10 @@ class ThingsBoardSized {
             Logger::printfln(MAXIMUM_RESPONSE_EXCEEDED, document_size, m_max_response_size);
             return;
         }
-        TBJsonDocument json_buffer(document_size);
+        // Memory is taken from the receive arena, which is only grown if the payload is bigger than any payload received before, therefore handling messages does not allocate on the heap once the arena is big enough
+        TBArenaJsonDocument json_buffer(document_size, Json_Arena_Allocator(m_receive_arena));
         // Because we calcualte the allocation dynamically fromt he payload, which is user input, it could theoretically be malicious ({ "malicious" : "{{{{{{{{{..."}) and contain a lot of the symbols used to calculate the size.
-        // But if that is the case adn the allocation still succeeds we delete the allocated memory relatively fast again so it shouldn't be a problem and if the allocation fails we simply return at this point with an appropriate error message
+        // If that is the case and the allocation still succeeds the arena keeps that memory until the instance is destroyed, so setMaxResponseSize() should be used to limit the size and if the allocation fails we simply return at this point with an appropriate error message
         if (json_buffer.capacity() != document_size) {
             Logger::printfln(HEAP_ALLOCATION_FAILED, document_size);
             return;
@@ -782,40 +1095,66 @@ class ThingsBoardSized {
         Logger::printfln(ALLOCATING_JSON, document_size);
 #endif // THINGSBOARD_ENABLE_DEBUG
 
+        // Api implementations the response is routed to can restrict deserialization to the fields they actually use, every other field is skipped while parsing
+        // and does not use any memory in the JsonDocument. If atleast one of them requires the complete payload, nothing is filtered
+        JsonDocument const * json_filter = nullptr;
+        size_t filter_count = 0U;
+        size_t filter_size = 0U;
+        for (auto it = route.events_last; it != route.last; ++it) {
+            IAPI_Implementation const * api = *it;
+            if (!api->Compare_Response_Topic(topic)) {
+                continue;
+            }
+            JsonDocument const * api_filter = api->Get_Json_Filter();
+            if (api_filter == nullptr) {
+                filter_count = 0U;
+                break;
+            }
+            json_filter = api_filter;
+            filter_count++;
+            filter_size += api_filter->memoryUsage();
+        }
+#if THINGSBOARD_ENABLE_DYNAMIC
+        // Filters only have to be merged if multiple api implementations handle the same response, the memory for the merged filter is reused like the one for the received payload
+        TBArenaJsonDocument merged_filter(filter_count > 1U ? filter_size : 0U, Json_Arena_Allocator(m_filter_arena));
+        if (filter_count > 1U) {
+            for (auto it = route.events_last; it != route.last; ++it) {
+                IAPI_Implementation const * api = *it;
+                if (api->Compare_Response_Topic(topic)) {
+                    Helper::mergeJsonFilter(merged_filter.as<JsonVariant>(), api->Get_Json_Filter()->as<JsonVariantConst>());
+                }
+            }
+            json_filter = &merged_filter;
+            if (merged_filter.overflowed()) {
+                filter_count = 0U;
+            }
+        }
+#else
+        // Merging requires a JsonDocument sized at runtime, therefore nothing is filtered if multiple api implementations handle the same response
+        if (filter_count > 1U) {
+            filter_count = 0U;
+        }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        if (filter_count == 0U) {
+            json_filter = nullptr;
+        }
+
         // The deserializeJson method we use, can use the zero copy mode because a writeable input was passed,
         // if that were not the case the needed allocated memory would drastically increase, because the keys would need to be copied as well.
         // See https://arduinojson.org/v6/doc/deserialization/ for more info on ArduinoJson deserialization
-        DeserializationError const error = deserializeJson(json_buffer, payload, length);
+        DeserializationError const error = (json_filter != nullptr) ? deserializeJson(json_buffer, payload, length, DeserializationOption::Filter(json_filter->as<JsonVariantConst>())) : deserializeJson(json_buffer, payload, length);
         if (error) {
             Logger::printfln(UNABLE_TO_DE_SERIALIZE_JSON, error.c_str());
             return;
         }
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_CXX20
-        auto filtered_json_api_implementations = m_api_implementations | std::views::filter([&topic](IAPI_Implementation const * api) {
-#else
-#if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<IAPI_Implementation *> filtered_json_api_implementations = {};
-#else
-        Array<IAPI_Implementation *, MaxEndpointsAmount> filtered_json_api_implementations = {};
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-        std::copy_if(m_api_implementations.begin(), m_api_implementations.end(), std::back_inserter(filtered_json_api_implementations), [&topic](IAPI_Implementation const * api) {
-#endif // THINGSBOARD_ENABLE_CXX20
-            return (api != nullptr && api->Get_Process_Type() == API_Process_Type::JSON && api->Compare_Response_Topic(topic));
-        });
-
-        for (auto & api : filtered_json_api_implementations) {
-            api->Process_Json_Response(topic, json_buffer);
-        }
-#else
-        for (auto & api : m_api_implementations) {
-            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::JSON || !api->Compare_Response_Topic(topic)) {
+        for (auto it = route.events_last; it != route.last; ++it) {
+            IAPI_Implementation * api = *it;
+            if (!api->Compare_Response_Topic(topic)) {
                 continue;
             }
             api->Process_Json_Response(topic, json_buffer);
         }
-#endif // THINGSBOARD_ENABLE_STL
     }
 
 #if !THINGSBOARD_ENABLE_STL
@@ -908,12 +1247,23 @@ class ThingsBoardSized {
 #if THINGSBOARD_ENABLE_STREAM_UTILS
     size_t                                          m_buffering_size = {};      // Buffering size used to serialize directly into client.
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
+    Json_Arena                                      m_send_arena = {};          // Memory reused by the messages of sendTelemetrySamples(), if the client does not support writing into its send buffer, only grows
 #if !THINGSBOARD_ENABLE_DYNAMIC
     Array<IAPI_Implementation*, MaxEndpointsAmount> m_api_implementations = {}; // Can hold a pointer to all possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+    Topic_Router<MaxEndpointsAmount>                m_topic_router = {};        // Routes received responses to the subscribed API implementations
 #else
     size_t                                          m_max_response_size = {};   // Maximum size allocated on the heap to hold the Json data structure for received cloud response payload, prevents possible malicious payload allocaitng a lot of memory
+    Json_Arena                                      m_receive_arena = {};       // Memory reused by the Json data structure of every received cloud response payload, only grows
+    Json_Arena                                      m_filter_arena = {};        // Memory reused by the merged filter, if a received cloud response payload is handled by multiple api implementations, only grows
     Vector<IAPI_Implementation*>                    m_api_implementations = {}; // Can hold a pointer to all  possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+    Topic_Router                                    m_topic_router = {};        // Routes received responses to the subscribed API implementations
 #endif // !THINGSBOARD_ENABLE_DYNAMIC                
+#if THINGSBOARD_ENABLE_PROTOBUF
+    Proto_Field const *                             m_telemetry_schema_first = {}; // Schema telemetry data is encoded with, json is sent if first and last are equal
+    Proto_Field const *                             m_telemetry_schema_last = {};
+    Proto_Field const *                             m_attribute_schema_first = {}; // Schema attribute data is encoded with, json is sent if first and last are equal
+    Proto_Field const *                             m_attribute_schema_last = {};
+#endif // THINGSBOARD_ENABLE_PROTOBUF
 };
 
 #if !THINGSBOARD_ENABLE_STL
@@ -0,0 +1,224 @@
+#ifndef Timeout_Wheel_h
+#define Timeout_Wheel_h
+
+// Local includes.
+#include "Callback.h"
+
+// Library includes.
+#include <stddef.h>
+#include <stdint.h>
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#else
+#include <Arduino.h>
+#endif // THINGSBOARD_USE_ESP_TIMER
+
+
+// Amount of bits the time in microseconds is shifted by to receive the tick of the wheel, meaning one tick is 4096 microseconds long
+size_t constexpr TIMEOUT_WHEEL_TICK_BITS = 12U;
+// Amount of slots the wheel consists of, has to be a power of two. One revolution of the wheel is therefore 64 * 4096 microseconds long
+size_t constexpr TIMEOUT_WHEEL_SLOTS = 64U;
+
+
+/// @brief Links of the intrusive circular doubly linked lists the timer wheel consists of,
+/// used on its own for the list heads of each slot, so that they do not have to contain a callback
+class Timeout_Link {
+  public:
+    /// @brief Constructs an unlinked entry
+    Timeout_Link() = default;
+
+  protected:
+    friend class Timeout_Wheel;
+
+    /// @brief Removes the entry from the list it is part of, does nothing if it is not part of any list.
+    /// Does not require knowing the list, because every list is circular and closed by its head
+    void Unlink() {
+        if (m_next == nullptr) {
+            return;
+        }
+        m_previous->m_next = m_next;
+        m_next->m_previous = m_previous;
+        m_next = nullptr;
+        m_previous = nullptr;
+    }
+
+    /// @brief Inserts the entry at the end of the list with the given head, meaning right in front of the head
+    /// @param head Head of the list, has to be linked to itself if the list is empty
+    void Link_Before(Timeout_Link & head) {
+        m_next = &head;
+        m_previous = head.m_previous;
+        head.m_previous->m_next = this;
+        head.m_previous = this;
+    }
+
+    Timeout_Link *m_next = {};     // Next entry in the list, nullptr if the entry is not part of any list
+    Timeout_Link *m_previous = {}; // Previous entry in the list, nullptr if the entry is not part of any list
+};
+
+
+/// @brief Timer that is embedded into the class that wants to be informed once a timeout has passed, instead of creating a timer object for every timeout.
+/// Arming and cancelling only links and unlinks the node from a slot of the global Timeout_Wheel, which is why the node is never copied together with its links.
+/// A copy is therefore always unarmed and an armed node is cancelled automatically once it is destroyed
+class Timeout_Node : public Timeout_Link, public Callback<void> {
+  public:
+    /// @brief Constructs empty timer node, will result in never being called. Internals are simply default constructed as nullptr
+    Timeout_Node() = default;
+
+    /// @brief Constructs timer node, will be called once the time it was armed with has passed without Cancel() being called
+    /// @param callback Callback method that will be called
+    explicit Timeout_Node(function callback)
+      : Timeout_Link()
+      , Callback(callback)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Copy constructor, only copies the callback, because the links belong to the instance that was armed
+    /// @param other Timer node to copy the callback from
+    Timeout_Node(Timeout_Node const & other)
+      : Timeout_Link()
+      , Callback(other)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Copy assignment, cancels this instance and copies the callback, because the links belong to the instance that was armed
+    /// @param other Timer node to copy the callback from
+    /// @return Reference to this instance
+    Timeout_Node & operator=(Timeout_Node const & other) {
+        if (this != &other) {
+            Cancel();
+            Callback::operator=(other);
+        }
+        return *this;
+    }
+
+    /// @brief Destructor, cancels the timer so that the wheel never calls a destroyed instance
+    ~Timeout_Node() {
+        Cancel();
+    }
+
+    /// @brief Whether the timer is armed and will therefore be called once its timeout has passed
+    /// @return Whether the timer is armed or not
+    bool Is_Armed() const {
+        return m_next != nullptr;
+    }
+
+    /// @brief Stops the timer and ensures the callback is not called, can be armed again afterwards
+    void Cancel() {
+        Unlink();
+    }
+
+  private:
+    friend class Timeout_Wheel;
+
+    uint64_t m_expiry_tick = {}; // Tick the timer expires at, the slot it is linked into is this tick modulo the amount of slots
+};
+
+
+/// @brief Hashed timer wheel that handles all timeouts of the library, instead of every timeout creating its own esp_timer or arduino-timer instance.
+/// Timers are sorted into the slot of the tick they expire at, arming and cancelling is therefore constant time independent of the amount of armed timers.
+/// Timers further away than one revolution of the wheel simply stay in their slot, until the tick they expire at has been reached.
+/// The wheel is ticked from the ThingsBoard loop() method, which means timeout callbacks are called from the same task as every other callback of the library,
+/// and are delayed by at most one tick plus the time between two calls to loop()
+class Timeout_Wheel {
+  public:
+#if THINGSBOARD_USE_ESP_TIMER
+    using Time = uint64_t;
+#else
+    using Time = unsigned long;
+#endif // THINGSBOARD_USE_ESP_TIMER
+
+    /// @brief Gets the timer wheel shared by all instances of the library
+    /// @return Global timer wheel
+    static Timeout_Wheel & Get_Instance() {
+        static Timeout_Wheel instance;
+        return instance;
+    }
+
+    /// @brief Gets the current time in microseconds, uses esp_timer_get_time() if the esp timer exists and micros() otherwise
+    /// @return Current time, wraps around for micros() which has to be handled by only ever comparing differences
+    static Time Now() {
+#if THINGSBOARD_USE_ESP_TIMER
+        return static_cast<Time>(esp_timer_get_time());
+#else
+        return micros();
+#endif // THINGSBOARD_USE_ESP_TIMER
+    }
+
+    /// @brief Arms the given timer, if it is already armed it is restarted with the given timeout instead
+    /// @param node Timer that should be called once the given timeout has passed, has to stay alive or be cancelled until then
+    /// @param timeout_microseconds Amount of microseconds until the timer is called, rounded up to the next tick
+    void Arm(Timeout_Node & node, uint64_t const & timeout_microseconds) {
+        node.Cancel();
+        Update_Time();
+        uint64_t expiry_tick = (m_time_microseconds + timeout_microseconds + (static_cast<uint64_t>(1U) << TIMEOUT_WHEEL_TICK_BITS) - 1U) >> TIMEOUT_WHEEL_TICK_BITS;
+        // The current tick has already been processed, therefore the timer can expire at the next tick at the earliest
+        if (expiry_tick <= m_current_tick) {
+            expiry_tick = m_current_tick + 1U;
+        }
+        node.m_expiry_tick = expiry_tick;
+        node.Link_Before(m_slots[expiry_tick & (TIMEOUT_WHEEL_SLOTS - 1U)]);
+    }
+
+    /// @brief Processes every tick that has passed since the last call and calls the callback of every timer that expired in those ticks.
+    /// Timers are unlinked before their callback is called, meaning the callback can arm or cancel any timer including the one that is currently called
+    void tick() {
+        Update_Time();
+        uint64_t const target_tick = m_time_microseconds >> TIMEOUT_WHEEL_TICK_BITS;
+        if (target_tick <= m_current_tick) {
+            return;
+        }
+
+        // Every slot has to be visited at most once, even if more ticks than one revolution have passed since the last call
+        uint64_t const passed_ticks = target_tick - m_current_tick;
+        size_t const visited_slots = passed_ticks < TIMEOUT_WHEEL_SLOTS ? passed_ticks : TIMEOUT_WHEEL_SLOTS;
+        Timeout_Link expired;
+        expired.m_next = &expired;
+        expired.m_previous = &expired;
+        for (size_t i = 1U; i <= visited_slots; i++) {
+            Timeout_Link & head = m_slots[(m_current_tick + i) & (TIMEOUT_WHEEL_SLOTS - 1U)];
+            Timeout_Link * link = head.m_next;
+            while (link != &head) {
+                Timeout_Link * next = link->m_next;
+                if (static_cast<Timeout_Node *>(link)->m_expiry_tick <= target_tick) {
+                    link->Unlink();
+                    link->Link_Before(expired);
+                }
+                link = next;
+            }
+        }
+        m_current_tick = target_tick;
+
+        // Expired timers are first collected and only called afterwards, because the callbacks might arm timers into the slots we are iterating over
+        while (expired.m_next != &expired) {
+            auto node = static_cast<Timeout_Node *>(expired.m_next);
+            node->Cancel();
+            node->Call_Callback();
+        }
+    }
+
+  private:
+    /// @brief Constructor, only called once by Get_Instance()
+    Timeout_Wheel() {
+        for (auto & head : m_slots) {
+            head.m_next = &head;
+            head.m_previous = &head;
+        }
+        m_last_time = Now();
+    }
+
+    /// @brief Adds the time that passed since the last call to the monotonic time of the wheel, which therefore never wraps around even if micros() does
+    void Update_Time() {
+        Time const now = Now();
+        m_time_microseconds += static_cast<Time>(now - m_last_time);
+        m_last_time = now;
+    }
+
+    Timeout_Link m_slots[TIMEOUT_WHEEL_SLOTS] = {}; // List heads of each slot, containing the timers whose expiry tick modulo the amount of slots is the index of the slot
+    Time       m_last_time = {};                // Time in microseconds the time of the wheel was last updated at
+    uint64_t   m_time_microseconds = {};        // Monotonic time of the wheel in microseconds, starting at 0 once the wheel is created
+    uint64_t   m_current_tick = {};             // Last tick that has been processed
+};
+
+#endif // Timeout_Wheel_h
@@ -0,0 +1,207 @@
+#ifndef Topic_Router_h
+#define Topic_Router_h
+
+// Local includes.
+#include "Callback.h"
+#include "IAPI_Implementation.h"
+
+// Library includes.
+#include <string.h>
+
+
+/// @brief Range of API implementations a received topic was routed to, the ones processing the response as raw bytes come first,
+/// followed by the ones processing it as json events and then the ones processing it as json, each in the order they were subscribed in
+struct Topic_Route {
+    IAPI_Implementation * const *first = {};       // First API implementation processing the response as raw bytes
+    IAPI_Implementation * const *raw_last = {};    // One past the last API implementation processing the response as raw bytes, first one processing it as json events
+    IAPI_Implementation * const *events_last = {}; // One past the last API implementation processing the response as json events, first one processing it as json
+    IAPI_Implementation * const *last = {};        // One past the last API implementation processing the response as json
+};
+
+
+/// @brief Routes received topics to the API implementations that could handle them, with one walk over a prefix trie built from Get_Response_Topic_Prefix() of every subscribed API implementation.
+/// Every node of the trie, where the prefix of atleast one API implementation ends, holds a precomputed list of all API implementations whose prefix ends at that node or at one of its parents.
+/// Routing therefore only has to find the deepest node the received topic passes through, which neither allocates memory nor calls any method on the API implementations.
+/// Multiple API implementations can share one prefix and prefixes are only a first filter, Compare_Response_Topic() still has to be called on every API implementation the topic was routed to.
+/// API implementations without a prefix are added to the root node and are therefore routed every topic
+#if THINGSBOARD_ENABLE_DYNAMIC
+class Topic_Router {
+#else
+/// @tparam MaxRoutes Maximum amount of API implementations that can be routed to, the trie then never contains more than MaxRoutes * 2 + 1 nodes
+template <size_t MaxRoutes>
+class Topic_Router {
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+  public:
+    /// @brief Rebuilds the trie from the given API implementations, has to be called every time an API implementation is subscribed.
+    /// Only allocates if the trie grows bigger than it ever was before, because the underlying containers keep their memory
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param first Iterator pointing to the first API implementation, in the order responses should be passed to them
+    /// @param last Iterator pointing to one past the last API implementation
+    template <typename InputIterator>
+    void Build(InputIterator const & first, InputIterator const & last) {
+        m_nodes.clear();
+        m_handlers.clear();
+        m_nodes.push_back(Route_Node());
+        for (auto it = first; it != last; ++it) {
+            IAPI_Implementation const * api = *it;
+            if (api == nullptr) {
+                continue;
+            }
+            Insert(Get_Prefix(*api));
+        }
+        Assign_Handlers(ROOT_NODE, ROOT_NODE, first, last);
+    }
+
+    /// @brief Routes the given topic to every API implementation whose prefix the topic starts with
+    /// @param topic Received topic
+    /// @return Range of API implementations that could handle the topic, stays valid until Build() is called again
+    Topic_Route Route(char const * topic) const {
+        Topic_Route route = {};
+        if (m_nodes.empty()) {
+            return route;
+        }
+        size_t node = ROOT_NODE;
+        while (*topic != '\0') {
+            size_t child = m_nodes[node].first_child;
+            // Siblings never start with the same character, therefore the first character decides which edge to follow
+            while (child != NO_NODE && m_nodes[child].label[0] != *topic) {
+                child = m_nodes[child].next_sibling;
+            }
+            if (child == NO_NODE || strncmp(m_nodes[child].label, topic, m_nodes[child].label_length) != 0) {
+                break;
+            }
+            topic += m_nodes[child].label_length;
+            node = child;
+        }
+        Route_Node const & found = m_nodes[node];
+        if (found.raw_count + found.events_count + found.json_count == 0U) {
+            return route;
+        }
+        route.first = &m_handlers[found.handlers_begin];
+        route.raw_last = route.first + found.raw_count;
+        route.events_last = route.raw_last + found.events_count;
+        route.last = route.events_last + found.json_count;
+        return route;
+    }
+
+  private:
+    // Index used instead of a child or sibling node, if there is none
+    static size_t constexpr NO_NODE = ~static_cast<size_t>(0U);
+    // Node representing the empty prefix, always exists after Build() has been called
+    static size_t constexpr ROOT_NODE = 0U;
+
+    /// @brief Node of the trie, the edge from the parent to this node is labeled with a part of a prefix, which is only referenced and not copied
+    struct Route_Node {
+        char const *label = "";           // Part of the prefix between the parent node and this node, points into the prefix of a subscribed API implementation
+        size_t     label_length = {};     // Amount of characters the label consists of
+        char const *prefix = {};          // Complete prefix of a subscribed API implementation ending at this node, nullptr if no prefix ends here
+        size_t     first_child = NO_NODE; // Index of the first child node
+        size_t     next_sibling = NO_NODE; // Index of the next node with the same parent
+        size_t     handlers_begin = {};   // Index of the first API implementation routed to, if a topic ends in this node or passes through it without reaching a child
+        size_t     raw_count = {};        // Amount of API implementations routed to processing the response as raw bytes
+        size_t     events_count = {};     // Amount of API implementations routed to processing the response as json events
+        size_t     json_count = {};       // Amount of API implementations routed to processing the response as json
+    };
+
+    /// @brief Prefix the given API implementation is routed with, an empty prefix routes every topic to it
+    static char const * Get_Prefix(IAPI_Implementation const & api) {
+        char const * prefix = api.Get_Response_Topic_Prefix();
+        return prefix != nullptr ? prefix : "";
+    }
+
+    /// @brief Inserts the given prefix into the trie, splitting the edge it diverges from if needed
+    /// @param prefix Prefix that should end in a node of the trie
+    void Insert(char const * prefix) {
+        char const * remaining = prefix;
+        size_t node = ROOT_NODE;
+        while (*remaining != '\0') {
+            size_t child = m_nodes[node].first_child;
+            while (child != NO_NODE && m_nodes[child].label[0] != *remaining) {
+                child = m_nodes[child].next_sibling;
+            }
+            if (child == NO_NODE) {
+                Route_Node leaf = {};
+                leaf.label = remaining;
+                leaf.label_length = strlen(remaining);
+                leaf.next_sibling = m_nodes[node].first_child;
+                m_nodes.push_back(leaf);
+                node = m_nodes[node].first_child = m_nodes.size() - 1U;
+                break;
+            }
+
+            size_t common = 1U;
+            while (common < m_nodes[child].label_length && m_nodes[child].label[common] == remaining[common]) {
+                common++;
+            }
+            if (common < m_nodes[child].label_length) {
+                // Prefix ends or diverges inside of the edge, the part of the label after the common characters is moved into a new child node
+                Route_Node split = {};
+                split.label = m_nodes[child].label + common;
+                split.label_length = m_nodes[child].label_length - common;
+                split.prefix = m_nodes[child].prefix;
+                split.first_child = m_nodes[child].first_child;
+                m_nodes.push_back(split);
+                m_nodes[child].label_length = common;
+                m_nodes[child].prefix = nullptr;
+                m_nodes[child].first_child = m_nodes.size() - 1U;
+            }
+            remaining += common;
+            node = child;
+        }
+        m_nodes[node].prefix = prefix;
+    }
+
+    /// @brief Precomputes the API implementations routed to from the given node and all its children
+    /// @param node Node the API implementations are assigned to
+    /// @param parent Node whose API implementations are used if no prefix ends in the given node
+    template <typename InputIterator>
+    void Assign_Handlers(size_t node, size_t parent, InputIterator const & first, InputIterator const & last) {
+        if (m_nodes[node].prefix == nullptr) {
+            m_nodes[node].handlers_begin = m_nodes[parent].handlers_begin;
+            m_nodes[node].raw_count = m_nodes[parent].raw_count;
+            m_nodes[node].events_count = m_nodes[parent].events_count;
+            m_nodes[node].json_count = m_nodes[parent].json_count;
+        }
+        else {
+            m_nodes[node].handlers_begin = m_handlers.size();
+            m_nodes[node].raw_count = Append_Handlers(m_nodes[node].prefix, API_Process_Type::RAW, first, last);
+            m_nodes[node].events_count = Append_Handlers(m_nodes[node].prefix, API_Process_Type::JSON_EVENTS, first, last);
+            m_nodes[node].json_count = Append_Handlers(m_nodes[node].prefix, API_Process_Type::JSON, first, last);
+        }
+        for (size_t child = m_nodes[node].first_child; child != NO_NODE; child = m_nodes[child].next_sibling) {
+            Assign_Handlers(child, node, first, last);
+        }
+    }
+
+    /// @brief Appends every API implementation with the given process type, whose prefix the given prefix starts with, in the order they were subscribed in
+    /// @return Amount of appended API implementations
+    template <typename InputIterator>
+    size_t Append_Handlers(char const * prefix, API_Process_Type type, InputIterator const & first, InputIterator const & last) {
+        size_t count = 0U;
+        for (auto it = first; it != last; ++it) {
+            IAPI_Implementation * api = *it;
+            if (api == nullptr || api->Get_Process_Type() != type) {
+                continue;
+            }
+            char const * api_prefix = Get_Prefix(*api);
+            if (strncmp(api_prefix, prefix, strlen(api_prefix)) != 0) {
+                continue;
+            }
+            m_handlers.push_back(api);
+            count++;
+        }
+        return count;
+    }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Route_Node>                                     m_nodes = {};    // Nodes of the trie, the root node is always the first one
+    Vector<IAPI_Implementation *>                          m_handlers = {}; // Precomputed lists of API implementations, each node references one range
+#else
+    Array<Route_Node, MaxRoutes * 2U + 1U>                 m_nodes = {};    // Nodes of the trie, the root node is always the first one
+    Array<IAPI_Implementation *, MaxRoutes * MaxRoutes>    m_handlers = {}; // Precomputed lists of API implementations, each node references one range
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+};
+
+#endif // Topic_Router_h
@@ -137,6 +137,22 @@ class Vector {
         return m_elements + m_size;
     }
 
+    /// @brief Allocates memory for atleast the given amount of elements, so that inserting up to that many elements does not reallocate.
+    /// Does nothing if enough memory has already been allocated
+    /// @param capacity Amount of elements memory should be allocated for
+    void reserve(size_t const & capacity) {
+        if (capacity <= m_capacity) {
+            return;
+        }
+        T* new_elements = new T[capacity]();
+        if (m_elements != nullptr) {
+            memcpy(new_elements, m_elements, m_size * sizeof(T));
+            delete[] m_elements;
+        }
+        m_elements = new_elements;
+        m_capacity = capacity;
+    }
+
     /// @brief Inserts the given element at the end of the underlying data container,
     /// If the interal data structure is full already then this method will assert and stop the application.
     /// Because if we do not we could cause an out of bounds write, which could possibly overwrite other memory.
@@ -144,13 +160,7 @@ class Vector {
     /// @param element Element that should be inserted at the end
     void push_back(T const & element) {
         if (m_size == m_capacity) {
-            m_capacity = (m_capacity == 0) ? 1 : 2 * m_capacity;
-            T* new_elements = new T[m_capacity]();
-            if (m_elements != nullptr) {
-                memcpy(new_elements, m_elements, m_size * sizeof(T));
-                delete[] m_elements;
-            }
-            m_elements = new_elements;
+            reserve((m_capacity == 0) ? 1 : 2 * m_capacity);
         }
         m_elements[m_size] = element;
         m_size++;